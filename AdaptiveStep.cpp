@@ -0,0 +1,227 @@
+/******************************************************
+ * File: AdaptiveStep.cpp
+ *
+ * Implementation of the AdaptiveStep.h interface.  A
+ * node whose force is weaker than the step moves by the
+ * force itself, exactly as in TransformGraph(); only
+ * stronger forces are cut down to the step length.  The
+ * displacements therefore shrink to zero as the forces
+ * balance, whatever the step has grown to.
+ */
+
+#include <cmath>
+#include <algorithm>
+#include "AdaptiveStep.h"
+using namespace std;
+
+/*
+ * DefaultConvergenceOptions
+ * Returns the default schedule.
+ */
+ConvergenceOptions DefaultConvergenceOptions() {
+    ConvergenceOptions options;
+    options.initialStep = kDefaultInitialStep;
+    options.coolingFactor = kDefaultCoolingFactor;
+    options.progressThreshold = kDefaultProgressThreshold;
+    options.tolerance = kDefaultConvergenceTolerance;
+    options.plateauWindow = kDefaultPlateauWindow;
+    options.plateauTolerance = kDefaultPlateauTolerance;
+    options.maximumIterations = kDefaultMaximumIterations;
+    return options;
+}
+
+/*
+ * InitializeConvergence
+ * The energy starts out infinite so that the first
+ * iteration counts as progress.
+ */
+ConvergenceState InitializeConvergence(const ConvergenceOptions& options) {
+    ConvergenceState state;
+    state.step = options.initialStep;
+    state.energy = HUGE_VAL;
+    state.plateauEnergy = HUGE_VAL;
+    state.progress = 0;
+    state.plateau = 0;
+    state.iterations = 0;
+    state.maximumDisplacement = HUGE_VAL;
+    state.converged = false;
+    return state;
+}
+
+/*
+ * UpdateConvergence
+ * The step only grows while it actually holds some node
+ * back; otherwise it would grow without bound once
+ * every force is weaker than it.  A window restarts
+ * only when the energy falls well below where it began,
+ * so that the jitter of approximate forces, which now
+ * and then dips a little lower, cannot keep the layout
+ * running forever.
+ */
+void UpdateConvergence(const ConvergenceOptions& options, double energy,
+                       double maximumDisplacement, bool limited, bool coolWhenFree,
+                       bool approximate, ConvergenceState& state) {
+    if (energy < state.energy) {
+        state.progress++;
+        if (state.progress >= options.progressThreshold && limited) {
+            state.progress = 0;
+            state.step /= options.coolingFactor;
+        }
+    } else {
+        state.progress = 0;
+        if (limited || coolWhenFree) state.step *= options.coolingFactor;
+    }
+    if (energy < (1.0 - options.plateauTolerance) * state.plateauEnergy) {
+        state.plateauEnergy = energy;
+        state.plateau = 0;
+    } else {
+        state.plateau++;
+    }
+    state.energy = energy;
+    state.maximumDisplacement = maximumDisplacement;
+    state.converged = maximumDisplacement < options.tolerance ||
+                      (approximate && options.plateauWindow > 0 &&
+                       state.plateau >= options.plateauWindow);
+    state.iterations++;
+}
+
+/*
+ * ApplyAdaptiveStep
+ * Moves every node along its force by at most the step,
+ * then updates the step from the change in energy.  The
+ * largest move is measured in edgeLength, the mean edge
+ * length before the step.
+ */
+static void ApplyAdaptiveStep(NodeArrays& positions, NodeArrays& nodeChanges,
+                              double edgeLength, const LayoutOptions& layoutOptions,
+                              const ConvergenceOptions& options, ConvergenceState& state) {
+    double energy = 0, maximumDisplacement = 0;
+    bool limited = false;
+    for (size_t nodeIndex = 0; nodeIndex < positions.size(); nodeIndex++) {
+        double forceX = nodeChanges.x[nodeIndex];
+        double forceY = nodeChanges.y[nodeIndex];
+        double forceSquared = forceX * forceX + forceY * forceY;
+        double force = sqrt(forceSquared);
+        double scale = 1.0;
+        if (force > state.step) {
+            scale = state.step / force;
+            limited = true;
+        }
+        positions.x[nodeIndex] += scale * forceX;
+        positions.y[nodeIndex] += scale * forceY;
+        energy += forceSquared;
+        maximumDisplacement = max(maximumDisplacement, scale * force);
+    }
+    ClearNodeArrays(nodeChanges);
+    UpdateConvergence(options, energy, maximumDisplacement / edgeLength, limited, true,
+                      ApproximateForces(layoutOptions), state);
+}
+
+/*
+ * AdaptiveTransformGraph
+ * Converts the graph to and from NodeArrays around one
+ * adaptive iteration.
+ */
+void AdaptiveTransformGraph(SimpleGraph& graph, const LayoutOptions& layoutOptions,
+                            const ConvergenceOptions& options, ConvergenceState& state) {
+    NodeArrays positions;
+    LoadNodeArrays(graph.nodes, positions);
+    NodeArrays nodeChanges = InitializeNodeChanges(positions);
+    AdaptiveTransformNodeArrays(positions, graph.edges, nodeChanges, layoutOptions, options,
+                                state);
+    StoreNodeArrays(positions, graph.nodes);
+}
+
+/*
+ * AdaptiveTransformNodeArrays
+ * Calculates the forces, then takes an adaptive step.
+ */
+void AdaptiveTransformNodeArrays(NodeArrays& positions, const vector<Edge>& edges,
+                                 NodeArrays& nodeChanges, const LayoutOptions& layoutOptions,
+                                 const ConvergenceOptions& options, ConvergenceState& state) {
+    CalculateNodeForces(positions, edges, nodeChanges, layoutOptions);
+    ApplyAdaptiveStep(positions, nodeChanges, MeanEdgeLength(positions, edges), layoutOptions,
+                      options, state);
+}
+
+/*
+ * AdaptiveTransformNodeArrays
+ * The same, gathering the attraction over the adjacency.
+ */
+void AdaptiveTransformNodeArrays(NodeArrays& positions, const Adjacency& adjacency,
+                                 NodeArrays& nodeChanges, const LayoutOptions& layoutOptions,
+                                 const ConvergenceOptions& options, ConvergenceState& state) {
+    CalculateNodeForces(positions, adjacency, nodeChanges, layoutOptions);
+    ApplyAdaptiveStep(positions, nodeChanges, MeanEdgeLength(positions, adjacency),
+                      layoutOptions, options, state);
+}
+
+/*
+ * AdaptiveTransformNodeArrays
+ * The same, against a deadline.
+ */
+bool AdaptiveTransformNodeArrays(NodeArrays& positions, const Adjacency& adjacency,
+                                 NodeArrays& nodeChanges, const LayoutOptions& layoutOptions,
+                                 const ConvergenceOptions& options, ConvergenceState& state,
+                                 const LayoutDeadline& deadline) {
+    if (!CalculateNodeForces(positions, adjacency, nodeChanges, layoutOptions, deadline)) {
+        ClearNodeArrays(nodeChanges);
+        return false;
+    }
+    ApplyAdaptiveStep(positions, nodeChanges, MeanEdgeLength(positions, adjacency),
+                      layoutOptions, options, state);
+    return true;
+}
+
+/*
+ * RunToConvergence
+ * Iterates on NodeArrays, converting the graph only at
+ * the start and the end, and builds the adjacency once
+ * for all of the iterations.
+ */
+ConvergenceState RunToConvergence(SimpleGraph& graph, const LayoutOptions& layoutOptions,
+                                  const ConvergenceOptions& options) {
+    ConvergenceState state = InitializeConvergence(options);
+    NodeArrays positions;
+    LoadNodeArrays(graph.nodes, positions);
+    NodeArrays nodeChanges = InitializeNodeChanges(positions);
+    Adjacency adjacency;
+    BuildAdjacency(graph.nodes.size(), graph.edges, adjacency);
+    while (!state.converged && state.iterations < options.maximumIterations) {
+        AdaptiveTransformNodeArrays(positions, adjacency, nodeChanges, layoutOptions, options,
+                                    state);
+    }
+    StoreNodeArrays(positions, graph.nodes);
+    return state;
+}
+
+/*
+ * RunWithinBudget
+ * As RunToConvergence(), with the deadline started
+ * before the graph is converted so that the conversion
+ * counts against the budget too.
+ */
+ConvergenceState RunWithinBudget(SimpleGraph& graph, const LayoutOptions& layoutOptions,
+                                 const ConvergenceOptions& options, double seconds) {
+    LayoutDeadline deadline = StartDeadline(seconds);
+    ConvergenceState state = InitializeConvergence(options);
+    NodeArrays positions;
+    LoadNodeArrays(graph.nodes, positions);
+    NodeArrays nodeChanges = InitializeNodeChanges(positions);
+    Adjacency adjacency;
+    BuildAdjacency(graph.nodes.size(), graph.edges, adjacency);
+
+    bool interruptible = InterruptibleForces(layoutOptions);
+    double lastIterationSeconds = 0;
+    while (!state.converged && state.iterations < options.maximumIterations) {
+        if (!IterationFitsBudget(deadline, interruptible ? 0 : lastIterationSeconds)) break;
+        double iterationStart = SecondsSinceStart(deadline);
+        if (!AdaptiveTransformNodeArrays(positions, adjacency, nodeChanges, layoutOptions,
+                                         options, state, deadline)) {
+            break;
+        }
+        lastIterationSeconds = SecondsSinceStart(deadline) - iterationStart;
+    }
+    StoreNodeArrays(positions, graph.nodes);
+    return state;
+}
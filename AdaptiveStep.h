@@ -0,0 +1,210 @@
+/*************************************************************************
+ * File: AdaptiveStep.h
+ *
+ * A header file defining an adaptive cooling schedule for the
+ * force-directed layout, following Yifan Hu's "Efficient and high
+ * quality force-directed graph drawing" (2005).  TransformGraph() moves
+ * every node by the full force acting on it, so the layout never settles
+ * and keeps running until the caller gives up.  Here each node instead
+ * moves along its force by at most a step length, and that step adapts
+ * to the progress of the layout:
+ *
+ *   - The energy of an iteration is the sum of the squared forces on the
+ *     nodes.  It falls as the layout approaches equilibrium.
+ *   - If the energy rises, the layout is overshooting, so the step
+ *     shrinks by the cooling factor.
+ *   - If the energy falls for progressThreshold iterations in a row, the
+ *     step grows by the same factor, so the layout does not crawl.
+ *
+ * The layout has converged once no node moves farther than the
+ * tolerance, in mean edge lengths, in an iteration.  The approximate
+ * engines never get there: their forces carry an error that does not
+ * vanish at equilibrium, so the nodes keep jittering by about that
+ * error.  The exact engine in float or mixed precision jitters the same
+ * way with its rounding.  A layout on such forces has therefore also
+ * converged once a long window of iterations has gone by without the
+ * energy falling by more than a small fraction; a short or loose window
+ * mistakes a slow stretch, such as a line unfolding, for jitter and
+ * stops it early.  The exact double-precision forces only ever stop on
+ * the displacement, since a slow stretch of an exact layout, such as a
+ * large grid unfolding, can go a whole window without that much progress
+ * and still be far from done.  RunToConvergence() runs until then, or
+ * for at most a number of iterations; RunWithinBudget() also stops when
+ * a time budget runs out.
+ */
+
+#ifndef AdaptiveStep_Included // Include guard
+#define AdaptiveStep_Included
+
+#include "SimpleGraph.h" // For the SimpleGraph type.
+#include "ForceLayout.h" // For the LayoutOptions type.
+
+/* Default parameters of the schedule.  Steps are in edge rest lengths, and the
+ * tolerance in mean edge lengths of the layout. */
+const double kDefaultInitialStep = 1.0;
+const double kDefaultCoolingFactor = 0.9;
+const size_t kDefaultProgressThreshold = 5;
+const double kDefaultConvergenceTolerance = 1e-4;
+const size_t kDefaultPlateauWindow = 1000;
+const double kDefaultPlateauTolerance = 0.01;
+const size_t kDefaultMaximumIterations = 100000;
+
+/**
+ * Type: ConvergenceOptions
+ * -----------------------------------------------------------------------
+ * Parameters of the cooling schedule.  initialStep is the step length of
+ * the first iteration, and coolingFactor, between zero and one, the
+ * factor the step shrinks by.  The layout has converged once the largest
+ * distance moved by a node in one iteration, in mean edge lengths of the
+ * layout, is below tolerance, since a large graph stretches its edges
+ * well beyond their rest length, or, for forces that ApproximateForces()
+ * calls approximate, once plateauWindow iterations in a row have left
+ * the energy above 1 - plateauTolerance times the energy the window
+ * started from; a plateauWindow of zero turns the second test off.
+ * RunToConvergence() also stops after maximumIterations.
+ */
+struct ConvergenceOptions {
+    double initialStep;
+    double coolingFactor;
+    size_t progressThreshold;
+    double tolerance;
+    size_t plateauWindow;
+    double plateauTolerance;
+    size_t maximumIterations;
+};
+
+/**
+ * Type: ConvergenceState
+ * -----------------------------------------------------------------------
+ * The progress of one layout.  step is the step length of the next
+ * iteration and progress the number of iterations in a row that lowered
+ * the energy.  energy and maximumDisplacement, in mean edge lengths,
+ * describe the last iteration, and iterations counts the iterations run
+ * so far.  plateauEnergy is the energy the current window started from,
+ * and plateau the number of iterations since then.
+ */
+struct ConvergenceState {
+    double step;
+    double energy;
+    double plateauEnergy;
+    size_t progress;
+    size_t plateau;
+    size_t iterations;
+    double maximumDisplacement;
+    bool converged;
+};
+
+/**
+ * Function: DefaultConvergenceOptions()
+ * -----------------------------------------------------------------------
+ * Returns the default cooling schedule.
+ */
+ConvergenceOptions DefaultConvergenceOptions();
+
+/**
+ * Function: InitializeConvergence(const ConvergenceOptions& options)
+ * -----------------------------------------------------------------------
+ * Returns the state of a layout that has not run any iterations.
+ */
+ConvergenceState InitializeConvergence(const ConvergenceOptions& options);
+
+/**
+ * Function: UpdateConvergence(const ConvergenceOptions& options,
+ *                             double energy, double maximumDisplacement,
+ *                             bool limited, bool coolWhenFree,
+ *                             bool approximate, ConvergenceState& state)
+ * -----------------------------------------------------------------------
+ * Records an iteration that moved every node along its force by at most
+ * state.step, with the given energy and largest displacement, the latter
+ * in mean edge lengths, and adapts the step for the next one.  limited
+ * tells whether the step held any node back; the step only grows if it
+ * did.  A rise in energy cools the step, unless coolWhenFree is false
+ * and the step held no node back.  approximate tells whether the forces
+ * jitter as ApproximateForces() describes, which lets a plateau in the
+ * energy end the layout.
+ */
+void UpdateConvergence(const ConvergenceOptions& options, double energy,
+                       double maximumDisplacement, bool limited, bool coolWhenFree,
+                       bool approximate, ConvergenceState& state);
+
+/**
+ * Function: AdaptiveTransformGraph(SimpleGraph& graph,
+ *                                  const LayoutOptions& layoutOptions,
+ *                                  const ConvergenceOptions& options,
+ *                                  ConvergenceState& state)
+ * -----------------------------------------------------------------------
+ * Runs one iteration of the force-directed algorithm with the current
+ * step length, then updates state.  A layout that has converged keeps
+ * running if asked to; the caller decides when to stop.
+ */
+void AdaptiveTransformGraph(SimpleGraph& graph, const LayoutOptions& layoutOptions,
+                            const ConvergenceOptions& options, ConvergenceState& state);
+
+/**
+ * Function: AdaptiveTransformNodeArrays(NodeArrays& positions,
+ *                                       const vector<Edge>& edges,
+ *                                       NodeArrays& nodeChanges,
+ *                                       const LayoutOptions& layoutOptions,
+ *                                       const ConvergenceOptions& options,
+ *                                       ConvergenceState& state)
+ * -----------------------------------------------------------------------
+ * The same, on node positions already stored as NodeArrays.  nodeChanges
+ * must be all zero, and is left that way.  The overload taking an
+ * adjacency built once with BuildAdjacency() gathers the attraction per
+ * node, as in ForceLayout.h.
+ */
+void AdaptiveTransformNodeArrays(NodeArrays& positions, const vector<Edge>& edges,
+                                 NodeArrays& nodeChanges, const LayoutOptions& layoutOptions,
+                                 const ConvergenceOptions& options, ConvergenceState& state);
+void AdaptiveTransformNodeArrays(NodeArrays& positions, const Adjacency& adjacency,
+                                 NodeArrays& nodeChanges, const LayoutOptions& layoutOptions,
+                                 const ConvergenceOptions& options, ConvergenceState& state);
+
+/**
+ * Function: AdaptiveTransformNodeArrays(NodeArrays& positions,
+ *                                       const Adjacency& adjacency,
+ *                                       NodeArrays& nodeChanges,
+ *                                       const LayoutOptions& layoutOptions,
+ *                                       const ConvergenceOptions& options,
+ *                                       ConvergenceState& state,
+ *                                       const LayoutDeadline& deadline)
+ * -----------------------------------------------------------------------
+ * The same, abandoning the iteration if the deadline passes while the
+ * forces are being computed (see CalculateNodeForces() in ForceLayout.h).
+ * Returns false if it did, leaving the positions and state as they were.
+ */
+bool AdaptiveTransformNodeArrays(NodeArrays& positions, const Adjacency& adjacency,
+                                 NodeArrays& nodeChanges, const LayoutOptions& layoutOptions,
+                                 const ConvergenceOptions& options, ConvergenceState& state,
+                                 const LayoutDeadline& deadline);
+
+/**
+ * Function: RunToConvergence(SimpleGraph& graph,
+ *                            const LayoutOptions& layoutOptions,
+ *                            const ConvergenceOptions& options)
+ * -----------------------------------------------------------------------
+ * Runs adaptive iterations until the layout converges or
+ * options.maximumIterations have run, and returns the final state.
+ */
+ConvergenceState RunToConvergence(SimpleGraph& graph, const LayoutOptions& layoutOptions,
+                                  const ConvergenceOptions& options);
+
+/**
+ * Function: RunWithinBudget(SimpleGraph& graph,
+ *                           const LayoutOptions& layoutOptions,
+ *                           const ConvergenceOptions& options,
+ *                           double seconds)
+ * -----------------------------------------------------------------------
+ * Lays out the graph until it converges, options.maximumIterations have
+ * run or the given number of seconds, which may be a fraction, have
+ * passed on the steady clock, and returns the final state.  The layout
+ * stopped on time if it neither converged nor used every iteration.
+ * Every engine stops within one tile or block of the deadline, dropping
+ * the unfinished iteration.  The trigonometric reference pass, which
+ * cannot stop part of the way through, does not start an iteration that
+ * the last one suggests would end after the deadline.
+ */
+ConvergenceState RunWithinBudget(SimpleGraph& graph, const LayoutOptions& layoutOptions,
+                                 const ConvergenceOptions& options, double seconds);
+
+#endif
@@ -0,0 +1,97 @@
+/******************************************************
+ * File: Adjacency.cpp
+ *
+ * Implementation of the Adjacency.h interface.  The
+ * structure is filled by a counting sort: one pass
+ * counts each node's degree, a prefix sum turns the
+ * counts into offsets, and a second pass drops each
+ * edge into place.
+ */
+
+#include <cmath>
+#include "Adjacency.h"
+using namespace std;
+
+/*
+ * BuildAdjacency
+ * Counts, sums, then places both ends of every edge.
+ */
+void BuildAdjacency(size_t numberOfNodes, const vector<Edge>& edges, Adjacency& adjacency) {
+    adjacency.offsets.assign(numberOfNodes + 1, 0);
+    for (size_t i = 0; i < edges.size(); i++) {
+        if (edges[i].start == edges[i].end) continue;
+        adjacency.offsets[edges[i].start + 1]++;
+        adjacency.offsets[edges[i].end + 1]++;
+    }
+    for (size_t node = 0; node < numberOfNodes; node++) {
+        adjacency.offsets[node + 1] += adjacency.offsets[node];
+    }
+
+    adjacency.targets.resize(adjacency.offsets[numberOfNodes]);
+    vector<size_t> next(adjacency.offsets.begin(), adjacency.offsets.end() - 1);
+    for (size_t i = 0; i < edges.size(); i++) {
+        const Edge& edge = edges[i];
+        if (edge.start == edge.end) continue;
+        adjacency.targets[next[edge.start]++] = edge.end;
+        adjacency.targets[next[edge.end]++] = edge.start;
+    }
+}
+
+/*
+ * MeasureEdges
+ * Sums the length of every edge from both of its ends,
+ * which leaves the mean unchanged, skipping the edges
+ * with a skipped end unless skipped is NULL.
+ */
+static double MeasureEdges(const NodeArrays& positions, const Adjacency& adjacency,
+                           const vector<bool>* skipped) {
+    double total = 0;
+    size_t count = 0;
+    for (size_t node = 0; node < adjacency.size(); node++) {
+        if (skipped && (*skipped)[node]) continue;
+        for (size_t k = adjacency.offsets[node]; k < adjacency.offsets[node + 1]; k++) {
+            size_t neighbour = adjacency.targets[k];
+            if (skipped && (*skipped)[neighbour]) continue;
+            double dx = positions.x[neighbour] - positions.x[node];
+            double dy = positions.y[neighbour] - positions.y[node];
+            total += sqrt(dx * dx + dy * dy);
+            count++;
+        }
+    }
+    return count == 0 || total == 0 ? 1 : total / count;
+}
+
+/*
+ * MeanEdgeLength
+ * Measures every edge.
+ */
+double MeanEdgeLength(const NodeArrays& positions, const Adjacency& adjacency) {
+    return MeasureEdges(positions, adjacency, NULL);
+}
+
+/*
+ * MeanEdgeLength
+ * Measures every edge of the list once.
+ */
+double MeanEdgeLength(const NodeArrays& positions, const vector<Edge>& edges) {
+    double total = 0;
+    size_t count = 0;
+    for (size_t i = 0; i < edges.size(); i++) {
+        size_t start = edges[i].start, end = edges[i].end;
+        if (start == end) continue;
+        double dx = positions.x[end] - positions.x[start];
+        double dy = positions.y[end] - positions.y[start];
+        total += sqrt(dx * dx + dy * dy);
+        count++;
+    }
+    return count == 0 || total == 0 ? 1 : total / count;
+}
+
+/*
+ * MeanEdgeLength
+ * Measures the edges between nodes that are not skipped.
+ */
+double MeanEdgeLength(const NodeArrays& positions, const Adjacency& adjacency,
+                      const vector<bool>& skipped) {
+    return MeasureEdges(positions, adjacency, &skipped);
+}
@@ -0,0 +1,74 @@
+/*************************************************************************
+ * File: Adjacency.h
+ *
+ * A header file defining a compact adjacency structure for graphs, in
+ * compressed sparse row form.  The neighbours of every node are stored
+ * one after another in a single array, and a second array records where
+ * each node's run begins.  Compared with a list of edges, it lets a
+ * graph search visit a node's neighbours with one sequential read; and
+ * compared with a vector of vectors, it needs two allocations in total
+ * instead of one per node.
+ */
+
+#ifndef Adjacency_Included // Include guard
+#define Adjacency_Included
+
+#include "SimpleGraph.h" // For the Edge type.
+#include "NodeArrays.h"  // For the NodeArrays type.
+
+/**
+ * Type: Adjacency
+ * -----------------------------------------------------------------------
+ * The neighbours of node i are targets[offsets[i]] up to, but not
+ * including, targets[offsets[i + 1]].  offsets has one more element than
+ * there are nodes.
+ */
+struct Adjacency {
+    vector<size_t> offsets;
+    vector<unsigned int> targets;
+
+    size_t size() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+    size_t degree(size_t node) const { return offsets[node + 1] - offsets[node]; }
+};
+
+/**
+ * Function: BuildAdjacency(size_t numberOfNodes,
+ *                          const vector<Edge>& edges,
+ *                          Adjacency& adjacency)
+ * -----------------------------------------------------------------------
+ * Fills adjacency with the neighbours of each of numberOfNodes nodes
+ * joined by the given edges, in both directions.  Self-loops are left
+ * out; parallel edges give repeated neighbours.
+ */
+void BuildAdjacency(size_t numberOfNodes, const vector<Edge>& edges, Adjacency& adjacency);
+
+/**
+ * Function: MeanEdgeLength(const NodeArrays& positions,
+ *                          const Adjacency& adjacency)
+ * -----------------------------------------------------------------------
+ * Returns the mean length of the edges in the adjacency at the given
+ * positions, or one if there are none or they all have zero length.
+ */
+double MeanEdgeLength(const NodeArrays& positions, const Adjacency& adjacency);
+
+/**
+ * Function: MeanEdgeLength(const NodeArrays& positions,
+ *                          const vector<Edge>& edges)
+ * -----------------------------------------------------------------------
+ * The same, for the edges in a list.  Self-loops do not count, just as
+ * BuildAdjacency() leaves them out.
+ */
+double MeanEdgeLength(const NodeArrays& positions, const vector<Edge>& edges);
+
+/**
+ * Function: MeanEdgeLength(const NodeArrays& positions,
+ *                          const Adjacency& adjacency,
+ *                          const vector<bool>& skipped)
+ * -----------------------------------------------------------------------
+ * The same, leaving out every edge with an end whose entry in skipped is
+ * true, such as a node that has not been placed yet.
+ */
+double MeanEdgeLength(const NodeArrays& positions, const Adjacency& adjacency,
+                      const vector<bool>& skipped);
+
+#endif
@@ -0,0 +1,210 @@
+/******************************************************
+ * File: ComponentLayout.cpp
+ *
+ * Implementation of the ComponentLayout.h interface.
+ * The worker threads take components from a shared
+ * counter, largest first, so that one thread does not
+ * end up with the largest component at the end of a
+ * long run of small ones.
+ */
+
+#include <cmath>
+#include <atomic>
+#include <algorithm>
+#include "ComponentLayout.h"
+#include "Parallel.h"
+using namespace std;
+
+/* The bounding box of one component, and where it is packed. */
+struct ComponentBox {
+    size_t component;
+    double minX, minY, maxX, maxY;
+    double packedX, packedY;
+};
+
+/*
+ * DefaultComponentOptions
+ * Returns the default parameters.
+ */
+ComponentOptions DefaultComponentOptions() {
+    ComponentOptions options;
+    options.numberOfThreads = 0;
+    options.padding = kDefaultComponentPadding;
+    return options;
+}
+
+/*
+ * FindRoot
+ * Returns the root of the node's set, halving the path
+ * to it on the way.
+ */
+static size_t FindRoot(vector<size_t>& parents, size_t node) {
+    while (parents[node] != node) {
+        parents[node] = parents[parents[node]];
+        node = parents[node];
+    }
+    return node;
+}
+
+/*
+ * FindComponents
+ * Unites the ends of every edge, joining the smaller set
+ * under the larger, then numbers the roots as they are
+ * first met.
+ */
+size_t FindComponents(size_t numberOfNodes, const vector<Edge>& edges,
+                      vector<size_t>& components) {
+    vector<size_t> parents(numberOfNodes), sizes(numberOfNodes, 1);
+    for (size_t node = 0; node < numberOfNodes; node++) parents[node] = node;
+    for (size_t edgeIndex = 0; edgeIndex < edges.size(); edgeIndex++) {
+        size_t root0 = FindRoot(parents, edges[edgeIndex].start);
+        size_t root1 = FindRoot(parents, edges[edgeIndex].end);
+        if (root0 == root1) continue;
+        if (sizes[root0] < sizes[root1]) swap(root0, root1);
+        parents[root1] = root0;
+        sizes[root0] += sizes[root1];
+    }
+
+    const size_t kUnnumbered = numberOfNodes;
+    vector<size_t> numbers(numberOfNodes, kUnnumbered);
+    size_t numberOfComponents = 0;
+    components.resize(numberOfNodes);
+    for (size_t node = 0; node < numberOfNodes; node++) {
+        size_t root = FindRoot(parents, node);
+        if (numbers[root] == kUnnumbered) numbers[root] = numberOfComponents++;
+        components[node] = numbers[root];
+    }
+    return numberOfComponents;
+}
+
+/*
+ * CompareBoxHeights
+ * Orders boxes from tallest to shortest.
+ */
+static bool CompareBoxHeights(const ComponentBox& box0, const ComponentBox& box1) {
+    return box0.maxY - box0.minY > box1.maxY - box1.minY;
+}
+
+/*
+ * PackComponents
+ * Finds each component's bounding box and packs the
+ * boxes, tallest first, into rows no wider than the
+ * square root of their total area or the widest box.
+ * Each row is as tall as its first box.
+ */
+void PackComponents(SimpleGraph& graph, const vector<size_t>& components,
+                    size_t numberOfComponents, double padding) {
+    vector<ComponentBox> boxes(numberOfComponents);
+    for (size_t component = 0; component < numberOfComponents; component++) {
+        boxes[component].component = component;
+        boxes[component].minX = boxes[component].minY = HUGE_VAL;
+        boxes[component].maxX = boxes[component].maxY = -HUGE_VAL;
+    }
+    for (size_t node = 0; node < graph.nodes.size(); node++) {
+        ComponentBox& box = boxes[components[node]];
+        box.minX = min(box.minX, graph.nodes[node].x);
+        box.minY = min(box.minY, graph.nodes[node].y);
+        box.maxX = max(box.maxX, graph.nodes[node].x);
+        box.maxY = max(box.maxY, graph.nodes[node].y);
+    }
+
+    double totalArea = 0, widest = 0;
+    for (size_t i = 0; i < boxes.size(); i++) {
+        double width = boxes[i].maxX - boxes[i].minX + padding;
+        double height = boxes[i].maxY - boxes[i].minY + padding;
+        totalArea += width * height;
+        widest = max(widest, width);
+    }
+    double rowWidth = max(widest, sqrt(totalArea));
+
+    sort(boxes.begin(), boxes.end(), CompareBoxHeights);
+    double x = 0, y = 0, rowHeight = 0;
+    for (size_t i = 0; i < boxes.size(); i++) {
+        double width = boxes[i].maxX - boxes[i].minX + padding;
+        double height = boxes[i].maxY - boxes[i].minY + padding;
+        if (x > 0 && x + width > rowWidth) {
+            x = 0;
+            y += rowHeight;
+        }
+        if (x == 0) rowHeight = height;
+        boxes[i].packedX = x;
+        boxes[i].packedY = y;
+        x += width;
+    }
+
+    //Move every node by its box's offset; the boxes are no longer in component order
+    vector<double> offsetX(numberOfComponents), offsetY(numberOfComponents);
+    for (size_t i = 0; i < boxes.size(); i++) {
+        offsetX[boxes[i].component] = boxes[i].packedX - boxes[i].minX;
+        offsetY[boxes[i].component] = boxes[i].packedY - boxes[i].minY;
+    }
+    for (size_t node = 0; node < graph.nodes.size(); node++) {
+        graph.nodes[node].x += offsetX[components[node]];
+        graph.nodes[node].y += offsetY[components[node]];
+    }
+}
+
+/*
+ * ComponentLayout
+ * Splits the graph into one SimpleGraph per component,
+ * with its edges renumbered, lays them out concurrently,
+ * and copies the positions back before packing.
+ * Components of one node need no layout.
+ */
+size_t ComponentLayout(SimpleGraph& graph, const LayoutOptions& layoutOptions,
+                       const ConvergenceOptions& convergenceOptions,
+                       const ComponentOptions& options) {
+    vector<size_t> components;
+    size_t numberOfComponents = FindComponents(graph.nodes.size(), graph.edges, components);
+
+    //Split the graph, remembering where each node came from
+    vector<SimpleGraph> subgraphs(numberOfComponents);
+    vector<vector<size_t> > members(numberOfComponents);
+    vector<size_t> localIndex(graph.nodes.size());
+    for (size_t node = 0; node < graph.nodes.size(); node++) {
+        size_t component = components[node];
+        localIndex[node] = members[component].size();
+        members[component].push_back(node);
+        subgraphs[component].nodes.push_back(graph.nodes[node]);
+    }
+    for (size_t edgeIndex = 0; edgeIndex < graph.edges.size(); edgeIndex++) {
+        Edge edge = graph.edges[edgeIndex];
+        size_t component = components[edge.start];
+        edge.start = localIndex[edge.start];
+        edge.end = localIndex[edge.end];
+        subgraphs[component].edges.push_back(edge);
+    }
+
+    //Hand out the components largest first
+    vector<size_t> order;
+    for (size_t component = 0; component < numberOfComponents; component++) {
+        if (members[component].size() > 1) order.push_back(component);
+    }
+    stable_sort(order.begin(), order.end(), [&](size_t component0, size_t component1) {
+        return members[component0].size() > members[component1].size();
+    });
+    //Count one iteration's pairs, though each component runs many
+    size_t pairs = 0;
+    for (size_t i = 0; i < order.size(); i++) {
+        size_t size = members[order[i]].size();
+        pairs += size * (size - 1) / 2;
+    }
+    size_t numberOfThreads = LimitThreadCount(options.numberOfThreads, order.size(), pairs);
+    LayoutOptions componentOptions = layoutOptions;
+    if (numberOfThreads > 1) componentOptions.numberOfThreads = 1;
+
+    atomic<size_t> next(0);
+    RunOnThreads(numberOfThreads, [&](size_t) {
+        for (size_t i = next++; i < order.size(); i = next++) {
+            RunToConvergence(subgraphs[order[i]], componentOptions, convergenceOptions);
+        }
+    });
+
+    for (size_t component = 0; component < numberOfComponents; component++) {
+        for (size_t i = 0; i < members[component].size(); i++) {
+            graph.nodes[members[component][i]] = subgraphs[component].nodes[i];
+        }
+    }
+    PackComponents(graph, components, numberOfComponents, options.padding);
+    return numberOfComponents;
+}
@@ -0,0 +1,88 @@
+/*************************************************************************
+ * File: ComponentLayout.h
+ *
+ * A header file defining a layout driver for graphs with more than one
+ * connected component.  Laid out as a whole, the components of such a
+ * graph only interact through the repulsion, which pushes them apart
+ * for ever: the layout never converges, and the time spent on pairs of
+ * nodes in different components buys nothing.
+ *
+ * The driver instead finds the components with a union-find over the
+ * edges and lays each one out on its own, as a separate graph, with the
+ * components shared out among worker threads.  It then packs the
+ * components' bounding boxes into one layout: the boxes are sorted by
+ * height and placed left to right in rows as wide as the square root
+ * of their total area, or as the widest box if that is wider, the "next
+ * fit decreasing height" shelf packing.
+ */
+
+#ifndef ComponentLayout_Included // Include guard
+#define ComponentLayout_Included
+
+#include "SimpleGraph.h"  // For the SimpleGraph type.
+#include "ForceLayout.h"  // For the LayoutOptions type.
+#include "AdaptiveStep.h" // For the ConvergenceOptions type.
+
+/* Default space left between packed components, in edge rest lengths. */
+const double kDefaultComponentPadding = 1.0;
+
+/**
+ * Type: ComponentOptions
+ * -----------------------------------------------------------------------
+ * Parameters of the driver.  The components are laid out on
+ * numberOfThreads threads, or one per core if it is zero, and packed
+ * with padding between their bounding boxes.
+ */
+struct ComponentOptions {
+    size_t numberOfThreads;
+    double padding;
+};
+
+/**
+ * Function: DefaultComponentOptions()
+ * -----------------------------------------------------------------------
+ * Returns the default parameters, with one thread per core.
+ */
+ComponentOptions DefaultComponentOptions();
+
+/**
+ * Function: FindComponents(size_t numberOfNodes,
+ *                          const vector<Edge>& edges,
+ *                          vector<size_t>& components)
+ * -----------------------------------------------------------------------
+ * Stores in components the connected component of each node and returns
+ * the number of components.  They are numbered from zero in the order
+ * of their lowest-numbered nodes.
+ */
+size_t FindComponents(size_t numberOfNodes, const vector<Edge>& edges,
+                      vector<size_t>& components);
+
+/**
+ * Function: PackComponents(SimpleGraph& graph,
+ *                          const vector<size_t>& components,
+ *                          size_t numberOfComponents, double padding)
+ * -----------------------------------------------------------------------
+ * Moves each component of the graph, as found by FindComponents(), so
+ * that their bounding boxes are packed into rows with padding between
+ * them.  The shape of each component is unchanged.
+ */
+void PackComponents(SimpleGraph& graph, const vector<size_t>& components,
+                    size_t numberOfComponents, double padding);
+
+/**
+ * Function: ComponentLayout(SimpleGraph& graph,
+ *                           const LayoutOptions& layoutOptions,
+ *                           const ConvergenceOptions& convergenceOptions,
+ *                           const ComponentOptions& options)
+ * -----------------------------------------------------------------------
+ * Runs every component of the graph to convergence by RunToConvergence()
+ * from its nodes' current positions, then packs them, and returns the
+ * number of components.  When the components are shared among several
+ * threads, each is laid out on one thread, whatever
+ * layoutOptions.numberOfThreads says.
+ */
+size_t ComponentLayout(SimpleGraph& graph, const LayoutOptions& layoutOptions,
+                       const ConvergenceOptions& convergenceOptions,
+                       const ComponentOptions& options);
+
+#endif
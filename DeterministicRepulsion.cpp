@@ -0,0 +1,127 @@
+/******************************************************
+ * File: DeterministicRepulsion.cpp
+ *
+ * Implementation of the DeterministicRepulsion.h
+ * interface.  Threads claim row blocks from a shared
+ * counter, which decides only who computes a block,
+ * never the order of any sum.  The kernel is plain
+ * scalar code: the vector kernels of SimdRepulsion.cpp
+ * owe their speed to a reciprocal square root estimate,
+ * whose bits differ between processors, and a vector
+ * division was no faster per pair than a scalar one on
+ * the machines measured.
+ */
+
+#include <cmath>
+#include <atomic>
+#include <algorithm>
+#include "DeterministicRepulsion.h"
+#include "ForceLayout.h"
+#include "Parallel.h"
+using namespace std;
+
+/*
+ * SumTree
+ * Adds up count values along a balanced binary tree,
+ * the first half before the second.
+ */
+static double SumTree(const double* values, size_t count) {
+    if (count == 0) return 0;
+    if (count == 1) return values[0];
+    size_t half = (count + 1) / 2;
+    return SumTree(values, half) + SumTree(values + half, count - half);
+}
+
+/*
+ * SumChunk
+ * Stores in sumX and sumY the repulsion on node i from
+ * the nodes in [begin, end).  Partner j goes into lane
+ * (j - begin) % kDeterministicLanes, and node i itself
+ * adds nothing.
+ */
+static void SumChunk(const double* x, const double* y, size_t i, size_t begin, size_t end,
+                     double& sumX, double& sumY) {
+    double laneX[kDeterministicLanes], laneY[kDeterministicLanes];
+    fill(laneX, laneX + kDeterministicLanes, 0.0);
+    fill(laneY, laneY + kDeterministicLanes, 0.0);
+    double x0 = x[i], y0 = y[i];
+
+    //The force kRepel / d along the unit vector (dx, dy) / d
+    size_t j = begin;
+    for (; j + kDeterministicLanes <= end; j += kDeterministicLanes) {
+        for (size_t lane = 0; lane < kDeterministicLanes; lane++) {
+            double dx = x0 - x[j + lane];
+            double dy = y0 - y[j + lane];
+            double scale = (j + lane == i) ? 0.0 : kRepel / (dx * dx + dy * dy);
+            laneX[lane] += scale * dx;
+            laneY[lane] += scale * dy;
+        }
+    }
+    for (size_t lane = 0; j < end; j++, lane++) {
+        double dx = x0 - x[j];
+        double dy = y0 - y[j];
+        double scale = (j == i) ? 0.0 : kRepel / (dx * dx + dy * dy);
+        laneX[lane] += scale * dx;
+        laneY[lane] += scale * dy;
+    }
+    sumX = SumTree(laneX, kDeterministicLanes);
+    sumY = SumTree(laneY, kDeterministicLanes);
+}
+
+/*
+ * CalculateDeterministicRepulsiveForces
+ * Runs against a deadline that never passes.
+ */
+void CalculateDeterministicRepulsiveForces(const NodeArrays& positions, NodeArrays& nodeChanges,
+                                           size_t numberOfThreads) {
+    CalculateDeterministicRepulsiveForces(positions, nodeChanges, numberOfThreads,
+                                          StartDeadline(HUGE_VAL));
+}
+
+/*
+ * CalculateDeterministicRepulsiveForces
+ * For each claimed block, sums every chunk for every
+ * node of the block while that chunk is in cache, then
+ * reduces each node's chunk sums along the tree.  The
+ * deadline is checked after each block, as the tiled
+ * engine checks it after each tile.
+ */
+bool CalculateDeterministicRepulsiveForces(const NodeArrays& positions, NodeArrays& nodeChanges,
+                                           size_t numberOfThreads, const LayoutDeadline& deadline) {
+    size_t numberOfNodes = positions.size();
+    size_t numberOfBlocks = (numberOfNodes + kDeterministicRowBlock - 1) / kDeterministicRowBlock;
+    size_t numberOfChunks = (numberOfNodes + kDeterministicChunkSize - 1) /
+                            kDeterministicChunkSize;
+    numberOfThreads = LimitThreadCount(numberOfThreads, numberOfBlocks,
+                                       numberOfNodes * numberOfNodes);
+    const double* x = positions.x.data();
+    const double* y = positions.y.data();
+    atomic<size_t> nextBlock(0);
+    atomic<bool> stopped(false);
+
+    RunOnThreads(numberOfThreads, [&](size_t) {
+        vector<double> partialX(kDeterministicRowBlock * numberOfChunks);
+        vector<double> partialY(kDeterministicRowBlock * numberOfChunks);
+        for (size_t block = nextBlock++; block < numberOfBlocks; block = nextBlock++) {
+            size_t rowBegin = block * kDeterministicRowBlock;
+            size_t rowEnd = min(rowBegin + kDeterministicRowBlock, numberOfNodes);
+            for (size_t chunk = 0; chunk < numberOfChunks; chunk++) {
+                size_t columnBegin = chunk * kDeterministicChunkSize;
+                size_t columnEnd = min(columnBegin + kDeterministicChunkSize, numberOfNodes);
+                for (size_t i = rowBegin; i < rowEnd; i++) {
+                    size_t slot = (i - rowBegin) * numberOfChunks + chunk;
+                    SumChunk(x, y, i, columnBegin, columnEnd, partialX[slot], partialY[slot]);
+                }
+            }
+            for (size_t i = rowBegin; i < rowEnd; i++) {
+                size_t first = (i - rowBegin) * numberOfChunks;
+                nodeChanges.x[i] += SumTree(&partialX[first], numberOfChunks);
+                nodeChanges.y[i] += SumTree(&partialY[first], numberOfChunks);
+            }
+            if (DeadlinePassed(deadline) && nextBlock.exchange(numberOfBlocks) < numberOfBlocks) {
+                stopped = true;
+            }
+        }
+    });
+    return !stopped;
+}
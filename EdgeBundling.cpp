@@ -0,0 +1,578 @@
+/******************************************************
+ * File: EdgeBundling.cpp
+ *
+ * Implementation of the EdgeBundling.h interface.  The
+ * interior points of every polyline are kept in one
+ * flat array, those of edge e at e * n to e * n + n - 1
+ * for n points per edge.  Where the paper pulls a point
+ * towards each compatible edge by the inverse of their
+ * distance, which shoots points past one another once
+ * they come close, here a point moves along the mean of
+ * the directions to its compatible edges, weighted by
+ * their compatibility, so it settles in the middle of
+ * its bundle.  The springs are applied as a smoothing
+ * towards the middle of a point's neighbours, which
+ * stays stable however many points the polyline has.
+ */
+
+#include <cmath>
+#include <algorithm>
+#include "EdgeBundling.h"
+#include "Parallel.h"
+using namespace std;
+
+/* Each cycle runs this fraction of the iterations of the one before. */
+const double kBundlingIterationRate = 2.0 / 3.0;
+
+/* The grid has at most this many cells per edge. */
+const size_t kBundlingCellsPerEdge = 4;
+
+/* Widens each bound on a compatible pair so that rounding cannot lose one. */
+const double kBundlingBoundSlack = 1 + 1e-9;
+
+/*
+ * Type: CompatibleEdge
+ * An edge compatible with another, with their
+ * compatibility, and whether it runs the other way, so
+ * that its points are matched from its far end.
+ */
+struct CompatibleEdge {
+    size_t edge;
+    double weight;
+    bool reversed;
+};
+
+/*
+ * Type: EdgeSegment
+ * The midpoint, length and unit direction of an edge's
+ * straight line, which the bounds on its compatible
+ * edges are checked against before they are measured.
+ */
+struct EdgeSegment {
+    double midX, midY;
+    double length;
+    double unitX, unitY;
+};
+
+/*
+ * Type: MidpointGrid
+ * The edges bucketed by the cell their midpoint falls
+ * in.  The edges of cell c are edges[cellStart[c]] up to
+ * edges[cellStart[c + 1]], in increasing order, and the
+ * longest of them is longest[c] long; the longest edge
+ * of all is longestEdge long.
+ */
+struct MidpointGrid {
+    double minX, minY;
+    double cellSize;
+    size_t columns, rows;
+    vector<size_t> cellStart;
+    vector<size_t> edges;
+    vector<double> longest;
+    double longestEdge;
+};
+
+/*
+ * Type: CompatibleBounds
+ * Bounds that every pair of edges with compatibility at
+ * least t must meet, since each of the four measures is
+ * at most one and so must itself be at least t: the
+ * longer edge is at most lengthRatio times the shorter,
+ * the midpoints are at most midpointRatio times the mean
+ * length apart, and the angle measure, as well as the
+ * product of the angle, scale and position measures, is
+ * at least minimumMeasure.  Each is widened by
+ * kBundlingBoundSlack.
+ */
+struct CompatibleBounds {
+    double lengthRatio;
+    double midpointRatio;
+    double minimumMeasure;
+};
+
+/*
+ * DefaultBundlingOptions
+ * Returns the default parameters.
+ */
+BundlingOptions DefaultBundlingOptions() {
+    BundlingOptions options;
+    options.cycles = kDefaultBundlingCycles;
+    options.initialIterations = kDefaultBundlingIterations;
+    options.initialStep = kDefaultBundlingStep;
+    options.stiffness = kDefaultBundlingStiffness;
+    options.compatibility = kDefaultBundlingCompatibility;
+    options.numberOfThreads = 0;
+    return options;
+}
+
+/*
+ * VisibilityCompatibility
+ * Projects q0 and q1 onto the line through p0 and p1,
+ * and measures how near the middle of that projection
+ * the midpoint of p0 p1 lies.
+ */
+static double VisibilityCompatibility(const Node& p0, const Node& p1,
+                                      const Node& q0, const Node& q1) {
+    double dx = p1.x - p0.x, dy = p1.y - p0.y;
+    double lengthSquared = dx * dx + dy * dy;
+    double t0 = ((q0.x - p0.x) * dx + (q0.y - p0.y) * dy) / lengthSquared;
+    double t1 = ((q1.x - p0.x) * dx + (q1.y - p0.y) * dy) / lengthSquared;
+    double projectionLength = fabs(t1 - t0) * sqrt(lengthSquared);
+    if (projectionLength == 0) return 0;
+
+    double middle = (t0 + t1) / 2;
+    double middleX = p0.x + middle * dx, middleY = p0.y + middle * dy;
+    double offsetX = (p0.x + p1.x) / 2 - middleX, offsetY = (p0.y + p1.y) / 2 - middleY;
+    double offset = sqrt(offsetX * offsetX + offsetY * offsetY);
+    return max(1 - 2 * offset / projectionLength, 0.0);
+}
+
+/*
+ * EdgeCompatibility
+ * Multiplies the angle, scale, position and visibility
+ * compatibilities of the paper.
+ */
+double EdgeCompatibility(const Node& p0, const Node& p1, const Node& q0, const Node& q1) {
+    double px = p1.x - p0.x, py = p1.y - p0.y;
+    double qx = q1.x - q0.x, qy = q1.y - q0.y;
+    double lengthP = sqrt(px * px + py * py);
+    double lengthQ = sqrt(qx * qx + qy * qy);
+    if (lengthP == 0 || lengthQ == 0) return 0;
+
+    double angle = fabs(px * qx + py * qy) / (lengthP * lengthQ);
+    double average = (lengthP + lengthQ) / 2;
+    double scale = 2 / (average / min(lengthP, lengthQ) + max(lengthP, lengthQ) / average);
+    double mx = (q0.x + q1.x - p0.x - p1.x) / 2, my = (q0.y + q1.y - p0.y - p1.y) / 2;
+    double position = average / (average + sqrt(mx * mx + my * my));
+    double visibility = min(VisibilityCompatibility(p0, p1, q0, q1),
+                            VisibilityCompatibility(q0, q1, p0, p1));
+    return angle * scale * position * visibility;
+}
+
+/*
+ * CompatibleThresholdBounds
+ * Returns the bounds for the threshold t.  The scale
+ * compatibility is at least t only if the longer edge is
+ * at most 4 / t - 3 times the shorter; the position
+ * compatibility is at least t only if the midpoints are
+ * at most (1 - t) / t times the mean length apart.
+ */
+static CompatibleBounds CompatibleThresholdBounds(double threshold) {
+    CompatibleBounds bounds;
+    bounds.lengthRatio = (4 / threshold - 3) * kBundlingBoundSlack;
+    bounds.midpointRatio = (1 - threshold) / threshold * kBundlingBoundSlack;
+    bounds.minimumMeasure = threshold / kBundlingBoundSlack;
+    return bounds;
+}
+
+/*
+ * ScalePositionProduct
+ * Returns the product of the scale and position measures
+ * of two edges of the given lengths whose midpoints are
+ * sqrt(distanceSquared) apart, as EdgeCompatibility()
+ * computes them, leaving out only the visibility.
+ */
+static double ScalePositionProduct(double lengthP, double lengthQ, double distanceSquared) {
+    double average = (lengthP + lengthQ) / 2;
+    double scale = 2 / (average / min(lengthP, lengthQ) + max(lengthP, lengthQ) / average);
+    return scale * average / (average + sqrt(distanceSquared));
+}
+
+/*
+ * MeasureEdgeSegments
+ * Stores the midpoint and unit direction of every edge of
+ * nonzero length.
+ */
+static void MeasureEdgeSegments(const SimpleGraph& graph, const vector<double>& lengths,
+                                vector<EdgeSegment>& segments) {
+    size_t numberOfEdges = graph.edges.size();
+    segments.resize(numberOfEdges);
+    for (size_t e = 0; e < numberOfEdges; e++) {
+        const Node& start = graph.nodes[graph.edges[e].start];
+        const Node& end = graph.nodes[graph.edges[e].end];
+        EdgeSegment& segment = segments[e];
+        segment.midX = (start.x + end.x) / 2;
+        segment.midY = (start.y + end.y) / 2;
+        segment.length = lengths[e];
+        segment.unitX = segment.unitY = 0;
+        if (lengths[e] == 0) continue;
+        segment.unitX = (end.x - start.x) / lengths[e];
+        segment.unitY = (end.y - start.y) / lengths[e];
+    }
+}
+
+/*
+ * BuildMidpointGrid
+ * Buckets the midpoints of the edges of nonzero length
+ * into square cells about as wide as the mean edge, or
+ * wider if that would give too many cells.
+ */
+static void BuildMidpointGrid(const vector<EdgeSegment>& segments, MidpointGrid& grid) {
+    size_t numberOfEdges = segments.size();
+    double minX = HUGE_VAL, minY = HUGE_VAL, maxX = -HUGE_VAL, maxY = -HUGE_VAL;
+    double totalLength = 0;
+    size_t counted = 0;
+    for (size_t e = 0; e < numberOfEdges; e++) {
+        if (segments[e].length == 0) continue;
+        minX = min(minX, segments[e].midX);
+        minY = min(minY, segments[e].midY);
+        maxX = max(maxX, segments[e].midX);
+        maxY = max(maxY, segments[e].midY);
+        totalLength += segments[e].length;
+        counted++;
+    }
+
+    grid.minX = minX;
+    grid.minY = minY;
+    grid.columns = grid.rows = 1;
+    grid.cellSize = 1;
+    if (counted > 0) {
+        double width = maxX - minX, height = maxY - minY;
+        grid.cellSize = totalLength / counted;
+        double cells = (width / grid.cellSize + 1) * (height / grid.cellSize + 1);
+        double maximumCells = (double) kBundlingCellsPerEdge * counted;
+        if (cells > maximumCells) grid.cellSize *= sqrt(cells / maximumCells);
+        grid.columns = (size_t) (width / grid.cellSize) + 1;
+        grid.rows = (size_t) (height / grid.cellSize) + 1;
+    }
+
+    //Count the midpoints in each cell, then place them
+    vector<size_t> cellOf(numberOfEdges);
+    grid.cellStart.assign(grid.columns * grid.rows + 1, 0);
+    grid.longest.assign(grid.columns * grid.rows, 0.0);
+    grid.longestEdge = 0;
+    for (size_t e = 0; e < numberOfEdges; e++) {
+        const EdgeSegment& segment = segments[e];
+        if (segment.length == 0) continue;
+        size_t column = min((size_t) ((segment.midX - minX) / grid.cellSize), grid.columns - 1);
+        size_t row = min((size_t) ((segment.midY - minY) / grid.cellSize), grid.rows - 1);
+        cellOf[e] = row * grid.columns + column;
+        grid.cellStart[cellOf[e] + 1]++;
+        grid.longest[cellOf[e]] = max(grid.longest[cellOf[e]], segment.length);
+        grid.longestEdge = max(grid.longestEdge, segment.length);
+    }
+    for (size_t c = 0; c < grid.columns * grid.rows; c++) {
+        grid.cellStart[c + 1] += grid.cellStart[c];
+    }
+    grid.edges.assign(counted, 0);
+    vector<size_t> next(grid.cellStart.begin(), grid.cellStart.end() - 1);
+    for (size_t e = 0; e < numberOfEdges; e++) {
+        if (segments[e].length > 0) grid.edges[next[cellOf[e]]++] = e;
+    }
+}
+
+/*
+ * FindCompatibleEdges
+ * Appends to found every pair (e, other) with e in
+ * [begin, end) and other > e whose compatibility is at
+ * least the threshold, so that each pair is measured
+ * once.  The midpoints can be no farther apart than the
+ * position bound allows for e and the longest edge it
+ * could be paired with, so only the cells that close are
+ * searched, skipping those whose longest edge is too
+ * short to be compatible with e, and an edge is only
+ * measured once its length, direction and midpoint meet
+ * the bounds.
+ */
+static void FindCompatibleEdges(const SimpleGraph& graph, const vector<EdgeSegment>& segments,
+                                const MidpointGrid& grid, double threshold,
+                                size_t begin, size_t end,
+                                vector<pair<size_t, CompatibleEdge> >& found) {
+    CompatibleBounds bounds = CompatibleThresholdBounds(threshold);
+    for (size_t e = begin; e < end; e++) {
+        const EdgeSegment& segment = segments[e];
+        if (segment.length == 0) continue;
+        const Node& p0 = graph.nodes[graph.edges[e].start];
+        const Node& p1 = graph.nodes[graph.edges[e].end];
+        double shortest = segment.length / bounds.lengthRatio;
+        double longest = min(segment.length * bounds.lengthRatio, grid.longestEdge);
+        double radius = bounds.midpointRatio * (segment.length + longest) / 2;
+
+        //Cells overlapping the square around the midpoint, clamped to the grid
+        double first = (segment.midX - radius - grid.minX) / grid.cellSize;
+        double last = (segment.midX + radius - grid.minX) / grid.cellSize;
+        size_t firstColumn = first < 0 ? 0 : (size_t) first;
+        size_t lastColumn = min(last < 0 ? 0 : (size_t) last, grid.columns - 1);
+        first = (segment.midY - radius - grid.minY) / grid.cellSize;
+        last = (segment.midY + radius - grid.minY) / grid.cellSize;
+        size_t firstRow = first < 0 ? 0 : (size_t) first;
+        size_t lastRow = min(last < 0 ? 0 : (size_t) last, grid.rows - 1);
+
+        for (size_t row = firstRow; row <= lastRow && firstColumn < grid.columns; row++) {
+            for (size_t column = firstColumn; column <= lastColumn; column++) {
+                size_t cell = row * grid.columns + column;
+                if (grid.longest[cell] < shortest) continue;
+                const size_t* cellEnd = grid.edges.data() + grid.cellStart[cell + 1];
+                const size_t* after = upper_bound(grid.edges.data() + grid.cellStart[cell],
+                                                  cellEnd, e);
+                for (; after != cellEnd; after++) {
+                    size_t other = *after;
+                    const EdgeSegment& candidate = segments[other];
+                    if (candidate.length < shortest || candidate.length > longest) continue;
+                    double cosine = segment.unitX * candidate.unitX +
+                                    segment.unitY * candidate.unitY;
+                    if (fabs(cosine) < bounds.minimumMeasure) continue;
+                    double dx = candidate.midX - segment.midX;
+                    double dy = candidate.midY - segment.midY;
+                    double separation = bounds.midpointRatio *
+                                        (segment.length + candidate.length) / 2;
+                    double distanceSquared = dx * dx + dy * dy;
+                    if (distanceSquared > separation * separation) continue;
+                    if (fabs(cosine) * ScalePositionProduct(segment.length, candidate.length,
+                                                            distanceSquared) <
+                        bounds.minimumMeasure) continue;
+
+                    const Node& q0 = graph.nodes[graph.edges[other].start];
+                    const Node& q1 = graph.nodes[graph.edges[other].end];
+                    double weight = EdgeCompatibility(p0, p1, q0, q1);
+                    if (weight < threshold) continue;
+
+                    CompatibleEdge entry;
+                    entry.edge = other;
+                    entry.weight = weight;
+                    entry.reversed = cosine < 0;
+                    found.push_back(make_pair(e, entry));
+                }
+            }
+        }
+    }
+}
+
+/*
+ * FindAllCompatibleEdges
+ * Buckets the midpoints and shares the edges out between
+ * the threads to find their pairs, then adds every pair
+ * to the lists of both of its edges.  Compatibility and
+ * direction are the same from either end, and the pairs
+ * are merged in the order of their lower edge, so the
+ * lists do not depend on the number of threads.  Each
+ * edge's search counts as nine measures, one edge in
+ * each of the three by three cells around its midpoint.
+ */
+static void FindAllCompatibleEdges(const SimpleGraph& graph, const vector<double>& lengths,
+                                   double threshold, size_t numberOfThreads,
+                                   vector<vector<CompatibleEdge> >& compatible) {
+    size_t numberOfEdges = graph.edges.size();
+    vector<EdgeSegment> segments;
+    MeasureEdgeSegments(graph, lengths, segments);
+    MidpointGrid grid;
+    BuildMidpointGrid(segments, grid);
+    numberOfThreads = LimitThreadCount(numberOfThreads, numberOfEdges, 9 * numberOfEdges);
+    vector<vector<pair<size_t, CompatibleEdge> > > found(numberOfThreads);
+    RunOnThreads(numberOfThreads, [&](size_t thread) {
+        size_t begin, end;
+        ThreadRange(numberOfEdges, thread, numberOfThreads, begin, end);
+        FindCompatibleEdges(graph, segments, grid, threshold, begin, end, found[thread]);
+    });
+
+    compatible.assign(numberOfEdges, vector<CompatibleEdge>());
+    for (size_t thread = 0; thread < numberOfThreads; thread++) {
+        for (size_t k = 0; k < found[thread].size(); k++) {
+            size_t e = found[thread][k].first;
+            CompatibleEdge entry = found[thread][k].second;
+            compatible[e].push_back(entry);
+            size_t other = entry.edge;
+            entry.edge = e;
+            compatible[other].push_back(entry);
+        }
+    }
+}
+
+/*
+ * MeasureEdgeLengths
+ * Stores the straight length of every edge.
+ */
+static void MeasureEdgeLengths(const SimpleGraph& graph, vector<double>& lengths) {
+    size_t numberOfEdges = graph.edges.size();
+    lengths.resize(numberOfEdges);
+    for (size_t e = 0; e < numberOfEdges; e++) {
+        const Node& start = graph.nodes[graph.edges[e].start];
+        const Node& end = graph.nodes[graph.edges[e].end];
+        lengths[e] = sqrt((end.x - start.x) * (end.x - start.x) +
+                          (end.y - start.y) * (end.y - start.y));
+    }
+}
+
+/*
+ * FindCompatiblePairs
+ * Keeps each pair from the side of its lower edge.
+ */
+size_t FindCompatiblePairs(const SimpleGraph& graph, double compatibility,
+                           size_t numberOfThreads, vector<pair<size_t, size_t> >& pairs) {
+    size_t numberOfEdges = graph.edges.size();
+    vector<double> lengths;
+    MeasureEdgeLengths(graph, lengths);
+    vector<vector<CompatibleEdge> > compatible;
+    FindAllCompatibleEdges(graph, lengths, compatibility, numberOfThreads, compatible);
+
+    pairs.clear();
+    for (size_t e = 0; e < numberOfEdges; e++) {
+        for (size_t k = 0; k < compatible[e].size(); k++) {
+            if (e < compatible[e][k].edge) pairs.push_back(make_pair(e, compatible[e][k].edge));
+        }
+    }
+    sort(pairs.begin(), pairs.end());
+    return pairs.size();
+}
+
+/*
+ * SubdividePolylines
+ * Adds a point at the middle of every segment, turning n
+ * interior points per edge into 2n + 1.
+ */
+static void SubdividePolylines(const SimpleGraph& graph, size_t& pointsPerEdge,
+                               vector<double>& x, vector<double>& y) {
+    size_t numberOfEdges = graph.edges.size();
+    size_t nextPoints = 2 * pointsPerEdge + 1;
+    vector<double> nextX(numberOfEdges * nextPoints), nextY(numberOfEdges * nextPoints);
+    for (size_t e = 0; e < numberOfEdges; e++) {
+        const Node& start = graph.nodes[graph.edges[e].start];
+        const Node& end = graph.nodes[graph.edges[e].end];
+        const double* oldX = &x[e * pointsPerEdge];
+        const double* oldY = &y[e * pointsPerEdge];
+        double* newX = &nextX[e * nextPoints];
+        double* newY = &nextY[e * nextPoints];
+        for (size_t i = 0; i <= pointsPerEdge; i++) {
+            double previousX = (i == 0) ? start.x : oldX[i - 1];
+            double previousY = (i == 0) ? start.y : oldY[i - 1];
+            double currentX = (i == pointsPerEdge) ? end.x : oldX[i];
+            double currentY = (i == pointsPerEdge) ? end.y : oldY[i];
+            newX[2 * i] = (previousX + currentX) / 2;
+            newY[2 * i] = (previousY + currentY) / 2;
+            if (i < pointsPerEdge) {
+                newX[2 * i + 1] = currentX;
+                newY[2 * i + 1] = currentY;
+            }
+        }
+    }
+    x.swap(nextX);
+    y.swap(nextY);
+    pointsPerEdge = nextPoints;
+}
+
+/*
+ * MovePolylinePoints
+ * Stores in nextX and nextY the points of the edges in
+ * [begin, end) after one iteration, reading only x and
+ * y.
+ */
+static void MovePolylinePoints(const SimpleGraph& graph, const vector<double>& lengths,
+                               const vector<vector<CompatibleEdge> >& compatible,
+                               size_t pointsPerEdge, double step, double stiffness,
+                               const vector<double>& x, const vector<double>& y,
+                               size_t begin, size_t end,
+                               vector<double>& nextX, vector<double>& nextY) {
+    for (size_t e = begin; e < end; e++) {
+        const Node& start = graph.nodes[graph.edges[e].start];
+        const Node& finish = graph.nodes[graph.edges[e].end];
+        size_t first = e * pointsPerEdge;
+        for (size_t i = 0; i < pointsPerEdge; i++) {
+            double px = x[first + i], py = y[first + i];
+            double previousX = (i == 0) ? start.x : x[first + i - 1];
+            double previousY = (i == 0) ? start.y : y[first + i - 1];
+            double followingX = (i + 1 == pointsPerEdge) ? finish.x : x[first + i + 1];
+            double followingY = (i + 1 == pointsPerEdge) ? finish.y : y[first + i + 1];
+
+            //Spring: towards the middle of the two neighbours
+            double moveX = stiffness * ((previousX + followingX) / 2 - px);
+            double moveY = stiffness * ((previousY + followingY) / 2 - py);
+
+            //Attraction: along the weighted mean direction to the matching points
+            double sumX = 0, sumY = 0, totalWeight = 0;
+            for (size_t k = 0; k < compatible[e].size(); k++) {
+                const CompatibleEdge& other = compatible[e][k];
+                size_t j = other.reversed ? pointsPerEdge - 1 - i : i;
+                double dx = x[other.edge * pointsPerEdge + j] - px;
+                double dy = y[other.edge * pointsPerEdge + j] - py;
+                double distance = sqrt(dx * dx + dy * dy);
+                totalWeight += other.weight;
+                if (distance == 0) continue;
+                sumX += other.weight * dx / distance;
+                sumY += other.weight * dy / distance;
+            }
+            if (totalWeight > 0) {
+                moveX += step * lengths[e] * sumX / totalWeight;
+                moveY += step * lengths[e] * sumY / totalWeight;
+            }
+            nextX[first + i] = px + moveX;
+            nextY[first + i] = py + moveY;
+        }
+    }
+}
+
+/*
+ * BundleEdges
+ * Finds the compatible pairs once, since the edges'
+ * straight positions do not change, then runs the
+ * cycles.  The threads are started once per cycle and
+ * run all of its iterations, meeting at a barrier after
+ * each one; the point arrays alternate between source
+ * and destination, so the last destination is swapped
+ * into place only after an odd number of iterations.
+ */
+size_t BundleEdges(const SimpleGraph& graph, const BundlingOptions& options,
+                   vector<vector<Node> >& polylines) {
+    size_t numberOfEdges = graph.edges.size();
+    vector<double> lengths;
+    MeasureEdgeLengths(graph, lengths);
+    vector<vector<CompatibleEdge> > compatible;
+    FindAllCompatibleEdges(graph, lengths, options.compatibility, options.numberOfThreads,
+                           compatible);
+    size_t numberOfPairs = 0;
+    for (size_t e = 0; e < numberOfEdges; e++) numberOfPairs += compatible[e].size();
+
+    //The first cycle, the shortest, moves one point per edge
+    size_t firstCycle = max(options.initialIterations, (size_t) 1);
+    size_t numberOfThreads = LimitThreadCount(options.numberOfThreads, numberOfEdges,
+                                              (numberOfEdges + numberOfPairs) * firstCycle);
+
+    //One point at the middle of every edge to start
+    size_t pointsPerEdge = 1;
+    vector<double> x(numberOfEdges), y(numberOfEdges);
+    for (size_t e = 0; e < numberOfEdges; e++) {
+        x[e] = (graph.nodes[graph.edges[e].start].x + graph.nodes[graph.edges[e].end].x) / 2;
+        y[e] = (graph.nodes[graph.edges[e].start].y + graph.nodes[graph.edges[e].end].y) / 2;
+    }
+
+    double step = options.initialStep;
+    double iterations = options.initialIterations;
+    vector<double> nextX, nextY;
+    for (size_t cycle = 0; cycle < options.cycles; cycle++) {
+        if (cycle > 0) {
+            SubdividePolylines(graph, pointsPerEdge, x, y);
+            step /= 2;
+            iterations *= kBundlingIterationRate;
+        }
+        nextX.resize(x.size());
+        nextY.resize(y.size());
+        size_t cycleIterations = max((size_t) (iterations + 0.5), (size_t) 1);
+        ThreadBarrier barrier(numberOfThreads);
+        RunOnThreads(numberOfThreads, [&](size_t thread) {
+            size_t begin, end;
+            ThreadRange(numberOfEdges, thread, numberOfThreads, begin, end);
+            for (size_t iteration = 0; iteration < cycleIterations; iteration++) {
+                bool even = iteration % 2 == 0;
+                MovePolylinePoints(graph, lengths, compatible, pointsPerEdge, step,
+                                   options.stiffness, even ? x : nextX, even ? y : nextY,
+                                   begin, end, even ? nextX : x, even ? nextY : y);
+                barrier.wait();
+            }
+        });
+        if (cycleIterations % 2 == 1) {
+            x.swap(nextX);
+            y.swap(nextY);
+        }
+    }
+
+    polylines.assign(numberOfEdges, vector<Node>());
+    for (size_t e = 0; e < numberOfEdges; e++) {
+        polylines[e].reserve(pointsPerEdge + 2);
+        polylines[e].push_back(graph.nodes[graph.edges[e].start]);
+        for (size_t i = 0; i < pointsPerEdge; i++) {
+            Node point = {x[e * pointsPerEdge + i], y[e * pointsPerEdge + i]};
+            polylines[e].push_back(point);
+        }
+        polylines[e].push_back(graph.nodes[graph.edges[e].end]);
+    }
+    return numberOfPairs / 2;
+}
@@ -0,0 +1,118 @@
+/*************************************************************************
+ * File: EdgeBundling.h
+ *
+ * A header file defining force-directed edge bundling, which draws the
+ * edges of a finished layout as curves that run together in bundles
+ * wherever several edges take roughly the same route.  On dense graphs
+ * the straight lines otherwise cross in every direction and the picture
+ * turns into a hairball.
+ *
+ * The method follows Holten and van Wijk, "Force-Directed Edge Bundling
+ * for Graph Visualization" (2009).  Every edge is cut into a polyline,
+ * and the points of each polyline are pulled towards the matching points
+ * of the edges compatible with it, while springs along the polyline keep
+ * it smooth.  The work is done in cycles: each cycle doubles the number
+ * of points on every polyline, by adding one at the middle of each
+ * segment, and halves the step size, so that the bundles are found
+ * coarsely first and then refined.
+ *
+ * Two edges are compatible when they are of similar length, point in
+ * similar directions, lie close together and face each other; the
+ * product of these four measures lies between zero and one.  Plain FDEB
+ * measures every pair of edges, which takes O(E^2) time.  Since each
+ * measure is at most one, each must itself reach the threshold, which
+ * caps the ratio of the two lengths, the angle between the edges and
+ * how far apart their midpoints can be.  The midpoints are placed in a
+ * uniform grid, each edge looks only at the cells within that distance
+ * and only at the edges after it, and a pair is measured only once the
+ * cheaper caps hold.  The pairs found are exactly those that every pair
+ * would give.  The edges are shared out between threads both to find
+ * their compatible edges and in every iteration, each thread moving the
+ * points of its own edges from the positions of the iteration before,
+ * so the result is the same on any number of threads.  The threads are
+ * started once per cycle and wait for each other between its
+ * iterations.
+ */
+
+#ifndef EdgeBundling_Included // Include guard
+#define EdgeBundling_Included
+
+#include <utility>       // For the pair type.
+#include "SimpleGraph.h" // For the SimpleGraph type.
+
+/* Default parameters of the edge bundling. */
+const size_t kDefaultBundlingCycles = 6;
+const size_t kDefaultBundlingIterations = 50;
+const double kDefaultBundlingStep = 0.04;
+const double kDefaultBundlingStiffness = 0.5;
+const double kDefaultBundlingCompatibility = 0.6;
+
+/**
+ * Type: BundlingOptions
+ * -----------------------------------------------------------------------
+ * Parameters controlling the bundling.  It runs for the given number of
+ * cycles, the first of initialIterations iterations and each later one
+ * of two thirds as many as the one before.  In the first cycle a point
+ * moves by up to initialStep times the length of its edge per iteration
+ * towards its compatible edges, and stiffness, between zero and one, is
+ * how far it is drawn each iteration towards the middle of its two
+ * neighbours on the polyline.  Only pairs of edges whose compatibility
+ * is at least compatibility, which must be more than zero, attract each
+ * other.  The work is shared between numberOfThreads threads, or one
+ * per core if numberOfThreads is zero.
+ */
+struct BundlingOptions {
+    size_t cycles;
+    size_t initialIterations;
+    double initialStep;
+    double stiffness;
+    double compatibility;
+    size_t numberOfThreads;
+};
+
+/**
+ * Function: DefaultBundlingOptions()
+ * -----------------------------------------------------------------------
+ * Returns the default bundling parameters, which use one thread per
+ * core.
+ */
+BundlingOptions DefaultBundlingOptions();
+
+/**
+ * Function: EdgeCompatibility(const Node& p0, const Node& p1,
+ *                             const Node& q0, const Node& q1)
+ * -----------------------------------------------------------------------
+ * Returns the compatibility of the edge from p0 to p1 with the edge from
+ * q0 to q1, between zero and one.  Edges of no length are compatible
+ * with nothing.
+ */
+double EdgeCompatibility(const Node& p0, const Node& p1, const Node& q0, const Node& q1);
+
+/**
+ * Function: FindCompatiblePairs(const SimpleGraph& graph,
+ *                               double compatibility,
+ *                               size_t numberOfThreads,
+ *                               vector<pair<size_t, size_t> >& pairs)
+ * -----------------------------------------------------------------------
+ * Stores in pairs, in increasing order, every pair (i, j) with i < j of
+ * edges whose compatibility is at least the given one, searching the
+ * midpoint grid as BundleEdges() does, on numberOfThreads threads, or
+ * one per core if it is zero.  Returns the number of pairs.
+ */
+size_t FindCompatiblePairs(const SimpleGraph& graph, double compatibility,
+                           size_t numberOfThreads, vector<pair<size_t, size_t> >& pairs);
+
+/**
+ * Function: BundleEdges(const SimpleGraph& graph,
+ *                       const BundlingOptions& options,
+ *                       vector<vector<Node> >& polylines)
+ * -----------------------------------------------------------------------
+ * Bundles the edges of the graph as it is laid out, storing in
+ * polylines[i] the points graph.edges[i] should be drawn through, from
+ * its start node to its end node.  Returns the number of pairs of
+ * compatible edges.
+ */
+size_t BundleEdges(const SimpleGraph& graph, const BundlingOptions& options,
+                   vector<vector<Node> >& polylines);
+
+#endif
@@ -0,0 +1,354 @@
+/******************************************************
+ * File: FastMultipole.cpp
+ *
+ * Implementation of the FastMultipole.h interface.
+ * Each cell of the quadtree carries a multipole
+ * expansion of the field of its own nodes and a local
+ * expansion of the field of the far-away nodes, both
+ * about the cell's geometric centre:
+ *
+ *   multipole:  sum over k of M_k / (z - c)^(k + 1)
+ *   local:      sum over l of L_l * (z - c)^l
+ *
+ * The multipoles are built bottom-up, the dual tree
+ * traversal converts them into locals (M2L), and the
+ * locals are pushed down to the leaves and evaluated.
+ */
+
+#include <cmath>
+#include <complex>
+#include <algorithm>
+#include "FastMultipole.h"
+#include "QuadTree.h"
+#include "ForceLayout.h"
+using namespace std;
+
+typedef complex<double> Complex;
+
+/* Working storage for one evaluation of the forces. */
+struct MultipoleState {
+    const NodeArrays* positions;
+    QuadTree tree;
+    size_t order;
+    double theta;
+    vector<double> binomial;     // binomial[n * width + k] is n choose k
+    size_t width;
+    vector<Complex> multipoles;  // order + 1 coefficients per cell
+    vector<Complex> locals;      // order + 1 coefficients per cell
+    vector<double> radii;        // distance from each centre to its farthest node
+    vector<Complex> fields;      // sum of 1 / (z_i - z_j) for each node
+    vector<Complex> powers;      // scratch powers for M2L and L2L, 2 * order + 2 long
+    const LayoutDeadline* deadline;
+    size_t stepsSinceCheck;      // cell visits since the deadline was last read
+    bool stopped;                // whether the deadline has stopped the pass
+};
+
+/*
+ * NodePosition, CellCenter
+ * Return a node position or a cell centre as a complex
+ * number.
+ */
+static Complex NodePosition(const MultipoleState& state, size_t node) {
+    return Complex(state.positions->x[node], state.positions->y[node]);
+}
+
+static Complex CellCenter(const QuadTreeCell& cell) {
+    return Complex(cell.centerX, cell.centerY);
+}
+
+/*
+ * Binomial
+ * Returns n choose k from the precomputed table.
+ */
+static double Binomial(const MultipoleState& state, size_t n, size_t k) {
+    return state.binomial[n * state.width + k];
+}
+
+/*
+ * OutOfTime
+ * Counts one visit to a cell in the traversal or the
+ * push down, checks the deadline every kDeadlineCheckNodes
+ * visits, and returns whether it stopped the pass.
+ */
+static bool OutOfTime(MultipoleState& state) {
+    if (state.stopped) return true;
+    if (++state.stepsSinceCheck < kDeadlineCheckNodes) return false;
+    state.stepsSinceCheck = 0;
+    state.stopped = DeadlinePassed(*state.deadline);
+    return state.stopped;
+}
+
+/*
+ * BuildMultipoles
+ * Computes the multipole expansion and radius of a cell
+ * and all of its descendants, directly from the nodes in
+ * a leaf and by shifting the children's expansions (M2M)
+ * otherwise.
+ */
+static void BuildMultipoles(MultipoleState& state, size_t cellIndex) {
+    const QuadTreeCell& cell = state.tree.cells[cellIndex];
+    Complex center = CellCenter(cell);
+    Complex* multipole = &state.multipoles[cellIndex * (state.order + 1)];
+    double radius = 0;
+
+    if (cell.isLeaf) {
+        for (size_t i = cell.firstBody; i < cell.lastBody; i++) {
+            Complex offset = NodePosition(state, state.tree.bodies[i]) - center;
+            Complex power = 1;
+            for (size_t k = 0; k <= state.order; k++) {
+                multipole[k] += power;
+                power *= offset;
+            }
+            radius = max(radius, abs(offset));
+        }
+    } else {
+        for (size_t child = 0; child < 4; child++) {
+            size_t childIndex = cell.firstChild + child;
+            if (state.tree.cells[childIndex].mass == 0) continue;
+            BuildMultipoles(state, childIndex);
+
+            //Shift the child's expansion to this cell's centre
+            Complex shift = CellCenter(state.tree.cells[childIndex]) - center;
+            const Complex* childMultipole = &state.multipoles[childIndex * (state.order + 1)];
+            for (size_t k = 0; k <= state.order; k++) {
+                Complex power = 1;
+                Complex sum = 0;
+                for (size_t l = k + 1; l-- > 0; ) {
+                    sum += Binomial(state, k, l) * power * childMultipole[l];
+                    power *= shift;
+                }
+                multipole[k] += sum;
+            }
+            radius = max(radius, abs(shift) + state.radii[childIndex]);
+        }
+    }
+
+    //The cell's own corners also bound its radius
+    state.radii[cellIndex] = min(radius, cell.halfSize * sqrt(2.0));
+}
+
+/*
+ * MultipoleToLocal
+ * Adds the field of the source cell's multipole expansion
+ * into the target cell's local expansion (M2L).
+ */
+static void MultipoleToLocal(MultipoleState& state, size_t source, size_t target) {
+    const Complex* multipole = &state.multipoles[source * (state.order + 1)];
+    Complex* local = &state.locals[target * (state.order + 1)];
+    Complex separation = CellCenter(state.tree.cells[target]) -
+                         CellCenter(state.tree.cells[source]);
+
+    //inversePowers[n] is 1 / separation^n
+    Complex* inversePowers = &state.powers[0];
+    Complex inverse = 1.0 / separation;
+    inversePowers[0] = 1;
+    for (size_t n = 1; n < state.powers.size(); n++) {
+        inversePowers[n] = inversePowers[n - 1] * inverse;
+    }
+
+    for (size_t l = 0; l <= state.order; l++) {
+        Complex sum = 0;
+        for (size_t k = 0; k <= state.order; k++) {
+            sum += Binomial(state, k + l, l) * multipole[k] * inversePowers[k + l + 1];
+        }
+        local[l] += (l % 2 == 0) ? sum : -sum;
+    }
+}
+
+/*
+ * DirectInteraction
+ * Adds the exact field between the nodes of two leaves,
+ * or between every pair of nodes in one leaf.
+ */
+static void DirectInteraction(MultipoleState& state, size_t first, size_t second) {
+    const QuadTreeCell& a = state.tree.cells[first];
+    const QuadTreeCell& b = state.tree.cells[second];
+    for (size_t i = a.firstBody; i < a.lastBody; i++) {
+        size_t node0 = state.tree.bodies[i];
+        Complex z0 = NodePosition(state, node0);
+        size_t start = (first == second) ? i + 1 : b.firstBody;
+        for (size_t j = start; j < b.lastBody; j++) {
+            size_t node1 = state.tree.bodies[j];
+            Complex term = 1.0 / (z0 - NodePosition(state, node1));
+            state.fields[node0] += term;
+            state.fields[node1] -= term;
+        }
+    }
+}
+
+/*
+ * Interact
+ * The dual tree traversal.  Well-separated pairs of cells
+ * exchange expansions, pairs of leaves interact directly,
+ * and anything else is refined by splitting the larger
+ * of the two cells.  Once the deadline has passed, the
+ * traversal unwinds without doing anything more.
+ */
+static void Interact(MultipoleState& state, size_t first, size_t second) {
+    const QuadTreeCell& a = state.tree.cells[first];
+    const QuadTreeCell& b = state.tree.cells[second];
+    if (a.mass == 0 || b.mass == 0) return;
+    if (OutOfTime(state)) return;
+
+    if (first == second) {
+        if (a.isLeaf) {
+            DirectInteraction(state, first, first);
+        } else {
+            for (size_t child0 = 0; child0 < 4; child0++) {
+                for (size_t child1 = child0; child1 < 4; child1++) {
+                    Interact(state, a.firstChild + child0, a.firstChild + child1);
+                }
+            }
+        }
+        return;
+    }
+
+    double distance = abs(CellCenter(a) - CellCenter(b));
+    if (state.radii[first] + state.radii[second] < state.theta * distance) {
+        MultipoleToLocal(state, second, first);
+        MultipoleToLocal(state, first, second);
+    } else if (a.isLeaf && b.isLeaf) {
+        DirectInteraction(state, first, second);
+    } else if (a.isLeaf || (!b.isLeaf && state.radii[second] > state.radii[first])) {
+        for (size_t child = 0; child < 4; child++) {
+            Interact(state, first, b.firstChild + child);
+        }
+    } else {
+        for (size_t child = 0; child < 4; child++) {
+            Interact(state, a.firstChild + child, second);
+        }
+    }
+}
+
+/*
+ * PushLocals
+ * Shifts a cell's local expansion into its children
+ * (L2L), and evaluates it at every node of a leaf (L2P),
+ * until the deadline passes.
+ */
+static void PushLocals(MultipoleState& state, size_t cellIndex) {
+    const QuadTreeCell& cell = state.tree.cells[cellIndex];
+    if (cell.mass == 0) return;
+    if (OutOfTime(state)) return;
+    Complex center = CellCenter(cell);
+    const Complex* local = &state.locals[cellIndex * (state.order + 1)];
+
+    if (cell.isLeaf) {
+        for (size_t i = cell.firstBody; i < cell.lastBody; i++) {
+            size_t node = state.tree.bodies[i];
+            Complex offset = NodePosition(state, node) - center;
+            //Horner's rule
+            Complex value = 0;
+            for (size_t l = state.order + 1; l-- > 0; ) {
+                value = value * offset + local[l];
+            }
+            state.fields[node] += value;
+        }
+        return;
+    }
+
+    for (size_t child = 0; child < 4; child++) {
+        size_t childIndex = cell.firstChild + child;
+        Complex shift = CellCenter(state.tree.cells[childIndex]) - center;
+        Complex* childLocal = &state.locals[childIndex * (state.order + 1)];
+
+        //shiftPowers[n] is shift^n; the scratch is free again before the recursion
+        Complex* shiftPowers = &state.powers[0];
+        shiftPowers[0] = 1;
+        for (size_t n = 1; n <= state.order; n++) {
+            shiftPowers[n] = shiftPowers[n - 1] * shift;
+        }
+        for (size_t m = 0; m <= state.order; m++) {
+            Complex sum = 0;
+            for (size_t l = m; l <= state.order; l++) {
+                sum += Binomial(state, l, m) * shiftPowers[l - m] * local[l];
+            }
+            childLocal[m] += sum;
+        }
+        PushLocals(state, childIndex);
+    }
+}
+
+/*
+ * ValidTheta
+ * Returns theta if it is a usable separation ratio, and
+ * zero, which splits every pair of cells down to their
+ * leaves, if it is not.
+ */
+static double ValidTheta(double theta) {
+    return (theta >= 0 && theta < kMaximumBarnesHutTheta) ? theta : 0;
+}
+
+/*
+ * CalculateFastMultipoleRepulsiveForces
+ * Runs against a deadline that never passes.
+ */
+void CalculateFastMultipoleRepulsiveForces(const NodeArrays& positions,
+                                           NodeArrays& nodeChanges,
+                                           size_t order, double theta) {
+    CalculateFastMultipoleRepulsiveForces(positions, nodeChanges, order, theta,
+                                          StartDeadline(HUGE_VAL));
+}
+
+/*
+ * CalculateFastMultipoleRepulsiveForces
+ * Builds the quadtree and expansions, runs the dual tree
+ * traversal, and converts each node's field into a force,
+ * unless the deadline stopped the traversal or the push.
+ */
+bool CalculateFastMultipoleRepulsiveForces(const NodeArrays& positions,
+                                           NodeArrays& nodeChanges,
+                                           size_t order, double theta,
+                                           const LayoutDeadline& deadline) {
+    size_t numberOfNodes = positions.size();
+    if (numberOfNodes == 0) return true;
+
+    MultipoleState state;
+    state.positions = &positions;
+    state.order = order;
+    state.theta = ValidTheta(theta);
+    state.deadline = &deadline;
+    state.stepsSinceCheck = 0;
+    state.stopped = false;
+    BuildQuadTree(positions, state.tree, kFastMultipoleLeafCapacity);
+
+    //Pascal's triangle up to the largest index needed by M2L
+    state.width = 2 * order + 1;
+    state.binomial.assign(state.width * state.width, 0.0);
+    for (size_t n = 0; n < state.width; n++) {
+        state.binomial[n * state.width] = 1;
+        for (size_t k = 1; k <= n; k++) {
+            state.binomial[n * state.width + k] =
+                state.binomial[(n - 1) * state.width + k - 1] +
+                state.binomial[(n - 1) * state.width + k];
+        }
+    }
+
+    size_t numberOfCells = state.tree.cells.size();
+    state.multipoles.assign(numberOfCells * (order + 1), Complex(0));
+    state.locals.assign(numberOfCells * (order + 1), Complex(0));
+    state.radii.assign(numberOfCells, 0.0);
+    state.fields.assign(numberOfNodes, Complex(0));
+    state.powers.assign(2 * order + 2, Complex(0));
+
+    BuildMultipoles(state, 0);
+    Interact(state, 0, 0);
+    PushLocals(state, 0);
+    if (state.stopped) return false;
+
+    //The force is kRepel times the conjugate of the field
+    for (size_t nodeIndex = 0; nodeIndex < numberOfNodes; nodeIndex++) {
+        nodeChanges.x[nodeIndex] += kRepel * state.fields[nodeIndex].real();
+        nodeChanges.y[nodeIndex] -= kRepel * state.fields[nodeIndex].imag();
+    }
+    return true;
+}
+
+/*
+ * FastMultipoleErrorBound
+ * Returns the relative error bound of a single
+ * cell-to-cell interaction.
+ */
+double FastMultipoleErrorBound(size_t order, double theta) {
+    return 2 * pow(theta, (double) (order + 1)) / ((1 - theta) * (1 - theta));
+}
@@ -0,0 +1,87 @@
+/*************************************************************************
+ * File: FastMultipole.h
+ *
+ * A header file defining a two-dimensional fast multipole method (FMM)
+ * for the repulsive forces of the layout.
+ *
+ * The Fruchterman-Reingold repulsion between two nodes has magnitude
+ * kRepel / d and points away from the other node, which is exactly the
+ * gradient of the logarithmic potential kRepel * log(d).  Writing node
+ * positions as complex numbers z, the repulsion on node i is therefore
+ *
+ *     kRepel * conj( sum over j of 1 / (z_i - z_j) )
+ *
+ * and the sum can be evaluated with truncated Laurent (multipole) and
+ * Taylor (local) expansions of 1 / (z - z_j) over an adaptive quadtree.
+ * Pairs of cells are visited with a dual tree traversal: two cells of
+ * radius rA and rB whose centres are d apart interact through their
+ * expansions whenever rA + rB < theta * d, and otherwise are split, or
+ * summed directly once both are leaves.  The total work is O(n) for a
+ * fixed expansion order.
+ *
+ * With expansions truncated after the term of degree `order`, the error of
+ * every cell-to-cell interaction is at most
+ *
+ *     2 * theta^(order + 1) / (1 - theta)^2
+ *
+ * times Q * kRepel / d, the force the source cell would exert if all Q of
+ * its nodes sat at its centre.  FastMultipoleErrorBound() returns this
+ * factor so callers can pick an order for a target accuracy.
+ */
+
+#ifndef FastMultipole_Included // Include guard
+#define FastMultipole_Included
+
+#include "NodeArrays.h"   // For the NodeArrays type.
+#include "LayoutBudget.h" // For the LayoutDeadline type.
+
+/* Default number of expansion terms kept by the FMM engine. */
+const size_t kDefaultFastMultipoleOrder = 12;
+
+/* Number of nodes a quadtree leaf may hold before the FMM splits it. */
+const size_t kFastMultipoleLeafCapacity = 16;
+
+/**
+ * Function: CalculateFastMultipoleRepulsiveForces(const NodeArrays& positions,
+ *                                                 NodeArrays& nodeChanges,
+ *                                                 size_t order,
+ *                                                 double theta)
+ * -----------------------------------------------------------------------
+ * Adds the repulsive force on every node into nodeChanges, computed with
+ * expansions of the given order.  theta is the separation ratio that
+ * decides when two cells are far enough apart to use their expansions.
+ * As in QuadTree.h, a theta outside [0, kMaximumBarnesHutTheta) of
+ * ForceLayout.h, where the expansions would not converge, is rejected,
+ * and the forces are then computed exactly, as with theta = 0.
+ */
+void CalculateFastMultipoleRepulsiveForces(const NodeArrays& positions,
+                                           NodeArrays& nodeChanges,
+                                           size_t order, double theta);
+
+/**
+ * Function: CalculateFastMultipoleRepulsiveForces(const NodeArrays& positions,
+ *                                                 NodeArrays& nodeChanges,
+ *                                                 size_t order,
+ *                                                 double theta,
+ *                                                 const LayoutDeadline& deadline)
+ * -----------------------------------------------------------------------
+ * The same, except that the deadline is checked after every
+ * kDeadlineCheckNodes cells the traversal or the push down of the local
+ * expansions visits.  Returns true if the forces were added, and false
+ * if the deadline stopped the pass, in which case nodeChanges is left
+ * as it was.
+ */
+bool CalculateFastMultipoleRepulsiveForces(const NodeArrays& positions,
+                                           NodeArrays& nodeChanges,
+                                           size_t order, double theta,
+                                           const LayoutDeadline& deadline);
+
+/**
+ * Function: FastMultipoleErrorBound(size_t order, double theta)
+ * -----------------------------------------------------------------------
+ * Returns the bound on the relative error of a single cell-to-cell
+ * interaction described above.
+ */
+double FastMultipoleErrorBound(size_t order, double theta);
+
+#endif
@@ -0,0 +1,241 @@
+/******************************************************
+ * File: ForceAtlas2.cpp
+ *
+ * Implementation of the ForceAtlas2.h interface.  The
+ * forces are computed in the paper's units, in which an
+ * edge of length d pulls with force d; the repulsion
+ * engines, which work in units of kRepel, are rescaled
+ * to match.  The speed control follows the reference
+ * implementation in Gephi, including its estimate of the
+ * best jitter tolerance for the size of the graph.
+ */
+
+#include <cmath>
+#include <algorithm>
+#include "ForceAtlas2.h"
+#include "ForceModels.h"
+#include "QuadTree.h"
+#include "GridRepulsion.h"
+using namespace std;
+
+/* The global speed stops rising once it reaches this value. */
+const double kMaximumSpeed = 1000;
+
+/* Lower bound on the factor the global speed aims for. */
+const double kMinimumSpeedEfficiency = 0.05;
+
+/* The largest fraction by which the global speed may rise in one iteration. */
+const double kMaximumSpeedRise = 0.5;
+
+/* The linear pull of ForceAtlas2 in its own units. */
+struct UnitLinearForces {
+    static const bool kInverseDistanceRepulsion = true;
+    static double Repel(double distance) { return 1 / distance; }
+    static double Attract(double distance) { return distance; }
+};
+
+/*
+ * DefaultForceAtlas2Options
+ * Returns the default parameters.
+ */
+ForceAtlas2Options DefaultForceAtlas2Options() {
+    ForceAtlas2Options options;
+    options.scalingRatio = kDefaultScalingRatio;
+    options.gravity = kDefaultGravity;
+    options.jitterTolerance = kDefaultJitterTolerance;
+    options.degreeWeightedRepulsion = true;
+    options.tolerance = kDefaultForceAtlas2Tolerance;
+    options.maximumIterations = kDefaultForceAtlas2Iterations;
+    return options;
+}
+
+/*
+ * InitializeForceAtlas2
+ * Gives every node its mass and starts at speed one, so
+ * the first iteration moves every node by its force.
+ */
+ForceAtlas2State InitializeForceAtlas2(const Adjacency& adjacency,
+                                       const ForceAtlas2Options& options) {
+    ForceAtlas2State state;
+    size_t numberOfNodes = adjacency.size();
+    state.masses.assign(numberOfNodes, 1.0);
+    if (options.degreeWeightedRepulsion) {
+        for (size_t node = 0; node < numberOfNodes; node++) {
+            state.masses[node] += adjacency.degree(node);
+        }
+    }
+    ResizeNodeArrays(state.previousForces, numberOfNodes);
+    ResizeNodeArrays(state.forces, numberOfNodes);
+    state.speed = 1;
+    state.speedEfficiency = 1;
+    state.iterations = 0;
+    state.maximumDisplacement = HUGE_VAL;
+    state.converged = false;
+    return state;
+}
+
+/*
+ * CalculateForceAtlas2Forces
+ * Adds the mass-weighted repulsion from the selected
+ * engine, scaled from kRepel to scalingRatio, then the
+ * gravity and the attraction.  The grid cutoff is given
+ * in edge lengths, which in ForceAtlas2's units are
+ * neither fixed nor one, so it is scaled by the current
+ * mean edge length.  Returns false, with only part of
+ * the repulsion added, if the deadline stopped it.
+ */
+static bool CalculateForceAtlas2Forces(const NodeArrays& positions, const Adjacency& adjacency,
+                                       double edgeLength, const LayoutOptions& layoutOptions,
+                                       const ForceAtlas2Options& options,
+                                       ForceAtlas2State& state, const LayoutDeadline& deadline) {
+    NodeArrays& forces = state.forces;
+    bool finished;
+    if (layoutOptions.repulsionMode == kGridRepulsion) {
+        finished = CalculateGridRepulsiveForces(positions, state.masses, forces,
+                                                layoutOptions.cutoff * edgeLength, deadline);
+    } else if (layoutOptions.repulsionMode == kExactRepulsion) {
+        finished = CalculateRepulsiveForces(positions, state.masses, forces, deadline);
+    } else {
+        finished = CalculateBarnesHutRepulsiveForces(positions, state.masses, forces,
+                                                     layoutOptions.theta, deadline);
+    }
+    if (!finished) return false;
+
+    double scale = options.scalingRatio / kRepel;
+    for (size_t node = 0; node < positions.size(); node++) {
+        forces.x[node] *= scale;
+        forces.y[node] *= scale;
+
+        //Gravity of constant strength towards the origin
+        double distance = sqrt(positions.x[node] * positions.x[node] +
+                               positions.y[node] * positions.y[node]);
+        if (distance > 0) {
+            double factor = options.gravity * state.masses[node] / distance;
+            forces.x[node] -= factor * positions.x[node];
+            forces.y[node] -= factor * positions.y[node];
+        }
+    }
+
+    CalculateGatheredModelAttractiveForces<UnitLinearForces>(positions, adjacency, forces,
+                                                             layoutOptions.numberOfThreads);
+    return true;
+}
+
+/*
+ * AdjustSpeed
+ * Sets the global speed from the total swing and
+ * traction of this iteration's forces against the last.
+ * The jitter tolerance is scaled by an estimate of the
+ * best value for the graph, and the speed efficiency
+ * backs off whenever the layout swings too much.
+ */
+static void AdjustSpeed(const ForceAtlas2Options& options, ForceAtlas2State& state) {
+    const NodeArrays& forces = state.forces;
+    const NodeArrays& previous = state.previousForces;
+    size_t numberOfNodes = forces.size();
+    double totalSwing = 0, totalTraction = 0;
+    for (size_t node = 0; node < numberOfNodes; node++) {
+        double swingX = previous.x[node] - forces.x[node];
+        double swingY = previous.y[node] - forces.y[node];
+        double tractionX = previous.x[node] + forces.x[node];
+        double tractionY = previous.y[node] + forces.y[node];
+        totalSwing += state.masses[node] * sqrt(swingX * swingX + swingY * swingY);
+        totalTraction += state.masses[node] * 0.5 *
+                         sqrt(tractionX * tractionX + tractionY * tractionY);
+    }
+    if (totalSwing == 0) return;
+
+    double estimatedTolerance = 0.05 * sqrt((double) numberOfNodes);
+    double minimumTolerance = sqrt(estimatedTolerance);
+    double maximumTolerance = 10;
+    double jitterTolerance = options.jitterTolerance *
+        max(minimumTolerance, min(maximumTolerance, estimatedTolerance * totalTraction /
+                                  ((double) numberOfNodes * numberOfNodes)));
+
+    //Protection against erratic behaviour
+    if (totalSwing / totalTraction > 2.0) {
+        if (state.speedEfficiency > kMinimumSpeedEfficiency) state.speedEfficiency *= 0.5;
+        jitterTolerance = max(jitterTolerance, options.jitterTolerance);
+    }
+    double targetSpeed = jitterTolerance * state.speedEfficiency * totalTraction / totalSwing;
+
+    if (totalSwing > jitterTolerance * totalTraction) {
+        if (state.speedEfficiency > kMinimumSpeedEfficiency) state.speedEfficiency *= 0.7;
+    } else if (state.speed < kMaximumSpeed) {
+        state.speedEfficiency *= 1.3;
+    }
+    state.speed += min(targetSpeed - state.speed, kMaximumSpeedRise * state.speed);
+}
+
+/*
+ * ForceAtlas2TransformNodeArrays
+ * Runs against a deadline that never passes.
+ */
+void ForceAtlas2TransformNodeArrays(NodeArrays& positions, const Adjacency& adjacency,
+                                    const LayoutOptions& layoutOptions,
+                                    const ForceAtlas2Options& options, ForceAtlas2State& state) {
+    ForceAtlas2TransformNodeArrays(positions, adjacency, layoutOptions, options, state,
+                                   StartDeadline(HUGE_VAL));
+}
+
+/*
+ * ForceAtlas2TransformNodeArrays
+ * Each node moves along its force by the global speed,
+ * damped by its own swing: speed / (1 + sqrt(speed *
+ * swing)).  The forces are then kept for the next
+ * iteration's swing.  A pass the deadline stopped leaves
+ * nothing behind but cleared forces.
+ */
+bool ForceAtlas2TransformNodeArrays(NodeArrays& positions, const Adjacency& adjacency,
+                                    const LayoutOptions& layoutOptions,
+                                    const ForceAtlas2Options& options, ForceAtlas2State& state,
+                                    const LayoutDeadline& deadline) {
+    double edgeLength = MeanEdgeLength(positions, adjacency);
+    if (!CalculateForceAtlas2Forces(positions, adjacency, edgeLength, layoutOptions, options,
+                                    state, deadline)) {
+        ClearNodeArrays(state.forces);
+        return false;
+    }
+    AdjustSpeed(options, state);
+
+    NodeArrays& forces = state.forces;
+    NodeArrays& previous = state.previousForces;
+    double maximumDisplacement = 0;
+    for (size_t node = 0; node < positions.size(); node++) {
+        double swingX = previous.x[node] - forces.x[node];
+        double swingY = previous.y[node] - forces.y[node];
+        double swing = state.masses[node] * sqrt(swingX * swingX + swingY * swingY);
+        double factor = state.speed / (1 + sqrt(state.speed * swing));
+        double moveX = factor * forces.x[node];
+        double moveY = factor * forces.y[node];
+        positions.x[node] += moveX;
+        positions.y[node] += moveY;
+        maximumDisplacement = max(maximumDisplacement, sqrt(moveX * moveX + moveY * moveY));
+    }
+    state.previousForces.swap(state.forces);
+    ClearNodeArrays(state.forces);
+
+    state.iterations++;
+    state.maximumDisplacement = maximumDisplacement / edgeLength;
+    state.converged = state.maximumDisplacement < options.tolerance;
+    return true;
+}
+
+/*
+ * RunForceAtlas2
+ * Builds the adjacency and iterates until the layout
+ * converges or the iteration limit is reached.
+ */
+ForceAtlas2State RunForceAtlas2(SimpleGraph& graph, const LayoutOptions& layoutOptions,
+                                const ForceAtlas2Options& options) {
+    Adjacency adjacency;
+    BuildAdjacency(graph.nodes.size(), graph.edges, adjacency);
+    NodeArrays positions;
+    LoadNodeArrays(graph.nodes, positions);
+    ForceAtlas2State state = InitializeForceAtlas2(adjacency, options);
+    while (!state.converged && state.iterations < options.maximumIterations) {
+        ForceAtlas2TransformNodeArrays(positions, adjacency, layoutOptions, options, state);
+    }
+    StoreNodeArrays(positions, graph.nodes);
+    return state;
+}
@@ -0,0 +1,150 @@
+/*************************************************************************
+ * File: ForceAtlas2.h
+ *
+ * A header file defining the ForceAtlas2 layout engine of Jacomy,
+ * Venturini, Heymann and Bastian, "ForceAtlas2, a Continuous Graph
+ * Layout Algorithm for Handy Network Visualization" (2014).
+ *
+ * Its forces are those of ForceAtlas2Forces in ForceModels.h, a linear
+ * pull along each edge against a 1 / d repulsion, with two additions.
+ * The repulsion between two nodes is multiplied by their masses, one
+ * more than their degrees, which pushes hubs apart and gives leaves room
+ * around them; and every node is pulled towards the origin by a gravity
+ * proportional to its mass, which keeps disconnected components from
+ * drifting away.
+ *
+ * Its step is what sets it apart.  Instead of one global step length,
+ * each node's step follows its own "swing", how much its force changed
+ * direction since the last iteration.  A node that swings is
+ * oscillating and is slowed down, while one whose force keeps pointing
+ * the same way moves at the global speed.  The global speed itself is
+ * raised or lowered so that the total swing stays within a set fraction
+ * of the total "traction", the part of the forces that stays the same.
+ * On scale-free graphs, where a few hubs oscillate while the leaves
+ * still have far to go, this converges much faster than a single step.
+ *
+ * The repulsion is computed by the engine selected in a LayoutOptions:
+ * the exact engine, Barnes-Hut, or the grid cutoff.  Those engines have
+ * mass-weighted versions; the multipole engine does not, so asking for
+ * it uses Barnes-Hut.
+ */
+
+#ifndef ForceAtlas2_Included // Include guard
+#define ForceAtlas2_Included
+
+#include "SimpleGraph.h" // For the SimpleGraph type.
+#include "ForceLayout.h" // For the LayoutOptions type.
+
+/* Default parameters, as in the paper's reference implementation. */
+const double kDefaultScalingRatio = 2.0;
+const double kDefaultGravity = 1.0;
+const double kDefaultJitterTolerance = 1.0;
+const double kDefaultForceAtlas2Tolerance = 1e-3;
+const size_t kDefaultForceAtlas2Iterations = 100000;
+
+/**
+ * Type: ForceAtlas2Options
+ * -----------------------------------------------------------------------
+ * Parameters of the layout.  scalingRatio multiplies the repulsion, and
+ * gravity the pull towards the origin.  jitterTolerance is the fraction
+ * of the traction the total swing may reach before the global speed is
+ * lowered; larger values run faster and less precisely.
+ * degreeWeightedRepulsion selects the mass-weighted repulsion; without
+ * it every node has mass one.  The layout has converged once no node
+ * moves farther than tolerance, relative to the mean edge length, in
+ * one iteration; RunForceAtlas2() also stops after maximumIterations.
+ */
+struct ForceAtlas2Options {
+    double scalingRatio;
+    double gravity;
+    double jitterTolerance;
+    bool degreeWeightedRepulsion;
+    double tolerance;
+    size_t maximumIterations;
+};
+
+/**
+ * Type: ForceAtlas2State
+ * -----------------------------------------------------------------------
+ * The progress of one layout.  masses holds every node's mass,
+ * previousForces the forces of the last iteration, from which the
+ * swing is measured, and forces is scratch space for the next.  speed
+ * is the global speed and speedEfficiency the factor it aims for.
+ * maximumDisplacement is the farthest any node moved in the last
+ * iteration, relative to the mean edge length.
+ */
+struct ForceAtlas2State {
+    vector<double> masses;
+    NodeArrays previousForces;
+    NodeArrays forces;
+    double speed;
+    double speedEfficiency;
+    size_t iterations;
+    double maximumDisplacement;
+    bool converged;
+};
+
+/**
+ * Function: DefaultForceAtlas2Options()
+ * -----------------------------------------------------------------------
+ * Returns the default parameters, with degree-weighted repulsion.
+ */
+ForceAtlas2Options DefaultForceAtlas2Options();
+
+/**
+ * Function: InitializeForceAtlas2(const Adjacency& adjacency,
+ *                                 const ForceAtlas2Options& options)
+ * -----------------------------------------------------------------------
+ * Returns the state of a layout of the graph with the given adjacency
+ * that has not run any iterations.
+ */
+ForceAtlas2State InitializeForceAtlas2(const Adjacency& adjacency,
+                                       const ForceAtlas2Options& options);
+
+/**
+ * Function: ForceAtlas2TransformNodeArrays(NodeArrays& positions,
+ *                                          const Adjacency& adjacency,
+ *                                          const LayoutOptions& layoutOptions,
+ *                                          const ForceAtlas2Options& options,
+ *                                          ForceAtlas2State& state)
+ * -----------------------------------------------------------------------
+ * Runs one iteration: computes the forces, adapts the global speed, and
+ * moves every node at its own speed.  The repulsion uses the engine
+ * selected in layoutOptions, and the attraction is gathered over the
+ * adjacency on its numberOfThreads threads.
+ */
+void ForceAtlas2TransformNodeArrays(NodeArrays& positions, const Adjacency& adjacency,
+                                    const LayoutOptions& layoutOptions,
+                                    const ForceAtlas2Options& options, ForceAtlas2State& state);
+
+/**
+ * Function: ForceAtlas2TransformNodeArrays(NodeArrays& positions,
+ *                                          const Adjacency& adjacency,
+ *                                          const LayoutOptions& layoutOptions,
+ *                                          const ForceAtlas2Options& options,
+ *                                          ForceAtlas2State& state,
+ *                                          const LayoutDeadline& deadline)
+ * -----------------------------------------------------------------------
+ * The same, except that the repulsion stops part of the way through if
+ * the deadline passes first.  Returns false if it did, in which case the
+ * iteration is dropped and positions and state are left as they were.
+ * Every engine checks the deadline: the exact engine after blocks of
+ * rows, and Barnes-Hut and the grid after blocks of nodes.
+ */
+bool ForceAtlas2TransformNodeArrays(NodeArrays& positions, const Adjacency& adjacency,
+                                    const LayoutOptions& layoutOptions,
+                                    const ForceAtlas2Options& options, ForceAtlas2State& state,
+                                    const LayoutDeadline& deadline);
+
+/**
+ * Function: RunForceAtlas2(SimpleGraph& graph,
+ *                          const LayoutOptions& layoutOptions,
+ *                          const ForceAtlas2Options& options)
+ * -----------------------------------------------------------------------
+ * Runs iterations until the layout converges or options.maximumIterations
+ * have run, and returns the final state.
+ */
+ForceAtlas2State RunForceAtlas2(SimpleGraph& graph, const LayoutOptions& layoutOptions,
+                                const ForceAtlas2Options& options);
+
+#endif
@@ -0,0 +1,589 @@
+/******************************************************
+ * File: ForceLayout.cpp
+ *
+ * Implementation of the ForceLayout.h interface.  The
+ * force calculations follow the Fruchterman-Reingold
+ * algorithm: every pair of nodes repels and every edge
+ * pulls its endpoints together.
+ */
+
+#include <cmath>
+#include <algorithm>
+#include "ForceLayout.h"
+#include "ForceModels.h"
+#include "QuadTree.h"
+#include "FastMultipole.h"
+#include "GridRepulsion.h"
+#include "SimdRepulsion.h"
+#include "ParallelRepulsion.h"
+#include "DeterministicRepulsion.h"
+#include "Parallel.h"
+using namespace std;
+
+/*
+ * DefaultLayoutOptions
+ * Returns options selecting the exact repulsion engine
+ * with the default tree engine parameters.
+ */
+LayoutOptions DefaultLayoutOptions() {
+    LayoutOptions options;
+    options.repulsionMode = kExactRepulsion;
+    options.theta = kDefaultBarnesHutTheta;
+    options.multipoleOrder = kDefaultFastMultipoleOrder;
+    options.cutoff = kDefaultRepulsionCutoff;
+    options.trigonometricForces = false;
+    options.numberOfThreads = 1;
+    options.precision = kDoublePrecision;
+    options.forceModel = kFruchtermanReingoldModel;
+    options.deterministic = false;
+    return options;
+}
+
+/*
+ * TransformGraph
+ * Takes in a graph by reference, calculates the repulsive and
+ * attractive forces acting on the nodes in the graph, and
+ * then updates node positions accordingly.  The positions are
+ * copied into separate x and y arrays for the force passes
+ * and copied back afterwards.
+ */
+void TransformGraph(SimpleGraph& graph, const LayoutOptions& options) {
+    NodeArrays positions;
+    LoadNodeArrays(graph.nodes, positions);
+    NodeArrays nodeChanges = InitializeNodeChanges(positions);
+    TransformNodeArrays(positions, graph.edges, nodeChanges, options);
+    StoreNodeArrays(positions, graph.nodes);
+}
+
+/*
+ * TransformNodeArrays
+ * Runs one iteration on nodes that are already stored as
+ * separate x and y arrays.
+ */
+void TransformNodeArrays(NodeArrays& positions, const vector<Edge>& edges,
+                         NodeArrays& nodeChanges, const LayoutOptions& options) {
+    CalculateNodeForces(positions, edges, nodeChanges, options);
+    UpdateNodeMovements(positions, nodeChanges);
+}
+
+/*
+ * TransformNodeArrays
+ * The same, gathering the attraction over the adjacency.
+ */
+void TransformNodeArrays(NodeArrays& positions, const Adjacency& adjacency,
+                         NodeArrays& nodeChanges, const LayoutOptions& options) {
+    CalculateNodeForces(positions, adjacency, nodeChanges, options);
+    UpdateNodeMovements(positions, nodeChanges);
+}
+
+/*
+ * CalculateRepulsion
+ * Adds the repulsive forces computed by the engine named
+ * in the options; the exact engine uses the widest SIMD
+ * kernel available, in reduced precision if asked,
+ * otherwise with a fixed order of addition if asked, or
+ * split into tiles over threads unless asked for one
+ * thread.
+ */
+static void CalculateRepulsion(const NodeArrays& positions, NodeArrays& nodeChanges,
+                               const LayoutOptions& options) {
+    if (options.repulsionMode == kBarnesHutRepulsion) {
+        CalculateBarnesHutRepulsiveForces(positions, nodeChanges, options.theta);
+    } else if (options.repulsionMode == kFastMultipoleRepulsion) {
+        CalculateFastMultipoleRepulsiveForces(positions, nodeChanges, options.multipoleOrder,
+                                              options.theta);
+    } else if (options.repulsionMode == kGridRepulsion) {
+        CalculateGridRepulsiveForces(positions, nodeChanges, options.cutoff);
+    } else if (options.trigonometricForces) {
+        CalculateTrigonometricRepulsiveForces(positions, nodeChanges);
+    } else if (options.precision != kDoublePrecision) {
+        CalculatePrecisionRepulsiveForces(positions, nodeChanges, options.precision);
+    } else if (options.deterministic) {
+        CalculateDeterministicRepulsiveForces(positions, nodeChanges, options.numberOfThreads);
+    } else if (options.numberOfThreads != 1) {
+        CalculateParallelRepulsiveForces(positions, nodeChanges, options.numberOfThreads);
+    } else {
+        CalculateVectorizedRepulsiveForces(positions, nodeChanges);
+    }
+}
+
+/*
+ * ModelRepulsionThreads
+ * Returns the number of threads the model's own exact
+ * kernel runs on: one for a deterministic layout, since
+ * only then is the order of every sum fixed.
+ */
+static size_t ModelRepulsionThreads(const LayoutOptions& options) {
+    return options.deterministic ? 1 : options.numberOfThreads;
+}
+
+/*
+ * CalculateModelRepulsion
+ * Adds the model's repulsion: through the engine named in
+ * the options if the model repels as 1 / d, and with its
+ * own exact tiled kernel otherwise.
+ */
+template <typename Forces>
+static void CalculateModelRepulsion(const NodeArrays& positions, NodeArrays& nodeChanges,
+                                    const LayoutOptions& options) {
+    if (Forces::kInverseDistanceRepulsion) {
+        CalculateRepulsion(positions, nodeChanges, options);
+    } else {
+        CalculateParallelModelRepulsiveForces<Forces>(positions, nodeChanges,
+                                                      ModelRepulsionThreads(options));
+    }
+}
+
+/*
+ * CalculateScatteredForces
+ * Adds the model's repulsion, then scatters its
+ * attraction along the edges.
+ */
+template <typename Forces>
+static void CalculateScatteredForces(const NodeArrays& positions, const vector<Edge>& edges,
+                                     NodeArrays& nodeChanges, const LayoutOptions& options) {
+    CalculateModelRepulsion<Forces>(positions, nodeChanges, options);
+    CalculateModelAttractiveForces<Forces>(positions, edges, nodeChanges);
+}
+
+/*
+ * CalculateGatheredForces
+ * Adds the model's repulsion, then gathers its attraction
+ * on the threads the options ask for.
+ */
+template <typename Forces>
+static void CalculateGatheredForces(const NodeArrays& positions, const Adjacency& adjacency,
+                                    NodeArrays& nodeChanges, const LayoutOptions& options) {
+    CalculateModelRepulsion<Forces>(positions, nodeChanges, options);
+    CalculateGatheredModelAttractiveForces<Forces>(positions, adjacency, nodeChanges,
+                                                   options.numberOfThreads);
+}
+
+/*
+ * CalculateNodeForces
+ * Chooses the model once per pass.  The trigonometric
+ * passes only implement the original forces.
+ */
+void CalculateNodeForces(const NodeArrays& positions, const vector<Edge>& edges,
+                         NodeArrays& nodeChanges, const LayoutOptions& options) {
+    if (options.forceModel == kLinLogModel) {
+        CalculateScatteredForces<LinLogForces>(positions, edges, nodeChanges, options);
+    } else if (options.forceModel == kForceAtlas2Model) {
+        CalculateScatteredForces<ForceAtlas2Forces>(positions, edges, nodeChanges, options);
+    } else if (options.trigonometricForces) {
+        CalculateRepulsion(positions, nodeChanges, options);
+        CalculateTrigonometricAttractiveForces(positions, edges, nodeChanges);
+    } else {
+        CalculateScatteredForces<FruchtermanReingoldForces>(positions, edges, nodeChanges,
+                                                            options);
+    }
+}
+
+/*
+ * GatherTrigonometricAttraction
+ * Adds, for each node, the pull of each neighbour split
+ * into components through its angle, as the reference
+ * pass does from both ends of every edge.
+ */
+static void GatherTrigonometricAttraction(const NodeArrays& positions,
+                                          const Adjacency& adjacency, NodeArrays& nodeChanges) {
+    for (size_t node = 0; node < adjacency.size(); node++) {
+        double x0 = positions.x[node];
+        double y0 = positions.y[node];
+        for (size_t k = adjacency.offsets[node]; k < adjacency.offsets[node + 1]; k++) {
+            double x1 = positions.x[adjacency.targets[k]];
+            double y1 = positions.y[adjacency.targets[k]];
+            double fAttract = CalculateFAttract(x0, x1, y0, y1);
+            double radiansAngle = CalculateRadiansAngle(x0, x1, y0, y1);
+            nodeChanges.x[node] += CalculateXForce(fAttract, radiansAngle);
+            nodeChanges.y[node] += CalculateYForce(fAttract, radiansAngle);
+        }
+    }
+}
+
+/*
+ * CalculateNodeForces
+ * The same, gathering the attraction over the adjacency.
+ */
+void CalculateNodeForces(const NodeArrays& positions, const Adjacency& adjacency,
+                         NodeArrays& nodeChanges, const LayoutOptions& options) {
+    if (options.forceModel == kLinLogModel) {
+        CalculateGatheredForces<LinLogForces>(positions, adjacency, nodeChanges, options);
+    } else if (options.forceModel == kForceAtlas2Model) {
+        CalculateGatheredForces<ForceAtlas2Forces>(positions, adjacency, nodeChanges, options);
+    } else if (options.trigonometricForces) {
+        CalculateRepulsion(positions, nodeChanges, options);
+        GatherTrigonometricAttraction(positions, adjacency, nodeChanges);
+    } else {
+        CalculateGatheredForces<FruchtermanReingoldForces>(positions, adjacency, nodeChanges,
+                                                           options);
+    }
+}
+
+/*
+ * CalculateInterruptibleForces
+ * Adds the repulsion through the model's own tiled kernel
+ * if it does not repel as 1 / d, and otherwise through
+ * the engine CalculateRepulsion() would pick, each
+ * checking the deadline as it goes; then, if it finished,
+ * gathers the model's attraction.
+ */
+template <typename Forces>
+static bool CalculateInterruptibleForces(const NodeArrays& positions, const Adjacency& adjacency,
+                                         NodeArrays& nodeChanges, const LayoutOptions& options,
+                                         const LayoutDeadline& deadline) {
+    bool finished;
+    if (!Forces::kInverseDistanceRepulsion) {
+        finished = CalculateParallelModelRepulsiveForces<Forces>(positions, nodeChanges,
+                                                                 ModelRepulsionThreads(options),
+                                                                 deadline);
+    } else if (options.repulsionMode == kBarnesHutRepulsion) {
+        finished = CalculateBarnesHutRepulsiveForces(positions, nodeChanges, options.theta,
+                                                     deadline);
+    } else if (options.repulsionMode == kFastMultipoleRepulsion) {
+        finished = CalculateFastMultipoleRepulsiveForces(positions, nodeChanges,
+                                                         options.multipoleOrder, options.theta,
+                                                         deadline);
+    } else if (options.repulsionMode == kGridRepulsion) {
+        finished = CalculateGridRepulsiveForces(positions, nodeChanges, options.cutoff,
+                                                deadline);
+    } else if (options.precision != kDoublePrecision) {
+        finished = CalculatePrecisionRepulsiveForces(positions, nodeChanges, options.precision,
+                                                     deadline);
+    } else if (options.deterministic) {
+        finished = CalculateDeterministicRepulsiveForces(positions, nodeChanges,
+                                                         options.numberOfThreads, deadline);
+    } else {
+        finished = CalculateParallelRepulsiveForces(positions, nodeChanges,
+                                                    options.numberOfThreads, deadline);
+    }
+    if (!finished) return false;
+    CalculateGatheredModelAttractiveForces<Forces>(positions, adjacency, nodeChanges,
+                                                   options.numberOfThreads);
+    return true;
+}
+
+/*
+ * CalculateNodeForces
+ * The same, against a deadline.  On one thread the tiled
+ * engine runs its tiles in turn, so it can stop between
+ * them where the whole-triangle kernel could not.
+ */
+bool CalculateNodeForces(const NodeArrays& positions, const Adjacency& adjacency,
+                         NodeArrays& nodeChanges, const LayoutOptions& options,
+                         const LayoutDeadline& deadline) {
+    if (!InterruptibleForces(options)) {
+        CalculateNodeForces(positions, adjacency, nodeChanges, options);
+        return true;
+    }
+    if (options.forceModel == kLinLogModel) {
+        return CalculateInterruptibleForces<LinLogForces>(positions, adjacency, nodeChanges,
+                                                          options, deadline);
+    } else if (options.forceModel == kForceAtlas2Model) {
+        return CalculateInterruptibleForces<ForceAtlas2Forces>(positions, adjacency, nodeChanges,
+                                                               options, deadline);
+    }
+    return CalculateInterruptibleForces<FruchtermanReingoldForces>(positions, adjacency,
+                                                                   nodeChanges, options,
+                                                                   deadline);
+}
+
+/*
+ * InterruptibleModelForces
+ * A model that does not repel as 1 / d always uses its
+ * own tiled kernel; the others use the engine named in
+ * the options, every one of which can stop early except
+ * the trigonometric reference pass.
+ */
+template <typename Forces>
+static bool InterruptibleModelForces(const LayoutOptions& options) {
+    if (!Forces::kInverseDistanceRepulsion) return true;
+    return options.repulsionMode != kExactRepulsion || !options.trigonometricForces;
+}
+
+/*
+ * InterruptibleForces
+ * Chooses the model as CalculateNodeForces() does.
+ */
+bool InterruptibleForces(const LayoutOptions& options) {
+    if (options.forceModel == kLinLogModel) {
+        return InterruptibleModelForces<LinLogForces>(options);
+    } else if (options.forceModel == kForceAtlas2Model) {
+        return InterruptibleModelForces<ForceAtlas2Forces>(options);
+    }
+    return InterruptibleModelForces<FruchtermanReingoldForces>(options);
+}
+
+/*
+ * ApproximateForces
+ * Reduced precision rounds the exact forces differently
+ * as the nodes move, much as the approximate engines do.
+ */
+bool ApproximateForces(const LayoutOptions& options) {
+    return options.repulsionMode != kExactRepulsion || options.precision != kDoublePrecision;
+}
+
+/*
+ * InitializeNodeChanges
+ * Takes in the node positions and returns a set of node
+ * changes of the same size, all of which are 0.
+ */
+NodeArrays InitializeNodeChanges(const NodeArrays& positions) {
+    NodeArrays nodeChanges;
+    ResizeNodeArrays(nodeChanges, positions.size());
+    return nodeChanges;
+}
+
+/*
+ * CalculateRepulsiveForces
+ * Takes in the node positions and the node changes by
+ * reference. Calculates the repulsive forces on the nodes
+ * and adds them to the node changes.  Each force is
+ * split into x and y components with the unit vector between
+ * the two nodes, so no trigonometry is needed.
+ */
+void CalculateRepulsiveForces(const NodeArrays& positions, NodeArrays& nodeChanges) {
+    const double* x = positions.x.data();
+    const double* y = positions.y.data();
+    double* changeX = nodeChanges.x.data();
+    double* changeY = nodeChanges.y.data();
+    size_t numberOfNodes = positions.size();
+
+    for (size_t nodeIndex0 = 0; nodeIndex0 + 1 < numberOfNodes; nodeIndex0++) {
+        double x0 = x[nodeIndex0];
+        double y0 = y[nodeIndex0];
+        for (size_t nodeIndex1 = nodeIndex0 + 1; nodeIndex1 < numberOfNodes; nodeIndex1++) {
+
+            //Get the vector between the two nodes
+            double dx = x[nodeIndex1] - x0;
+            double dy = y[nodeIndex1] - y0;
+            double distance = sqrt(dx * dx + dy * dy);
+
+            //Scale the unit vector by the repulsive force
+            double fRepel = CalculateFRepel(distance);
+            double forceX = fRepel * dx / distance;
+            double forceY = fRepel * dy / distance;
+
+            changeX[nodeIndex0] -= forceX;
+            changeY[nodeIndex0] -= forceY;
+            changeX[nodeIndex1] += forceX;
+            changeY[nodeIndex1] += forceY;
+        }
+    }
+}
+
+/*
+ * CalculateRepulsiveForces
+ * Runs against a deadline that never passes.
+ */
+void CalculateRepulsiveForces(const NodeArrays& positions, const vector<double>& masses,
+                              NodeArrays& nodeChanges) {
+    CalculateRepulsiveForces(positions, masses, nodeChanges, StartDeadline(HUGE_VAL));
+}
+
+/*
+ * CalculateRepulsiveForces
+ * Visits every pair once, as the unweighted version
+ * does, scaling each force by both nodes' masses, and
+ * checks the deadline after each row that brings the
+ * pairs since the last check to kDeadlineCheckPairs.
+ */
+bool CalculateRepulsiveForces(const NodeArrays& positions, const vector<double>& masses,
+                              NodeArrays& nodeChanges, const LayoutDeadline& deadline) {
+    const double* x = positions.x.data();
+    const double* y = positions.y.data();
+    double* changeX = nodeChanges.x.data();
+    double* changeY = nodeChanges.y.data();
+    size_t numberOfNodes = positions.size();
+    size_t pairsSinceCheck = 0;
+
+    for (size_t nodeIndex0 = 0; nodeIndex0 + 1 < numberOfNodes; nodeIndex0++) {
+        double x0 = x[nodeIndex0];
+        double y0 = y[nodeIndex0];
+        double mass0 = masses[nodeIndex0];
+        for (size_t nodeIndex1 = nodeIndex0 + 1; nodeIndex1 < numberOfNodes; nodeIndex1++) {
+            double dx = x[nodeIndex1] - x0;
+            double dy = y[nodeIndex1] - y0;
+            double distance = sqrt(dx * dx + dy * dy);
+
+            double fRepel = mass0 * masses[nodeIndex1] * CalculateFRepel(distance);
+            double forceX = fRepel * dx / distance;
+            double forceY = fRepel * dy / distance;
+
+            changeX[nodeIndex0] -= forceX;
+            changeY[nodeIndex0] -= forceY;
+            changeX[nodeIndex1] += forceX;
+            changeY[nodeIndex1] += forceY;
+        }
+        pairsSinceCheck += numberOfNodes - nodeIndex0 - 1;
+        if (pairsSinceCheck >= kDeadlineCheckPairs) {
+            if (DeadlinePassed(deadline)) return false;
+            pairsSinceCheck = 0;
+        }
+    }
+    return true;
+}
+
+/*
+ * CalculateTrigonometricRepulsiveForces
+ * The original version of CalculateRepulsiveForces, which
+ * splits each force into components with atan2, cos and sin.
+ * Kept as the reference that the faster path is checked against.
+ */
+void CalculateTrigonometricRepulsiveForces(const NodeArrays& positions,
+                                           NodeArrays& nodeChanges) {
+    for (size_t nodeIndex0 = 0; nodeIndex0 + 1 < positions.size(); nodeIndex0++) {
+        for (size_t nodeIndex1 = nodeIndex0 + 1; nodeIndex1 < positions.size(); nodeIndex1++) {
+            
+            //Get node positions
+            double x0 = positions.x[nodeIndex0];
+            double x1 = positions.x[nodeIndex1];
+            double y0 = positions.y[nodeIndex0];
+            double y1 = positions.y[nodeIndex1];
+            
+            //Calculate repulsive force and angle between the two nodes
+            double fRepel = CalculateFRepel(x0, x1, y0, y1);
+            double radiansAngle = CalculateRadiansAngle(x0, x1, y0, y1);
+            
+            //Update the x and y changes based on the forces.
+            nodeChanges.x[nodeIndex0] -= CalculateXForce(fRepel, radiansAngle);
+            nodeChanges.y[nodeIndex0] -= CalculateYForce(fRepel, radiansAngle);
+            nodeChanges.x[nodeIndex1] += CalculateXForce(fRepel, radiansAngle);
+            nodeChanges.y[nodeIndex1] += CalculateYForce(fRepel, radiansAngle);
+        }
+    }
+}
+
+
+/*
+ * CalculateAttractiveForces
+ * Takes in the node positions, the edges and the node changes
+ * by reference. Calculates the attractive forces and updates
+ * the node changes appropriately, using the unit vector
+ * along each edge rather than its angle.
+ */
+void CalculateAttractiveForces(const NodeArrays& positions, const vector<Edge>& edges,
+                               NodeArrays& nodeChanges) {
+    CalculateModelAttractiveForces<FruchtermanReingoldForces>(positions, edges, nodeChanges);
+}
+
+/*
+ * CalculateGatheredAttractiveForces
+ * Each thread owns a contiguous range of nodes and sums,
+ * for each of them, the pull of its neighbours.  Every
+ * edge is evaluated once from each end, twice the work
+ * of the scatter pass, but no two threads ever write the
+ * same node.
+ */
+void CalculateGatheredAttractiveForces(const NodeArrays& positions, const Adjacency& adjacency,
+                                       NodeArrays& nodeChanges, size_t numberOfThreads) {
+    CalculateGatheredModelAttractiveForces<FruchtermanReingoldForces>(positions, adjacency,
+                                                                      nodeChanges,
+                                                                      numberOfThreads);
+}
+
+/*
+ * CalculateTrigonometricAttractiveForces
+ * The original version of CalculateAttractiveForces, kept as
+ * the reference that the faster path is checked against.
+ */
+void CalculateTrigonometricAttractiveForces(const NodeArrays& positions,
+                                            const vector<Edge>& edges,
+                                            NodeArrays& nodeChanges) {
+    for (size_t edgeIndex = 0; edgeIndex < edges.size(); edgeIndex++) {
+        
+        //Get node positions
+        double x0 = positions.x[edges[edgeIndex].start];
+        double x1 = positions.x[edges[edgeIndex].end];
+        double y0 = positions.y[edges[edgeIndex].start];
+        double y1 = positions.y[edges[edgeIndex].end];
+        
+        //Calculate attractive force and radian angle
+        double fAttract = CalculateFAttract(x0, x1, y0, y1);
+        double radiansAngle = CalculateRadiansAngle(x0, x1, y0, y1);
+        
+        //Update x and y changes based on graph
+        nodeChanges.x[edges[edgeIndex].start] += CalculateXForce(fAttract, radiansAngle);
+        nodeChanges.y[edges[edgeIndex].start] += CalculateYForce(fAttract, radiansAngle);
+        nodeChanges.x[edges[edgeIndex].end]   -= CalculateXForce(fAttract, radiansAngle);
+        nodeChanges.y[edges[edgeIndex].end]   -= CalculateYForce(fAttract, radiansAngle);
+    }
+}
+
+/*
+ * CalculateFRepel
+ * Calculates and returns the repeling force from the
+ * input of four double coordinates of two node locations
+ */
+double CalculateFRepel(double x0, double x1, double y0, double y1) {
+    return CalculateFRepel(sqrt( (x1 - x0) * (x1 - x0) + (y1 - y0) * (y1 - y0)));
+}
+
+/*
+ * CalculateFRepel
+ * Calculates and returns the repeling force between two
+ * nodes that are the given distance apart
+ */
+double CalculateFRepel(double distance) {
+    return kRepel / distance;
+}
+
+/*
+ * CalculateFAttract
+ * Calculates and returns the attracting force from the
+ * input of four double coordinates of two node locations
+ */
+double CalculateFAttract(double x0, double x1, double y0, double y1) {
+    return kAttract * ((x1 - x0) * (x1 - x0) + (y1 - y0) * (y1 - y0));
+}
+
+/*
+ * CalculateFAttract
+ * Calculates and returns the attracting force between two
+ * nodes that are the given distance apart
+ */
+double CalculateFAttract(double distance) {
+    return kAttract * distance * distance;
+}
+
+/*
+ * CalculateRadiansAngle
+ * Calculates and returns the radians angle between nodes with
+ * two different positions
+ */
+double CalculateRadiansAngle(double x0, double x1, double y0, double y1) {
+    return atan2 (y1-y0, x1-x0);
+}
+                                         
+/*
+ * CalculateXForce
+ * Takes in a force and an angle in radians and computes the appropriate
+ * x component of that force.
+ */
+double CalculateXForce(double fRepel, double radiansAngle){
+    return fRepel * cos(radiansAngle);
+}
+
+/*
+ * CalculateYForce
+ * Takes in a force and an angle in radians and computes the appropriate
+ * Y component of that force.
+ */
+double CalculateYForce(double fRepel, double radiansAngle){
+    return fRepel * sin(radiansAngle);
+}
+
+/*
+ * UpdateNodeMovements
+ * Takes in the node positions and changes by reference,
+ * moves each node by its change and resets the changes.
+ */
+void UpdateNodeMovements(NodeArrays& positions, NodeArrays& nodeChanges) {
+    for(size_t nodeIndex = 0; nodeIndex < positions.size(); nodeIndex++) {
+        //Update the node positions
+        positions.x[nodeIndex] += nodeChanges.x[nodeIndex];
+        positions.y[nodeIndex] += nodeChanges.y[nodeIndex];
+    }
+    //Reset the node changes
+    ClearNodeArrays(nodeChanges);
+}
@@ -0,0 +1,313 @@
+/*************************************************************************
+ * File: ForceLayout.h
+ *
+ * A header file defining the Fruchterman-Reingold force-directed layout
+ * engine used by GraphViz.  Each call to TransformGraph() computes the
+ * repulsive forces between every pair of nodes and the attractive forces
+ * along every edge, then moves each node by the net force acting on it.
+ *
+ * The repulsive phase dominates the running time, so it can be computed
+ * by one of several interchangeable engines selected at runtime through
+ * the LayoutOptions structure.
+ *
+ * Inside the engine, node positions and node changes are kept in
+ * NodeArrays, with the x and y coordinates in separate arrays.
+ * TransformGraph() converts a SimpleGraph to and from that form; callers
+ * running many iterations without drawing can call TransformNodeArrays()
+ * directly and skip the conversion.
+ */
+
+#ifndef ForceLayout_Included // Include guard
+#define ForceLayout_Included
+
+#include "SimpleGraph.h" // For the SimpleGraph type.
+#include "NodeArrays.h"  // For the NodeArrays type.
+#include "Adjacency.h"   // For the Adjacency type.
+#include "PrecisionRepulsion.h" // For the PrecisionMode type.
+#include "LayoutBudget.h"  // For the LayoutDeadline type.
+
+/* Constants controlling the strength of the two forces. */
+const double kRepel = 10e-3;
+const double kAttract = 10e-3;
+
+/* Default opening angle used by the Barnes-Hut and multipole engines. */
+const double kDefaultBarnesHutTheta = 0.5;
+
+/* The tree engines accept opening angles in [0, kMaximumBarnesHutTheta). */
+const double kMaximumBarnesHutTheta = 1.0;
+
+/**
+ * Type: RepulsionMode
+ * -----------------------------------------------------------------------
+ * The engine used to compute the repulsive forces.  kExactRepulsion
+ * visits every pair of nodes, using SIMD instructions where available
+ * and several threads if asked to.  kBarnesHutRepulsion approximates
+ * groups of distant nodes by their centre of mass using a quadtree.
+ * kFastMultipoleRepulsion uses multipole expansions over a quadtree and
+ * runs in linear time with a controllable error.  kGridRepulsion ignores
+ * pairs of nodes farther apart than a cutoff distance.
+ */
+enum RepulsionMode {
+    kExactRepulsion,
+    kBarnesHutRepulsion,
+    kFastMultipoleRepulsion,
+    kGridRepulsion
+};
+
+/**
+ * Type: ForceModel
+ * -----------------------------------------------------------------------
+ * The force laws the layout uses, each implemented by the policy type of
+ * the same name in ForceModels.h.  kFruchtermanReingoldModel is the
+ * original model.
+ */
+enum ForceModel {
+    kFruchtermanReingoldModel,
+    kLinLogModel,
+    kForceAtlas2Model
+};
+
+/**
+ * Type: LayoutOptions
+ * -----------------------------------------------------------------------
+ * Parameters controlling a single layout step.  theta is the opening
+ * angle of the Barnes-Hut and multipole engines, and multipoleOrder the
+ * degree of the multipole expansions.  cutoff is the distance beyond
+ * which the grid engine ignores repulsion.  Each parameter is ignored by
+ * the engines that do not use it.  trigonometricForces selects the
+ * original exact passes, which split forces into components with atan2,
+ * cos and sin, in place of the faster unit-vector passes.
+ * numberOfThreads is the number of threads the exact engine and the
+ * gathered attraction pass run on, with zero meaning one per core; fewer
+ * run when the work is too small to share (see LimitThreadCount() in
+ * Parallel.h), as in every threaded pass.  precision selects the exact
+ * engine's reduced-precision kernels of PrecisionRepulsion.h, which run
+ * on one thread.  forceModel selects the force laws; the trigonometric
+ * passes only exist for the original one.  deterministic makes the exact
+ * engine use the kernel of DeterministicRepulsion.h, so that a layout
+ * comes out the same to the last bit on any number of threads.  Every
+ * other pass already does.
+ */
+struct LayoutOptions {
+    RepulsionMode repulsionMode;
+    double theta;
+    size_t multipoleOrder;
+    double cutoff;
+    bool trigonometricForces;
+    size_t numberOfThreads;
+    PrecisionMode precision;
+    ForceModel forceModel;
+    bool deterministic;
+};
+
+/**
+ * Function: DefaultLayoutOptions()
+ * -----------------------------------------------------------------------
+ * Returns options selecting the exact repulsion engine on one thread, in
+ * double precision, with the Fruchterman-Reingold forces, without the
+ * deterministic kernel.
+ */
+LayoutOptions DefaultLayoutOptions();
+
+/**
+ * Function: TransformGraph(SimpleGraph& graph, const LayoutOptions& options)
+ * -----------------------------------------------------------------------
+ * Runs one iteration of the force-directed algorithm on the graph,
+ * calculating the repulsive and attractive forces acting on the nodes
+ * and then updating the node positions accordingly.
+ */
+void TransformGraph(SimpleGraph& graph, const LayoutOptions& options);
+
+/**
+ * Function: TransformNodeArrays(NodeArrays& positions,
+ *                               const vector<Edge>& edges,
+ *                               NodeArrays& nodeChanges,
+ *                               const LayoutOptions& options)
+ * -----------------------------------------------------------------------
+ * Runs one iteration of the force-directed algorithm on the given node
+ * positions.  nodeChanges must be the same size as positions and all
+ * zero; it is left that way.
+ */
+void TransformNodeArrays(NodeArrays& positions, const vector<Edge>& edges,
+                         NodeArrays& nodeChanges, const LayoutOptions& options);
+
+/**
+ * Function: TransformNodeArrays(NodeArrays& positions,
+ *                               const Adjacency& adjacency,
+ *                               NodeArrays& nodeChanges,
+ *                               const LayoutOptions& options)
+ * -----------------------------------------------------------------------
+ * The same, for callers that built the graph's adjacency once with
+ * BuildAdjacency().  The attraction is then gathered per node by
+ * CalculateGatheredAttractiveForces().
+ */
+void TransformNodeArrays(NodeArrays& positions, const Adjacency& adjacency,
+                         NodeArrays& nodeChanges, const LayoutOptions& options);
+
+/**
+ * Function: CalculateNodeForces(const NodeArrays& positions,
+ *                               const vector<Edge>& edges,
+ *                               NodeArrays& nodeChanges,
+ *                               const LayoutOptions& options)
+ * -----------------------------------------------------------------------
+ * Adds the net repulsive and attractive force on every node into
+ * nodeChanges without moving any node.  This is the first half of
+ * TransformNodeArrays(), for drivers that choose their own step.  The
+ * overload taking an adjacency gathers the attraction as its
+ * TransformNodeArrays() does, splitting each pull through its angle
+ * when trigonometricForces is set, just as the edge-list overload does.
+ */
+void CalculateNodeForces(const NodeArrays& positions, const vector<Edge>& edges,
+                         NodeArrays& nodeChanges, const LayoutOptions& options);
+void CalculateNodeForces(const NodeArrays& positions, const Adjacency& adjacency,
+                         NodeArrays& nodeChanges, const LayoutOptions& options);
+
+/**
+ * Function: CalculateNodeForces(const NodeArrays& positions,
+ *                               const Adjacency& adjacency,
+ *                               NodeArrays& nodeChanges,
+ *                               const LayoutOptions& options,
+ *                               const LayoutDeadline& deadline)
+ * -----------------------------------------------------------------------
+ * The same, stopping part of the way through the repulsion if the
+ * deadline passes first.  Returns false if it did, in which case
+ * nodeChanges holds only part of the forces and should be cleared.
+ * Only the engines for which InterruptibleForces() is true can stop
+ * early; the others always finish.
+ */
+bool CalculateNodeForces(const NodeArrays& positions, const Adjacency& adjacency,
+                         NodeArrays& nodeChanges, const LayoutOptions& options,
+                         const LayoutDeadline& deadline);
+
+/**
+ * Function: InterruptibleForces(const LayoutOptions& options)
+ * -----------------------------------------------------------------------
+ * Returns whether CalculateNodeForces() can check a deadline part of
+ * the way through an iteration under the options: always for a force
+ * model whose repulsion is not kRepel / d, which ForceModels.h computes
+ * with its own tiled kernel, and otherwise for every engine but the
+ * exact one with trigonometricForces set, whose reference pass always
+ * finishes.  The tree and grid engines check between blocks of nodes or
+ * cells, and the exact engines between tiles or blocks of rows.
+ */
+bool InterruptibleForces(const LayoutOptions& options);
+
+/**
+ * Function: ApproximateForces(const LayoutOptions& options)
+ * -----------------------------------------------------------------------
+ * Returns whether the repulsion under the options jitters from one
+ * iteration to the next the way an approximate engine's does: for every
+ * engine but the exact one, and for the exact one in float or mixed
+ * precision.  UpdateConvergence() lets such layouts stop on a plateau.
+ */
+bool ApproximateForces(const LayoutOptions& options);
+
+/**
+ * Function: InitializeNodeChanges(const NodeArrays& positions)
+ * -----------------------------------------------------------------------
+ * Returns arrays holding one zeroed change for each node in positions.
+ */
+NodeArrays InitializeNodeChanges(const NodeArrays& positions);
+
+/**
+ * Function: CalculateRepulsiveForces(const NodeArrays& positions,
+ *                                    NodeArrays& nodeChanges)
+ * -----------------------------------------------------------------------
+ * Adds the exact repulsive force between every pair of nodes into
+ * nodeChanges.  CalculateTrigonometricRepulsiveForces() computes the
+ * same forces through the angle between the nodes; it is several times
+ * slower and is kept as a reference.
+ */
+void CalculateRepulsiveForces(const NodeArrays& positions, NodeArrays& nodeChanges);
+void CalculateTrigonometricRepulsiveForces(const NodeArrays& positions,
+                                           NodeArrays& nodeChanges);
+
+/**
+ * Function: CalculateRepulsiveForces(const NodeArrays& positions,
+ *                                    const vector<double>& masses,
+ *                                    NodeArrays& nodeChanges)
+ * -----------------------------------------------------------------------
+ * The same, with the force between two nodes scaled by the product of
+ * their masses.
+ */
+void CalculateRepulsiveForces(const NodeArrays& positions, const vector<double>& masses,
+                              NodeArrays& nodeChanges);
+
+/**
+ * Function: CalculateRepulsiveForces(const NodeArrays& positions,
+ *                                    const vector<double>& masses,
+ *                                    NodeArrays& nodeChanges,
+ *                                    const LayoutDeadline& deadline)
+ * -----------------------------------------------------------------------
+ * The same, except that the deadline is checked after every row of
+ * pairs that brings those since the last check to kDeadlineCheckPairs.
+ * Returns true if every pair was done, and false if the deadline
+ * stopped the pass, in which case nodeChanges holds only part of the
+ * forces.
+ */
+bool CalculateRepulsiveForces(const NodeArrays& positions, const vector<double>& masses,
+                              NodeArrays& nodeChanges, const LayoutDeadline& deadline);
+
+/**
+ * Function: CalculateAttractiveForces(const NodeArrays& positions,
+ *                                     const vector<Edge>& edges,
+ *                                     NodeArrays& nodeChanges)
+ * -----------------------------------------------------------------------
+ * Adds the attractive force along every edge into nodeChanges.
+ * CalculateTrigonometricAttractiveForces() is the reference version that
+ * works through the angle of each edge.
+ */
+void CalculateAttractiveForces(const NodeArrays& positions, const vector<Edge>& edges,
+                               NodeArrays& nodeChanges);
+void CalculateTrigonometricAttractiveForces(const NodeArrays& positions,
+                                            const vector<Edge>& edges,
+                                            NodeArrays& nodeChanges);
+
+/**
+ * Function: CalculateGatheredAttractiveForces(const NodeArrays& positions,
+ *                                             const Adjacency& adjacency,
+ *                                             NodeArrays& nodeChanges,
+ *                                             size_t numberOfThreads)
+ * -----------------------------------------------------------------------
+ * Adds the same forces as CalculateAttractiveForces(), but computes each
+ * node's total from its own list of neighbours instead of scattering
+ * each edge's force into both of its ends.  Each node's change is then
+ * written once, by one thread, so the nodes are split between
+ * numberOfThreads threads, with zero meaning one per core.  Self-loops,
+ * which BuildAdjacency() leaves out, exert no force.
+ */
+void CalculateGatheredAttractiveForces(const NodeArrays& positions, const Adjacency& adjacency,
+                                       NodeArrays& nodeChanges, size_t numberOfThreads);
+
+/**
+ * Function: UpdateNodeMovements(NodeArrays& positions,
+ *                               NodeArrays& nodeChanges)
+ * -----------------------------------------------------------------------
+ * Moves every node by its accumulated change, then resets the changes
+ * to zero.
+ */
+void UpdateNodeMovements(NodeArrays& positions, NodeArrays& nodeChanges);
+
+/**
+ * Functions: CalculateFRepel, CalculateFAttract
+ * -----------------------------------------------------------------------
+ * Return the magnitude of the repulsive and attractive forces between
+ * two nodes at (x0, y0) and (x1, y1), or between two nodes that are the
+ * given distance apart.
+ */
+double CalculateFRepel(double x0, double x1, double y0, double y1);
+double CalculateFAttract(double x0, double x1, double y0, double y1);
+double CalculateFRepel(double distance);
+double CalculateFAttract(double distance);
+
+/**
+ * Functions: CalculateRadiansAngle, CalculateXForce, CalculateYForce
+ * -----------------------------------------------------------------------
+ * Return the angle of the vector from (x0, y0) to (x1, y1), and the x and
+ * y components of a force of the given magnitude acting at that angle.
+ */
+double CalculateRadiansAngle(double x0, double x1, double y0, double y1);
+double CalculateXForce(double fRepel, double radiansAngle);
+double CalculateYForce(double fRepel, double radiansAngle);
+
+#endif
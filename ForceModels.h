@@ -0,0 +1,307 @@
+/*************************************************************************
+ * File: ForceModels.h
+ *
+ * A header file defining the force laws the layout engine can use, as
+ * policy types that the force kernels are compiled against.  Each model
+ * is a struct with two static functions returning the magnitude of the
+ * forces between two nodes that are a given distance apart:
+ *
+ *     static double Repel(double distance);
+ *     static double Attract(double distance);
+ *
+ * and a constant kInverseDistanceRepulsion that is true when Repel() is
+ * kRepel / distance.  The kernels below are templates over the model,
+ * so each model's laws are inlined into a loop of its own with no
+ * dispatch per pair, and trying a new law means writing a new struct
+ * rather than editing the loops.
+ *
+ * Three models are provided.  All of them repel as 1 / d and rest an
+ * isolated edge at length 1 under kRepel and kAttract; they differ in
+ * how hard a stretched edge pulls:
+ *
+ *   - FruchtermanReingoldForces, the original d^2 pull;
+ *   - LinLogForces, the constant pull of Noack's LinLog energy model,
+ *     which separates clusters much more strongly;
+ *   - ForceAtlas2Forces, the linear pull of ForceAtlas2.
+ *
+ * The shared repulsion is not a shortcut: LinLog's energy repels by
+ * -ln d per pair, whose force is 1 / d, and ForceAtlas2 repels as 1 / d
+ * scaled by the degrees of the two nodes, which its own engine applies.
+ *
+ * Models that repel as 1 / d use every repulsion engine in
+ * ForceLayout.h, since that is the law the approximations compute.  A
+ * model with any other law sets kInverseDistanceRepulsion to false, and
+ * its repulsion is then computed exactly by
+ * CalculateParallelModelRepulsiveForces() whichever engine is selected,
+ * on one thread if the layout must be deterministic.  LayoutBenchmark
+ * checks that path with an inverse-square law.
+ */
+
+#ifndef ForceModels_Included // Include guard
+#define ForceModels_Included
+
+#include <cmath>
+#include <algorithm>
+#include "ForceLayout.h"       // For kRepel, kAttract and the NodeArrays type.
+#include "Parallel.h"          // For RunOnThreads.
+#include "ParallelRepulsion.h" // For RunRepulsionTiles.
+
+/**
+ * Type: FruchtermanReingoldForces
+ * -----------------------------------------------------------------------
+ * kRepel / d repulsion and kAttract * d^2 attraction, as in
+ * CalculateFRepel() and CalculateFAttract().
+ */
+struct FruchtermanReingoldForces {
+    static const bool kInverseDistanceRepulsion = true;
+    static double Repel(double distance) { return kRepel / distance; }
+    static double Attract(double distance) { return kAttract * distance * distance; }
+};
+
+/**
+ * Type: LinLogForces
+ * -----------------------------------------------------------------------
+ * kRepel / d repulsion and a constant kAttract attraction: the forces of
+ * the energy kAttract * d per edge minus kRepel * ln d per pair.
+ */
+struct LinLogForces {
+    static const bool kInverseDistanceRepulsion = true;
+    static double Repel(double distance) { return kRepel / distance; }
+    static double Attract(double) { return kAttract; }
+};
+
+/**
+ * Type: ForceAtlas2Forces
+ * -----------------------------------------------------------------------
+ * kRepel / d repulsion and kAttract * d attraction.  ForceAtlas2 also
+ * weights the repulsion by the degrees of the two nodes; that weighting
+ * belongs to its own engine rather than to the law between two nodes.
+ */
+struct ForceAtlas2Forces {
+    static const bool kInverseDistanceRepulsion = true;
+    static double Repel(double distance) { return kRepel / distance; }
+    static double Attract(double distance) { return kAttract * distance; }
+};
+
+/**
+ * Function: CalculateModelRepulsiveTile<Forces>(
+ *               const NodeArrays& positions, NodeArrays& nodeChanges,
+ *               size_t rowBegin, size_t rowEnd,
+ *               size_t columnBegin, size_t columnEnd)
+ * -----------------------------------------------------------------------
+ * Adds the model's repulsion for one tile of the pair triangle into
+ * nodeChanges, as CalculateVectorizedRepulsiveTile() of SimdRepulsion.h
+ * does for kRepel / d: every pair (i, j) with i in [rowBegin, rowEnd),
+ * j in [columnBegin, columnEnd) and i < j.
+ */
+template <typename Forces>
+void CalculateModelRepulsiveTile(const NodeArrays& positions, NodeArrays& nodeChanges,
+                                 size_t rowBegin, size_t rowEnd,
+                                 size_t columnBegin, size_t columnEnd);
+
+/**
+ * Function: CalculateModelRepulsiveForces<Forces>(
+ *               const NodeArrays& positions, NodeArrays& nodeChanges)
+ * -----------------------------------------------------------------------
+ * Adds the model's repulsive force between every pair of nodes into
+ * nodeChanges, on one thread.
+ */
+template <typename Forces>
+void CalculateModelRepulsiveForces(const NodeArrays& positions, NodeArrays& nodeChanges);
+
+/**
+ * Function: CalculateParallelModelRepulsiveForces<Forces>(
+ *               const NodeArrays& positions, NodeArrays& nodeChanges,
+ *               size_t numberOfThreads)
+ * -----------------------------------------------------------------------
+ * The same forces, with the pair triangle cut into tiles and shared out
+ * between numberOfThreads threads, or one per core if it is zero, by
+ * RunRepulsionTiles() of ParallelRepulsion.h.
+ */
+template <typename Forces>
+void CalculateParallelModelRepulsiveForces(const NodeArrays& positions, NodeArrays& nodeChanges,
+                                           size_t numberOfThreads);
+
+/**
+ * Function: CalculateParallelModelRepulsiveForces<Forces>(
+ *               const NodeArrays& positions, NodeArrays& nodeChanges,
+ *               size_t numberOfThreads, const LayoutDeadline& deadline)
+ * -----------------------------------------------------------------------
+ * The same, except that every thread checks the deadline after each
+ * tile.  Returns true if every tile was done, and false if the deadline
+ * stopped the pass, in which case nodeChanges holds only part of the
+ * forces.
+ */
+template <typename Forces>
+bool CalculateParallelModelRepulsiveForces(const NodeArrays& positions, NodeArrays& nodeChanges,
+                                           size_t numberOfThreads, const LayoutDeadline& deadline);
+
+/**
+ * Function: CalculateModelAttractiveForces<Forces>(
+ *               const NodeArrays& positions, const vector<Edge>& edges,
+ *               NodeArrays& nodeChanges)
+ * -----------------------------------------------------------------------
+ * Adds the model's attractive force along every edge into nodeChanges,
+ * scattering each edge's force into both of its ends.  Self-loops, and
+ * edges whose ends lie on top of each other, have no direction and are
+ * skipped.
+ */
+template <typename Forces>
+void CalculateModelAttractiveForces(const NodeArrays& positions, const vector<Edge>& edges,
+                                    NodeArrays& nodeChanges);
+
+/**
+ * Function: CalculateGatheredModelAttractiveForces<Forces>(
+ *               const NodeArrays& positions, const Adjacency& adjacency,
+ *               NodeArrays& nodeChanges, size_t numberOfThreads)
+ * -----------------------------------------------------------------------
+ * The same forces, gathered per node over the adjacency on
+ * numberOfThreads threads as CalculateGatheredAttractiveForces() does,
+ * again skipping neighbours that lie on top of the node.
+ */
+template <typename Forces>
+void CalculateGatheredModelAttractiveForces(const NodeArrays& positions,
+                                            const Adjacency& adjacency,
+                                            NodeArrays& nodeChanges, size_t numberOfThreads);
+
+/*
+ * Templates have to be defined where they are instantiated, so the
+ * kernels follow here rather than in a .cpp file.  Clients need only
+ * the declarations above.
+ */
+
+/*
+ * CalculateModelRepulsiveTile
+ * Visits every pair of the tile once and scales the unit
+ * vector between the nodes by the model's repulsion.
+ */
+template <typename Forces>
+void CalculateModelRepulsiveTile(const NodeArrays& positions, NodeArrays& nodeChanges,
+                                 size_t rowBegin, size_t rowEnd,
+                                 size_t columnBegin, size_t columnEnd) {
+    const double* x = positions.x.data();
+    const double* y = positions.y.data();
+    double* changeX = nodeChanges.x.data();
+    double* changeY = nodeChanges.y.data();
+
+    for (size_t nodeIndex0 = rowBegin; nodeIndex0 < rowEnd; nodeIndex0++) {
+        double x0 = x[nodeIndex0];
+        double y0 = y[nodeIndex0];
+        size_t first = max(columnBegin, nodeIndex0 + 1);
+        for (size_t nodeIndex1 = first; nodeIndex1 < columnEnd; nodeIndex1++) {
+            double dx = x[nodeIndex1] - x0;
+            double dy = y[nodeIndex1] - y0;
+            double distance = sqrt(dx * dx + dy * dy);
+
+            double fRepel = Forces::Repel(distance);
+            double forceX = fRepel * dx / distance;
+            double forceY = fRepel * dy / distance;
+
+            changeX[nodeIndex0] -= forceX;
+            changeY[nodeIndex0] -= forceY;
+            changeX[nodeIndex1] += forceX;
+            changeY[nodeIndex1] += forceY;
+        }
+    }
+}
+
+/*
+ * CalculateModelRepulsiveForces
+ * Runs the whole triangle as one tile.
+ */
+template <typename Forces>
+void CalculateModelRepulsiveForces(const NodeArrays& positions, NodeArrays& nodeChanges) {
+    CalculateModelRepulsiveTile<Forces>(positions, nodeChanges, 0, positions.size(),
+                                        0, positions.size());
+}
+
+/*
+ * CalculateParallelModelRepulsiveForces
+ * Runs against a deadline that never passes.
+ */
+template <typename Forces>
+void CalculateParallelModelRepulsiveForces(const NodeArrays& positions, NodeArrays& nodeChanges,
+                                           size_t numberOfThreads) {
+    CalculateParallelModelRepulsiveForces<Forces>(positions, nodeChanges, numberOfThreads,
+                                                  StartDeadline(HUGE_VAL));
+}
+
+/*
+ * CalculateParallelModelRepulsiveForces
+ * Hands the model's tile kernel to the shared tiling.
+ */
+template <typename Forces>
+bool CalculateParallelModelRepulsiveForces(const NodeArrays& positions, NodeArrays& nodeChanges,
+                                           size_t numberOfThreads, const LayoutDeadline& deadline) {
+    return RunRepulsionTiles(positions, nodeChanges, numberOfThreads, deadline,
+                             CalculateModelRepulsiveTile<Forces>);
+}
+
+/*
+ * CalculateModelAttractiveForces
+ * Scales the unit vector along each edge by the model's
+ * attraction and adds it to both ends.
+ */
+template <typename Forces>
+void CalculateModelAttractiveForces(const NodeArrays& positions, const vector<Edge>& edges,
+                                    NodeArrays& nodeChanges) {
+    for (size_t edgeIndex = 0; edgeIndex < edges.size(); edgeIndex++) {
+        size_t start = edges[edgeIndex].start;
+        size_t end = edges[edgeIndex].end;
+
+        //Get the vector along the edge
+        double dx = positions.x[end] - positions.x[start];
+        double dy = positions.y[end] - positions.y[start];
+        double distance = sqrt(dx * dx + dy * dy);
+        if (distance == 0) continue;
+
+        //Scale the unit vector by the attractive force
+        double fAttract = Forces::Attract(distance);
+        double forceX = fAttract * dx / distance;
+        double forceY = fAttract * dy / distance;
+
+        nodeChanges.x[start] += forceX;
+        nodeChanges.y[start] += forceY;
+        nodeChanges.x[end]   -= forceX;
+        nodeChanges.y[end]   -= forceY;
+    }
+}
+
+/*
+ * CalculateGatheredModelAttractiveForces
+ * Each thread owns a contiguous range of nodes and sums,
+ * for each of them, the pull of its neighbours.  Each
+ * node and each of its edge ends counts as one
+ * evaluation of work.
+ */
+template <typename Forces>
+void CalculateGatheredModelAttractiveForces(const NodeArrays& positions,
+                                            const Adjacency& adjacency,
+                                            NodeArrays& nodeChanges, size_t numberOfThreads) {
+    const double* x = positions.x.data();
+    const double* y = positions.y.data();
+    size_t numberOfNodes = adjacency.size();
+    numberOfThreads = LimitThreadCount(numberOfThreads, numberOfNodes,
+                                       numberOfNodes + adjacency.targets.size());
+    RunOnThreads(numberOfThreads, [&](size_t thread) {
+        size_t begin, end;
+        ThreadRange(numberOfNodes, thread, numberOfThreads, begin, end);
+        for (size_t node = begin; node < end; node++) {
+            double sumX = 0, sumY = 0;
+            for (size_t k = adjacency.offsets[node]; k < adjacency.offsets[node + 1]; k++) {
+                size_t neighbour = adjacency.targets[k];
+                double dx = x[neighbour] - x[node];
+                double dy = y[neighbour] - y[node];
+                double distance = sqrt(dx * dx + dy * dy);
+                if (distance == 0) continue;
+                double fAttract = Forces::Attract(distance);
+                sumX += fAttract * dx / distance;
+                sumY += fAttract * dy / distance;
+            }
+            nodeChanges.x[node] += sumX;
+            nodeChanges.y[node] += sumY;
+        }
+    });
+}
+
+#endif
@@ -0,0 +1,117 @@
+/******************************************************
+ * File: GraphDistances.cpp
+ *
+ * Implementation of the GraphDistances.h interface.
+ * Each breadth-first search fills one row of the upper
+ * triangle; unreachable pairs are marked while searching
+ * and given their final distance once the longest real
+ * path is known.
+ */
+
+#include <atomic>
+#include <algorithm>
+#include <cmath>
+#include "GraphDistances.h"
+#include "Parallel.h"
+using namespace std;
+
+/* The table of n nodes takes n(n - 1) bytes, so n is at most the root of the budget. */
+const size_t kMaximumDistanceNodes = (size_t) sqrt((double) kDistanceTableBytes);
+
+/*
+ * BreadthFirstSearch
+ * The queue is an array with a head and a tail index;
+ * every node enters it at most once, since only
+ * unreached nodes enter it and the depths saturate
+ * below kUnreachable.
+ */
+unsigned short BreadthFirstSearch(const Adjacency& adjacency, size_t source,
+                                  vector<unsigned short>& depth, vector<size_t>& queue) {
+    fill(depth.begin(), depth.end(), kUnreachable);
+    depth[source] = 0;
+    queue[0] = source;
+    size_t head = 0, tail = 1;
+    while (head < tail) {
+        size_t node = queue[head++];
+        unsigned short nextDepth = min(depth[node], (unsigned short) (kMaximumDepth - 1)) + 1;
+        for (size_t k = adjacency.offsets[node]; k < adjacency.offsets[node + 1]; k++) {
+            size_t neighbour = adjacency.targets[k];
+            if (depth[neighbour] != kUnreachable) continue;
+            depth[neighbour] = nextDepth;
+            queue[tail++] = neighbour;
+        }
+    }
+    return depth[queue[tail - 1]];
+}
+
+/*
+ * ChoosePivots
+ * Keeps each node's distance to its closest pivot so
+ * far; the next pivot is the node where it is largest.
+ */
+void ChoosePivots(const Adjacency& adjacency, size_t numberOfPivots, vector<size_t>& pivots,
+                  vector<vector<unsigned short> >& pivotDepths) {
+    size_t numberOfNodes = adjacency.size();
+    numberOfPivots = min(numberOfPivots, numberOfNodes);
+    pivots.clear();
+    pivotDepths.assign(numberOfPivots, vector<unsigned short>(numberOfNodes));
+    vector<unsigned short> closestDistance(numberOfNodes, kUnreachable);
+    vector<size_t> queue(numberOfNodes);
+
+    size_t nextPivot = 0;
+    for (size_t p = 0; p < numberOfPivots; p++) {
+        pivots.push_back(nextPivot);
+        BreadthFirstSearch(adjacency, nextPivot, pivotDepths[p], queue);
+        for (size_t node = 0; node < numberOfNodes; node++) {
+            closestDistance[node] = min(closestDistance[node], pivotDepths[p][node]);
+        }
+        nextPivot = max_element(closestDistance.begin(), closestDistance.end()) -
+                    closestDistance.begin();
+    }
+}
+
+/*
+ * CalculateGraphDistances
+ * Threads claim sources from a shared counter, each with
+ * its own search storage, and record the distances to
+ * the nodes after the source.  The longest distance is
+ * kept per thread and combined at the end.
+ */
+bool CalculateGraphDistances(const SimpleGraph& graph, GraphDistances& distances,
+                             size_t numberOfThreads) {
+    size_t numberOfNodes = graph.nodes.size();
+    distances.numberOfNodes = 0;
+    distances.values.clear();
+    if (numberOfNodes > kMaximumDistanceNodes) return false;
+
+    Adjacency adjacency;
+    BuildAdjacency(numberOfNodes, graph.edges, adjacency);
+
+    distances.numberOfNodes = numberOfNodes;
+    distances.values.assign(numberOfNodes * (numberOfNodes - 1) / 2 + 1, kUnreachable);
+
+    //Each search visits every node and edge end once
+    numberOfThreads = LimitThreadCount(numberOfThreads, numberOfNodes,
+                                       numberOfNodes * (numberOfNodes + adjacency.targets.size()));
+    vector<unsigned short> farthest(numberOfThreads, 0);
+    atomic<size_t> nextSource(0);
+    RunOnThreads(numberOfThreads, [&](size_t thread) {
+        vector<unsigned short> depth(numberOfNodes);
+        vector<size_t> queue(numberOfNodes);
+        for (size_t source = nextSource++; source < numberOfNodes; source = nextSource++) {
+            farthest[thread] = max(farthest[thread],
+                                   BreadthFirstSearch(adjacency, source, depth, queue));
+            unsigned short* row = &distances.values[source * numberOfNodes -
+                                                    source * (source + 1) / 2];
+            for (size_t node = source + 1; node < numberOfNodes; node++) {
+                row[node - source - 1] = depth[node];
+            }
+        }
+    });
+
+    distances.maximumDistance = *max_element(farthest.begin(), farthest.end());
+    distances.disconnectedDistance = distances.maximumDistance + 1;
+    replace(distances.values.begin(), distances.values.end(), kUnreachable,
+            distances.disconnectedDistance);
+    return true;
+}
@@ -0,0 +1,116 @@
+/*************************************************************************
+ * File: GraphDistances.h
+ *
+ * A header file defining the table of shortest-path distances between
+ * every pair of nodes, as used by the distance-based layout engines.
+ * The graph is unweighted, so the distances are hop counts found by a
+ * breadth-first search from every node.  Only the upper triangle of the
+ * symmetric table is stored, one unsigned short per pair: a graph of
+ * 10,000 nodes needs about 100 MB and one of 30,000 about 900 MB.
+ *
+ * Pairs of nodes in different connected components have no path.  They
+ * are given a distance one longer than the longest real path, which
+ * keeps the components apart without flinging them to infinity.
+ *
+ * The searches are independent and each fills its own row of the
+ * table, so they run in parallel, walking a compact adjacency structure
+ * built once from the edges.
+ */
+
+#ifndef GraphDistances_Included // Include guard
+#define GraphDistances_Included
+
+#include "SimpleGraph.h" // For the SimpleGraph type.
+#include "Adjacency.h"   // For the Adjacency type.
+
+/*
+ * Memory the table may take, and the largest graph that fits in it.  The
+ * table holds two bytes for each of the n(n - 1) / 2 pairs, just under
+ * n^2 bytes, so the limit is the square root of the budget, 32,768 nodes
+ * for 1 GB.  It is computed from the budget in GraphDistances.cpp.
+ */
+const size_t kDistanceTableBytes = (size_t) 1 << 30;
+extern const size_t kMaximumDistanceNodes;
+
+/**
+ * Type: GraphDistances
+ * -----------------------------------------------------------------------
+ * The hop count between every pair of distinct nodes.  Use
+ * GraphDistance() to read it.
+ */
+struct GraphDistances {
+    size_t numberOfNodes;
+    unsigned short maximumDistance;     // longest path between connected nodes
+    unsigned short disconnectedDistance; // distance used between components
+    vector<unsigned short> values;      // upper triangle, row by row
+};
+
+/* Marks a node that a breadth-first search has not reached. */
+const unsigned short kUnreachable = 0xFFFF;
+
+/* The largest depth a search stores; deeper nodes are given this one. */
+const unsigned short kMaximumDepth = kUnreachable - 1;
+
+/**
+ * Function: BreadthFirstSearch(const Adjacency& adjacency,
+ *                              size_t source,
+ *                              vector<unsigned short>& depth,
+ *                              vector<size_t>& queue)
+ * -----------------------------------------------------------------------
+ * Stores in depth[i] the number of edges on a shortest path from source
+ * to node i, or kUnreachable if there is none.  Depths beyond
+ * kMaximumDepth, which only paths of more than 65,534 edges reach, are
+ * stored as kMaximumDepth, so no real depth is ever mistaken for an
+ * unreached node.  depth and queue must have one element per node;
+ * queue is working storage, passed in so that repeated searches do not
+ * reallocate it.  Returns the largest depth reached.
+ */
+unsigned short BreadthFirstSearch(const Adjacency& adjacency, size_t source,
+                                  vector<unsigned short>& depth, vector<size_t>& queue);
+
+/**
+ * Function: ChoosePivots(const Adjacency& adjacency,
+ *                        size_t numberOfPivots,
+ *                        vector<size_t>& pivots,
+ *                        vector<vector<unsigned short> >& pivotDepths)
+ * -----------------------------------------------------------------------
+ * Chooses up to numberOfPivots pivot nodes spread over the graph by the
+ * max-min rule: the first is node zero and each next one is the node
+ * farthest from all those already chosen, with unreachable nodes the
+ * farthest of all.  Stores the pivots in pivots and, in pivotDepths[p],
+ * the depths found by a breadth-first search from pivot p.
+ */
+void ChoosePivots(const Adjacency& adjacency, size_t numberOfPivots, vector<size_t>& pivots,
+                  vector<vector<unsigned short> >& pivotDepths);
+
+/**
+ * Function: CalculateGraphDistances(const SimpleGraph& graph,
+ *                                   GraphDistances& distances,
+ *                                   size_t numberOfThreads = 0)
+ * -----------------------------------------------------------------------
+ * Fills distances with the hop counts between every pair of nodes of the
+ * graph, running the searches on numberOfThreads threads, or one per
+ * core if it is zero.  Returns false, leaving distances empty, if the
+ * graph has more than kMaximumDistanceNodes nodes.
+ */
+bool CalculateGraphDistances(const SimpleGraph& graph, GraphDistances& distances,
+                             size_t numberOfThreads = 0);
+
+/**
+ * Function: GraphDistance(const GraphDistances& distances,
+ *                         size_t node0, size_t node1)
+ * -----------------------------------------------------------------------
+ * Returns the distance between two distinct nodes, in either order.
+ */
+inline unsigned short GraphDistance(const GraphDistances& distances,
+                                    size_t node0, size_t node1) {
+    if (node0 > node1) {
+        size_t swap = node0;
+        node0 = node1;
+        node1 = swap;
+    }
+    size_t n = distances.numberOfNodes;
+    return distances.values[node0 * n - node0 * (node0 + 1) / 2 + (node1 - node0 - 1)];
+}
+
+#endif
@@ -61,12 +61,6 @@ Viewport ComputeViewport(SimpleGraph& graph) {
 	return result;
 }
 
-/* A constant controlling the percent of the viewport dimension to dedicate
- * on each side to padding.  Increasing this value adds more of a margin to
- * the screen.
- */
-const double kMarginPaddingPercent = 0.025;
-
 /* Given an X or Y coordinate, the minimum and maximum values for the coordinate,
  * and the scale factor (i.e. the maximum possible X or Y value in the display),
  * scales the coordinate so that it fits in the display with the proper padding.
@@ -108,8 +102,23 @@ void DrawArcs(SimpleGraph& graph, Viewport& viewport) {
 	}
 }
 
-/* Size of each node when drawn. */
-const double kNodeRadius = 1 / 16.0;
+/* Draws every edge along its path, one segment at a time. */
+void DrawPaths(const vector<vector<Node> >& edgePaths, Viewport& viewport) {
+	SetPenColor("Black");
+
+	for (size_t i = 0; i < edgePaths.size(); ++i) {
+		const vector<Node>& path = edgePaths[i];
+		for (size_t j = 1; j < path.size(); ++j) {
+			const double startX = TransformX(path[j - 1].x, viewport);
+			const double startY = TransformY(path[j - 1].y, viewport);
+			const double endX   = TransformX(path[j].x, viewport);
+			const double endY   = TransformY(path[j].y, viewport);
+
+			MovePen(startX, startY);
+			DrawLine(endX - startX, endY - startY);
+		}
+	}
+}
 
 /* Draws all of the nodes. */
 void DrawNodes(SimpleGraph& graph, Viewport& viewport) {
@@ -141,8 +150,19 @@ void DrawGraph(SimpleGraph& graph) {
 	UpdateDisplay();
 }
 
+/* Renders the graph with its edges drawn along the given paths. */
+void DrawGraph(SimpleGraph& graph, const vector<vector<Node> >& edgePaths) {
+	ClearDisplay();
+	Viewport viewport = ComputeViewport(graph);
+
+	/* Draw the paths, then the nodes on top of them as before. */
+	DrawPaths(edgePaths, viewport);
+	DrawNodes(graph, viewport);
+	UpdateDisplay();
+}
+
 /* Initializing this module just sets up the graphics window to a comfortable size. */
 void InitGraphVisualizer() {
-	SetWindowSize(4, 4);
+	SetWindowSize(kWindowSize, kWindowSize);
 	InitGraphics();
 }
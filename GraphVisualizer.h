@@ -20,6 +20,18 @@
 
 #include "SimpleGraph.h" // For the SimpleGraph type.
 
+/* Width and height of the graphics window, in inches. */
+const double kWindowSize = 4;
+
+/* A constant controlling the percent of the viewport dimension to dedicate
+ * on each side to padding.  Increasing this value adds more of a margin to
+ * the screen.
+ */
+const double kMarginPaddingPercent = 0.025;
+
+/* Size of each node when drawn, in inches. */
+const double kNodeRadius = 1 / 16.0;
+
 /**
  * Function: InitGraphVisualizer()
  * -----------------------------------------------------------------------
@@ -37,6 +49,18 @@ void InitGraphVisualizer();
  */
 void DrawGraph(SimpleGraph& graph);
 
+/**
+ * Function: DrawGraph(SimpleGraph& graph,
+ *                     const vector<vector<Node> >& edgePaths)
+ * -----------------------------------------------------------------------
+ * Draws the specified graph with each edge following a path of points
+ * rather than a straight line: edgePaths[i] holds the points of
+ * graph.edges[i] from its start node to its end node, as produced by
+ * BundleEdges() in EdgeBundling.h.  The graph is scaled to fit in the
+ * same way as by DrawGraph(graph).
+ */
+void DrawGraph(SimpleGraph& graph, const vector<vector<Node> >& edgePaths);
+
 /**
  * Redefinition: main
  * -----------------------------------------------------------------------
@@ -0,0 +1,156 @@
+/******************************************************
+ * File: GridRepulsion.cpp
+ *
+ * Implementation of the GridRepulsion.h interface.  The
+ * nodes are counting-sorted by the hash of their cell,
+ * giving a compact table in which the nodes of each
+ * hash bucket are contiguous.
+ */
+
+#include <cmath>
+#include "GridRepulsion.h"
+#include "ForceLayout.h"
+using namespace std;
+
+/*
+ * BuildNodeGrid
+ * Counts the nodes of each bucket, sums the counts into
+ * starts, then places each node and its cell.
+ */
+void BuildNodeGrid(const NodeArrays& positions, const vector<size_t>& nodes, double cellSize,
+                   NodeGrid& grid) {
+    size_t numberOfNodes = nodes.size();
+
+    //Use a power-of-two table with at least one bucket per node
+    size_t tableSize = 1;
+    while (tableSize < numberOfNodes) tableSize *= 2;
+    grid.cellSize = cellSize;
+    grid.mask = tableSize - 1;
+    grid.bucketStarts.assign(tableSize + 1, 0);
+
+    //Find each node's cell and bucket
+    vector<GridCell> cells(numberOfNodes);
+    vector<size_t> buckets(numberOfNodes);
+    for (size_t i = 0; i < numberOfNodes; i++) {
+        cells[i] = FindGridCell(positions.x[nodes[i]], positions.y[nodes[i]], cellSize);
+        buckets[i] = HashGridCell(cells[i].x, cells[i].y, grid.mask);
+        grid.bucketStarts[buckets[i] + 1]++;
+    }
+
+    //Counting sort the nodes by bucket
+    for (size_t bucket = 0; bucket < tableSize; bucket++) {
+        grid.bucketStarts[bucket + 1] += grid.bucketStarts[bucket];
+    }
+    grid.sortedNodes.resize(numberOfNodes);
+    grid.cells.resize(numberOfNodes);
+    vector<size_t> nextSlot(grid.bucketStarts.begin(), grid.bucketStarts.end() - 1);
+    for (size_t i = 0; i < numberOfNodes; i++) {
+        size_t slot = nextSlot[buckets[i]]++;
+        grid.sortedNodes[slot] = nodes[i];
+        grid.cells[slot] = cells[i];
+    }
+}
+
+/*
+ * RepelThroughGrid
+ * Buckets the nodes by cell, then for every node scans
+ * the nodes of the nine surrounding cells, applying each
+ * pair closer than the cutoff once.  Each force is
+ * scaled by the masses of both nodes, unless masses is
+ * NULL.  When the nodes crowd into a few cells the scan
+ * approaches all pairs, so the deadline is checked after
+ * every kDeadlineCheckNodes nodes, or sooner once the
+ * nodes scanned since the last check reach
+ * kDeadlineCheckPairs.
+ */
+static bool RepelThroughGrid(const NodeArrays& positions, const double* masses,
+                             NodeArrays& nodeChanges, double cutoff,
+                             const LayoutDeadline& deadline) {
+    size_t numberOfNodes = positions.size();
+    vector<size_t> nodes(numberOfNodes);
+    for (size_t nodeIndex = 0; nodeIndex < numberOfNodes; nodeIndex++) nodes[nodeIndex] = nodeIndex;
+    NodeGrid grid;
+    BuildNodeGrid(positions, nodes, cutoff, grid);
+
+    double cutoffSquared = cutoff * cutoff;
+    size_t pairsSinceCheck = 0;
+    for (size_t nodeIndex0 = 0; nodeIndex0 < numberOfNodes; nodeIndex0++) {
+        double x0 = positions.x[nodeIndex0];
+        double y0 = positions.y[nodeIndex0];
+        GridCell cell = FindGridCell(x0, y0, cutoff);
+
+        for (long dy = -1; dy <= 1; dy++) {
+            for (long dx = -1; dx <= 1; dx++) {
+                long cellX = cell.x + dx;
+                long cellY = cell.y + dy;
+                size_t bucket = HashGridCell(cellX, cellY, grid.mask);
+                size_t bucketEnd = grid.bucketStarts[bucket + 1];
+                pairsSinceCheck += bucketEnd - grid.bucketStarts[bucket];
+
+                for (size_t i = grid.bucketStarts[bucket]; i < bucketEnd; i++) {
+                    //Visit each pair once, and skip nodes from other cells in the bucket
+                    size_t nodeIndex1 = grid.sortedNodes[i];
+                    if (nodeIndex1 <= nodeIndex0) continue;
+                    if (grid.cells[i].x != cellX || grid.cells[i].y != cellY) continue;
+
+                    double x1 = positions.x[nodeIndex1];
+                    double y1 = positions.y[nodeIndex1];
+                    double distanceSquared = (x1 - x0) * (x1 - x0) + (y1 - y0) * (y1 - y0);
+                    if (distanceSquared >= cutoffSquared) continue;
+
+                    double distance = sqrt(distanceSquared);
+                    double fRepel = CalculateFRepel(distance);
+                    if (masses) fRepel *= masses[nodeIndex0] * masses[nodeIndex1];
+                    double forceX = fRepel * (x1 - x0) / distance;
+                    double forceY = fRepel * (y1 - y0) / distance;
+                    nodeChanges.x[nodeIndex0] -= forceX;
+                    nodeChanges.y[nodeIndex0] -= forceY;
+                    nodeChanges.x[nodeIndex1] += forceX;
+                    nodeChanges.y[nodeIndex1] += forceY;
+                }
+            }
+        }
+        if ((nodeIndex0 + 1) % kDeadlineCheckNodes == 0 || pairsSinceCheck >= kDeadlineCheckPairs) {
+            if (DeadlinePassed(deadline)) return false;
+            pairsSinceCheck = 0;
+        }
+    }
+    return true;
+}
+
+/*
+ * CalculateGridRepulsiveForces
+ * Repels unweighted nodes.
+ */
+void CalculateGridRepulsiveForces(const NodeArrays& positions, NodeArrays& nodeChanges,
+                                  double cutoff) {
+    RepelThroughGrid(positions, NULL, nodeChanges, cutoff, StartDeadline(HUGE_VAL));
+}
+
+/*
+ * CalculateGridRepulsiveForces
+ * Repels unweighted nodes until the deadline passes.
+ */
+bool CalculateGridRepulsiveForces(const NodeArrays& positions, NodeArrays& nodeChanges,
+                                  double cutoff, const LayoutDeadline& deadline) {
+    return RepelThroughGrid(positions, NULL, nodeChanges, cutoff, deadline);
+}
+
+/*
+ * CalculateGridRepulsiveForces
+ * Repels nodes weighted by the given masses.
+ */
+void CalculateGridRepulsiveForces(const NodeArrays& positions, const vector<double>& masses,
+                                  NodeArrays& nodeChanges, double cutoff) {
+    RepelThroughGrid(positions, masses.data(), nodeChanges, cutoff, StartDeadline(HUGE_VAL));
+}
+
+/*
+ * CalculateGridRepulsiveForces
+ * Repels weighted nodes until the deadline passes.
+ */
+bool CalculateGridRepulsiveForces(const NodeArrays& positions, const vector<double>& masses,
+                                  NodeArrays& nodeChanges, double cutoff,
+                                  const LayoutDeadline& deadline) {
+    return RepelThroughGrid(positions, masses.data(), nodeChanges, cutoff, deadline);
+}
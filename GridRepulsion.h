@@ -0,0 +1,161 @@
+/*************************************************************************
+ * File: GridRepulsion.h
+ *
+ * A header file defining the "grid variant" of the Fruchterman-Reingold
+ * repulsive forces.  Instead of letting every pair of nodes repel, only
+ * nodes closer together than a cutoff distance repel each other.  The
+ * nodes are bucketed into square cells as wide as the cutoff, so each
+ * node only needs to be compared against the nodes in its own cell and
+ * the eight cells around it.  On sparse graphs, where each node has a
+ * bounded number of neighbours within the cutoff, an iteration takes
+ * close to linear time.
+ *
+ * The cells are found through a hash table rather than a dense array, so
+ * the memory used does not depend on how far apart the nodes drift.
+ */
+
+#ifndef GridRepulsion_Included // Include guard
+#define GridRepulsion_Included
+
+#include <cmath>
+#include <climits>
+#include "NodeArrays.h"   // For the NodeArrays type.
+#include "LayoutBudget.h" // For the LayoutDeadline type.
+
+/* Default cutoff, twice the rest length of an edge under kRepel and kAttract. */
+const double kDefaultRepulsionCutoff = 2.0;
+
+/**
+ * Type: GridCell
+ * -----------------------------------------------------------------------
+ * A square cell of a grid, numbered from the origin in each direction.
+ */
+struct GridCell {
+    long x, y;
+};
+
+/**
+ * Type: NodeGrid
+ * -----------------------------------------------------------------------
+ * Some of the nodes, bucketed by the hash of their cell in a table of
+ * mask + 1 buckets, a power of two.  The nodes of bucket b are
+ * sortedNodes[bucketStarts[b]] up to, but not including,
+ * sortedNodes[bucketStarts[b + 1]], and cells[k] is the cell of
+ * sortedNodes[k].  Several cells can share a bucket, so a scan of one
+ * cell skips the entries whose cell differs.
+ */
+struct NodeGrid {
+    double cellSize;
+    size_t mask;
+    vector<size_t> bucketStarts;
+    vector<size_t> sortedNodes;
+    vector<GridCell> cells;
+};
+
+/* The largest cell number in either direction, with room for a neighbour past it. */
+const double kMaximumGridCell = (double) (LONG_MAX / 2);
+
+/**
+ * Function: FindGridCellNumber(double coordinate, double cellSize)
+ * -----------------------------------------------------------------------
+ * Returns the number of the cell of side cellSize that holds the
+ * coordinate.  A coordinate too far out for a long, such as one left by
+ * a diverged step, and one that is not a number, are clamped to the
+ * outermost cells, so that the conversion is always defined.
+ */
+inline long FindGridCellNumber(double coordinate, double cellSize) {
+    double cell = floor(coordinate / cellSize);
+    if (!(cell > -kMaximumGridCell)) return (long) -kMaximumGridCell;
+    if (!(cell < kMaximumGridCell)) return (long) kMaximumGridCell;
+    return (long) cell;
+}
+
+/**
+ * Function: FindGridCell(double x, double y, double cellSize)
+ * -----------------------------------------------------------------------
+ * Returns the cell of side cellSize that holds the point (x, y).
+ */
+inline GridCell FindGridCell(double x, double y, double cellSize) {
+    GridCell cell;
+    cell.x = FindGridCellNumber(x, cellSize);
+    cell.y = FindGridCellNumber(y, cellSize);
+    return cell;
+}
+
+/**
+ * Function: HashGridCell(long x, long y, size_t mask)
+ * -----------------------------------------------------------------------
+ * Returns the bucket of the cell (x, y) in a table of mask + 1 buckets.
+ */
+inline size_t HashGridCell(long x, long y, size_t mask) {
+    unsigned long hash = (unsigned long) x * 73856093UL ^ (unsigned long) y * 19349663UL;
+    return (size_t) hash & mask;
+}
+
+/**
+ * Function: BuildNodeGrid(const NodeArrays& positions,
+ *                         const vector<size_t>& nodes,
+ *                         double cellSize, NodeGrid& grid)
+ * -----------------------------------------------------------------------
+ * Counting-sorts the given nodes into grid by the hash of their cells of
+ * side cellSize, in a table with at least one bucket per node.  Takes
+ * time in proportion to the number of nodes given, not the size of the
+ * graph.
+ */
+void BuildNodeGrid(const NodeArrays& positions, const vector<size_t>& nodes, double cellSize,
+                   NodeGrid& grid);
+
+/**
+ * Function: CalculateGridRepulsiveForces(const NodeArrays& positions,
+ *                                        NodeArrays& nodeChanges,
+ *                                        double cutoff)
+ * -----------------------------------------------------------------------
+ * Adds the repulsive force between every pair of nodes closer together
+ * than cutoff into nodeChanges.  Pairs farther apart are ignored.
+ */
+void CalculateGridRepulsiveForces(const NodeArrays& positions, NodeArrays& nodeChanges,
+                                  double cutoff);
+
+/**
+ * Function: CalculateGridRepulsiveForces(const NodeArrays& positions,
+ *                                        NodeArrays& nodeChanges,
+ *                                        double cutoff,
+ *                                        const LayoutDeadline& deadline)
+ * -----------------------------------------------------------------------
+ * The same, except that the deadline is checked after the scans for
+ * every kDeadlineCheckNodes nodes, or sooner once they have visited
+ * kDeadlineCheckPairs candidates, since nodes crowded into a few cells
+ * make a scan cost as much as all pairs.  Returns true if every node was
+ * done, and false if the deadline stopped the pass, in which case
+ * nodeChanges holds only part of the forces.
+ */
+bool CalculateGridRepulsiveForces(const NodeArrays& positions, NodeArrays& nodeChanges,
+                                  double cutoff, const LayoutDeadline& deadline);
+
+/**
+ * Function: CalculateGridRepulsiveForces(const NodeArrays& positions,
+ *                                        const vector<double>& masses,
+ *                                        NodeArrays& nodeChanges,
+ *                                        double cutoff)
+ * -----------------------------------------------------------------------
+ * The same, with the force between two nodes scaled by the product of
+ * their masses.
+ */
+void CalculateGridRepulsiveForces(const NodeArrays& positions, const vector<double>& masses,
+                                  NodeArrays& nodeChanges, double cutoff);
+
+/**
+ * Function: CalculateGridRepulsiveForces(const NodeArrays& positions,
+ *                                        const vector<double>& masses,
+ *                                        NodeArrays& nodeChanges,
+ *                                        double cutoff,
+ *                                        const LayoutDeadline& deadline)
+ * -----------------------------------------------------------------------
+ * The same, weighted by the masses, stopping as the unweighted version
+ * does once the deadline has passed.
+ */
+bool CalculateGridRepulsiveForces(const NodeArrays& positions, const vector<double>& masses,
+                                  NodeArrays& nodeChanges, double cutoff,
+                                  const LayoutDeadline& deadline);
+
+#endif
@@ -0,0 +1,474 @@
+/******************************************************
+ * File: IncrementalLayout.cpp
+ *
+ * Implementation of the IncrementalLayout.h interface.
+ * The held nodes do not move during a relayout, so they
+ * are bucketed into a NodeGrid of cutoff-sized cells
+ * once, and their push beyond the cutoff is summed
+ * once.  The active nodes push each other from where
+ * they are, pair by pair, every iteration.
+ */
+
+#include <cmath>
+#include <algorithm>
+#include "IncrementalLayout.h"
+#include "Adjacency.h"
+#include "ForceLayout.h"
+#include "GridRepulsion.h"
+#include "LayoutGeometry.h"
+using namespace std;
+
+/* How far from its neighbours a new node is first placed, in edge lengths. */
+const double kPlacementDistance = 0.5;
+
+/*
+ * DefaultIncrementalOptions
+ * Returns the default parameters.
+ */
+IncrementalOptions DefaultIncrementalOptions() {
+    IncrementalOptions options;
+    options.radius = kDefaultRelayoutRadius;
+    options.cutoff = kDefaultRelayoutCutoff;
+    options.step = kDefaultRelayoutStep;
+    options.cooling = kDefaultRelayoutCooling;
+    options.tolerance = kDefaultRelayoutTolerance;
+    options.maximumIterations = kDefaultRelayoutIterations;
+    return options;
+}
+
+/*
+ * InitializeIncrementalState
+ * Clears every flag.
+ */
+IncrementalState InitializeIncrementalState(const SimpleGraph& graph) {
+    IncrementalState state;
+    state.touched.assign(graph.nodes.size(), false);
+    state.unplaced.assign(graph.nodes.size(), false);
+    state.pinned.assign(graph.nodes.size(), false);
+    return state;
+}
+
+/*
+ * AddNode
+ * Appends a node at the origin, flagged so that the
+ * relayout places it properly.
+ */
+size_t AddNode(SimpleGraph& graph, IncrementalState& state) {
+    Node node = {0, 0};
+    graph.nodes.push_back(node);
+    state.touched.push_back(true);
+    state.unplaced.push_back(true);
+    state.pinned.push_back(false);
+    return graph.nodes.size() - 1;
+}
+
+/*
+ * RemoveNode
+ * Drops the node's edges, touching the other ends, then
+ * moves the last node into the gap and renames it in
+ * the remaining edges.
+ */
+void RemoveNode(SimpleGraph& graph, IncrementalState& state, size_t node) {
+    size_t last = graph.nodes.size() - 1;
+    size_t kept = 0;
+    for (size_t edgeIndex = 0; edgeIndex < graph.edges.size(); edgeIndex++) {
+        Edge edge = graph.edges[edgeIndex];
+        if (edge.start == node || edge.end == node) {
+            state.touched[edge.start == node ? edge.end : edge.start] = true;
+            continue;
+        }
+        if (edge.start == last) edge.start = node;
+        if (edge.end == last) edge.end = node;
+        graph.edges[kept++] = edge;
+    }
+    graph.edges.resize(kept);
+
+    graph.nodes[node] = graph.nodes[last];
+    state.touched[node] = state.touched[last];
+    state.unplaced[node] = state.unplaced[last];
+    state.pinned[node] = state.pinned[last];
+    graph.nodes.pop_back();
+    state.touched.pop_back();
+    state.unplaced.pop_back();
+    state.pinned.pop_back();
+}
+
+/*
+ * AddEdge
+ * Appends the edge and touches both ends.
+ */
+void AddEdge(SimpleGraph& graph, IncrementalState& state, size_t start, size_t end) {
+    Edge edge = {start, end};
+    graph.edges.push_back(edge);
+    state.touched[start] = true;
+    state.touched[end] = true;
+}
+
+/*
+ * RemoveEdge
+ * Finds the first matching edge and erases it.
+ */
+bool RemoveEdge(SimpleGraph& graph, IncrementalState& state, size_t start, size_t end) {
+    for (size_t edgeIndex = 0; edgeIndex < graph.edges.size(); edgeIndex++) {
+        const Edge& edge = graph.edges[edgeIndex];
+        if ((edge.start == start && edge.end == end) || (edge.start == end && edge.end == start)) {
+            graph.edges.erase(graph.edges.begin() + edgeIndex);
+            state.touched[start] = true;
+            state.touched[end] = true;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * PinNode
+ * Sets the node's pin.
+ */
+void PinNode(IncrementalState& state, size_t node, bool pinned) {
+    state.pinned[node] = pinned;
+}
+
+/*
+ * MeanNodeSpacing
+ * Returns the side of the square each node would have
+ * if the bounding box of the layout were shared out
+ * evenly, or one if the box is empty.
+ */
+static double MeanNodeSpacing(const NodeArrays& positions) {
+    size_t numberOfNodes = positions.size();
+    if (numberOfNodes == 0) return 1;
+    double minimumX = positions.x[0], maximumX = positions.x[0];
+    double minimumY = positions.y[0], maximumY = positions.y[0];
+    for (size_t node = 1; node < numberOfNodes; node++) {
+        minimumX = min(minimumX, positions.x[node]);
+        maximumX = max(maximumX, positions.x[node]);
+        minimumY = min(minimumY, positions.y[node]);
+        maximumY = max(maximumY, positions.y[node]);
+    }
+    double area = (maximumX - minimumX) * (maximumY - minimumY);
+    return area == 0 ? 1 : sqrt(area / numberOfNodes);
+}
+
+/*
+ * PlaceNewNodes
+ * Puts each new node a little way from the mean of its
+ * placed neighbours, repeating so that chains of new
+ * nodes grow out from the old layout.  New nodes with no
+ * placed neighbour at all go next to the centre of the
+ * layout.  Successive nodes are turned by the golden
+ * angle so that no two land on the same spot.
+ */
+static void PlaceNewNodes(NodeArrays& positions, const Adjacency& adjacency,
+                          double edgeLength, vector<bool>& unplaced) {
+    double distance = kPlacementDistance * edgeLength;
+    size_t numberOfNodes = positions.size();
+    double centreX = 0, centreY = 0;
+    size_t placed = 0;
+    for (size_t node = 0; node < numberOfNodes; node++) {
+        if (unplaced[node]) continue;
+        centreX += positions.x[node];
+        centreY += positions.y[node];
+        placed++;
+    }
+    if (placed > 0) {
+        centreX /= placed;
+        centreY /= placed;
+    }
+
+    bool progress = true;
+    while (progress) {
+        progress = false;
+        for (size_t node = 0; node < numberOfNodes; node++) {
+            if (!unplaced[node]) continue;
+            double sumX = 0, sumY = 0;
+            size_t count = 0;
+            for (size_t k = adjacency.offsets[node]; k < adjacency.offsets[node + 1]; k++) {
+                size_t neighbour = adjacency.targets[k];
+                if (unplaced[neighbour]) continue;
+                sumX += positions.x[neighbour];
+                sumY += positions.y[neighbour];
+                count++;
+            }
+            if (count == 0) continue;
+            double angle = kGoldenAngle * node;
+            positions.x[node] = sumX / count + distance * cos(angle);
+            positions.y[node] = sumY / count + distance * sin(angle);
+            unplaced[node] = false;
+            progress = true;
+        }
+    }
+
+    for (size_t node = 0; node < numberOfNodes; node++) {
+        if (!unplaced[node]) continue;
+        double angle = kGoldenAngle * node;
+        positions.x[node] = centreX + distance * cos(angle);
+        positions.y[node] = centreY + distance * sin(angle);
+        unplaced[node] = false;
+    }
+}
+
+/*
+ * FindActiveNodes
+ * Searches breadth first from every touched node, out to
+ * radius edges, and returns the unpinned nodes reached.
+ * active is set for each of them.
+ */
+static vector<size_t> FindActiveNodes(const Adjacency& adjacency, const IncrementalState& state,
+                                      size_t radius, vector<bool>& active) {
+    size_t numberOfNodes = adjacency.size();
+    vector<size_t> depth(numberOfNodes, radius + 1);
+    vector<size_t> queue;
+    for (size_t node = 0; node < numberOfNodes; node++) {
+        if (!state.touched[node]) continue;
+        depth[node] = 0;
+        queue.push_back(node);
+    }
+    for (size_t head = 0; head < queue.size(); head++) {
+        size_t node = queue[head];
+        if (depth[node] == radius) continue;
+        for (size_t k = adjacency.offsets[node]; k < adjacency.offsets[node + 1]; k++) {
+            size_t neighbour = adjacency.targets[k];
+            if (depth[neighbour] <= radius) continue;
+            depth[neighbour] = depth[node] + 1;
+            queue.push_back(neighbour);
+        }
+    }
+
+    vector<size_t> activeNodes;
+    active.assign(numberOfNodes, false);
+    for (size_t i = 0; i < queue.size(); i++) {
+        if (state.pinned[queue[i]]) continue;
+        active[queue[i]] = true;
+        activeNodes.push_back(queue[i]);
+    }
+    return activeNodes;
+}
+
+/*
+ * AddRepulsion
+ * Adds scale times the push of the node at (x1, y1) on
+ * the node at (x0, y0), in units of kRepel.
+ */
+static void AddRepulsion(double x0, double y0, double x1, double y1, double scale,
+                         double& forceX, double& forceY) {
+    double dx = x0 - x1;
+    double dy = y0 - y1;
+    double distanceSquared = dx * dx + dy * dy;
+    if (distanceSquared == 0) return;
+    double distance = sqrt(distanceSquared);
+    double fRepel = scale * CalculateFRepel(distance) / kRepel;
+    forceX += fRepel * dx / distance;
+    forceY += fRepel * dy / distance;
+}
+
+/*
+ * SquaredDistance
+ * Returns the squared distance between two points.
+ */
+static double SquaredDistance(double x0, double y0, double x1, double y1) {
+    return (x0 - x1) * (x0 - x1) + (y0 - y1) * (y0 - y1);
+}
+
+/*
+ * AddHeldRepulsion
+ * Adds the push of the held nodes on an active node now
+ * at (x0, y0) that started at (startX, startY), on top
+ * of its far field.  A held node is near if it is within
+ * the cutoff now, and then pushes from where the active
+ * node is.  The far field counted the held nodes beyond
+ * the cutoff of the start, at the start, so a node near
+ * now but not then has that frozen push taken back out,
+ * and a node near then but not now, which the far field
+ * left out, pushes from where the active node is.  Both
+ * kinds lie in the nine cells around one of the points.
+ */
+static void AddHeldRepulsion(double x0, double y0, double startX, double startY,
+                             const NodeArrays& positions, const NodeGrid& grid,
+                             double& forceX, double& forceY) {
+    double cutoffSquared = grid.cellSize * grid.cellSize;
+    for (int pass = 0; pass < 2; pass++) {
+        GridCell cell = pass == 0 ? FindGridCell(x0, y0, grid.cellSize) :
+                                    FindGridCell(startX, startY, grid.cellSize);
+        for (long dy = -1; dy <= 1; dy++) {
+            for (long dx = -1; dx <= 1; dx++) {
+                size_t bucket = HashGridCell(cell.x + dx, cell.y + dy, grid.mask);
+                size_t bucketEnd = grid.bucketStarts[bucket + 1];
+                for (size_t k = grid.bucketStarts[bucket]; k < bucketEnd; k++) {
+                    if (grid.cells[k].x != cell.x + dx || grid.cells[k].y != cell.y + dy) {
+                        continue;
+                    }
+                    double x1 = positions.x[grid.sortedNodes[k]];
+                    double y1 = positions.y[grid.sortedNodes[k]];
+                    bool nearNow = SquaredDistance(x0, y0, x1, y1) < cutoffSquared;
+                    bool nearThen = SquaredDistance(startX, startY, x1, y1) < cutoffSquared;
+                    if (pass == 0 && nearNow) {
+                        AddRepulsion(x0, y0, x1, y1, 1, forceX, forceY);
+                        if (!nearThen) AddRepulsion(startX, startY, x1, y1, -1, forceX, forceY);
+                    } else if (pass == 1 && nearThen && !nearNow) {
+                        AddRepulsion(x0, y0, x1, y1, 1, forceX, forceY);
+                    }
+                }
+            }
+        }
+    }
+}
+
+/*
+ * CalculateFarField
+ * Returns the push on each active node of every held
+ * node at least the cutoff away from where the active
+ * node starts.  The held nodes do not move and the
+ * active ones do not move far, so this is computed once
+ * per relayout and kept; without it, the layout around
+ * the edit would shrink inwards, no longer balanced by
+ * the repulsion of the rest of the graph.  This is the
+ * one pass over the whole graph for each active node.
+ */
+static void CalculateFarField(const NodeArrays& positions, const vector<size_t>& activeNodes,
+                              const vector<size_t>& heldNodes, double cutoff,
+                              NodeArrays& farField) {
+    ResizeNodeArrays(farField, activeNodes.size());
+    ClearNodeArrays(farField);
+    double cutoffSquared = cutoff * cutoff;
+    for (size_t i = 0; i < activeNodes.size(); i++) {
+        double x0 = positions.x[activeNodes[i]];
+        double y0 = positions.y[activeNodes[i]];
+        double forceX = 0, forceY = 0;
+        for (size_t k = 0; k < heldNodes.size(); k++) {
+            double x1 = positions.x[heldNodes[k]];
+            double y1 = positions.y[heldNodes[k]];
+            if (SquaredDistance(x0, y0, x1, y1) < cutoffSquared) continue;
+            AddRepulsion(x0, y0, x1, y1, 1, forceX, forceY);
+        }
+        farField.x[i] = forceX;
+        farField.y[i] = forceY;
+    }
+}
+
+/*
+ * CalculateActiveForce
+ * Returns the force on the active node activeNodes[i]:
+ * its far field and the near push of the held nodes,
+ * the push of every other active node where it is now,
+ * and the pull of its neighbours.  The forces are
+ * divided by kRepel, so that they are in the same units
+ * as the step length.
+ */
+static void CalculateActiveForce(size_t i, const NodeArrays& positions,
+                                 const Adjacency& adjacency, const vector<size_t>& activeNodes,
+                                 const NodeGrid& heldGrid, const NodeArrays& farField,
+                                 double startX, double startY, double& forceX, double& forceY) {
+    size_t node = activeNodes[i];
+    double x0 = positions.x[node];
+    double y0 = positions.y[node];
+    forceX = farField.x[i];
+    forceY = farField.y[i];
+    AddHeldRepulsion(x0, y0, startX, startY, positions, heldGrid, forceX, forceY);
+    for (size_t j = 0; j < activeNodes.size(); j++) {
+        if (j == i) continue;
+        AddRepulsion(x0, y0, positions.x[activeNodes[j]], positions.y[activeNodes[j]], 1,
+                     forceX, forceY);
+    }
+
+    for (size_t k = adjacency.offsets[node]; k < adjacency.offsets[node + 1]; k++) {
+        size_t neighbour = adjacency.targets[k];
+        double dx = positions.x[neighbour] - x0;
+        double dy = positions.y[neighbour] - y0;
+        double distance = sqrt(dx * dx + dy * dy);
+        if (distance == 0) continue;
+        double fAttract = CalculateFAttract(distance) / kRepel;
+        forceX += fAttract * dx / distance;
+        forceY += fAttract * dy / distance;
+    }
+}
+
+/*
+ * IncrementalRelayout
+ * Measures the steps in mean edge lengths of the layout
+ * as it stands, since a large graph stretches its edges
+ * well beyond their rest length, and the cutoff in mean
+ * node spacings.  Then moves each moving node along its
+ * force, at most its own step length.  Every step
+ * cools, and a node that overshoots, so that its force
+ * turns back, has its step halved as well; a node near
+ * its resting place thus settles in a few iterations
+ * however far others still have to go.  A node that
+ * moves less than the tolerance stops for the rest of
+ * the relayout.  The nodes are moved one at a time,
+ * each seeing the latest positions of the others.
+ */
+IncrementalResult IncrementalRelayout(SimpleGraph& graph, IncrementalState& state,
+                                      const IncrementalOptions& options) {
+    Adjacency adjacency;
+    BuildAdjacency(graph.nodes.size(), graph.edges, adjacency);
+    NodeArrays positions;
+    LoadNodeArrays(graph.nodes, positions);
+    double edgeLength = MeanEdgeLength(positions, adjacency, state.unplaced);
+    PlaceNewNodes(positions, adjacency, edgeLength, state.unplaced);
+
+    IncrementalResult result;
+    vector<bool> active;
+    vector<size_t> activeNodes = FindActiveNodes(adjacency, state, options.radius, active);
+    result.activeNodes = activeNodes.size();
+    result.iterations = 0;
+    result.maximumDisplacement = 0;
+    state.touched.assign(graph.nodes.size(), false);
+
+    double cutoff = options.cutoff * MeanNodeSpacing(positions);
+    vector<size_t> heldNodes;
+    for (size_t node = 0; node < graph.nodes.size(); node++) {
+        if (!active[node]) heldNodes.push_back(node);
+    }
+    NodeGrid heldGrid;
+    BuildNodeGrid(positions, heldNodes, cutoff, heldGrid);
+    NodeArrays farField;
+    CalculateFarField(positions, activeNodes, heldNodes, cutoff, farField);
+    vector<double> startX(activeNodes.size()), startY(activeNodes.size());
+    for (size_t i = 0; i < activeNodes.size(); i++) {
+        startX[i] = positions.x[activeNodes[i]];
+        startY[i] = positions.y[activeNodes[i]];
+    }
+
+    //Moving nodes are kept by their index in activeNodes
+    vector<size_t> movingNodes(activeNodes.size());
+    for (size_t i = 0; i < activeNodes.size(); i++) movingNodes[i] = i;
+    vector<double> steps(activeNodes.size(), options.step * edgeLength);
+    vector<double> lastX(activeNodes.size(), 0), lastY(activeNodes.size(), 0);
+    double tolerance = options.tolerance * edgeLength;
+    while (!movingNodes.empty() && result.iterations < options.maximumIterations) {
+        size_t stillMoving = 0;
+        for (size_t k = 0; k < movingNodes.size(); k++) {
+            size_t i = movingNodes[k];
+            size_t node = activeNodes[i];
+            double forceX, forceY;
+            CalculateActiveForce(i, positions, adjacency, activeNodes, heldGrid, farField,
+                                 startX[i], startY[i], forceX, forceY);
+            double force = sqrt(forceX * forceX + forceY * forceY);
+            if (force == 0) continue;
+            forceX /= force;
+            forceY /= force;
+
+            //A node whose force turned back has overshot, so its step halves
+            if (forceX * lastX[i] + forceY * lastY[i] < 0) steps[i] *= 0.5;
+            double move = min(force, steps[i]);
+            positions.x[node] += move * forceX;
+            positions.y[node] += move * forceY;
+            lastX[i] = forceX;
+            lastY[i] = forceY;
+            steps[i] *= options.cooling;
+            if (move >= tolerance) movingNodes[stillMoving++] = i;
+        }
+        movingNodes.resize(stillMoving);
+        result.iterations++;
+    }
+
+    for (size_t i = 0; i < activeNodes.size(); i++) {
+        double dx = positions.x[activeNodes[i]] - startX[i];
+        double dy = positions.y[activeNodes[i]] - startY[i];
+        result.maximumDisplacement = max(result.maximumDisplacement, sqrt(dx * dx + dy * dy));
+    }
+    result.maximumDisplacement /= edgeLength;
+    StoreNodeArrays(positions, graph.nodes);
+    return result;
+}
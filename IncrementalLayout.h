@@ -0,0 +1,165 @@
+/*************************************************************************
+ * File: IncrementalLayout.h
+ *
+ * A header file defining edits to a graph that has already been laid
+ * out, and a relayout that only moves the nodes near the edits.  Laying
+ * the whole graph out again from the unit circle after every change is
+ * slow, and it throws away the picture the user has learned: nodes far
+ * from the change end up somewhere else entirely.
+ *
+ * The edit functions change a SimpleGraph in place and record in an
+ * IncrementalState which nodes they touched.  IncrementalRelayout() then
+ * places any new nodes next to their neighbours and runs the
+ * Fruchterman-Reingold forces on the nodes within a few edges of the
+ * touched ones, with every other node held still.  Held nodes still
+ * repel and attract the moving ones.  The repulsion of every held node
+ * beyond a fixed cutoff is summed once, when the relayout starts, at a
+ * cost in proportion to the number of nodes that may move times the
+ * size of the graph.  After that, each moving node looks up the held
+ * nodes within the cutoff in a grid, and is pushed by every other node
+ * that may move from where it is now, so an iteration costs time in
+ * proportion to the number of moving nodes times their near held
+ * neighbours plus the square of the number of nodes that may move.
+ *
+ * The step length cools from iteration to iteration.  A node stops as
+ * soon as a step moves it less than a tolerance, and the relayout ends
+ * once no node is left moving, so an edit that barely changes the
+ * forces costs almost nothing.  Nodes can also be pinned, so that no
+ * relayout ever moves them.
+ */
+
+#ifndef IncrementalLayout_Included // Include guard
+#define IncrementalLayout_Included
+
+#include "SimpleGraph.h" // For the SimpleGraph type.
+
+/* Default parameters of the relayout.  The cutoff is in mean node spacings,
+ * and the other distances are in mean edge lengths. */
+const size_t kDefaultRelayoutRadius = 2;
+const double kDefaultRelayoutCutoff = 3.0;
+const double kDefaultRelayoutStep = 0.5;
+const double kDefaultRelayoutCooling = 0.95;
+const double kDefaultRelayoutTolerance = 1e-3;
+const size_t kDefaultRelayoutIterations = 200;
+
+/**
+ * Type: IncrementalState
+ * -----------------------------------------------------------------------
+ * What the edits have done since the last relayout, with one entry per
+ * node.  touched marks the nodes whose edges changed, unplaced the nodes
+ * added since the last relayout, and pinned the nodes no relayout may
+ * move.  The edit functions keep the vectors the same size as the
+ * graph.
+ */
+struct IncrementalState {
+    vector<bool> touched;
+    vector<bool> unplaced;
+    vector<bool> pinned;
+};
+
+/**
+ * Type: IncrementalOptions
+ * -----------------------------------------------------------------------
+ * Parameters of the relayout, with distances relative to the mean edge
+ * length of the layout.  The nodes within radius edges of a touched node
+ * may move.  A held node farther than cutoff from a moving one repels it
+ * with the force it had when the relayout started; the cutoff is
+ * measured in mean node spacings instead, the side of the square each
+ * node would have if the layout's bounding box were shared out evenly,
+ * since the hubs of a scale-free graph stretch its edges across much of
+ * the layout.  Each node's first step is at most step long, and the
+ * limit shrinks by the factor cooling every iteration.  A node stops
+ * once it moves less than tolerance in a step, and the relayout stops
+ * after maximumIterations in any case.
+ */
+struct IncrementalOptions {
+    size_t radius;
+    double cutoff;
+    double step;
+    double cooling;
+    double tolerance;
+    size_t maximumIterations;
+};
+
+/**
+ * Type: IncrementalResult
+ * -----------------------------------------------------------------------
+ * What one relayout did: the number of nodes that were allowed to move,
+ * the number of iterations run, and the largest distance any node ended
+ * up from where it started, in mean edge lengths.
+ */
+struct IncrementalResult {
+    size_t activeNodes;
+    size_t iterations;
+    double maximumDisplacement;
+};
+
+/**
+ * Function: DefaultIncrementalOptions()
+ * -----------------------------------------------------------------------
+ * Returns the default parameters.
+ */
+IncrementalOptions DefaultIncrementalOptions();
+
+/**
+ * Function: InitializeIncrementalState(const SimpleGraph& graph)
+ * -----------------------------------------------------------------------
+ * Returns a state for a graph that has been laid out, with nothing
+ * touched and nothing pinned.
+ */
+IncrementalState InitializeIncrementalState(const SimpleGraph& graph);
+
+/**
+ * Function: AddNode(SimpleGraph& graph, IncrementalState& state)
+ * -----------------------------------------------------------------------
+ * Adds a node with no edges and returns its index.  It is placed by the
+ * next relayout, next to whatever neighbours it has been given by then.
+ */
+size_t AddNode(SimpleGraph& graph, IncrementalState& state);
+
+/**
+ * Function: RemoveNode(SimpleGraph& graph, IncrementalState& state,
+ *                      size_t node)
+ * -----------------------------------------------------------------------
+ * Removes the node and every edge touching it, and marks its neighbours
+ * as touched.  To keep the indices dense, the last node takes the
+ * removed node's index; edges and the state are renumbered to match.
+ */
+void RemoveNode(SimpleGraph& graph, IncrementalState& state, size_t node);
+
+/**
+ * Function: AddEdge(SimpleGraph& graph, IncrementalState& state,
+ *                   size_t start, size_t end)
+ * -----------------------------------------------------------------------
+ * Adds an edge between two existing nodes and marks both as touched.
+ */
+void AddEdge(SimpleGraph& graph, IncrementalState& state, size_t start, size_t end);
+
+/**
+ * Function: RemoveEdge(SimpleGraph& graph, IncrementalState& state,
+ *                      size_t start, size_t end)
+ * -----------------------------------------------------------------------
+ * Removes one edge between the two nodes, in either direction, marking
+ * both as touched.  Returns false if there was no such edge.
+ */
+bool RemoveEdge(SimpleGraph& graph, IncrementalState& state, size_t start, size_t end);
+
+/**
+ * Function: PinNode(IncrementalState& state, size_t node, bool pinned)
+ * -----------------------------------------------------------------------
+ * Pins the node where it is, or releases it.
+ */
+void PinNode(IncrementalState& state, size_t node, bool pinned);
+
+/**
+ * Function: IncrementalRelayout(SimpleGraph& graph,
+ *                               IncrementalState& state,
+ *                               const IncrementalOptions& options)
+ * -----------------------------------------------------------------------
+ * Places the new nodes, then moves the unpinned nodes near the touched
+ * ones until they settle.  Afterwards nothing is touched or unplaced.
+ */
+IncrementalResult IncrementalRelayout(SimpleGraph& graph, IncrementalState& state,
+                                      const IncrementalOptions& options);
+
+#endif
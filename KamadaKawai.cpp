@@ -0,0 +1,238 @@
+/******************************************************
+ * File: KamadaKawai.cpp
+ *
+ * Implementation of the KamadaKawai.h interface.  The
+ * gradient of every node is stored, as the sum of the
+ * forces of its springs.  Moving a node changes one
+ * spring of every other node, so after each step the
+ * old force of that spring is taken away from the
+ * other node's gradient and the new one added, and
+ * only the moved node's own gradient is summed afresh.
+ */
+
+#include <cmath>
+#include "KamadaKawai.h"
+#include "GraphDistances.h"
+using namespace std;
+
+/* Newton-Raphson steps applied to one node before choosing again. */
+const size_t kMaximumStepsPerNode = 20;
+
+/* The distances, and the stiffness of a spring of each length. */
+struct KamadaKawaiState {
+    GraphDistances distances;
+    vector<double> stiffness;  // stiffness[d] is 1 / d^2
+    vector<double> x, y;
+    vector<double> gradientX, gradientY;
+};
+
+/*
+ * DefaultKamadaKawaiOptions
+ * Returns the default parameters.
+ */
+KamadaKawaiOptions DefaultKamadaKawaiOptions() {
+    KamadaKawaiOptions options;
+    options.maximumIterations = kDefaultKamadaKawaiIterations;
+    options.tolerance = kDefaultKamadaKawaiTolerance;
+    options.numberOfThreads = 0;
+    return options;
+}
+
+/*
+ * SpringForce
+ * Stores in forceX and forceY the gradient, with respect
+ * to the first node, of the energy of the spring between
+ * two nodes at offset (dx, dy).  Coincident nodes exert
+ * no force, having no direction to push in.
+ */
+static void SpringForce(const KamadaKawaiState& state, unsigned short distance,
+                        double dx, double dy, double& forceX, double& forceY) {
+    double length = sqrt(dx * dx + dy * dy);
+    if (length == 0) {
+        forceX = forceY = 0;
+        return;
+    }
+    double scale = state.stiffness[distance] * (1 - distance / length);
+    forceX = scale * dx;
+    forceY = scale * dy;
+}
+
+/*
+ * CalculateGradient
+ * Sums the forces of all of one node's springs.
+ */
+static void CalculateGradient(KamadaKawaiState& state, size_t node) {
+    double sumX = 0, sumY = 0;
+    for (size_t other = 0; other < state.x.size(); other++) {
+        if (other == node) continue;
+        double forceX, forceY;
+        SpringForce(state, GraphDistance(state.distances, node, other),
+                    state.x[node] - state.x[other], state.y[node] - state.y[other],
+                    forceX, forceY);
+        sumX += forceX;
+        sumY += forceY;
+    }
+    state.gradientX[node] = sumX;
+    state.gradientY[node] = sumY;
+}
+
+/*
+ * NewtonStep
+ * Moves one node to the minimum of the quadratic that
+ * matches its energy to second order, with the other
+ * nodes held fixed, and brings every gradient up to
+ * date.  Springs squeezed below their rest length can
+ * make that quadratic a saddle, whose stationary point
+ * the node would circle forever; the step then uses the
+ * sum of the stiffnesses, which bounds the curvature of
+ * the stretched springs, in place of the Hessian.
+ * Returns false, without moving, if nothing can be
+ * solved for.
+ */
+static bool NewtonStep(KamadaKawaiState& state, size_t node) {
+    size_t numberOfNodes = state.x.size();
+    double xx = 0, xy = 0, yy = 0, totalStiffness = 0;
+    for (size_t other = 0; other < numberOfNodes; other++) {
+        if (other == node) continue;
+        double dx = state.x[node] - state.x[other];
+        double dy = state.y[node] - state.y[other];
+        double lengthSquared = dx * dx + dy * dy;
+        if (lengthSquared == 0) continue;
+        unsigned short distance = GraphDistance(state.distances, node, other);
+        double stiffness = state.stiffness[distance];
+        totalStiffness += stiffness;
+        double scale = distance / (lengthSquared * sqrt(lengthSquared));
+        xx += stiffness * (1 - scale * dy * dy);
+        yy += stiffness * (1 - scale * dx * dx);
+        xy += stiffness * scale * dx * dy;
+    }
+    double determinant = xx * yy - xy * xy;
+    if (!isfinite(determinant)) return false;
+    double stepX, stepY;
+    if (xx > 0 && determinant > 0) {
+        stepX = (xy * state.gradientY[node] - yy * state.gradientX[node]) / determinant;
+        stepY = (xy * state.gradientX[node] - xx * state.gradientY[node]) / determinant;
+    } else {
+        if (totalStiffness == 0) return false;
+        stepX = -state.gradientX[node] / totalStiffness;
+        stepY = -state.gradientY[node] / totalStiffness;
+    }
+
+    double oldX = state.x[node], oldY = state.y[node];
+    state.x[node] += stepX;
+    state.y[node] += stepY;
+    for (size_t other = 0; other < numberOfNodes; other++) {
+        if (other == node) continue;
+        unsigned short distance = GraphDistance(state.distances, node, other);
+        double oldForceX, oldForceY, newForceX, newForceY;
+        SpringForce(state, distance, state.x[other] - oldX, state.y[other] - oldY,
+                    oldForceX, oldForceY);
+        SpringForce(state, distance, state.x[other] - state.x[node],
+                    state.y[other] - state.y[node], newForceX, newForceY);
+        state.gradientX[other] += newForceX - oldForceX;
+        state.gradientY[other] += newForceY - oldForceY;
+    }
+    CalculateGradient(state, node);
+    return true;
+}
+
+/*
+ * GradientMagnitude
+ * Returns the length of one node's gradient.
+ */
+static double GradientMagnitude(const KamadaKawaiState& state, size_t node) {
+    return sqrt(state.gradientX[node] * state.gradientX[node] +
+                state.gradientY[node] * state.gradientY[node]);
+}
+
+/*
+ * SteepestNode
+ * Returns the node with the largest gradient.
+ */
+static size_t SteepestNode(const KamadaKawaiState& state) {
+    size_t steepest = 0;
+    double largest = 0;
+    for (size_t node = 0; node < state.x.size(); node++) {
+        double magnitude = GradientMagnitude(state, node);
+        if (magnitude > largest) {
+            largest = magnitude;
+            steepest = node;
+        }
+    }
+    return steepest;
+}
+
+/*
+ * CalculateEnergy
+ * Sums the energy of every spring.
+ */
+static double CalculateEnergy(const KamadaKawaiState& state) {
+    size_t numberOfNodes = state.x.size();
+    const unsigned short* distance = state.distances.values.data();
+    double energy = 0;
+    for (size_t i = 0; i < numberOfNodes; i++) {
+        for (size_t j = i + 1; j < numberOfNodes; j++) {
+            double dx = state.x[i] - state.x[j];
+            double dy = state.y[i] - state.y[j];
+            double error = sqrt(dx * dx + dy * dy) - *distance;
+            energy += state.stiffness[*distance++] * error * error / 2;
+        }
+    }
+    return energy;
+}
+
+/*
+ * KamadaKawaiLayout
+ * Computes the distances and every node's gradient, then
+ * repeatedly takes the node with the largest gradient and
+ * steps it until its gradient is below the tolerance.
+ */
+KamadaKawaiResult KamadaKawaiLayout(SimpleGraph& graph, const KamadaKawaiOptions& options) {
+    KamadaKawaiResult result;
+    result.iterations = 0;
+    result.energy = HUGE_VAL;
+    result.maximumGradient = HUGE_VAL;
+
+    KamadaKawaiState state;
+    if (!CalculateGraphDistances(graph, state.distances, options.numberOfThreads)) return result;
+    size_t numberOfNodes = graph.nodes.size();
+    result.energy = result.maximumGradient = 0;
+    if (numberOfNodes < 2) return result;
+
+    state.stiffness.assign(state.distances.disconnectedDistance + 1, 0.0);
+    for (size_t d = 1; d < state.stiffness.size(); d++) {
+        state.stiffness[d] = 1.0 / ((double) d * d);
+    }
+    state.x.resize(numberOfNodes);
+    state.y.resize(numberOfNodes);
+    for (size_t i = 0; i < numberOfNodes; i++) {
+        state.x[i] = graph.nodes[i].x;
+        state.y[i] = graph.nodes[i].y;
+    }
+    state.gradientX.resize(numberOfNodes);
+    state.gradientY.resize(numberOfNodes);
+    for (size_t i = 0; i < numberOfNodes; i++) CalculateGradient(state, i);
+
+    while (result.iterations < options.maximumIterations) {
+        size_t node = SteepestNode(state);
+        if (GradientMagnitude(state, node) < options.tolerance) break;
+
+        //A capped number of steps, in case the node circles its minimum
+        size_t step = 0;
+        while (step < kMaximumStepsPerNode && result.iterations < options.maximumIterations) {
+            if (!NewtonStep(state, node)) break;
+            step++;
+            result.iterations++;
+            if (GradientMagnitude(state, node) < options.tolerance) break;
+        }
+        if (step == 0) break;
+    }
+
+    result.maximumGradient = GradientMagnitude(state, SteepestNode(state));
+    for (size_t i = 0; i < numberOfNodes; i++) {
+        graph.nodes[i].x = state.x[i];
+        graph.nodes[i].y = state.y[i];
+    }
+    result.energy = CalculateEnergy(state);
+    return result;
+}
@@ -0,0 +1,80 @@
+/*************************************************************************
+ * File: KamadaKawai.h
+ *
+ * A header file defining a layout engine after Kamada and Kawai, "An
+ * Algorithm for Drawing General Undirected Graphs" (1989).  Every pair
+ * of nodes is joined by a spring whose rest length is the graph
+ * distance d_ij between them and whose stiffness is 1 / d_ij^2, and the
+ * engine minimizes the total spring energy
+ *
+ *   E = sum over pairs i < j of (|x_i - x_j| - d_ij)^2 / (2 d_ij^2)
+ *
+ * one node at a time.  Each move takes the node whose energy gradient
+ * is largest and applies Newton-Raphson steps to it alone, holding the
+ * others fixed, until its own gradient vanishes.  The energy is half
+ * the stress of StressLayout.h, but the node-by-node moves suit small
+ * symmetric graphs, which they lay out with their symmetries showing.
+ *
+ * The distances are computed by CalculateGraphDistances, which runs the
+ * breadth-first searches in parallel; this is the costly step on all
+ * but the smallest graphs.  Each move then costs time proportional to
+ * the number of nodes, as the gradients of all nodes are kept up to
+ * date as the moved node's springs change.
+ */
+
+#ifndef KamadaKawai_Included // Include guard
+#define KamadaKawai_Included
+
+#include "SimpleGraph.h" // For the SimpleGraph type.
+
+/* Default parameters of the Kamada-Kawai layout. */
+const size_t kDefaultKamadaKawaiIterations = 100000;
+const double kDefaultKamadaKawaiTolerance = 1e-3;
+
+/**
+ * Type: KamadaKawaiOptions
+ * -----------------------------------------------------------------------
+ * Parameters controlling the layout.  It stops after maximumIterations
+ * Newton-Raphson steps, or once the magnitude of every node's energy
+ * gradient is below tolerance.  numberOfThreads is the number of
+ * threads computing the graph distances, with zero meaning one per core.
+ */
+struct KamadaKawaiOptions {
+    size_t maximumIterations;
+    double tolerance;
+    size_t numberOfThreads;
+};
+
+/**
+ * Type: KamadaKawaiResult
+ * -----------------------------------------------------------------------
+ * The number of Newton-Raphson steps taken, the spring energy of the
+ * final layout, and the largest magnitude of a node's energy gradient
+ * in it.
+ */
+struct KamadaKawaiResult {
+    size_t iterations;
+    double energy;
+    double maximumGradient;
+};
+
+/**
+ * Function: DefaultKamadaKawaiOptions()
+ * -----------------------------------------------------------------------
+ * Returns the default parameters, computing the distances on one thread
+ * per core.
+ */
+KamadaKawaiOptions DefaultKamadaKawaiOptions();
+
+/**
+ * Function: KamadaKawaiLayout(SimpleGraph& graph,
+ *                             const KamadaKawaiOptions& options)
+ * -----------------------------------------------------------------------
+ * Lays out the graph by the Kamada-Kawai method, starting from the
+ * nodes' current positions.  No two nodes should start at the same
+ * position.  Graphs too large for GraphDistances are left unchanged,
+ * with a result of zero iterations and infinite energy.
+ */
+KamadaKawaiResult KamadaKawaiLayout(SimpleGraph& graph, const KamadaKawaiOptions& options);
+
+#endif
@@ -0,0 +1,2106 @@
+/******************************************************
+ * File: LayoutBenchmark.cpp
+ *
+ * A command-line benchmark for the layout engine.  It
+ * does not open a window, so it can be built and run
+ * on machines without the graphics libraries:
+ *
+ *     make benchmark CCFLAGS=-O2
+ *     ./benchmark 30clique 127binary-tree 10grid
+ *
+ * For every graph file named on the command line, and
+ * for a series of random point clouds, it times one
+ * pass of each repulsion engine and reports the largest
+ * error of any node's force relative to the exact
+ * kernel.  It then compares the other engines and
+ * layout methods on the same graphs and on generated
+ * ones, as the comment on each function below says.
+ * Any check that fails makes the program exit with a
+ * nonzero status.
+ *
+ * All times are wall-clock times.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <sstream>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <algorithm>
+#include "SimpleGraph.h"
+#include "ForceLayout.h"
+#include "LayoutGeometry.h"
+#include "QuadTree.h"
+#include "FastMultipole.h"
+#include "GridRepulsion.h"
+#include "SimdRepulsion.h"
+#include "ParallelRepulsion.h"
+#include "DeterministicRepulsion.h"
+#include "LayoutBudget.h"
+#include "Parallel.h"
+#include "Multilevel.h"
+#include "AdaptiveStep.h"
+#include "StressLayout.h"
+#include "SgdLayout.h"
+#include "GraphDistances.h"
+#include "KamadaKawai.h"
+#include "PivotMds.h"
+#include "SpectralLayout.h"
+#include "PrecisionRepulsion.h"
+#include "ForceModels.h"
+#include "ForceAtlas2.h"
+#include "IncrementalLayout.h"
+#include "ComponentLayout.h"
+#include "SpatialLayout.h"
+#include "Octree.h"
+#include "OverlapRemoval.h"
+#include "EdgeBundling.h"
+using namespace std;
+
+typedef chrono::steady_clock BenchmarkClock;
+
+/* Constants */
+const size_t kWarmupIterations = 100;
+const size_t kRandomGraphSizes[] = { 1000, 4000, 16000 };
+const size_t kBenchmarkOrders[] = { 4, 8, 12, 16 };
+const size_t kTimingIterations = 1000;
+const size_t kRegressionIterations = 10;
+const double kForcePathTolerance = 1e-9;
+const double kParallelTolerance = 1e-12;
+const double kBarnesHutErrorBound = 0.02;
+const size_t kCutoffGridSizes[] = { 40, 200 };
+const size_t kCutoffIterations = 20;
+const size_t kMultilevelGridSize = 40;
+const size_t kBenchmarkPivots = 50;
+const size_t kKamadaKawaiBenchmarkNodes = 500;
+const size_t kAttractionGridSize = 300;
+const size_t kAttractionIterations = 100;
+const size_t kScaleFreeNodes = 1000;
+const size_t kScaleFreeEdgesPerNode = 2;
+const double kBarnesHutIterationFactor = 5.0;
+const double kBarnesHutStressFactor = 1.1;
+const double kStressRoundoff = 1e-9;
+const size_t kForestTrees = 40;
+const size_t kForestTreeSize = 60;
+const size_t kForestIterations = 2000;
+const double kPackingTolerance = 1e-9;
+const size_t kSpatialGraphSizes[] = { 1000, 8000, 131072 };
+const size_t kSpatialExactNodes = 8000;
+const size_t kSpatialSamples = 256;
+const size_t kSpatialIterations = 5000;
+const double kSpatialEnergyFactor = 2.0;
+const size_t kDeterministicNodes = 4000;
+const size_t kDeterministicThreads[] = { 1, 2, 3, 4, 7, 16 };
+const size_t kDeterministicTimedRuns = 3;
+const double kDeterministicMaximumSlowdown = 8.0;
+const size_t kDeterministicIterations = 500;
+const double kBudgetSeconds = 0.15;
+const double kBudgetTolerance = 0.02;
+const size_t kBudgetIterations = 10;
+const size_t kBudgetGridSize = 200;
+const size_t kOverlapGraphSizes[] = { 1000, 16000 };
+const double kOverlapDensity = 0.25;
+const size_t kBundlingThreads = 4;
+const double kBundlingTimedSeconds = 0.005;
+const size_t kModelRepulsionNodes = 4000;
+const size_t kModelRepulsionThreads = 4;
+const size_t kLongPathNodes = 70000;
+
+/* Node spacings whose squares underflow and overflow a float. */
+const double kVectorRangeSpacings[] = { 1e-25, 1e25 };
+const size_t kVectorRangeNodes = 16;
+
+/* The graph files shipped with the program, read from the working directory. */
+const char* const kBundledGraphs[] = {
+    "10clique", "10grid", "10line", "127binary-tree", "2line", "30clique", "30cycle",
+    "31binary-tree", "32wheel", "3grid", "50line", "5clique", "5grid", "60cycle",
+    "63binary-tree", "64wheel", "8wheel", "bull", "cube", "desargues", "dodecahedron",
+    "doodad-1", "doodad-2", "doodad-3", "durer", "heawood", "icosahedron", "mobius-kantor",
+    "moser-spindle", "octahedron", "petersen", "star", "tesseract", "tietze", "triangle",
+    "utility"
+};
+
+/* A repulsion of kRepel / d^2, which only the policy kernels compute. */
+struct InverseSquareForces {
+    static const bool kInverseDistanceRepulsion = false;
+    static double Repel(double distance) { return kRepel / (distance * distance); }
+    static double Attract(double distance) { return kAttract * distance * distance; }
+};
+
+/* Function prototypes */
+void PlaceOnUnitCircle(SimpleGraph& graph);
+bool LoadGraphFile(const string& fileName, SimpleGraph& graph);
+SimpleGraph CreateRandomGraph(size_t numberOfNodes);
+SimpleGraph CreateGridGraph(size_t size);
+void PlaceOnLattice(SimpleGraph& graph, size_t size);
+SimpleGraph CreateScaleFreeGraph(size_t numberOfNodes, size_t edgesPerNode);
+SimpleGraph CreateForestGraph(size_t numberOfTrees, size_t maximumTreeSize);
+SpatialArrays CreateRandomSpatialArrays(size_t numberOfNodes);
+size_t CountEdgeCrossings(const SimpleGraph& graph);
+double CalculateAreaPerNode(const SimpleGraph& graph);
+double GetSeconds(BenchmarkClock::time_point startTime);
+double MaximumRelativeError(const NodeArrays& exact, const NodeArrays& approximate);
+double LargestForceError(const NodeArrays& exact, const NodeArrays& approximate);
+void PrintResult(const string& engine, double seconds, double error);
+void BenchmarkRepulsion(const string& name, SimpleGraph& graph);
+bool CheckVectorRange();
+bool CheckBarnesHutError(const string& name, const SimpleGraph& graph);
+void BenchmarkGridCutoff(const string& name, const SimpleGraph& graph);
+bool CompareForcePaths(const string& name, const SimpleGraph& graph);
+bool BenchmarkScaling(const string& name, const SimpleGraph& graph);
+bool BenchmarkAttraction(const string& name, const SimpleGraph& graph);
+void BenchmarkInitialLayouts(const string& name, const SimpleGraph& graph);
+bool BenchmarkConvergence(const string& name, const SimpleGraph& graph);
+bool CheckBundledConvergence();
+void BenchmarkStress(const string& name, const SimpleGraph& graph);
+void BenchmarkPrecision(const string& name, const SimpleGraph& graph);
+void BenchmarkForceModels(const string& name, const SimpleGraph& graph);
+bool CheckSelfLoopAttraction(const string& name, const SimpleGraph& graph);
+bool CheckModelRepulsion(const string& name, const SimpleGraph& graph);
+bool ConvergesLikeExact(const ConvergenceState& barnesHut, const SimpleGraph& barnesHutLayout,
+                        const ConvergenceState& exact, const SimpleGraph& exactLayout);
+bool KeptOutsideEdits(const SimpleGraph& before, const SimpleGraph& after,
+                      const IncrementalState& state, size_t radius);
+bool CheckRemoveNode(const SimpleGraph& graph, size_t node);
+bool BenchmarkForceAtlas2(const string& name, const SimpleGraph& graph);
+bool BenchmarkIncremental(const string& name, const SimpleGraph& graph);
+bool PaddedBoxesApart(const SimpleGraph& graph, double padding);
+bool OnlyTranslated(const SimpleGraph& before, const SimpleGraph& after);
+bool BenchmarkComponents(const string& name, const SimpleGraph& graph);
+double SampledSpatialError(const SpatialArrays& positions, const SpatialArrays& approximate);
+bool BenchmarkSpatialRepulsion(const SpatialArrays& positions);
+bool BenchmarkSpatialLayout(const string& name, const SimpleGraph& graph);
+bool IdenticalArrays(const NodeArrays& arrays0, const NodeArrays& arrays1);
+bool BenchmarkDeterministicForces(const string& name, const SimpleGraph& graph);
+bool BenchmarkDeterministicLayout(const string& name, const SimpleGraph& graph);
+bool BenchmarkBudget(const string& name, const SimpleGraph& graph);
+bool CheckDeadlineLimits();
+bool CheckLongPathSearch();
+bool BenchmarkPassBudgets(const string& name, const SimpleGraph& graph);
+bool BenchmarkOverlap(const string& name, const SimpleGraph& graph, const OverlapOptions& options);
+bool BenchmarkBundling(const string& name, const SimpleGraph& graph);
+
+/* Functions */
+
+/*
+ * PlaceOnUnitCircle
+ * Spreads the nodes evenly around the unit circle in
+ * index order, where the main program starts them.
+ */
+void PlaceOnUnitCircle(SimpleGraph& graph) {
+    size_t numberOfNodes = graph.nodes.size();
+    for(size_t n = 0; n < numberOfNodes; n++) {
+        graph.nodes[n].x = cos(2 * kPi * (double) n / (double) numberOfNodes);
+        graph.nodes[n].y = sin(2 * kPi * (double) n / (double) numberOfNodes);
+    }
+}
+
+/*
+ * LoadGraphFile
+ * Reads a graph file in the same format as the main
+ * program, placing the nodes on the unit circle.
+ * Returns false if the file cannot be read.
+ */
+bool LoadGraphFile(const string& fileName, SimpleGraph& graph) {
+    ifstream graphFileStream(fileName.c_str());
+    size_t numberOfNodes;
+    graphFileStream >> numberOfNodes;
+    if(graphFileStream.fail()) return false;
+
+    graph.nodes.resize(numberOfNodes);
+    PlaceOnUnitCircle(graph);
+    size_t start, end;
+    while(graphFileStream >> start >> end) {
+        Edge edge;
+        edge.start = start;
+        edge.end = end;
+        graph.edges.push_back(edge);
+    }
+    return true;
+}
+
+/*
+ * CreateRandomGraph
+ * Returns a graph with no edges whose nodes are
+ * scattered over the unit square, with a third of them
+ * packed into a small cluster in one corner so that
+ * the quadtree is unbalanced.
+ */
+SimpleGraph CreateRandomGraph(size_t numberOfNodes) {
+    SimpleGraph graph;
+    srand(106);
+    for(size_t n = 0; n < numberOfNodes; n++) {
+        Node node;
+        node.x = rand() / (double) RAND_MAX;
+        node.y = rand() / (double) RAND_MAX;
+        if(n % 3 == 0) {
+            node.x *= 0.01;
+            node.y *= 0.01;
+        }
+        graph.nodes.push_back(node);
+    }
+    return graph;
+}
+
+/*
+ * CreateGridGraph
+ * Returns a square grid graph with size nodes a side,
+ * placed on the unit circle like a loaded graph file.
+ */
+SimpleGraph CreateGridGraph(size_t size) {
+    SimpleGraph graph;
+    graph.nodes.resize(size * size);
+    PlaceOnUnitCircle(graph);
+    for(size_t row = 0; row < size; row++) {
+        for(size_t column = 0; column < size; column++) {
+            Edge edge;
+            edge.start = row * size + column;
+            if(column + 1 < size) {
+                edge.end = edge.start + 1;
+                graph.edges.push_back(edge);
+            }
+            if(row + 1 < size) {
+                edge.end = edge.start + size;
+                graph.edges.push_back(edge);
+            }
+        }
+    }
+    return graph;
+}
+
+/*
+ * PlaceOnLattice
+ * Moves the nodes of a grid graph of size nodes a side
+ * to the points of a square lattice of unit spacing,
+ * where every edge is at its rest length.
+ */
+void PlaceOnLattice(SimpleGraph& graph, size_t size) {
+    for(size_t n = 0; n < graph.nodes.size(); n++) {
+        graph.nodes[n].x = (double) (n % size);
+        graph.nodes[n].y = (double) (n / size);
+    }
+}
+
+/*
+ * CreateScaleFreeGraph
+ * Returns a graph grown by preferential attachment, as in
+ * the Barabasi-Albert model: each new node joins
+ * edgesPerNode earlier nodes chosen with probability
+ * proportional to their degree.  The nodes start on the
+ * unit circle, and the same seed is used every time.
+ */
+SimpleGraph CreateScaleFreeGraph(size_t numberOfNodes, size_t edgesPerNode) {
+    SimpleGraph graph;
+    graph.nodes.resize(numberOfNodes);
+    PlaceOnUnitCircle(graph);
+
+    //Every edge lists both ends here, so a uniform pick is degree-weighted
+    srand(106);
+    vector<size_t> endpoints;
+    for(size_t n = 1; n < numberOfNodes; n++) {
+        for(size_t k = 0; k < edgesPerNode && k < n; k++) {
+            Edge edge;
+            edge.start = n;
+            edge.end = endpoints.empty() ? 0 : endpoints[rand() % endpoints.size()];
+            if(edge.end == n) edge.end = 0;
+            graph.edges.push_back(edge);
+            endpoints.push_back(edge.start);
+            endpoints.push_back(edge.end);
+        }
+    }
+    return graph;
+}
+
+/*
+ * CreateForestGraph
+ * Returns a forest of numberOfTrees random trees of 2
+ * to maximumTreeSize nodes each, placed on the unit
+ * circle.  Each node is joined to a random earlier node
+ * of its tree.
+ */
+SimpleGraph CreateForestGraph(size_t numberOfTrees, size_t maximumTreeSize) {
+    SimpleGraph graph;
+    srand(106);
+    for(size_t tree = 0; tree < numberOfTrees; tree++) {
+        size_t root = graph.nodes.size();
+        size_t treeSize = 2 + rand() % (maximumTreeSize - 1);
+        for(size_t n = 0; n < treeSize; n++) {
+            Node node = {0, 0};
+            graph.nodes.push_back(node);
+            if(n == 0) continue;
+            Edge edge;
+            edge.start = root + n;
+            edge.end = root + rand() % n;
+            graph.edges.push_back(edge);
+        }
+    }
+    PlaceOnUnitCircle(graph);
+    return graph;
+}
+
+/*
+ * CreateRandomSpatialArrays
+ * Returns nodes scattered over the unit cube, with a
+ * third of them packed into one corner, like
+ * CreateRandomGraph() in three dimensions.
+ */
+SpatialArrays CreateRandomSpatialArrays(size_t numberOfNodes) {
+    SpatialArrays positions;
+    ResizeSpatialArrays(positions, numberOfNodes);
+    srand(106);
+    for(size_t n = 0; n < numberOfNodes; n++) {
+        double scale = (n % 3 == 0) ? 0.01 : 1.0;
+        positions.x[n] = scale * rand() / (double) RAND_MAX;
+        positions.y[n] = scale * rand() / (double) RAND_MAX;
+        positions.z[n] = scale * rand() / (double) RAND_MAX;
+    }
+    return positions;
+}
+
+/*
+ * CountEdgeCrossings
+ * Returns the number of pairs of edges, not sharing an
+ * endpoint, that properly cross in the graph's layout.
+ * Every pair of edges is tested, so this is only meant
+ * for graphs of a few thousand edges.
+ */
+size_t CountEdgeCrossings(const SimpleGraph& graph) {
+    size_t crossings = 0;
+    for(size_t i = 0; i < graph.edges.size(); i++) {
+        const Edge& first = graph.edges[i];
+        const Node& a = graph.nodes[first.start];
+        const Node& b = graph.nodes[first.end];
+        for(size_t j = i + 1; j < graph.edges.size(); j++) {
+            const Edge& second = graph.edges[j];
+            if(second.start == first.start || second.start == first.end ||
+               second.end == first.start || second.end == first.end) continue;
+            const Node& c = graph.nodes[second.start];
+            const Node& d = graph.nodes[second.end];
+
+            //The endpoints of each edge must lie on opposite sides of the other
+            double sideC = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+            double sideD = (b.x - a.x) * (d.y - a.y) - (b.y - a.y) * (d.x - a.x);
+            double sideA = (d.x - c.x) * (a.y - c.y) - (d.y - c.y) * (a.x - c.x);
+            double sideB = (d.x - c.x) * (b.y - c.y) - (d.y - c.y) * (b.x - c.x);
+            if(sideC * sideD < 0 && sideA * sideB < 0) crossings++;
+        }
+    }
+    return crossings;
+}
+
+/*
+ * CalculateAreaPerNode
+ * Returns the area of the layout's bounding box divided
+ * by the number of nodes.
+ */
+double CalculateAreaPerNode(const SimpleGraph& graph) {
+    double minX = HUGE_VAL, minY = HUGE_VAL, maxX = -HUGE_VAL, maxY = -HUGE_VAL;
+    for(size_t n = 0; n < graph.nodes.size(); n++) {
+        minX = min(minX, graph.nodes[n].x);
+        minY = min(minY, graph.nodes[n].y);
+        maxX = max(maxX, graph.nodes[n].x);
+        maxY = max(maxY, graph.nodes[n].y);
+    }
+    return (maxX - minX) * (maxY - minY) / graph.nodes.size();
+}
+
+/*
+ * GetSeconds
+ * Returns the wall-clock time elapsed since startTime.
+ */
+double GetSeconds(BenchmarkClock::time_point startTime) {
+    return chrono::duration<double>(BenchmarkClock::now() - startTime).count();
+}
+
+/*
+ * MaximumRelativeError
+ * Returns the largest distance between an approximate
+ * force and the exact force on the same node, divided
+ * by the size of the exact force.
+ */
+double MaximumRelativeError(const NodeArrays& exact, const NodeArrays& approximate) {
+    double result = 0;
+    for(size_t i = 0; i < exact.size(); i++) {
+        double errorX = exact.x[i] - approximate.x[i];
+        double errorY = exact.y[i] - approximate.y[i];
+        double error = sqrt(errorX * errorX + errorY * errorY);
+        double size = sqrt(exact.x[i] * exact.x[i] + exact.y[i] * exact.y[i]);
+        if(size > 0) result = max(result, error / size);
+    }
+    return result;
+}
+
+/*
+ * LargestForceError
+ * Returns the largest distance between an approximate
+ * force and the exact force on the same node, divided
+ * by the size of the largest exact force on any node.
+ */
+double LargestForceError(const NodeArrays& exact, const NodeArrays& approximate) {
+    double largestError = 0, largestForce = 0;
+    for(size_t i = 0; i < exact.size(); i++) {
+        double errorX = exact.x[i] - approximate.x[i];
+        double errorY = exact.y[i] - approximate.y[i];
+        largestError = max(largestError, sqrt(errorX * errorX + errorY * errorY));
+        largestForce = max(largestForce,
+                           sqrt(exact.x[i] * exact.x[i] + exact.y[i] * exact.y[i]));
+    }
+    return largestForce > 0 ? largestError / largestForce : 0;
+}
+
+/*
+ * PrintResult
+ * Prints one row of the results table.
+ */
+void PrintResult(const string& engine, double seconds, double error) {
+    cout << "  " << setw(24) << left << engine << right
+         << setw(12) << fixed << setprecision(4) << seconds << " s"
+         << setw(14) << scientific << setprecision(2) << error << endl;
+}
+
+/*
+ * CheckVectorRange
+ * Runs every vector kernel the processor supports on a
+ * row of kVectorRangeNodes nodes at each of the
+ * kVectorRangeSpacings, and prints whether the forces
+ * are all finite and match the scalar kernel.
+ */
+bool CheckVectorRange() {
+    bool matches = true;
+    for(size_t i = 0; i < sizeof(kVectorRangeSpacings) / sizeof(kVectorRangeSpacings[0]); i++) {
+        NodeArrays positions;
+        ResizeNodeArrays(positions, kVectorRangeNodes);
+        for(size_t node = 0; node < kVectorRangeNodes; node++) {
+            positions.x[node] = node * kVectorRangeSpacings[i];
+            positions.y[node] = 0;
+        }
+        NodeArrays exact = InitializeNodeChanges(positions);
+        CalculateRepulsiveForces(positions, exact);
+        for(int level = kAvx2Kernel; level <= DetectSimdLevel(); level++) {
+            NodeArrays vectorized = InitializeNodeChanges(positions);
+            CalculateVectorizedRepulsiveForces(positions, vectorized, (SimdLevel) level);
+            for(size_t node = 0; node < kVectorRangeNodes; node++) {
+                if(!isfinite(vectorized.x[node]) || !isfinite(vectorized.y[node])) matches = false;
+            }
+            if(MaximumRelativeError(exact, vectorized) > kForcePathTolerance) matches = false;
+        }
+    }
+    cout << "Vector kernels " << (matches ? "match" : "DO NOT match")
+         << " the scalar kernel outside the range of a float" << endl << endl;
+    return matches;
+}
+
+/*
+ * BenchmarkRepulsion
+ * Times one repulsion pass of every engine on the graph
+ * and compares the results with the exact kernel.
+ */
+void BenchmarkRepulsion(const string& name, SimpleGraph& graph) {
+    cout << name << " (" << graph.nodes.size() << " nodes)" << endl;
+    NodeArrays positions;
+    LoadNodeArrays(graph.nodes, positions);
+
+    NodeArrays exact = InitializeNodeChanges(positions);
+    BenchmarkClock::time_point startTime = BenchmarkClock::now();
+    CalculateRepulsiveForces(positions, exact);
+    PrintResult("exact", GetSeconds(startTime), 0);
+
+    NodeArrays approximate = InitializeNodeChanges(positions);
+    startTime = BenchmarkClock::now();
+    CalculateModelRepulsiveForces<FruchtermanReingoldForces>(positions, approximate);
+    PrintResult("exact, policy", GetSeconds(startTime), MaximumRelativeError(exact, approximate));
+
+    for(int level = kAvx2Kernel; level <= DetectSimdLevel(); level++) {
+        approximate = InitializeNodeChanges(positions);
+        startTime = BenchmarkClock::now();
+        CalculateVectorizedRepulsiveForces(positions, approximate, (SimdLevel) level);
+        double seconds = GetSeconds(startTime);
+        PrintResult(string("exact, ") + SimdLevelName((SimdLevel) level), seconds,
+                    MaximumRelativeError(exact, approximate));
+    }
+
+    PrecisionMode reduced[] = { kSinglePrecision, kMixedPrecision };
+    for(size_t i = 0; i < sizeof(reduced) / sizeof(reduced[0]); i++) {
+        approximate = InitializeNodeChanges(positions);
+        startTime = BenchmarkClock::now();
+        CalculatePrecisionRepulsiveForces(positions, approximate, reduced[i]);
+        double seconds = GetSeconds(startTime);
+        PrintResult(string("exact, ") + PrecisionModeName(reduced[i]), seconds,
+                    MaximumRelativeError(exact, approximate));
+    }
+
+    approximate = InitializeNodeChanges(positions);
+    startTime = BenchmarkClock::now();
+    CalculateParallelRepulsiveForces(positions, approximate, 0);
+    stringstream threaded;
+    threaded << "exact, threads: " << DefaultThreadCount();
+    PrintResult(threaded.str(), GetSeconds(startTime), MaximumRelativeError(exact, approximate));
+
+    approximate = InitializeNodeChanges(positions);
+    startTime = BenchmarkClock::now();
+    CalculateBarnesHutRepulsiveForces(positions, approximate, kDefaultBarnesHutTheta);
+    PrintResult("Barnes-Hut", GetSeconds(startTime), MaximumRelativeError(exact, approximate));
+
+    for(size_t i = 0; i < sizeof(kBenchmarkOrders) / sizeof(kBenchmarkOrders[0]); i++) {
+        size_t order = kBenchmarkOrders[i];
+        approximate = InitializeNodeChanges(positions);
+        startTime = BenchmarkClock::now();
+        CalculateFastMultipoleRepulsiveForces(positions, approximate, order,
+                                              kDefaultBarnesHutTheta);
+        double seconds = GetSeconds(startTime);
+
+        stringstream engine;
+        engine << "multipole, order " << order;
+        PrintResult(engine.str(), seconds, MaximumRelativeError(exact, approximate));
+    }
+    cout << endl;
+}
+
+/*
+ * CheckBarnesHutError
+ * Compares the Barnes-Hut forces at the default theta
+ * with the exact ones, and returns whether the largest
+ * error is within kBarnesHutErrorBound of the largest
+ * exact force in the graph, and whether a theta too
+ * large to accept gave the exact forces instead, both
+ * there and in the multipole engine.
+ */
+bool CheckBarnesHutError(const string& name, const SimpleGraph& graph) {
+    NodeArrays positions;
+    LoadNodeArrays(graph.nodes, positions);
+    NodeArrays exact = InitializeNodeChanges(positions);
+    CalculateRepulsiveForces(positions, exact);
+    NodeArrays approximate = InitializeNodeChanges(positions);
+    CalculateBarnesHutRepulsiveForces(positions, approximate, kDefaultBarnesHutTheta);
+
+    double error = LargestForceError(exact, approximate);
+    bool within = error <= kBarnesHutErrorBound;
+    cout << name << ": Barnes-Hut error " << scientific << setprecision(2) << error
+         << " of the largest force, " << (within ? "within" : "NOT within") << " the bound of "
+         << kBarnesHutErrorBound << endl;
+
+    approximate = InitializeNodeChanges(positions);
+    CalculateBarnesHutRepulsiveForces(positions, approximate, 1.5 * kMaximumBarnesHutTheta);
+    bool rejected = MaximumRelativeError(exact, approximate) <= kForcePathTolerance;
+    approximate = InitializeNodeChanges(positions);
+    CalculateFastMultipoleRepulsiveForces(positions, approximate, kDefaultFastMultipoleOrder,
+                                          1.5 * kMaximumBarnesHutTheta);
+    if(MaximumRelativeError(exact, approximate) > kForcePathTolerance) rejected = false;
+    if(!rejected) cout << "  A theta past the maximum was NOT rejected" << endl;
+    return within && rejected;
+}
+
+/*
+ * BenchmarkGridCutoff
+ * The grid engine only pays off once a layout is wider
+ * than its cutoff, so it is timed apart from the other
+ * engines, on spread layouts.  Times one pass of the
+ * grid engine at the default cutoff and one of the
+ * fastest exact kernel on one thread, and prints how
+ * wide the layout is, the grid engine's speedup and its
+ * error.
+ */
+void BenchmarkGridCutoff(const string& name, const SimpleGraph& graph) {
+    NodeArrays positions;
+    LoadNodeArrays(graph.nodes, positions);
+    double minX = HUGE_VAL, minY = HUGE_VAL, maxX = -HUGE_VAL, maxY = -HUGE_VAL;
+    for(size_t i = 0; i < positions.size(); i++) {
+        minX = min(minX, positions.x[i]);
+        minY = min(minY, positions.y[i]);
+        maxX = max(maxX, positions.x[i]);
+        maxY = max(maxY, positions.y[i]);
+    }
+    double width = sqrt((maxX - minX) * (maxX - minX) + (maxY - minY) * (maxY - minY));
+    cout << name << " (" << positions.size() << " nodes, " << fixed << setprecision(1) << width
+         << " across), grid cutoff " << kDefaultRepulsionCutoff << endl;
+
+    NodeArrays exact = InitializeNodeChanges(positions);
+    BenchmarkClock::time_point startTime = BenchmarkClock::now();
+    CalculateVectorizedRepulsiveForces(positions, exact);
+    double exactSeconds = GetSeconds(startTime);
+    PrintResult(string("exact, ") + SimdLevelName(DetectSimdLevel()), exactSeconds, 0);
+
+    NodeArrays approximate = InitializeNodeChanges(positions);
+    startTime = BenchmarkClock::now();
+    CalculateGridRepulsiveForces(positions, approximate, kDefaultRepulsionCutoff);
+    double gridSeconds = GetSeconds(startTime);
+    PrintResult("grid cutoff", gridSeconds, LargestForceError(exact, approximate));
+    cout << "  Speedup " << fixed << setprecision(2) << exactSeconds / gridSeconds << endl << endl;
+}
+
+/*
+ * CompareForcePaths
+ * Lays out copies of the graph with the unit-vector and
+ * trigonometric force passes, prints how long each took
+ * and how far apart the layouts were after
+ * kRegressionIterations as a fraction of the layout's
+ * size, and returns whether that is within
+ * kForcePathTolerance.  Without cooling the update is
+ * chaotic on dense graphs such as 30clique, where one
+ * ulp grows into a visible difference within about
+ * fifty iterations on either path, hence the short
+ * run.  It also checks that the trigonometric forces
+ * gathered over the adjacency agree with those
+ * scattered along the edges.
+ */
+bool CompareForcePaths(const string& name, const SimpleGraph& graph) {
+    SimpleGraph vectorGraph = graph;
+    SimpleGraph trigonometricGraph = graph;
+    SimpleGraph vectorLayout, trigonometricLayout;
+    LayoutOptions options = DefaultLayoutOptions();
+
+    BenchmarkClock::time_point startTime = BenchmarkClock::now();
+    for(size_t iteration = 0; iteration < kTimingIterations; iteration++) {
+        if(iteration == kRegressionIterations) vectorLayout = vectorGraph;
+        TransformGraph(vectorGraph, options);
+    }
+    double vectorSeconds = GetSeconds(startTime);
+
+    options.trigonometricForces = true;
+    startTime = BenchmarkClock::now();
+    for(size_t iteration = 0; iteration < kTimingIterations; iteration++) {
+        if(iteration == kRegressionIterations) trigonometricLayout = trigonometricGraph;
+        TransformGraph(trigonometricGraph, options);
+    }
+    double trigonometricSeconds = GetSeconds(startTime);
+
+    //Compare the largest difference against the extent of the layout
+    double difference = 0, extent = 0;
+    for(size_t i = 0; i < graph.nodes.size(); i++) {
+        const Node& a = vectorLayout.nodes[i];
+        const Node& b = trigonometricLayout.nodes[i];
+        difference = max(difference, max(fabs(a.x - b.x), fabs(a.y - b.y)));
+        extent = max(extent, max(fabs(b.x - trigonometricLayout.nodes[0].x),
+                                 fabs(b.y - trigonometricLayout.nodes[0].y)));
+    }
+    bool matches = difference <= kForcePathTolerance * extent;
+
+    NodeArrays positions;
+    LoadNodeArrays(graph.nodes, positions);
+    NodeArrays scattered = InitializeNodeChanges(positions);
+    CalculateNodeForces(positions, graph.edges, scattered, options);
+    Adjacency adjacency;
+    BuildAdjacency(positions.size(), graph.edges, adjacency);
+    NodeArrays gathered = InitializeNodeChanges(positions);
+    CalculateNodeForces(positions, adjacency, gathered, options);
+    bool gatheredMatches = MaximumRelativeError(scattered, gathered) <= kForcePathTolerance;
+
+    cout << name << ": " << kTimingIterations << " iterations" << endl;
+    PrintResult("unit-vector forces", vectorSeconds, 0);
+    PrintResult("trigonometric forces", trigonometricSeconds, difference / extent);
+    cout << "  Layouts after " << kRegressionIterations << " iterations "
+         << (matches ? "match" : "DO NOT match") << endl;
+    cout << "  Gathered trigonometric forces "
+         << (gatheredMatches ? "match" : "DO NOT match") << endl << endl;
+    return matches && gatheredMatches;
+}
+
+/*
+ * BenchmarkScaling
+ * Times the multithreaded exact engine on the graph with
+ * a doubling number of threads, printing the speedup
+ * and parallel efficiency over one thread.  Returns
+ * whether every thread count reproduced the
+ * single-threaded forces to within kParallelTolerance.
+ */
+bool BenchmarkScaling(const string& name, const SimpleGraph& graph) {
+    cout << name << " (" << graph.nodes.size() << " nodes), strong scaling" << endl;
+    cout << "  Threads          Time      Speedup   Efficiency     Max error" << endl;
+    NodeArrays positions;
+    LoadNodeArrays(graph.nodes, positions);
+    NodeArrays serial = InitializeNodeChanges(positions);
+    CalculateVectorizedRepulsiveForces(positions, serial);
+
+    bool matches = true;
+    double baseSeconds = 0;
+    size_t maximumThreads = max(2 * DefaultThreadCount(), (size_t) 4);
+    for(size_t numberOfThreads = 1; numberOfThreads <= maximumThreads; numberOfThreads *= 2) {
+        NodeArrays changes = InitializeNodeChanges(positions);
+        BenchmarkClock::time_point startTime = BenchmarkClock::now();
+        CalculateParallelRepulsiveForces(positions, changes, numberOfThreads);
+        double seconds = GetSeconds(startTime);
+        if(numberOfThreads == 1) baseSeconds = seconds;
+
+        double error = MaximumRelativeError(serial, changes);
+        if(error > kParallelTolerance) matches = false;
+        double speedup = baseSeconds / seconds;
+        cout << "  " << setw(7) << numberOfThreads
+             << setw(12) << fixed << setprecision(4) << seconds << " s"
+             << setw(11) << setprecision(2) << speedup
+             << setw(12) << setprecision(0) << 100 * speedup / numberOfThreads << " %"
+             << setw(14) << scientific << setprecision(2) << error << endl;
+    }
+    cout << "  Forces " << (matches ? "match" : "DO NOT match")
+         << " the single-threaded kernel" << endl << endl;
+    return matches;
+}
+
+/*
+ * BenchmarkAttraction
+ * Times kAttractionIterations attraction passes
+ * scattered along the edge list and gathered over the
+ * adjacency, on one thread and on one per core, or
+ * four if there are fewer cores, and checks that the
+ * forces agree to within kParallelTolerance.  Returns
+ * false if they do not.
+ */
+bool BenchmarkAttraction(const string& name, const SimpleGraph& graph) {
+    cout << name << " (" << graph.edges.size() << " edges), attraction" << endl;
+    NodeArrays positions;
+    LoadNodeArrays(graph.nodes, positions);
+    Adjacency adjacency;
+    BuildAdjacency(graph.nodes.size(), graph.edges, adjacency);
+
+    NodeArrays scattered = InitializeNodeChanges(positions);
+    BenchmarkClock::time_point startTime = BenchmarkClock::now();
+    for(size_t iteration = 0; iteration < kAttractionIterations; iteration++) {
+        ClearNodeArrays(scattered);
+        CalculateAttractiveForces(positions, graph.edges, scattered);
+    }
+    PrintResult("scatter", GetSeconds(startTime), 0);
+
+    bool matches = true;
+    //At least four threads, so that the split is exercised even on one core
+    size_t threadCounts[] = { 1, max(DefaultThreadCount(), (size_t) 4) };
+    for(size_t i = 0; i < 2; i++) {
+        NodeArrays gathered = InitializeNodeChanges(positions);
+        startTime = BenchmarkClock::now();
+        for(size_t iteration = 0; iteration < kAttractionIterations; iteration++) {
+            ClearNodeArrays(gathered);
+            CalculateGatheredAttractiveForces(positions, adjacency, gathered, threadCounts[i]);
+        }
+        double seconds = GetSeconds(startTime);
+        double error = MaximumRelativeError(scattered, gathered);
+        if(error > kParallelTolerance) matches = false;
+        stringstream engine;
+        engine << "gather, threads: " << threadCounts[i];
+        PrintResult(engine.str(), seconds, error);
+    }
+    if(!matches) cout << "  Gathered forces DO NOT match the scatter pass" << endl;
+    cout << endl;
+    return matches;
+}
+
+/*
+ * BenchmarkInitialLayouts
+ * Lays out copies of the graph with kTimingIterations
+ * plain iterations, with the default multilevel driver,
+ * and with as many iterations as the multilevel driver
+ * spends on each level after a Pivot MDS start and after
+ * a spectral start, if the graph is connected, and
+ * prints the time and remaining edge crossings of each.
+ */
+void BenchmarkInitialLayouts(const string& name, const SimpleGraph& graph) {
+    cout << name << " (" << graph.nodes.size() << " nodes), initial layouts" << endl;
+    cout << "  Layout                        Time     Crossings" << endl;
+    LayoutOptions options = DefaultLayoutOptions();
+
+    SimpleGraph plain = graph;
+    BenchmarkClock::time_point startTime = BenchmarkClock::now();
+    for(size_t iteration = 0; iteration < kTimingIterations; iteration++) {
+        TransformGraph(plain, options);
+    }
+    double plainSeconds = GetSeconds(startTime);
+    stringstream plainName;
+    plainName << kTimingIterations << " plain iterations";
+    cout << "  " << setw(24) << left << plainName.str() << right
+         << setw(12) << fixed << setprecision(4) << plainSeconds << " s"
+         << setw(14) << CountEdgeCrossings(plain) << endl;
+
+    SimpleGraph multilevel = graph;
+    startTime = BenchmarkClock::now();
+    size_t levels = MultilevelLayout(multilevel, options, DefaultMultilevelOptions());
+    double multilevelSeconds = GetSeconds(startTime);
+    stringstream multilevelName;
+    multilevelName << "multilevel, " << levels << " levels";
+    cout << "  " << setw(24) << left << multilevelName.str() << right
+         << setw(12) << fixed << setprecision(4) << multilevelSeconds << " s"
+         << setw(14) << CountEdgeCrossings(multilevel) << endl;
+
+    SimpleGraph seeded = graph;
+    startTime = BenchmarkClock::now();
+    PivotMdsLayout(seeded, kDefaultMdsPivots);
+    for(size_t iteration = 0; iteration < kDefaultRefinementIterations; iteration++) {
+        TransformGraph(seeded, options);
+    }
+    double seededSeconds = GetSeconds(startTime);
+    stringstream seededName;
+    seededName << "pivot MDS + " << kDefaultRefinementIterations;
+    cout << "  " << setw(24) << left << seededName.str() << right
+         << setw(12) << fixed << setprecision(4) << seededSeconds << " s"
+         << setw(14) << CountEdgeCrossings(seeded) << endl;
+
+    SimpleGraph spectral = graph;
+    startTime = BenchmarkClock::now();
+    if(SpectralLayout(spectral)) {
+        for(size_t iteration = 0; iteration < kDefaultRefinementIterations; iteration++) {
+            TransformGraph(spectral, options);
+        }
+        double spectralSeconds = GetSeconds(startTime);
+        stringstream spectralName;
+        spectralName << "spectral + " << kDefaultRefinementIterations;
+        cout << "  " << setw(24) << left << spectralName.str() << right
+             << setw(12) << fixed << setprecision(4) << spectralSeconds << " s"
+             << setw(14) << CountEdgeCrossings(spectral) << endl;
+    }
+    cout << endl;
+}
+
+/*
+ * BenchmarkConvergence
+ * Runs a copy of the graph to convergence on the exact
+ * engine with the default adaptive step schedule and
+ * prints how long it took.  Returns whether it stopped
+ * because no node moved as far as the tolerance, which
+ * is the only way an exact layout may stop.
+ */
+bool BenchmarkConvergence(const string& name, const SimpleGraph& graph) {
+    SimpleGraph layout = graph;
+    ConvergenceOptions options = DefaultConvergenceOptions();
+    BenchmarkClock::time_point startTime = BenchmarkClock::now();
+    ConvergenceState state = RunToConvergence(layout, DefaultLayoutOptions(), options);
+    double seconds = GetSeconds(startTime);
+    bool settled = state.converged && state.maximumDisplacement < options.tolerance;
+    cout << name << ": adaptive step " << (settled ? "converged" : "DID NOT converge")
+         << " after " << state.iterations << " iterations" << endl;
+    cout << "  " << setw(24) << left << "final energy" << right
+         << setw(12) << fixed << setprecision(4) << seconds << " s"
+         << setw(14) << scientific << setprecision(2) << state.energy << endl << endl;
+    return settled;
+}
+
+/*
+ * CheckBundledConvergence
+ * Runs each of kBundledGraphs to convergence on the
+ * exact engine, naming any that could not be loaded or
+ * hit the iteration limit, and prints whether they all
+ * converged.
+ */
+bool CheckBundledConvergence() {
+    size_t numberOfGraphs = sizeof(kBundledGraphs) / sizeof(kBundledGraphs[0]);
+    bool converged = true;
+    for(size_t i = 0; i < numberOfGraphs; i++) {
+        SimpleGraph graph;
+        if(!LoadGraphFile(kBundledGraphs[i], graph)) {
+            cout << kBundledGraphs[i] << " could not be loaded." << endl;
+            converged = false;
+            continue;
+        }
+        ConvergenceState state = RunToConvergence(graph, DefaultLayoutOptions(),
+                                                  DefaultConvergenceOptions());
+        if(!state.converged) {
+            cout << kBundledGraphs[i] << ": DID NOT converge after " << state.iterations
+                 << " iterations" << endl;
+            converged = false;
+        }
+    }
+    cout << "The exact engine " << (converged ? "converges" : "DOES NOT converge")
+         << " on all " << numberOfGraphs << " bundled graphs" << endl << endl;
+    return converged;
+}
+
+/*
+ * BenchmarkStress
+ * Lays out copies of the graph by the force-directed
+ * layout run to convergence, stress majorization,
+ * stochastic gradient descent and the Kamada-Kawai
+ * method, and prints the time taken and the stress of
+ * each.
+ */
+void BenchmarkStress(const string& name, const SimpleGraph& graph) {
+    cout << name << " (" << graph.nodes.size() << " nodes), stress" << endl;
+    cout << "  Layout                        Time        Stress" << endl;
+
+    SimpleGraph forceDirected = graph;
+    BenchmarkClock::time_point startTime = BenchmarkClock::now();
+    ConvergenceState state = RunToConvergence(forceDirected, DefaultLayoutOptions(),
+                                              DefaultConvergenceOptions());
+    double seconds = GetSeconds(startTime);
+    stringstream forceName;
+    forceName << "force-directed, " << state.iterations;
+    PrintResult(forceName.str(), seconds, CalculateStress(forceDirected));
+
+    SimpleGraph majorized = graph;
+    startTime = BenchmarkClock::now();
+    StressResult result = StressMajorizationLayout(majorized, DefaultStressOptions());
+    seconds = GetSeconds(startTime);
+    stringstream stressName;
+    stressName << "majorization, " << result.iterations;
+    PrintResult(stressName.str(), seconds, CalculateStress(majorized));
+
+    SgdOptions options = DefaultSgdOptions();
+    for(size_t sparse = 0; sparse < 2; sparse++) {
+        options.numberOfPivots = sparse ? kBenchmarkPivots : 0;
+        SimpleGraph descended = graph;
+        startTime = BenchmarkClock::now();
+        SgdLayout(descended, options);
+        seconds = GetSeconds(startTime);
+        stringstream sgdName;
+        sgdName << "SGD, ";
+        if(sparse) {
+            sgdName << kBenchmarkPivots << " pivots";
+        } else {
+            sgdName << "exact";
+        }
+        PrintResult(sgdName.str(), seconds, CalculateStress(descended));
+    }
+
+    //One node moves at a time, which is only practical on small graphs
+    if(graph.nodes.size() <= kKamadaKawaiBenchmarkNodes) {
+        SimpleGraph sprung = graph;
+        startTime = BenchmarkClock::now();
+        KamadaKawaiResult springResult = KamadaKawaiLayout(sprung, DefaultKamadaKawaiOptions());
+        seconds = GetSeconds(startTime);
+        stringstream springName;
+        springName << "Kamada-Kawai, " << springResult.iterations;
+        PrintResult(springName.str(), seconds, CalculateStress(sprung));
+    }
+    cout << endl;
+}
+
+/*
+ * BenchmarkPrecision
+ * Runs copies of the graph to convergence with the exact
+ * engine in each precision and prints the time taken and
+ * the stress of each layout.
+ */
+void BenchmarkPrecision(const string& name, const SimpleGraph& graph) {
+    cout << name << " (" << graph.nodes.size() << " nodes), precision" << endl;
+    cout << "  Precision                     Time        Stress" << endl;
+
+    PrecisionMode modes[] = { kDoublePrecision, kSinglePrecision, kMixedPrecision };
+    for(size_t i = 0; i < sizeof(modes) / sizeof(modes[0]); i++) {
+        LayoutOptions options = DefaultLayoutOptions();
+        options.precision = modes[i];
+        SimpleGraph layout = graph;
+        BenchmarkClock::time_point startTime = BenchmarkClock::now();
+        ConvergenceState state = RunToConvergence(layout, options, DefaultConvergenceOptions());
+        double seconds = GetSeconds(startTime);
+        stringstream modeName;
+        modeName << PrecisionModeName(modes[i]) << ", " << state.iterations;
+        PrintResult(modeName.str(), seconds, CalculateStress(layout));
+    }
+    cout << endl;
+}
+
+/*
+ * BenchmarkForceModels
+ * Runs copies of the graph to convergence under each
+ * force model and prints the time taken and the stress
+ * of each layout.
+ */
+void BenchmarkForceModels(const string& name, const SimpleGraph& graph) {
+    cout << name << " (" << graph.nodes.size() << " nodes), force models" << endl;
+    cout << "  Model                         Time        Stress" << endl;
+
+    ForceModel models[] = { kFruchtermanReingoldModel, kLinLogModel, kForceAtlas2Model };
+    const char* labels[] = { "FR", "LinLog", "ForceAtlas2" };
+    for(size_t i = 0; i < sizeof(models) / sizeof(models[0]); i++) {
+        LayoutOptions options = DefaultLayoutOptions();
+        options.forceModel = models[i];
+        SimpleGraph layout = graph;
+        BenchmarkClock::time_point startTime = BenchmarkClock::now();
+        ConvergenceState state = RunToConvergence(layout, options, DefaultConvergenceOptions());
+        double seconds = GetSeconds(startTime);
+        stringstream modelName;
+        modelName << labels[i] << ", " << state.iterations;
+        PrintResult(modelName.str(), seconds, CalculateStress(layout));
+    }
+    cout << endl;
+}
+
+/*
+ * CheckSelfLoopAttraction
+ * Adds a self-loop to a copy of the graph and prints
+ * whether each force model's attraction on it, both
+ * scattered along the edges and gathered per node, is
+ * the same as on the graph without it.  It then moves
+ * the ends of the first edge onto one point of the unit
+ * sphere and checks that the 3D attraction is the same
+ * as without that edge, rather than NaN.
+ */
+template <typename Forces>
+bool SelfLoopLeavesAttraction(const SimpleGraph& graph) {
+    NodeArrays positions;
+    LoadNodeArrays(graph.nodes, positions);
+    vector<Edge> looped = graph.edges;
+    looped.push_back(Edge());
+    looped.back().start = looped.back().end = 0;
+
+    NodeArrays expected = InitializeNodeChanges(positions);
+    CalculateModelAttractiveForces<Forces>(positions, graph.edges, expected);
+    NodeArrays scattered = InitializeNodeChanges(positions);
+    CalculateModelAttractiveForces<Forces>(positions, looped, scattered);
+    Adjacency adjacency;
+    BuildAdjacency(positions.size(), looped, adjacency);
+    NodeArrays gathered = InitializeNodeChanges(positions);
+    CalculateGatheredModelAttractiveForces<Forces>(positions, adjacency, gathered, 1);
+    return IdenticalArrays(expected, scattered) &&
+           MaximumRelativeError(expected, gathered) <= kForcePathTolerance;
+}
+
+bool CoincidentNeighboursLeaveSpatialAttraction(const SimpleGraph& graph) {
+    if(graph.edges.empty()) return true;
+    SpatialArrays positions;
+    InitialSpatialLayout(graph.nodes.size(), positions);
+    size_t start = graph.edges[0].start, end = graph.edges[0].end;
+    positions.x[end] = positions.x[start];
+    positions.y[end] = positions.y[start];
+    positions.z[end] = positions.z[start];
+
+    vector<Edge> remaining(graph.edges.begin() + 1, graph.edges.end());
+    Adjacency adjacency;
+    BuildAdjacency(positions.size(), remaining, adjacency);
+    SpatialArrays expected;
+    ResizeSpatialArrays(expected, positions.size());
+    CalculateSpatialAttractiveForces(positions, adjacency, expected, 1);
+    BuildAdjacency(positions.size(), graph.edges, adjacency);
+    SpatialArrays gathered;
+    ResizeSpatialArrays(gathered, positions.size());
+    CalculateSpatialAttractiveForces(positions, adjacency, gathered, 1);
+    size_t bytes = positions.size() * sizeof(double);
+    return memcmp(expected.x.data(), gathered.x.data(), bytes) == 0 &&
+           memcmp(expected.y.data(), gathered.y.data(), bytes) == 0 &&
+           memcmp(expected.z.data(), gathered.z.data(), bytes) == 0;
+}
+
+bool CheckSelfLoopAttraction(const string& name, const SimpleGraph& graph) {
+    bool passed = SelfLoopLeavesAttraction<FruchtermanReingoldForces>(graph) &&
+                  SelfLoopLeavesAttraction<LinLogForces>(graph) &&
+                  SelfLoopLeavesAttraction<ForceAtlas2Forces>(graph);
+    cout << name << ": a self-loop " << (passed ? "leaves" : "CHANGES")
+         << " the attraction of every force model" << endl;
+    bool coincident = CoincidentNeighboursLeaveSpatialAttraction(graph);
+    cout << name << ": coincident neighbours " << (coincident ? "add nothing to" : "CHANGE")
+         << " the 3D attraction" << endl << endl;
+    return passed && coincident;
+}
+
+/*
+ * CheckModelRepulsion
+ * Times the one-thread and tiled policy kernels under
+ * the inverse-square law, and prints whether they agree
+ * with each other, and whether the tiled kernel built
+ * from the Fruchterman-Reingold policy agrees with the
+ * vector kernel.
+ */
+bool CheckModelRepulsion(const string& name, const SimpleGraph& graph) {
+    cout << name << " (" << graph.nodes.size() << " nodes), policy repulsion" << endl;
+    NodeArrays positions;
+    LoadNodeArrays(graph.nodes, positions);
+
+    NodeArrays exact = InitializeNodeChanges(positions);
+    CalculateVectorizedRepulsiveForces(positions, exact);
+    NodeArrays tiled = InitializeNodeChanges(positions);
+    BenchmarkClock::time_point startTime = BenchmarkClock::now();
+    CalculateParallelModelRepulsiveForces<FruchtermanReingoldForces>(positions, tiled,
+                                                                     kModelRepulsionThreads);
+    double seconds = GetSeconds(startTime);
+    double error = MaximumRelativeError(exact, tiled);
+    bool matches = error <= kParallelTolerance;
+    stringstream inverse;
+    inverse << "1 / d, threads: " << kModelRepulsionThreads;
+    PrintResult(inverse.str(), seconds, error);
+
+    NodeArrays serial = InitializeNodeChanges(positions);
+    startTime = BenchmarkClock::now();
+    CalculateModelRepulsiveForces<InverseSquareForces>(positions, serial);
+    PrintResult("1 / d^2, 1 thread", GetSeconds(startTime), 0);
+    tiled = InitializeNodeChanges(positions);
+    startTime = BenchmarkClock::now();
+    CalculateParallelModelRepulsiveForces<InverseSquareForces>(positions, tiled,
+                                                               kModelRepulsionThreads);
+    seconds = GetSeconds(startTime);
+    error = MaximumRelativeError(serial, tiled);
+    if(error > kParallelTolerance) matches = false;
+    stringstream inverseSquare;
+    inverseSquare << "1 / d^2, threads: " << kModelRepulsionThreads;
+    PrintResult(inverseSquare.str(), seconds, error);
+    cout << "  Forces " << (matches ? "match" : "DO NOT match") << endl << endl;
+    return matches;
+}
+
+/*
+ * ConvergesLikeExact
+ * Returns whether a layout run on the Barnes-Hut engine
+ * and the same layout on the exact engine both
+ * converged, the first within kBarnesHutIterationFactor
+ * times the iterations of the second, and to a stress
+ * within kBarnesHutStressFactor of it, give or take
+ * kStressRoundoff for layouts of no stress at all.  The
+ * exact run counts as at least a plateau window: an
+ * exact layout can stop in a few hundred iterations
+ * once its step cools away, while Barnes-Hut needs a
+ * whole window just to see a plateau.
+ */
+bool ConvergesLikeExact(const ConvergenceState& barnesHut, const SimpleGraph& barnesHutLayout,
+                        const ConvergenceState& exact, const SimpleGraph& exactLayout) {
+    size_t exactIterations = max(exact.iterations, DefaultConvergenceOptions().plateauWindow);
+    return barnesHut.converged && exact.converged &&
+           barnesHut.iterations <= kBarnesHutIterationFactor * exactIterations &&
+           CalculateStress(barnesHutLayout) <=
+               kBarnesHutStressFactor * CalculateStress(exactLayout) + kStressRoundoff;
+}
+
+/*
+ * BenchmarkForceAtlas2
+ * Runs copies of the graph to convergence with the
+ * ForceAtlas2 engine and with the adaptive global step
+ * under the ForceAtlas2 force model, both on the
+ * Barnes-Hut engine, then with the global step on the
+ * exact engine, and prints the time taken and the
+ * stress of each layout.  Returns whether the
+ * Barnes-Hut global step converged like the exact one.
+ */
+bool BenchmarkForceAtlas2(const string& name, const SimpleGraph& graph) {
+    cout << name << " (" << graph.nodes.size() << " nodes), ForceAtlas2" << endl;
+    cout << "  Layout                        Time        Stress" << endl;
+    LayoutOptions options = DefaultLayoutOptions();
+    options.repulsionMode = kBarnesHutRepulsion;
+
+    SimpleGraph adapted = graph;
+    BenchmarkClock::time_point startTime = BenchmarkClock::now();
+    ForceAtlas2State state = RunForceAtlas2(adapted, options, DefaultForceAtlas2Options());
+    double seconds = GetSeconds(startTime);
+    stringstream adaptedName;
+    adaptedName << "node speeds, " << state.iterations;
+    PrintResult(adaptedName.str(), seconds, CalculateStress(adapted));
+
+    SimpleGraph global = graph;
+    options.forceModel = kForceAtlas2Model;
+    startTime = BenchmarkClock::now();
+    ConvergenceState globalState = RunToConvergence(global, options,
+                                                    DefaultConvergenceOptions());
+    seconds = GetSeconds(startTime);
+    stringstream globalName;
+    globalName << "global step, " << globalState.iterations;
+    PrintResult(globalName.str(), seconds, CalculateStress(global));
+
+    SimpleGraph exact = graph;
+    options.repulsionMode = kExactRepulsion;
+    startTime = BenchmarkClock::now();
+    ConvergenceState exactState = RunToConvergence(exact, options, DefaultConvergenceOptions());
+    seconds = GetSeconds(startTime);
+    stringstream exactName;
+    exactName << "global step, exact, " << exactState.iterations;
+    PrintResult(exactName.str(), seconds, CalculateStress(exact));
+
+    bool passed = ConvergesLikeExact(globalState, global, exactState, exact);
+    cout << "  Barnes-Hut " << (passed ? "converges" : "DOES NOT converge")
+         << " like the exact engine" << endl << endl;
+    return passed;
+}
+
+/*
+ * KeptOutsideEdits
+ * Returns whether a relayout from before to after left
+ * in place every node the state pins and every node
+ * more than radius edges from all of the nodes the
+ * state marks as touched, as they were before it ran.
+ */
+bool KeptOutsideEdits(const SimpleGraph& before, const SimpleGraph& after,
+                      const IncrementalState& state, size_t radius) {
+    size_t numberOfNodes = before.nodes.size();
+    Adjacency adjacency;
+    BuildAdjacency(numberOfNodes, before.edges, adjacency);
+    vector<unsigned short> nearest(numberOfNodes, kUnreachable);
+    vector<unsigned short> depth(numberOfNodes);
+    vector<size_t> queue(numberOfNodes);
+    for(size_t source = 0; source < numberOfNodes; source++) {
+        if(!state.touched[source]) continue;
+        BreadthFirstSearch(adjacency, source, depth, queue);
+        for(size_t i = 0; i < numberOfNodes; i++) nearest[i] = min(nearest[i], depth[i]);
+    }
+    for(size_t i = 0; i < numberOfNodes; i++) {
+        if(!state.pinned[i] && nearest[i] <= radius) continue;
+        if(after.nodes[i].x != before.nodes[i].x || after.nodes[i].y != before.nodes[i].y) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * CheckRemoveNode
+ * Removes the node from a copy of the graph and returns
+ * whether every edge that did not touch it survived,
+ * with the last node renamed to the removed one, and
+ * no edge still names an index past the end.
+ */
+bool CheckRemoveNode(const SimpleGraph& graph, size_t node) {
+    size_t last = graph.nodes.size() - 1;
+    vector<pair<size_t, size_t> > expected;
+    for(size_t i = 0; i < graph.edges.size(); i++) {
+        const Edge& edge = graph.edges[i];
+        if(edge.start == node || edge.end == node) continue;
+        expected.push_back(make_pair(edge.start, edge.end));
+    }
+
+    SimpleGraph removed = graph;
+    IncrementalState state = InitializeIncrementalState(removed);
+    RemoveNode(removed, state, node);
+    if(removed.nodes.size() != last || state.touched.size() != last) return false;
+    vector<pair<size_t, size_t> > kept;
+    for(size_t i = 0; i < removed.edges.size(); i++) {
+        const Edge& edge = removed.edges[i];
+        if(edge.start >= last || edge.end >= last) return false;
+        kept.push_back(make_pair(edge.start == node ? last : edge.start,
+                                 edge.end == node ? last : edge.end));
+    }
+    sort(expected.begin(), expected.end());
+    sort(kept.begin(), kept.end());
+    return kept == expected;
+}
+
+/*
+ * BenchmarkIncremental
+ * Lays out a copy of the graph with the Barnes-Hut
+ * engine, splits one of its edges with a new node, so
+ * that the graph stays connected and the exact engine
+ * can converge too, pins one of the edited nodes, and
+ * prints the time taken and the stress after an
+ * incremental relayout and after full ones from the
+ * edited layout on the Barnes-Hut and the exact engine.
+ * Returns whether the Barnes-Hut one converged like the
+ * exact one, the relayout stayed near the edits and
+ * off the pinned node, and RemoveNode() kept the right
+ * edges.
+ */
+bool BenchmarkIncremental(const string& name, const SimpleGraph& graph) {
+    LayoutOptions options = DefaultLayoutOptions();
+    options.repulsionMode = kBarnesHutRepulsion;
+    SimpleGraph edited = graph;
+    RunToConvergence(edited, options, DefaultConvergenceOptions());
+
+    IncrementalState state = InitializeIncrementalState(edited);
+    Edge removed = edited.edges[edited.edges.size() / 3];
+    RemoveEdge(edited, state, removed.start, removed.end);
+    size_t added = AddNode(edited, state);
+    AddEdge(edited, state, added, removed.start);
+    AddEdge(edited, state, added, removed.end);
+    PinNode(state, removed.start, true);
+    IncrementalState edits = state;
+
+    cout << name << " (" << graph.nodes.size() << " nodes), incremental relayout" << endl;
+    cout << "  Relayout                      Time        Stress" << endl;
+
+    SimpleGraph incremental = edited;
+    IncrementalOptions incrementalOptions = DefaultIncrementalOptions();
+    BenchmarkClock::time_point startTime = BenchmarkClock::now();
+    IncrementalResult result = IncrementalRelayout(incremental, state, incrementalOptions);
+    double seconds = GetSeconds(startTime);
+    stringstream incrementalName;
+    incrementalName << result.activeNodes << " nodes, " << result.iterations;
+    PrintResult(incrementalName.str(), seconds, CalculateStress(incremental));
+
+    SimpleGraph full = edited;
+    startTime = BenchmarkClock::now();
+    ConvergenceState fullState = RunToConvergence(full, options, DefaultConvergenceOptions());
+    seconds = GetSeconds(startTime);
+    stringstream fullName;
+    fullName << "full, " << fullState.iterations;
+    PrintResult(fullName.str(), seconds, CalculateStress(full));
+
+    SimpleGraph exact = edited;
+    LayoutOptions exactOptions = DefaultLayoutOptions();
+    startTime = BenchmarkClock::now();
+    ConvergenceState exactState = RunToConvergence(exact, exactOptions,
+                                                   DefaultConvergenceOptions());
+    seconds = GetSeconds(startTime);
+    stringstream exactName;
+    exactName << "full, exact, " << exactState.iterations;
+    PrintResult(exactName.str(), seconds, CalculateStress(exact));
+
+    bool converges = ConvergesLikeExact(fullState, full, exactState, exact);
+    cout << "  Barnes-Hut " << (converges ? "converges" : "DOES NOT converge")
+         << " like the exact engine" << endl;
+    bool kept = KeptOutsideEdits(edited, incremental, edits, incrementalOptions.radius);
+    cout << "  Pinned and distant nodes " << (kept ? "stay" : "DO NOT stay")
+         << " in place" << endl;
+    bool renumbered = CheckRemoveNode(graph, graph.nodes.size() / 4);
+    cout << "  Edges " << (renumbered ? "are" : "are NOT")
+         << " renumbered correctly by RemoveNode" << endl << endl;
+    return converges && kept && renumbered;
+}
+
+/*
+ * PaddedBoxesApart
+ * Returns whether the bounding boxes of the graph's
+ * components, each grown by padding to the right and
+ * above as PackComponents() places them, are apart to
+ * within kPackingTolerance.
+ */
+bool PaddedBoxesApart(const SimpleGraph& graph, double padding) {
+    vector<size_t> components;
+    size_t numberOfComponents = FindComponents(graph.nodes.size(), graph.edges, components);
+    vector<double> minX(numberOfComponents, HUGE_VAL), minY(numberOfComponents, HUGE_VAL);
+    vector<double> maxX(numberOfComponents, -HUGE_VAL), maxY(numberOfComponents, -HUGE_VAL);
+    for(size_t n = 0; n < graph.nodes.size(); n++) {
+        size_t component = components[n];
+        minX[component] = min(minX[component], graph.nodes[n].x);
+        minY[component] = min(minY[component], graph.nodes[n].y);
+        maxX[component] = max(maxX[component], graph.nodes[n].x + padding);
+        maxY[component] = max(maxY[component], graph.nodes[n].y + padding);
+    }
+    for(size_t i = 0; i < numberOfComponents; i++) {
+        for(size_t j = i + 1; j < numberOfComponents; j++) {
+            if(minX[i] < maxX[j] - kPackingTolerance && minX[j] < maxX[i] - kPackingTolerance &&
+               minY[i] < maxY[j] - kPackingTolerance && minY[j] < maxY[i] - kPackingTolerance) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/*
+ * OnlyTranslated
+ * Returns whether every node of each component moved by
+ * the same offset, to within kPackingTolerance, from
+ * before to after.
+ */
+bool OnlyTranslated(const SimpleGraph& before, const SimpleGraph& after) {
+    vector<size_t> components;
+    size_t numberOfComponents = FindComponents(before.nodes.size(), before.edges, components);
+    vector<double> offsetX(numberOfComponents, HUGE_VAL), offsetY(numberOfComponents, HUGE_VAL);
+    for(size_t n = 0; n < before.nodes.size(); n++) {
+        size_t component = components[n];
+        double dx = after.nodes[n].x - before.nodes[n].x;
+        double dy = after.nodes[n].y - before.nodes[n].y;
+        if(offsetX[component] == HUGE_VAL) {
+            offsetX[component] = dx;
+            offsetY[component] = dy;
+        }
+        if(fabs(dx - offsetX[component]) > kPackingTolerance ||
+           fabs(dy - offsetY[component]) > kPackingTolerance) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * BenchmarkComponents
+ * Lays out copies of the graph whole, for a limited
+ * number of iterations, and component by component on
+ * one thread and on one per core, and prints the time
+ * taken and the area per node of each layout.  Then
+ * packs the whole layout too.  Returns whether every
+ * packing kept the padded boxes apart and only moved
+ * the components.
+ */
+bool BenchmarkComponents(const string& name, const SimpleGraph& graph) {
+    cout << name << " (" << graph.nodes.size() << " nodes), components" << endl;
+    cout << "  Layout                        Time     Area/node" << endl;
+
+    SimpleGraph whole = graph;
+    ConvergenceOptions convergenceOptions = DefaultConvergenceOptions();
+    convergenceOptions.maximumIterations = kForestIterations;
+    BenchmarkClock::time_point startTime = BenchmarkClock::now();
+    ConvergenceState state = RunToConvergence(whole, DefaultLayoutOptions(), convergenceOptions);
+    double seconds = GetSeconds(startTime);
+    stringstream wholeName;
+    wholeName << "whole, " << state.iterations;
+    PrintResult(wholeName.str(), seconds, CalculateAreaPerNode(whole));
+
+    double padding = DefaultComponentOptions().padding;
+    bool apart = true;
+    size_t threadCounts[] = { 1, DefaultThreadCount() };
+    for(size_t i = 0; i < 2; i++) {
+        if(i > 0 && threadCounts[i] == 1) break;
+        ComponentOptions options = DefaultComponentOptions();
+        options.numberOfThreads = threadCounts[i];
+        SimpleGraph packed = graph;
+        startTime = BenchmarkClock::now();
+        size_t components = ComponentLayout(packed, DefaultLayoutOptions(),
+                                            DefaultConvergenceOptions(), options);
+        seconds = GetSeconds(startTime);
+        stringstream packedName;
+        packedName << components << " parts, " << threadCounts[i] << " threads";
+        PrintResult(packedName.str(), seconds, CalculateAreaPerNode(packed));
+        if(!PaddedBoxesApart(packed, padding)) apart = false;
+    }
+
+    vector<size_t> components;
+    size_t numberOfComponents = FindComponents(whole.nodes.size(), whole.edges, components);
+    SimpleGraph repacked = whole;
+    PackComponents(repacked, components, numberOfComponents, padding);
+    if(!PaddedBoxesApart(repacked, padding)) apart = false;
+    bool translated = OnlyTranslated(whole, repacked);
+    cout << "  Packed components' padded boxes " << (apart ? "are" : "are NOT") << " apart"
+         << endl;
+    cout << "  Packing " << (translated ? "only moved" : "DID NOT only move")
+         << " the components" << endl << endl;
+    return apart && translated;
+}
+
+/*
+ * SampledSpatialError
+ * Returns the largest error of the forces in
+ * approximate, relative to each node's exact force, over
+ * kSpatialSamples nodes spread through the arrays.  The
+ * exact forces are summed directly for just those nodes.
+ */
+double SampledSpatialError(const SpatialArrays& positions, const SpatialArrays& approximate) {
+    double result = 0;
+    size_t stride = max(positions.size() / kSpatialSamples, (size_t) 1);
+    for(size_t node = 0; node < positions.size(); node += stride) {
+        double forceX = 0, forceY = 0, forceZ = 0;
+        for(size_t other = 0; other < positions.size(); other++) {
+            if(other == node) continue;
+            double dx = positions.x[node] - positions.x[other];
+            double dy = positions.y[node] - positions.y[other];
+            double dz = positions.z[node] - positions.z[other];
+            double distance = sqrt(dx * dx + dy * dy + dz * dz);
+            double fRepel = CalculateFRepel(distance);
+            forceX += fRepel * dx / distance;
+            forceY += fRepel * dy / distance;
+            forceZ += fRepel * dz / distance;
+        }
+        double errorX = forceX - approximate.x[node];
+        double errorY = forceY - approximate.y[node];
+        double errorZ = forceZ - approximate.z[node];
+        double error = sqrt(errorX * errorX + errorY * errorY + errorZ * errorZ);
+        double size = sqrt(forceX * forceX + forceY * forceY + forceZ * forceZ);
+        if(size > 0) result = max(result, error / size);
+    }
+    return result;
+}
+
+/*
+ * BenchmarkSpatialRepulsion
+ * Times one pass of the exact three-dimensional forces,
+ * on clouds small enough, and of the octree on one
+ * thread and on one per core, and prints their sampled
+ * errors.  Returns whether the octree with theta = 0
+ * matches the exact forces on clouds small enough to
+ * check.
+ */
+bool BenchmarkSpatialRepulsion(const SpatialArrays& positions) {
+    cout << "random 3D (" << positions.size() << " nodes)" << endl;
+    SpatialArrays nodeChanges;
+    BenchmarkClock::time_point startTime;
+    if(positions.size() <= kSpatialExactNodes) {
+        ResizeSpatialArrays(nodeChanges, positions.size());
+        startTime = BenchmarkClock::now();
+        CalculateSpatialRepulsiveForces(positions, nodeChanges);
+        double seconds = GetSeconds(startTime);
+        PrintResult("exact 3D", seconds, SampledSpatialError(positions, nodeChanges));
+    }
+
+    size_t threadCounts[] = { 1, DefaultThreadCount() };
+    for(size_t i = 0; i < 2; i++) {
+        if(i > 0 && threadCounts[i] == 1) break;
+        ResizeSpatialArrays(nodeChanges, positions.size());
+        startTime = BenchmarkClock::now();
+        CalculateOctreeRepulsiveForces(positions, nodeChanges, kDefaultBarnesHutTheta,
+                                       threadCounts[i]);
+        double seconds = GetSeconds(startTime);
+        stringstream octreeName;
+        octreeName << "octree, threads: " << threadCounts[i];
+        PrintResult(octreeName.str(), seconds, SampledSpatialError(positions, nodeChanges));
+    }
+
+    //Opening no cells costs O(n^2), so it is checked on the smaller clouds only
+    bool matches = true;
+    if(positions.size() <= kSpatialExactNodes) {
+        ResizeSpatialArrays(nodeChanges, positions.size());
+        startTime = BenchmarkClock::now();
+        CalculateOctreeRepulsiveForces(positions, nodeChanges, 0, 0);
+        double seconds = GetSeconds(startTime);
+        double error = SampledSpatialError(positions, nodeChanges);
+        PrintResult("octree, theta 0", seconds, error);
+        matches = error <= kForcePathTolerance;
+    }
+    cout << endl;
+    if(!matches) cout << "The octree with theta = 0 does not match the exact forces." << endl;
+    return matches;
+}
+
+/*
+ * BenchmarkSpatialLayout
+ * Lays the graph out in three dimensions from the unit
+ * sphere, with the exact forces and with the octree,
+ * until it converges or kSpatialIterations have run,
+ * and prints the time taken and final energy.  Returns
+ * whether the octree layout ended within
+ * kSpatialEnergyFactor of the exact one's energy; a
+ * plateau rule that stops the octree early fails this.
+ */
+bool BenchmarkSpatialLayout(const string& name, const SimpleGraph& graph) {
+    cout << name << " (" << graph.nodes.size() << " nodes), 3D layout" << endl;
+    cout << "  Engine                        Time        Energy" << endl;
+    RepulsionMode modes[] = { kExactRepulsion, kBarnesHutRepulsion };
+    const char* labels[] = { "exact", "octree" };
+    double energies[2];
+    for(size_t i = 0; i < 2; i++) {
+        LayoutOptions options = DefaultLayoutOptions();
+        options.repulsionMode = modes[i];
+        ConvergenceOptions convergenceOptions = DefaultConvergenceOptions();
+        convergenceOptions.maximumIterations = kSpatialIterations;
+        SpatialArrays positions;
+        InitialSpatialLayout(graph.nodes.size(), positions);
+        BenchmarkClock::time_point startTime = BenchmarkClock::now();
+        ConvergenceState state = RunSpatialToConvergence(graph, positions, options,
+                                                         convergenceOptions);
+        double seconds = GetSeconds(startTime);
+        stringstream engineName;
+        engineName << labels[i] << ", " << state.iterations;
+        PrintResult(engineName.str(), seconds, state.energy);
+        energies[i] = state.energy;
+    }
+    bool passed = energies[1] <= kSpatialEnergyFactor * energies[0];
+    cout << "  The octree layout " << (passed ? "ends" : "DOES NOT end")
+         << " near the exact energy" << endl << endl;
+    return passed;
+}
+
+/*
+ * IdenticalArrays
+ * Returns whether the two arrays hold the same bits.
+ */
+bool IdenticalArrays(const NodeArrays& arrays0, const NodeArrays& arrays1) {
+    size_t bytes = arrays0.size() * sizeof(double);
+    return arrays0.size() == arrays1.size() &&
+           memcmp(arrays0.x.data(), arrays1.x.data(), bytes) == 0 &&
+           memcmp(arrays0.y.data(), arrays1.y.data(), bytes) == 0;
+}
+
+/*
+ * BenchmarkDeterministicForces
+ * Times the deterministic kernel and the tiled kernel on
+ * each of kDeterministicThreads threads, keeping the
+ * best of kDeterministicTimedRuns passes of each, and
+ * prints the deterministic kernel's slowdown and its
+ * error against the scalar exact kernel.  Returns false
+ * if a thread count gave different bits from one thread
+ * or a slowdown exceeded kDeterministicMaximumSlowdown.
+ */
+bool BenchmarkDeterministicForces(const string& name, const SimpleGraph& graph) {
+    cout << name << " (" << graph.nodes.size() << " nodes), deterministic forces" << endl;
+    NodeArrays positions;
+    LoadNodeArrays(graph.nodes, positions);
+    NodeArrays exact = InitializeNodeChanges(positions);
+    BenchmarkClock::time_point exactStart = BenchmarkClock::now();
+    CalculateRepulsiveForces(positions, exact);
+    cout << "  scalar exact kernel" << setw(16) << fixed << setprecision(4)
+         << GetSeconds(exactStart) << " s" << endl;
+    cout << "  Threads     Deterministic          Tiled  Slowdown     Max error" << endl;
+
+    NodeArrays reference;
+    bool identical = true, bounded = true;
+    for(size_t i = 0; i < sizeof(kDeterministicThreads) / sizeof(kDeterministicThreads[0]); i++) {
+        size_t numberOfThreads = kDeterministicThreads[i];
+        NodeArrays changes;
+        double seconds = HUGE_VAL, tiledSeconds = HUGE_VAL;
+        for(size_t run = 0; run < kDeterministicTimedRuns; run++) {
+            changes = InitializeNodeChanges(positions);
+            BenchmarkClock::time_point startTime = BenchmarkClock::now();
+            CalculateDeterministicRepulsiveForces(positions, changes, numberOfThreads);
+            seconds = min(seconds, GetSeconds(startTime));
+
+            NodeArrays tiled = InitializeNodeChanges(positions);
+            startTime = BenchmarkClock::now();
+            CalculateParallelRepulsiveForces(positions, tiled, numberOfThreads);
+            tiledSeconds = min(tiledSeconds, GetSeconds(startTime));
+        }
+        if(i == 0) reference = changes;
+        if(!IdenticalArrays(reference, changes)) identical = false;
+        if(seconds > kDeterministicMaximumSlowdown * tiledSeconds) bounded = false;
+        cout << "  " << setw(7) << numberOfThreads
+             << setw(16) << fixed << setprecision(4) << seconds << " s"
+             << setw(13) << tiledSeconds << " s"
+             << setw(10) << setprecision(2) << seconds / tiledSeconds
+             << setw(14) << scientific << MaximumRelativeError(exact, changes) << endl;
+    }
+
+    cout << "  Forces " << (identical ? "are" : "are NOT")
+         << " bit-identical on every thread count" << endl;
+    cout << "  Slowdown " << (bounded ? "is" : "is NOT") << " within "
+         << fixed << setprecision(0) << kDeterministicMaximumSlowdown << " times" << endl << endl;
+    return identical && bounded;
+}
+
+/*
+ * BenchmarkDeterministicLayout
+ * Runs the graph for kDeterministicIterations
+ * iterations in deterministic mode and with the tiled
+ * kernel on each of kDeterministicThreads threads,
+ * keeping the best of kDeterministicTimedRuns runs of
+ * each, and prints the times and the slowdown.  Returns
+ * whether every deterministic layout has the same bits
+ * as the one on one thread and took no more than
+ * kDeterministicMaximumSlowdown times as long as the
+ * tiled one.
+ */
+bool BenchmarkDeterministicLayout(const string& name, const SimpleGraph& graph) {
+    cout << name << ": deterministic layout, " << kDeterministicIterations
+         << " iterations" << endl;
+    cout << "  Threads     Deterministic          Tiled  Slowdown" << endl;
+    ConvergenceOptions convergenceOptions = DefaultConvergenceOptions();
+    convergenceOptions.maximumIterations = kDeterministicIterations;
+    LayoutOptions options = DefaultLayoutOptions();
+
+    NodeArrays reference, positions;
+    bool identical = true, bounded = true;
+    for(size_t i = 0; i < sizeof(kDeterministicThreads) / sizeof(kDeterministicThreads[0]); i++) {
+        options.numberOfThreads = kDeterministicThreads[i];
+        double seconds = HUGE_VAL, tiledSeconds = HUGE_VAL;
+        for(size_t run = 0; run < kDeterministicTimedRuns; run++) {
+            SimpleGraph layout = graph;
+            options.deterministic = true;
+            BenchmarkClock::time_point startTime = BenchmarkClock::now();
+            RunToConvergence(layout, options, convergenceOptions);
+            seconds = min(seconds, GetSeconds(startTime));
+            LoadNodeArrays(layout.nodes, positions);
+
+            SimpleGraph tiled = graph;
+            options.deterministic = false;
+            startTime = BenchmarkClock::now();
+            RunToConvergence(tiled, options, convergenceOptions);
+            tiledSeconds = min(tiledSeconds, GetSeconds(startTime));
+        }
+        if(i == 0) reference = positions;
+        bool matches = IdenticalArrays(reference, positions);
+        if(!matches) identical = false;
+        if(seconds > kDeterministicMaximumSlowdown * tiledSeconds) bounded = false;
+        cout << "  " << setw(7) << kDeterministicThreads[i]
+             << setw(16) << fixed << setprecision(4) << seconds << " s"
+             << setw(13) << tiledSeconds << " s"
+             << setw(10) << setprecision(2) << seconds / tiledSeconds
+             << (matches ? "     identical" : "     DIFFERENT") << endl;
+    }
+
+    cout << "  Layouts " << (identical ? "are" : "are NOT")
+         << " bit-identical on every thread count" << endl;
+    cout << "  Slowdown " << (bounded ? "is" : "is NOT") << " within "
+         << fixed << setprecision(0) << kDeterministicMaximumSlowdown << " times" << endl << endl;
+    return identical && bounded;
+}
+
+/*
+ * BenchmarkBudget
+ * Runs copies of the graph within kBudgetSeconds on the
+ * exact engine on one thread, on one per core, in
+ * deterministic mode and in single and mixed precision,
+ * and on the Barnes-Hut, multipole and grid engines,
+ * printing the time each took, why it stopped and its
+ * iterations.  Then runs the Barnes-Hut engine for at
+ * most kBudgetIterations with no time limit.  Every
+ * engine checks its deadline part of the way through an
+ * iteration, so returns false if a run overran its
+ * budget by more than kBudgetTolerance or the iteration
+ * limit was not met.
+ */
+bool BenchmarkBudget(const string& name, const SimpleGraph& graph) {
+    cout << name << " (" << graph.nodes.size() << " nodes), budget of " << fixed
+         << setprecision(2) << kBudgetSeconds << " s" << endl;
+    cout << "  Engine                        Time  Stopped by    Iterations" << endl;
+    const char* engineNames[] = { "exact, 1 thread", "exact, threads: 0", "deterministic",
+                                  "exact, single", "exact, mixed", "Barnes-Hut", "multipole",
+                                  "grid", "Barnes-Hut, iterations" };
+    const RepulsionMode engines[] = { kExactRepulsion, kExactRepulsion, kExactRepulsion,
+                                      kExactRepulsion, kExactRepulsion, kBarnesHutRepulsion,
+                                      kFastMultipoleRepulsion, kGridRepulsion,
+                                      kBarnesHutRepulsion };
+    const size_t numberOfRuns = sizeof(engines) / sizeof(engines[0]);
+    bool passed = true;
+    for(size_t run = 0; run < numberOfRuns; run++) {
+        LayoutOptions options = DefaultLayoutOptions();
+        options.repulsionMode = engines[run];
+        if(run == 1) options.numberOfThreads = 0;
+        if(run == 2) options.deterministic = true;
+        if(run == 3) options.precision = kSinglePrecision;
+        if(run == 4) options.precision = kMixedPrecision;
+        ConvergenceOptions convergenceOptions = DefaultConvergenceOptions();
+        double seconds = kBudgetSeconds;
+        bool iterationRun = (run + 1 == numberOfRuns);
+        if(iterationRun) {
+            convergenceOptions.maximumIterations = kBudgetIterations;
+            seconds = HUGE_VAL;
+        }
+
+        SimpleGraph layout = graph;
+        BenchmarkClock::time_point startTime = BenchmarkClock::now();
+        ConvergenceState state = RunWithinBudget(layout, options, convergenceOptions, seconds);
+        double elapsed = GetSeconds(startTime);
+
+        string stoppedBy = "time";
+        if(state.converged) {
+            stoppedBy = "convergence";
+        } else if(state.iterations == convergenceOptions.maximumIterations) {
+            stoppedBy = "iterations";
+        }
+        if(elapsed > seconds + kBudgetTolerance) passed = false;
+        if(iterationRun && !state.converged && state.iterations != kBudgetIterations) {
+            passed = false;
+        }
+        cout << "  " << setw(24) << left << engineNames[run] << right
+             << setw(10) << fixed << setprecision(4) << elapsed << " s  "
+             << setw(12) << left << stoppedBy << right
+             << setw(12) << state.iterations << endl;
+    }
+    cout << "  Budgets " << (passed ? "were" : "were NOT") << " kept" << endl << endl;
+    return passed;
+}
+
+/*
+ * CheckDeadlineLimits
+ * Starts deadlines with a negative, a NaN, a zero, a
+ * huge and an infinite budget.  Returns false unless
+ * the first three have already passed, the huge one is
+ * limited but far off and the infinite one is not
+ * limited.
+ */
+bool CheckDeadlineLimits() {
+    bool passed = DeadlinePassed(StartDeadline(-1)) && DeadlinePassed(StartDeadline(NAN)) &&
+                  DeadlinePassed(StartDeadline(0));
+    LayoutDeadline huge = StartDeadline(1e300);
+    if(!huge.limited || DeadlinePassed(huge) || SecondsRemaining(huge) < 1e9) passed = false;
+    LayoutDeadline infinite = StartDeadline(HUGE_VAL);
+    if(infinite.limited || DeadlinePassed(infinite)) passed = false;
+    cout << "Deadlines for negative, NaN, zero, huge and infinite budgets "
+         << (passed ? "were" : "were NOT") << " as expected" << endl << endl;
+    return passed;
+}
+
+/*
+ * CheckLongPathSearch
+ * Searches a path of kLongPathNodes nodes, longer than
+ * the depths can count, from one end, then lays it out
+ * by pivot MDS, whose pivots are found by the same
+ * searches.  Returns false unless every depth is its
+ * distance, saturated at kMaximumDepth, and every node
+ * entered the queue once.
+ */
+bool CheckLongPathSearch() {
+    SimpleGraph graph;
+    for(size_t n = 0; n < kLongPathNodes; n++) {
+        Node node = { 0, 0 };
+        graph.nodes.push_back(node);
+        if(n > 0) {
+            Edge edge = { n - 1, n };
+            graph.edges.push_back(edge);
+        }
+    }
+    Adjacency adjacency;
+    BuildAdjacency(graph.nodes.size(), graph.edges, adjacency);
+    vector<unsigned short> depth(kLongPathNodes);
+    vector<size_t> queue(kLongPathNodes);
+    bool passed = BreadthFirstSearch(adjacency, 0, depth, queue) == kMaximumDepth;
+    for(size_t n = 0; n < kLongPathNodes; n++) {
+        if(depth[n] != min(n, (size_t) kMaximumDepth) || queue[n] != n) passed = false;
+    }
+    PivotMdsLayout(graph, kBenchmarkPivots);
+    cout << "Depths on a path of " << kLongPathNodes << " nodes "
+         << (passed ? "were" : "were NOT") << " saturated at " << kMaximumDepth << endl << endl;
+    return passed;
+}
+
+/*
+ * BenchmarkPassBudgets
+ * Runs ForceAtlas2 on the exact, Barnes-Hut and grid
+ * engines, the spatial layout on the exact and octree
+ * engines, and the multilevel start on the exact
+ * engine, as the visualizer does, within
+ * kBudgetSeconds, printing the time each took and its
+ * iterations, or for the multilevel start its levels.
+ * Every one of them can stop part of the way through
+ * an iteration, so returns false if any overran its
+ * budget by more than kBudgetTolerance.
+ */
+bool BenchmarkPassBudgets(const string& name, const SimpleGraph& graph) {
+    cout << name << " (" << graph.nodes.size() << " nodes), budget of " << fixed
+         << setprecision(2) << kBudgetSeconds << " s" << endl;
+    cout << "  Layout                        Time    Iterations" << endl;
+    const char* layoutNames[] = { "ForceAtlas2, exact", "ForceAtlas2, Barnes-Hut",
+                                  "ForceAtlas2, grid", "spatial, exact", "spatial, octree",
+                                  "multilevel, exact" };
+    const size_t numberOfRuns = sizeof(layoutNames) / sizeof(layoutNames[0]);
+    Adjacency adjacency;
+    BuildAdjacency(graph.nodes.size(), graph.edges, adjacency);
+    bool passed = true;
+    for(size_t run = 0; run < numberOfRuns; run++) {
+        LayoutOptions layoutOptions = DefaultLayoutOptions();
+        if(run == 1 || run == 4) {
+            layoutOptions.repulsionMode = kBarnesHutRepulsion;
+            layoutOptions.numberOfThreads = 0;
+        }
+        if(run == 2) layoutOptions.repulsionMode = kGridRepulsion;
+
+        size_t iterations = 0;
+        BenchmarkClock::time_point startTime = BenchmarkClock::now();
+        LayoutDeadline deadline = StartDeadline(kBudgetSeconds);
+        if(run < 3) {
+            ForceAtlas2Options options = DefaultForceAtlas2Options();
+            ForceAtlas2State state = InitializeForceAtlas2(adjacency, options);
+            NodeArrays positions;
+            LoadNodeArrays(graph.nodes, positions);
+            while(!state.converged && state.iterations < options.maximumIterations) {
+                if(!ForceAtlas2TransformNodeArrays(positions, adjacency, layoutOptions, options,
+                                                   state, deadline)) break;
+            }
+            iterations = state.iterations;
+        } else if(run < 5) {
+            ConvergenceOptions options = DefaultConvergenceOptions();
+            ConvergenceState state = InitializeConvergence(options);
+            SpatialArrays positions, nodeChanges;
+            InitialSpatialLayout(graph.nodes.size(), positions);
+            ResizeSpatialArrays(nodeChanges, positions.size());
+            while(!state.converged && state.iterations < options.maximumIterations) {
+                if(!AdaptiveTransformSpatialArrays(positions, adjacency, nodeChanges,
+                                                   layoutOptions, options, state, deadline)) break;
+            }
+            iterations = state.iterations;
+        } else {
+            SimpleGraph layout = graph;
+            iterations = MultilevelLayout(layout, layoutOptions, DefaultMultilevelOptions(),
+                                          deadline);
+        }
+        double elapsed = GetSeconds(startTime);
+
+        if(elapsed > kBudgetSeconds + kBudgetTolerance) passed = false;
+        cout << "  " << setw(24) << left << layoutNames[run] << right
+             << setw(10) << fixed << setprecision(4) << elapsed << " s"
+             << setw(14) << iterations << endl;
+    }
+    cout << "  Budgets " << (passed ? "were" : "were NOT") << " kept" << endl << endl;
+    return passed;
+}
+
+/*
+ * BenchmarkOverlap
+ * Removes the node overlaps from a copy of the graph as
+ * it is laid out, printing the overlaps before and
+ * after, the passes and time taken, and how far the
+ * nodes moved.  Returns false if any overlap is left.
+ */
+bool BenchmarkOverlap(const string& name, const SimpleGraph& graph, const OverlapOptions& options) {
+    SimpleGraph layout = graph;
+    BenchmarkClock::time_point startTime = BenchmarkClock::now();
+    OverlapResult result = RemoveOverlaps(layout, options);
+    double seconds = GetSeconds(startTime);
+    bool passed = result.remainingOverlaps == 0 && CountOverlaps(layout, options) == 0;
+
+    cout << name << " (" << graph.nodes.size() << " nodes), overlap removal at radius "
+         << scientific << setprecision(2) << options.nodeRadius << endl;
+    cout << "  Overlaps    Left  Passes        Time     Moved" << endl;
+    cout << "  " << setw(8) << result.initialOverlaps << setw(8) << result.remainingOverlaps
+         << setw(8) << result.passes << setw(10) << fixed << setprecision(4) << seconds << " s"
+         << setw(10) << setprecision(4) << result.displacement << endl;
+    cout << "  Overlaps " << (passed ? "were" : "were NOT") << " removed" << endl << endl;
+    return passed;
+}
+
+/*
+ * BenchmarkBundling
+ * Finds the compatible pairs of edges by measuring
+ * every pair and through the midpoint grid, on one
+ * thread each, then bundles the edges on one thread and
+ * on kBundlingThreads, printing the time each took.
+ * Returns false if the grid found different pairs, was
+ * slower where the time is long enough to measure, the
+ * bundling counted a different number of them or the
+ * paths differ between thread counts.
+ */
+bool BenchmarkBundling(const string& name, const SimpleGraph& graph) {
+    cout << name << " (" << graph.edges.size() << " edges), edge bundling" << endl;
+    cout << "  Method                        Time         Pairs" << endl;
+    BundlingOptions options = DefaultBundlingOptions();
+
+    BenchmarkClock::time_point startTime = BenchmarkClock::now();
+    vector<pair<size_t, size_t> > everyPair;
+    for(size_t i = 0; i < graph.edges.size(); i++) {
+        const Node& p0 = graph.nodes[graph.edges[i].start];
+        const Node& p1 = graph.nodes[graph.edges[i].end];
+        for(size_t j = i + 1; j < graph.edges.size(); j++) {
+            const Node& q0 = graph.nodes[graph.edges[j].start];
+            const Node& q1 = graph.nodes[graph.edges[j].end];
+            if(EdgeCompatibility(p0, p1, q0, q1) >= options.compatibility) {
+                everyPair.push_back(make_pair(i, j));
+            }
+        }
+    }
+    double everyPairSeconds = GetSeconds(startTime);
+    double seconds = everyPairSeconds;
+    cout << "  " << setw(24) << left << "every pair measured" << right
+         << setw(10) << fixed << setprecision(4) << seconds << " s"
+         << setw(14) << everyPair.size() << endl;
+
+    startTime = BenchmarkClock::now();
+    vector<pair<size_t, size_t> > gridPairs;
+    FindCompatiblePairs(graph, options.compatibility, 1, gridPairs);
+    seconds = GetSeconds(startTime);
+    cout << "  " << setw(24) << left << "midpoint grid" << right
+         << setw(10) << fixed << setprecision(4) << seconds << " s"
+         << setw(14) << gridPairs.size() << endl;
+
+    cout << "  Grid speedup " << fixed << setprecision(2) << everyPairSeconds / seconds << endl;
+
+    bool passed = gridPairs == everyPair;
+    if(everyPairSeconds >= kBundlingTimedSeconds && seconds >= everyPairSeconds) passed = false;
+    vector<vector<Node> > serialPaths;
+    size_t threadCounts[] = { 1, kBundlingThreads };
+    for(size_t run = 0; run < 2; run++) {
+        options.numberOfThreads = threadCounts[run];
+        vector<vector<Node> > paths;
+        startTime = BenchmarkClock::now();
+        size_t numberOfPairs = BundleEdges(graph, options, paths);
+        seconds = GetSeconds(startTime);
+        if(numberOfPairs != everyPair.size()) passed = false;
+        if(run == 0) {
+            serialPaths = paths;
+        } else {
+            for(size_t i = 0; i < paths.size(); i++) {
+                if(paths[i].size() != serialPaths[i].size() ||
+                   memcmp(paths[i].data(), serialPaths[i].data(),
+                          paths[i].size() * sizeof(Node)) != 0) passed = false;
+            }
+        }
+
+        stringstream label;
+        label << "bundled, " << threadCounts[run] << (run == 0 ? " thread" : " threads");
+        cout << "  " << setw(24) << left << label.str() << right
+             << setw(10) << fixed << setprecision(4) << seconds << " s"
+             << setw(14) << numberOfPairs << endl;
+    }
+    cout << "  Pairs and paths " << (passed ? "match" : "DO NOT match") << endl << endl;
+    return passed;
+}
+
+/* Main function */
+
+int main(int argc, char* argv[]) {
+    cout << "Engine                     Time          Max error" << endl;
+    bool passed = true;
+
+    //Graph files, after the layout has had time to spread out
+    for(int arg = 1; arg < argc; arg++) {
+        SimpleGraph graph;
+        if(!LoadGraphFile(argv[arg], graph) || graph.nodes.size() < 2) {
+            cout << argv[arg] << " could not be loaded." << endl;
+            continue;
+        }
+        if(!CompareForcePaths(argv[arg], graph)) passed = false;
+        BenchmarkInitialLayouts(argv[arg], graph);
+        if(!BenchmarkConvergence(argv[arg], graph)) passed = false;
+        BenchmarkStress(argv[arg], graph);
+        BenchmarkPrecision(argv[arg], graph);
+        BenchmarkForceModels(argv[arg], graph);
+        if(!CheckSelfLoopAttraction(argv[arg], graph)) passed = false;
+        if(!BenchmarkForceAtlas2(argv[arg], graph)) passed = false;
+        if(!BenchmarkIncremental(argv[arg], graph)) passed = false;
+        if(!BenchmarkSpatialLayout(argv[arg], graph)) passed = false;
+        if(!BenchmarkDeterministicLayout(argv[arg], graph)) passed = false;
+        if(!BenchmarkBudget(argv[arg], graph)) passed = false;
+
+        SimpleGraph converged = graph;
+        RunToConvergence(converged, DefaultLayoutOptions(), DefaultConvergenceOptions());
+        if(!BenchmarkOverlap(argv[arg], converged, DefaultOverlapOptions())) passed = false;
+        if(!BenchmarkBundling(argv[arg], converged)) passed = false;
+        BenchmarkGridCutoff(argv[arg], converged);
+
+        if(!CheckBarnesHutError(argv[arg], graph)) passed = false;
+        LayoutOptions options = DefaultLayoutOptions();
+        for(size_t iteration = 0; iteration < kWarmupIterations; iteration++) {
+            TransformGraph(graph, options);
+        }
+        if(!CheckBarnesHutError(argv[arg], graph)) passed = false;
+        BenchmarkRepulsion(argv[arg], graph);
+        if(!BenchmarkAttraction(argv[arg], graph)) passed = false;
+    }
+
+    if(!CheckVectorRange()) passed = false;
+    if(!CheckBundledConvergence()) passed = false;
+
+    //Random point clouds of increasing size
+    size_t numberOfSizes = sizeof(kRandomGraphSizes) / sizeof(kRandomGraphSizes[0]);
+    for(size_t i = 0; i < numberOfSizes; i++) {
+        SimpleGraph graph = CreateRandomGraph(kRandomGraphSizes[i]);
+        BenchmarkRepulsion("random", graph);
+    }
+
+    //Random point clouds in three dimensions
+    for(size_t i = 0; i < sizeof(kSpatialGraphSizes) / sizeof(kSpatialGraphSizes[0]); i++) {
+        if(!BenchmarkSpatialRepulsion(CreateRandomSpatialArrays(kSpatialGraphSizes[i]))) {
+            passed = false;
+        }
+    }
+
+    if(!BenchmarkDeterministicForces("random", CreateRandomGraph(kDeterministicNodes))) {
+        passed = false;
+    }
+    if(!CheckModelRepulsion("random", CreateRandomGraph(kModelRepulsionNodes))) passed = false;
+
+    //Random point clouds, with room for every node at its radius
+    for(size_t i = 0; i < sizeof(kOverlapGraphSizes) / sizeof(kOverlapGraphSizes[0]); i++) {
+        OverlapOptions options = DefaultOverlapOptions();
+        options.nodeRadius = kOverlapDensity / sqrt((double) kOverlapGraphSizes[i]);
+        if(!BenchmarkOverlap("random", CreateRandomGraph(kOverlapGraphSizes[i]), options)) {
+            passed = false;
+        }
+    }
+
+    //Grids spread wider than the cutoff, where the grid engine pays off
+    for(size_t i = 0; i < sizeof(kCutoffGridSizes) / sizeof(kCutoffGridSizes[0]); i++) {
+        SimpleGraph graph = CreateGridGraph(kCutoffGridSizes[i]);
+        PlaceOnLattice(graph, kCutoffGridSizes[i]);
+        LayoutOptions options = DefaultLayoutOptions();
+        options.repulsionMode = kGridRepulsion;
+        ConvergenceOptions convergenceOptions = DefaultConvergenceOptions();
+        convergenceOptions.maximumIterations = kCutoffIterations;
+        RunToConvergence(graph, options, convergenceOptions);
+        stringstream cutoffName;
+        cutoffName << kCutoffGridSizes[i] << "grid";
+        BenchmarkGridCutoff(cutoffName.str(), graph);
+    }
+
+    stringstream budgetName;
+    budgetName << kBudgetGridSize << "grid";
+    if(!BenchmarkBudget(budgetName.str(), CreateGridGraph(kBudgetGridSize))) passed = false;
+    if(!CheckDeadlineLimits()) passed = false;
+    if(!CheckLongPathSearch()) passed = false;
+    if(!BenchmarkPassBudgets(budgetName.str(), CreateGridGraph(kBudgetGridSize))) passed = false;
+
+    stringstream gridName;
+    gridName << kMultilevelGridSize << "grid";
+    BenchmarkInitialLayouts(gridName.str(), CreateGridGraph(kMultilevelGridSize));
+    if(!BenchmarkConvergence(gridName.str(), CreateGridGraph(kMultilevelGridSize))) passed = false;
+    BenchmarkStress(gridName.str(), CreateGridGraph(kMultilevelGridSize));
+
+    stringstream scaleFreeName;
+    scaleFreeName << "scale-free " << kScaleFreeNodes;
+    if(!BenchmarkForceAtlas2(scaleFreeName.str(),
+                             CreateScaleFreeGraph(kScaleFreeNodes, kScaleFreeEdgesPerNode))) {
+        passed = false;
+    }
+    if(!BenchmarkIncremental(scaleFreeName.str(),
+                             CreateScaleFreeGraph(kScaleFreeNodes, kScaleFreeEdgesPerNode))) {
+        passed = false;
+    }
+
+    if(!BenchmarkBundling(scaleFreeName.str(),
+                          CreateScaleFreeGraph(kScaleFreeNodes, kScaleFreeEdgesPerNode))) {
+        passed = false;
+    }
+
+    stringstream forestName;
+    forestName << kForestTrees << " trees";
+    if(!BenchmarkComponents(forestName.str(), CreateForestGraph(kForestTrees, kForestTreeSize))) {
+        passed = false;
+    }
+
+    stringstream attractionName;
+    attractionName << kAttractionGridSize << "grid";
+    if(!BenchmarkAttraction(attractionName.str(), CreateGridGraph(kAttractionGridSize))) {
+        passed = false;
+    }
+
+    SimpleGraph largest = CreateRandomGraph(kRandomGraphSizes[numberOfSizes - 1]);
+    if(!BenchmarkScaling("random", largest)) passed = false;
+    return passed ? 0 : 1;
+}
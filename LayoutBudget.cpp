@@ -0,0 +1,69 @@
+/******************************************************
+ * File: LayoutBudget.cpp
+ *
+ * Implementation of the LayoutBudget.h interface.
+ */
+
+#include <cmath>
+#include "LayoutBudget.h"
+using namespace std;
+
+/*
+ * StartDeadline
+ * Reads the clock once for both ends of the budget.  A
+ * rejected budget ends where it starts.  The cast from
+ * seconds to clock ticks overflows past the end of the
+ * clock, so any budget over half of the time left on
+ * it, about a century, ends at its last tick instead;
+ * the half leaves room for the rounding of the double.
+ */
+LayoutDeadline StartDeadline(double seconds) {
+    LayoutDeadline deadline;
+    deadline.start = LayoutClock::now();
+    deadline.end = deadline.start;
+    deadline.limited = !(std::isinf(seconds) && seconds > 0);
+    if (!deadline.limited || !(seconds > 0)) return deadline;
+
+    LayoutClock::duration room = LayoutClock::time_point::max() - deadline.start;
+    if (seconds < chrono::duration<double>(room).count() / 2) {
+        deadline.end += chrono::duration_cast<LayoutClock::duration>(
+                            chrono::duration<double>(seconds));
+    } else {
+        deadline.end = LayoutClock::time_point::max();
+    }
+    return deadline;
+}
+
+/*
+ * DeadlinePassed
+ * Only reads the clock for limited deadlines.
+ */
+bool DeadlinePassed(const LayoutDeadline& deadline) {
+    return deadline.limited && LayoutClock::now() >= deadline.end;
+}
+
+/*
+ * SecondsSinceStart
+ * Converts the elapsed clock ticks to seconds.
+ */
+double SecondsSinceStart(const LayoutDeadline& deadline) {
+    return chrono::duration<double>(LayoutClock::now() - deadline.start).count();
+}
+
+/*
+ * SecondsRemaining
+ * Converts the clock ticks left to seconds.
+ */
+double SecondsRemaining(const LayoutDeadline& deadline) {
+    if (!deadline.limited) return HUGE_VAL;
+    return chrono::duration<double>(deadline.end - LayoutClock::now()).count();
+}
+
+/*
+ * IterationFitsBudget
+ * Takes the last iteration as the estimate of the next.
+ */
+bool IterationFitsBudget(const LayoutDeadline& deadline, double lastIterationSeconds) {
+    if (DeadlinePassed(deadline)) return false;
+    return lastIterationSeconds <= SecondsRemaining(deadline);
+}
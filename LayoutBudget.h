@@ -0,0 +1,86 @@
+/*************************************************************************
+ * File: LayoutBudget.h
+ *
+ * A header file defining the time budgets layouts can be run under.  A
+ * deadline is taken from the monotonic steady_clock, which does not jump
+ * when the wall clock is set and resolves far less than a second, so a
+ * layout can be bounded to, for example, 150 milliseconds.
+ *
+ * Reading the clock costs about as much as a few dozen force pairs, so
+ * the engines that can stop part of the way through an iteration check
+ * their deadline once per tile or block of nodes rather than once per
+ * pair.  See RunWithinBudget() in AdaptiveStep.h for the driver.
+ */
+
+#ifndef LayoutBudget_Included // Include guard
+#define LayoutBudget_Included
+
+#include <cstddef> // For the size_t type.
+#include <chrono>  // For the steady_clock type.
+
+/* The clock every budget is measured on. */
+typedef std::chrono::steady_clock LayoutClock;
+
+/* Number of nodes or cells a tree or grid engine visits between two checks of its deadline. */
+const size_t kDeadlineCheckNodes = 64;
+
+/* Number of pairs an all-pairs engine visits between two checks of its deadline. */
+const size_t kDeadlineCheckPairs = 65536;
+
+/**
+ * Type: LayoutDeadline
+ * -----------------------------------------------------------------------
+ * The moment a budget was started and the moment it runs out.  A
+ * deadline that is not limited never runs out.
+ */
+struct LayoutDeadline {
+    LayoutClock::time_point start;
+    LayoutClock::time_point end;
+    bool limited;
+};
+
+/**
+ * Function: StartDeadline(double seconds)
+ * -----------------------------------------------------------------------
+ * Returns a deadline the given number of seconds from now, which may be
+ * a fraction of a second.  An infinite budget gives a deadline that is
+ * not limited.  A negative or NaN budget is rejected: the deadline has
+ * already passed, so no work is started under it.  A budget longer than
+ * the clock can count ends at the clock's last tick.
+ */
+LayoutDeadline StartDeadline(double seconds);
+
+/**
+ * Function: DeadlinePassed(const LayoutDeadline& deadline)
+ * -----------------------------------------------------------------------
+ * Returns whether the deadline is limited and has run out.
+ */
+bool DeadlinePassed(const LayoutDeadline& deadline);
+
+/**
+ * Function: SecondsSinceStart(const LayoutDeadline& deadline)
+ * -----------------------------------------------------------------------
+ * Returns the time elapsed since the deadline was started, in seconds.
+ */
+double SecondsSinceStart(const LayoutDeadline& deadline);
+
+/**
+ * Function: SecondsRemaining(const LayoutDeadline& deadline)
+ * -----------------------------------------------------------------------
+ * Returns the time left before the deadline, in seconds, which is
+ * negative once it has passed and infinite if it is not limited.
+ */
+double SecondsRemaining(const LayoutDeadline& deadline);
+
+/**
+ * Function: IterationFitsBudget(const LayoutDeadline& deadline,
+ *                               double lastIterationSeconds)
+ * -----------------------------------------------------------------------
+ * Returns whether another iteration should be started: the deadline has
+ * not passed, and an iteration as long as the last one, which took
+ * lastIterationSeconds, would end before it.  Loops whose iterations can
+ * stop part of the way through pass zero, since they cannot overrun.
+ */
+bool IterationFitsBudget(const LayoutDeadline& deadline, double lastIterationSeconds);
+
+#endif
@@ -0,0 +1,35 @@
+/******************************************************
+ * File: LayoutGeometry.cpp
+ *
+ * Implementation of the LayoutGeometry.h interface.
+ */
+
+#include <cmath>
+#include "LayoutGeometry.h"
+using namespace std;
+
+/*
+ * PlaceAtUnitEdgeLength
+ * Measures the mean edge length, then scales and nudges
+ * every node.
+ */
+void PlaceAtUnitEdgeLength(const vector<double>& x, const vector<double>& y, double nudge,
+                           SimpleGraph& graph) {
+    double totalLength = 0;
+    size_t numberOfEdges = 0;
+    for (size_t i = 0; i < graph.edges.size(); i++) {
+        size_t start = graph.edges[i].start, end = graph.edges[i].end;
+        if (start == end) continue;
+        double dx = x[start] - x[end];
+        double dy = y[start] - y[end];
+        totalLength += sqrt(dx * dx + dy * dy);
+        numberOfEdges++;
+    }
+    double scale = (totalLength > 0) ? numberOfEdges / totalLength : 1;
+
+    for (size_t node = 0; node < graph.nodes.size(); node++) {
+        double angle = kGoldenAngle * node;
+        graph.nodes[node].x = scale * x[node] + nudge * cos(angle);
+        graph.nodes[node].y = scale * y[node] + nudge * sin(angle);
+    }
+}
@@ -0,0 +1,38 @@
+/*************************************************************************
+ * File: LayoutGeometry.h
+ *
+ * A header file defining the constants and helpers that several layout
+ * engines share when placing nodes.  The golden angle turns each of a
+ * run of nodes away from the one before by an irrational fraction of a
+ * full turn, so that no two of them, however many there are, ever point
+ * the same way.
+ */
+
+#ifndef LayoutGeometry_Included // Include guard
+#define LayoutGeometry_Included
+
+#include "SimpleGraph.h" // For the SimpleGraph type.
+
+/* Constants */
+const double kPi = 3.14159265358979323;
+
+/* The golden angle, pi * (3 - sqrt(5)), in radians. */
+const double kGoldenAngle = 2.39996322972865332;
+
+/**
+ * Function: PlaceAtUnitEdgeLength(const vector<double>& x,
+ *                                 const vector<double>& y,
+ *                                 double nudge, SimpleGraph& graph)
+ * -----------------------------------------------------------------------
+ * Moves node i of the graph to (x[i], y[i]), scaled about the origin so
+ * that the mean length of its edges is one, and then nudged by nudge
+ * edge lengths in a direction turned by the golden angle from node to
+ * node.  Nodes that the coordinates place on top of each other are thus
+ * pulled apart, so that the forces between them have a direction.
+ * Self-loops do not count towards the mean; if every edge has zero
+ * length the coordinates are not scaled.
+ */
+void PlaceAtUnitEdgeLength(const vector<double>& x, const vector<double>& y, double nudge,
+                           SimpleGraph& graph);
+
+#endif
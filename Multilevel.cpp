@@ -0,0 +1,234 @@
+/******************************************************
+ * File: Multilevel.cpp
+ *
+ * Implementation of the Multilevel.h interface.  Each
+ * level records, for each of its nodes, the node of the
+ * next coarser level it was collapsed into.  Nodes are
+ * weighted by the number of original nodes they stand
+ * for, and the matching prefers light partners so that
+ * the coarse nodes stay of similar size.
+ */
+
+#include <cmath>
+#include <algorithm>
+#include "Multilevel.h"
+#include "Adjacency.h"
+#include "LayoutGeometry.h"
+using namespace std;
+
+/* Coarsening stops if a matching leaves more than this fraction of the nodes. */
+const double kMinimumCoarseningRatio = 0.8;
+
+/* Distance, as a fraction of an edge's rest length, between collapsed nodes when separated. */
+const double kProlongationOffset = 0.1;
+
+/* Marks a node that has not been matched yet. */
+const size_t kUnmatched = (size_t) -1;
+
+/* One graph in the hierarchy. */
+struct GraphLevel {
+    size_t numberOfNodes;
+    vector<Edge> edges;
+    vector<size_t> weights;  // original nodes represented by each node
+    vector<size_t> parents;  // node of the next coarser level holding each node
+};
+
+/*
+ * DefaultMultilevelOptions
+ * Returns the default parameters.
+ */
+MultilevelOptions DefaultMultilevelOptions() {
+    MultilevelOptions options;
+    options.coarsestSize = kDefaultCoarsestSize;
+    options.coarsestIterations = kDefaultCoarsestIterations;
+    options.refinementIterations = kDefaultRefinementIterations;
+    return options;
+}
+
+/*
+ * CoarsenLevel
+ * Collapses a maximal matching of the fine level into
+ * the coarse level.  Nodes are visited from the lowest
+ * degree up, so that leaves are matched before their
+ * hubs are taken, and each is matched to its lightest
+ * unmatched neighbour.  Returns false, leaving the fine
+ * level without parents, if the matching is too small
+ * to be worth another level.
+ */
+static bool CoarsenLevel(GraphLevel& fine, GraphLevel& coarse) {
+    size_t numberOfNodes = fine.numberOfNodes;
+    Adjacency adjacency;
+    BuildAdjacency(numberOfNodes, fine.edges, adjacency);
+
+    vector<pair<size_t, size_t> > order(numberOfNodes);
+    for (size_t node = 0; node < numberOfNodes; node++) {
+        order[node] = make_pair(adjacency.degree(node), node);
+    }
+    sort(order.begin(), order.end());
+
+    fine.parents.assign(numberOfNodes, kUnmatched);
+    coarse.numberOfNodes = 0;
+    coarse.weights.clear();
+    for (size_t i = 0; i < numberOfNodes; i++) {
+        size_t node = order[i].second;
+        if (fine.parents[node] != kUnmatched) continue;
+
+        size_t partner = kUnmatched;
+        for (size_t k = adjacency.offsets[node]; k < adjacency.offsets[node + 1]; k++) {
+            size_t neighbour = adjacency.targets[k];
+            if (fine.parents[neighbour] != kUnmatched) continue;
+            if (partner == kUnmatched || fine.weights[neighbour] < fine.weights[partner]) {
+                partner = neighbour;
+            }
+        }
+
+        fine.parents[node] = coarse.numberOfNodes;
+        size_t weight = fine.weights[node];
+        if (partner != kUnmatched) {
+            fine.parents[partner] = coarse.numberOfNodes;
+            weight += fine.weights[partner];
+        }
+        coarse.weights.push_back(weight);
+        coarse.numberOfNodes++;
+    }
+
+    if (coarse.numberOfNodes > kMinimumCoarseningRatio * numberOfNodes) {
+        fine.parents.clear();
+        return false;
+    }
+
+    //Edges inside a matched pair vanish, and parallel edges merge
+    vector<pair<size_t, size_t> > coarseEdges;
+    for (size_t i = 0; i < fine.edges.size(); i++) {
+        size_t start = fine.parents[fine.edges[i].start];
+        size_t end = fine.parents[fine.edges[i].end];
+        if (start == end) continue;
+        coarseEdges.push_back(make_pair(min(start, end), max(start, end)));
+    }
+    sort(coarseEdges.begin(), coarseEdges.end());
+    coarseEdges.erase(unique(coarseEdges.begin(), coarseEdges.end()), coarseEdges.end());
+
+    coarse.edges.resize(coarseEdges.size());
+    for (size_t i = 0; i < coarseEdges.size(); i++) {
+        coarse.edges[i].start = coarseEdges[i].first;
+        coarse.edges[i].end = coarseEdges[i].second;
+    }
+    return true;
+}
+
+/*
+ * ProlongPositions
+ * Places every node of the fine level at the position of
+ * its coarse node.  The coarse layout is first scaled
+ * about its centroid by the square root of the growth in
+ * node count, since a layout's area grows with its
+ * number of nodes.  The second node of a matched pair is
+ * offset slightly so the two do not coincide.
+ */
+static void ProlongPositions(const GraphLevel& fine, const NodeArrays& coarsePositions,
+                             NodeArrays& finePositions) {
+    size_t numberOfCoarseNodes = coarsePositions.size();
+    double centerX = 0, centerY = 0;
+    for (size_t node = 0; node < numberOfCoarseNodes; node++) {
+        centerX += coarsePositions.x[node];
+        centerY += coarsePositions.y[node];
+    }
+    centerX /= numberOfCoarseNodes;
+    centerY /= numberOfCoarseNodes;
+    double scale = sqrt((double) fine.numberOfNodes / numberOfCoarseNodes);
+
+    ResizeNodeArrays(finePositions, fine.numberOfNodes);
+    vector<bool> placed(numberOfCoarseNodes, false);
+    for (size_t node = 0; node < fine.numberOfNodes; node++) {
+        size_t parent = fine.parents[node];
+        double x = centerX + scale * (coarsePositions.x[parent] - centerX);
+        double y = centerY + scale * (coarsePositions.y[parent] - centerY);
+        if (placed[parent]) {
+            //A golden-angle turn per node keeps the offsets spread out
+            double angle = kGoldenAngle * node;
+            x += kProlongationOffset * cos(angle);
+            y += kProlongationOffset * sin(angle);
+        }
+        placed[parent] = true;
+        finePositions.x[node] = x;
+        finePositions.y[node] = y;
+    }
+}
+
+/*
+ * RelaxLevel
+ * Runs the given number of layout iterations on one
+ * level, or as many as fit before the deadline.  An
+ * iteration the deadline stops part of the way through
+ * is dropped.
+ */
+static void RelaxLevel(const GraphLevel& level, NodeArrays& positions,
+                       const LayoutOptions& layoutOptions, size_t iterations,
+                       const LayoutDeadline& deadline) {
+    Adjacency adjacency;
+    BuildAdjacency(level.numberOfNodes, level.edges, adjacency);
+    NodeArrays nodeChanges = InitializeNodeChanges(positions);
+    bool interruptible = InterruptibleForces(layoutOptions);
+    double lastIterationSeconds = 0;
+    for (size_t iteration = 0; iteration < iterations; iteration++) {
+        if (!IterationFitsBudget(deadline, interruptible ? 0 : lastIterationSeconds)) return;
+        double iterationStart = SecondsSinceStart(deadline);
+        if (!CalculateNodeForces(positions, adjacency, nodeChanges, layoutOptions, deadline)) {
+            ClearNodeArrays(nodeChanges);
+            return;
+        }
+        UpdateNodeMovements(positions, nodeChanges);
+        lastIterationSeconds = SecondsSinceStart(deadline) - iterationStart;
+    }
+}
+
+/*
+ * MultilevelLayout
+ * Runs against a deadline that never passes.
+ */
+size_t MultilevelLayout(SimpleGraph& graph, const LayoutOptions& layoutOptions,
+                        const MultilevelOptions& options) {
+    return MultilevelLayout(graph, layoutOptions, options, StartDeadline(HUGE_VAL));
+}
+
+/*
+ * MultilevelLayout
+ * Builds the hierarchy, lays out the coarsest graph from
+ * the unit circle, and refines the layout back down to
+ * the original graph.
+ */
+size_t MultilevelLayout(SimpleGraph& graph, const LayoutOptions& layoutOptions,
+                        const MultilevelOptions& options, const LayoutDeadline& deadline) {
+    size_t numberOfNodes = graph.nodes.size();
+    if (numberOfNodes == 0) return 0;
+
+    vector<GraphLevel> levels(1);
+    levels[0].numberOfNodes = numberOfNodes;
+    levels[0].edges = graph.edges;
+    levels[0].weights.assign(numberOfNodes, 1);
+    while (levels.back().numberOfNodes > options.coarsestSize) {
+        GraphLevel coarse;
+        if (!CoarsenLevel(levels.back(), coarse)) break;
+        levels.push_back(coarse);
+    }
+
+    const GraphLevel& coarsest = levels.back();
+    NodeArrays positions;
+    ResizeNodeArrays(positions, coarsest.numberOfNodes);
+    for (size_t node = 0; node < coarsest.numberOfNodes; node++) {
+        positions.x[node] = cos(2 * kPi * (double) node / coarsest.numberOfNodes);
+        positions.y[node] = sin(2 * kPi * (double) node / coarsest.numberOfNodes);
+    }
+    RelaxLevel(coarsest, positions, layoutOptions, options.coarsestIterations, deadline);
+
+    for (size_t level = levels.size() - 1; level-- > 0; ) {
+        NodeArrays finePositions;
+        ProlongPositions(levels[level], positions, finePositions);
+        positions = finePositions;
+        RelaxLevel(levels[level], positions, layoutOptions, options.refinementIterations,
+                   deadline);
+    }
+
+    StoreNodeArrays(positions, graph.nodes);
+    return levels.size();
+}
@@ -0,0 +1,81 @@
+/*************************************************************************
+ * File: Multilevel.h
+ *
+ * A header file defining a multilevel driver for the force-directed
+ * layout.  Starting every node on the unit circle, plain
+ * Fruchterman-Reingold needs a very large number of iterations to
+ * untangle a big graph, because each iteration only moves nodes by the
+ * forces of their immediate surroundings.
+ *
+ * The multilevel driver instead coarsens the graph repeatedly, each time
+ * collapsing a maximal matching of its edges so that the graph roughly
+ * halves, until only a handful of nodes remain.  That coarsest graph is
+ * cheap to lay out well.  Its layout is then carried back down one
+ * level at a time: every node starts where the node it was collapsed
+ * into ended up, and a few iterations of the usual layout step refine
+ * the result.  The global shape is settled on the small graphs and only
+ * local detail is left to the large ones, as in Walshaw's multilevel
+ * algorithm and FM3.
+ */
+
+#ifndef Multilevel_Included // Include guard
+#define Multilevel_Included
+
+#include "SimpleGraph.h" // For the SimpleGraph type.
+#include "ForceLayout.h" // For the LayoutOptions type.
+
+/* Default parameters of the multilevel driver. */
+const size_t kDefaultCoarsestSize = 16;
+const size_t kDefaultCoarsestIterations = 500;
+const size_t kDefaultRefinementIterations = 50;
+
+/**
+ * Type: MultilevelOptions
+ * -----------------------------------------------------------------------
+ * Parameters controlling the multilevel driver.  Coarsening stops once a
+ * graph has no more than coarsestSize nodes, or once a matching no
+ * longer shrinks the graph appreciably, as happens for stars.  The
+ * coarsest graph is laid out with coarsestIterations iterations, and
+ * every finer graph is refined with refinementIterations.
+ */
+struct MultilevelOptions {
+    size_t coarsestSize;
+    size_t coarsestIterations;
+    size_t refinementIterations;
+};
+
+/**
+ * Function: DefaultMultilevelOptions()
+ * -----------------------------------------------------------------------
+ * Returns the default multilevel parameters.
+ */
+MultilevelOptions DefaultMultilevelOptions();
+
+/**
+ * Function: MultilevelLayout(SimpleGraph& graph,
+ *                            const LayoutOptions& layoutOptions,
+ *                            const MultilevelOptions& options)
+ * -----------------------------------------------------------------------
+ * Lays out the graph from scratch with the multilevel scheme, running
+ * every layout iteration with layoutOptions.  The nodes' previous
+ * positions are ignored.  Returns the number of levels used, counting
+ * the graph itself.
+ */
+size_t MultilevelLayout(SimpleGraph& graph, const LayoutOptions& layoutOptions,
+                        const MultilevelOptions& options);
+
+/**
+ * Function: MultilevelLayout(SimpleGraph& graph,
+ *                            const LayoutOptions& layoutOptions,
+ *                            const MultilevelOptions& options,
+ *                            const LayoutDeadline& deadline)
+ * -----------------------------------------------------------------------
+ * The same, against a deadline, in the way of RunWithinBudget() in
+ * AdaptiveStep.h.  Once the deadline has passed, or the next iteration
+ * would overrun it, no more iterations are run, but the positions are
+ * still carried down to the graph itself, so every node is placed.
+ */
+size_t MultilevelLayout(SimpleGraph& graph, const LayoutOptions& layoutOptions,
+                        const MultilevelOptions& options, const LayoutDeadline& deadline);
+
+#endif
@@ -0,0 +1,80 @@
+/******************************************************
+ * File: NodeArrays.cpp
+ *
+ * Implementation of the NodeArrays.h interface.
+ */
+
+#include "NodeArrays.h"
+using namespace std;
+
+/*
+ * ResizeNodeArrays
+ * Resizes both coordinate arrays, zeroing them.
+ */
+template <typename Scalar>
+void ResizeNodeArrays(BasicNodeArrays<Scalar>& arrays, size_t numberOfNodes) {
+    arrays.x.resize(numberOfNodes);
+    arrays.y.resize(numberOfNodes);
+}
+
+/*
+ * ClearNodeArrays
+ * Zeroes both coordinate arrays.
+ */
+template <typename Scalar>
+void ClearNodeArrays(BasicNodeArrays<Scalar>& arrays) {
+    arrays.x.fill(0);
+    arrays.y.fill(0);
+}
+
+//The precisions the layout engine uses
+template void ResizeNodeArrays(BasicNodeArrays<double>& arrays, size_t numberOfNodes);
+template void ResizeNodeArrays(BasicNodeArrays<float>& arrays, size_t numberOfNodes);
+template void ClearNodeArrays(BasicNodeArrays<double>& arrays);
+template void ClearNodeArrays(BasicNodeArrays<float>& arrays);
+
+/*
+ * LoadNodeArrays
+ * Splits the nodes' coordinates into the two arrays.
+ */
+void LoadNodeArrays(const vector<Node>& nodes, NodeArrays& arrays) {
+    if (arrays.size() != nodes.size()) {
+        ResizeNodeArrays(arrays, nodes.size());
+    }
+    for (size_t i = 0; i < nodes.size(); i++) {
+        arrays.x[i] = nodes[i].x;
+        arrays.y[i] = nodes[i].y;
+    }
+}
+
+/*
+ * StoreNodeArrays
+ * Interleaves the two arrays back into the nodes.
+ */
+void StoreNodeArrays(const NodeArrays& arrays, vector<Node>& nodes) {
+    nodes.resize(arrays.size());
+    for (size_t i = 0; i < nodes.size(); i++) {
+        nodes[i].x = arrays.x[i];
+        nodes[i].y = arrays.y[i];
+    }
+}
+
+/*
+ * ResizeSpatialArrays
+ * Resizes all three coordinate arrays, zeroing them.
+ */
+void ResizeSpatialArrays(SpatialArrays& arrays, size_t numberOfNodes) {
+    arrays.x.resize(numberOfNodes);
+    arrays.y.resize(numberOfNodes);
+    arrays.z.resize(numberOfNodes);
+}
+
+/*
+ * ClearSpatialArrays
+ * Zeroes all three coordinate arrays.
+ */
+void ClearSpatialArrays(SpatialArrays& arrays) {
+    arrays.x.fill(0);
+    arrays.y.fill(0);
+    arrays.z.fill(0);
+}
@@ -0,0 +1,168 @@
+/*************************************************************************
+ * File: NodeArrays.h
+ *
+ * A header file defining the structure-of-arrays storage used inside the
+ * layout engine.  SimpleGraph stores each node's x and y side by side,
+ * which is convenient for the rest of the program but forces every pass
+ * over one coordinate to read both, and keeps the SIMD kernels from
+ * loading several nodes' coordinates at once.  NodeArrays instead keeps
+ * all of the x coordinates in one array and all of the y coordinates in
+ * another, each aligned to a cache line.
+ *
+ * The same type holds both node positions and the per-iteration node
+ * changes.  The layout engine converts to and from SimpleGraph only at
+ * its interface, with LoadNodeArrays() and StoreNodeArrays().
+ */
+
+#ifndef NodeArrays_Included // Include guard
+#define NodeArrays_Included
+
+#include <cstddef>       // For NULL.
+#include "SimpleGraph.h" // For the SimpleGraph type.
+
+/* Alignment, in bytes, of the start of every coordinate array. */
+const size_t kNodeArrayAlignment = 64;
+
+/**
+ * Type: BasicAlignedArray<Scalar>
+ * -----------------------------------------------------------------------
+ * A resizable array of Scalar values whose first element is aligned to
+ * kNodeArrayAlignment bytes.  Copying an array copies its contents;
+ * swap() exchanges two arrays without copying any.  AlignedArray is the
+ * array of doubles used throughout the engine.
+ */
+template <typename Scalar>
+class BasicAlignedArray {
+public:
+    BasicAlignedArray() : values(NULL), length(0) {}
+    explicit BasicAlignedArray(size_t size) : values(NULL), length(0) { resize(size); }
+    BasicAlignedArray(const BasicAlignedArray& other) : values(NULL), length(0) {
+        *this = other;
+    }
+
+    BasicAlignedArray& operator= (const BasicAlignedArray& other) {
+        if (this != &other) {
+            resize(other.length);
+            for (size_t i = 0; i < length; i++) values[i] = other.values[i];
+        }
+        return *this;
+    }
+
+    /* Changes the number of elements; all elements are then zero. */
+    void resize(size_t size) {
+        const size_t padding = kNodeArrayAlignment / sizeof(Scalar);
+        storage.assign(size + padding, Scalar(0));
+        size_t address = (size_t) &storage[0];
+        size_t offset = (kNodeArrayAlignment - address % kNodeArrayAlignment) %
+                        kNodeArrayAlignment;
+        values = &storage[0] + offset / sizeof(Scalar);
+        length = size;
+    }
+
+    /* Sets every element to value. */
+    void fill(Scalar value) {
+        for (size_t i = 0; i < length; i++) values[i] = value;
+    }
+
+    /* Exchanges the contents of the two arrays; the buffers stay where they are. */
+    void swap(BasicAlignedArray& other) {
+        storage.swap(other.storage);
+        Scalar* otherValues = other.values;
+        other.values = values;
+        values = otherValues;
+        size_t otherLength = other.length;
+        other.length = length;
+        length = otherLength;
+    }
+
+    size_t size() const { return length; }
+    Scalar* data() { return values; }
+    const Scalar* data() const { return values; }
+    Scalar& operator[] (size_t index) { return values[index]; }
+    const Scalar& operator[] (size_t index) const { return values[index]; }
+
+private:
+    vector<Scalar> storage;
+    Scalar* values;
+    size_t length;
+};
+
+typedef BasicAlignedArray<double> AlignedArray;
+
+/**
+ * Type: BasicNodeArrays<Scalar>
+ * -----------------------------------------------------------------------
+ * The x and y coordinates of every node, in two separate arrays of
+ * Scalar.  NodeArrays, in double precision, is what the engine passes
+ * between its passes; the single-precision form is used by the kernels
+ * of PrecisionRepulsion.h.
+ */
+template <typename Scalar>
+struct BasicNodeArrays {
+    BasicAlignedArray<Scalar> x, y;
+
+    size_t size() const { return x.size(); }
+    void swap(BasicNodeArrays& other) { x.swap(other.x); y.swap(other.y); }
+};
+
+typedef BasicNodeArrays<double> NodeArrays;
+
+/**
+ * Function: ResizeNodeArrays(NodeArrays& arrays, size_t numberOfNodes)
+ * -----------------------------------------------------------------------
+ * Makes arrays hold numberOfNodes nodes, all at the origin.  This and
+ * ClearNodeArrays() are provided for arrays of float and of double.
+ */
+template <typename Scalar>
+void ResizeNodeArrays(BasicNodeArrays<Scalar>& arrays, size_t numberOfNodes);
+
+/**
+ * Function: ClearNodeArrays(NodeArrays& arrays)
+ * -----------------------------------------------------------------------
+ * Moves every node in arrays back to the origin without resizing.
+ */
+template <typename Scalar>
+void ClearNodeArrays(BasicNodeArrays<Scalar>& arrays);
+
+/**
+ * Function: LoadNodeArrays(const vector<Node>& nodes, NodeArrays& arrays)
+ * -----------------------------------------------------------------------
+ * Copies the coordinates of nodes into arrays, resizing it to match.
+ */
+void LoadNodeArrays(const vector<Node>& nodes, NodeArrays& arrays);
+
+/**
+ * Function: StoreNodeArrays(const NodeArrays& arrays, vector<Node>& nodes)
+ * -----------------------------------------------------------------------
+ * Copies the coordinates in arrays back into nodes, resizing it to match.
+ */
+void StoreNodeArrays(const NodeArrays& arrays, vector<Node>& nodes);
+
+/**
+ * Type: SpatialArrays
+ * -----------------------------------------------------------------------
+ * The x, y and z coordinates of every node of a layout in three
+ * dimensions, used by SpatialLayout.h in the same way as NodeArrays.
+ */
+struct SpatialArrays {
+    AlignedArray x, y, z;
+
+    size_t size() const { return x.size(); }
+};
+
+/**
+ * Function: ResizeSpatialArrays(SpatialArrays& arrays,
+ *                               size_t numberOfNodes)
+ * -----------------------------------------------------------------------
+ * Makes arrays hold numberOfNodes nodes, all at the origin.
+ */
+void ResizeSpatialArrays(SpatialArrays& arrays, size_t numberOfNodes);
+
+/**
+ * Function: ClearSpatialArrays(SpatialArrays& arrays)
+ * -----------------------------------------------------------------------
+ * Moves every node in arrays back to the origin without resizing.
+ */
+void ClearSpatialArrays(SpatialArrays& arrays);
+
+#endif
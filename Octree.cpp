@@ -0,0 +1,240 @@
+/******************************************************
+ * File: Octree.cpp
+ *
+ * Implementation of the Octree.h interface.  Like the
+ * quadtree, the tree is rebuilt from scratch on every
+ * iteration.  Building it stays on one thread; walking
+ * it for every node is where the time goes.
+ */
+
+#include <cmath>
+#include <atomic>
+#include <algorithm>
+#include "Octree.h"
+#include "ForceLayout.h"
+#include "Parallel.h"
+using namespace std;
+
+/* Predicate used to split a cell's nodes along one axis. */
+struct BelowMiddle {
+    const double* coordinates;
+    double middle;
+    bool operator() (size_t index) const { return coordinates[index] < middle; }
+};
+
+/*
+ * BuildCell
+ * Fills in the cell at cellIndex, which covers the nodes
+ * in bodies[first, last), splitting it into eight
+ * children until each leaf is small enough.
+ */
+static void BuildCell(const SpatialArrays& positions, Octree& tree, size_t cellIndex,
+                      size_t first, size_t last, size_t depth, size_t leafCapacity) {
+    OctreeCell cell = tree.cells[cellIndex];
+    cell.firstBody = first;
+    cell.lastBody = last;
+    cell.mass = 0;
+    cell.massX = cell.massY = cell.massZ = 0;
+
+    //Small or very deep cells become leaves
+    if (last - first <= leafCapacity || depth == kOctreeMaxDepth) {
+        cell.isLeaf = true;
+        cell.firstChild = 0;
+        for (size_t i = first; i < last; i++) {
+            cell.mass += 1;
+            cell.massX += positions.x[tree.bodies[i]];
+            cell.massY += positions.y[tree.bodies[i]];
+            cell.massZ += positions.z[tree.bodies[i]];
+        }
+        if (cell.mass > 0) {
+            cell.massX /= cell.mass;
+            cell.massY /= cell.mass;
+            cell.massZ /= cell.mass;
+        }
+        tree.cells[cellIndex] = cell;
+        return;
+    }
+
+    //Split by z, then each half by y, then each quarter by x
+    BelowMiddle belowZ = { positions.z.data(), cell.centerZ };
+    BelowMiddle belowY = { positions.y.data(), cell.centerY };
+    BelowMiddle belowX = { positions.x.data(), cell.centerX };
+    vector<size_t>::iterator begin = tree.bodies.begin();
+    size_t bounds[9];
+    bounds[0] = first;
+    bounds[4] = partition(begin + first, begin + last, belowZ) - begin;
+    bounds[8] = last;
+    for (size_t half = 0; half < 8; half += 4) {
+        bounds[half + 2] = partition(begin + bounds[half], begin + bounds[half + 4], belowY) -
+                           begin;
+        bounds[half + 1] = partition(begin + bounds[half], begin + bounds[half + 2], belowX) -
+                           begin;
+        bounds[half + 3] = partition(begin + bounds[half + 2], begin + bounds[half + 4],
+                                     belowX) - begin;
+    }
+
+    //Child k lies on the high side of x, y and z for bits 1, 2 and 4 of k
+    cell.isLeaf = false;
+    cell.firstChild = tree.cells.size();
+    double quarter = cell.halfSize / 2;
+    for (size_t child = 0; child < 8; child++) {
+        OctreeCell childCell;
+        childCell.centerX = cell.centerX + ((child & 1) ? quarter : -quarter);
+        childCell.centerY = cell.centerY + ((child & 2) ? quarter : -quarter);
+        childCell.centerZ = cell.centerZ + ((child & 4) ? quarter : -quarter);
+        childCell.halfSize = quarter;
+        tree.cells.push_back(childCell);
+    }
+    for (size_t child = 0; child < 8; child++) {
+        BuildCell(positions, tree, cell.firstChild + child, bounds[child], bounds[child + 1],
+                  depth + 1, leafCapacity);
+        const OctreeCell& childCell = tree.cells[cell.firstChild + child];
+        cell.mass += childCell.mass;
+        cell.massX += childCell.mass * childCell.massX;
+        cell.massY += childCell.mass * childCell.massY;
+        cell.massZ += childCell.mass * childCell.massZ;
+    }
+    cell.massX /= cell.mass;
+    cell.massY /= cell.mass;
+    cell.massZ /= cell.mass;
+    tree.cells[cellIndex] = cell;
+}
+
+/*
+ * BuildOctree
+ * Rebuilds the tree over all of the nodes, with a cubic
+ * root cell just large enough to hold them.
+ */
+void BuildOctree(const SpatialArrays& positions, Octree& tree, size_t leafCapacity) {
+    size_t numberOfNodes = positions.size();
+    tree.cells.clear();
+    tree.bodies.resize(numberOfNodes);
+    for (size_t i = 0; i < numberOfNodes; i++) {
+        tree.bodies[i] = i;
+    }
+
+    //Find the bounding box of the nodes
+    double minX = 0, minY = 0, minZ = 0, maxX = 0, maxY = 0, maxZ = 0;
+    if (numberOfNodes > 0) {
+        minX = maxX = positions.x[0];
+        minY = maxY = positions.y[0];
+        minZ = maxZ = positions.z[0];
+    }
+    for (size_t i = 1; i < numberOfNodes; i++) {
+        minX = min(minX, positions.x[i]);
+        maxX = max(maxX, positions.x[i]);
+        minY = min(minY, positions.y[i]);
+        maxY = max(maxY, positions.y[i]);
+        minZ = min(minZ, positions.z[i]);
+        maxZ = max(maxZ, positions.z[i]);
+    }
+
+    OctreeCell root;
+    root.centerX = (minX + maxX) / 2;
+    root.centerY = (minY + maxY) / 2;
+    root.centerZ = (minZ + maxZ) / 2;
+    root.halfSize = max(maxX - minX, max(maxY - minY, maxZ - minZ)) / 2;
+    tree.cells.push_back(root);
+    BuildCell(positions, tree, 0, 0, numberOfNodes, 0, leafCapacity);
+}
+
+/*
+ * CalculateOctreeRepulsiveForces
+ * Runs against a deadline that never passes.
+ */
+void CalculateOctreeRepulsiveForces(const SpatialArrays& positions, SpatialArrays& nodeChanges,
+                                    double theta, size_t numberOfThreads) {
+    CalculateOctreeRepulsiveForces(positions, nodeChanges, theta, numberOfThreads,
+                                   StartDeadline(HUGE_VAL));
+}
+
+/*
+ * CalculateOctreeRepulsiveForces
+ * Walks the octree once for every node, opening cells
+ * that are too close to approximate, or that contain
+ * the node, and interacting exactly with the nodes of
+ * any leaf it reaches.  Each thread walks for a
+ * contiguous range of nodes with a stack of its own.  A
+ * walk counts as log2 of the number of nodes
+ * evaluations, fewer than it takes through a balanced
+ * tree.  A thread that finds the deadline passed raises
+ * a flag that stops the others at their next check.
+ */
+bool CalculateOctreeRepulsiveForces(const SpatialArrays& positions, SpatialArrays& nodeChanges,
+                                    double theta, size_t numberOfThreads,
+                                    const LayoutDeadline& deadline) {
+    if (!(theta >= 0 && theta < kMaximumBarnesHutTheta)) theta = 0;
+    Octree tree;
+    BuildOctree(positions, tree);
+
+    size_t numberOfNodes = positions.size();
+    size_t walk = (size_t) log2(numberOfNodes + 1.0) + 1;
+    numberOfThreads = LimitThreadCount(numberOfThreads, numberOfNodes, numberOfNodes * walk);
+    atomic<bool> stopped(false);
+    RunOnThreads(numberOfThreads, [&](size_t thread) {
+        size_t begin, end;
+        ThreadRange(numberOfNodes, thread, numberOfThreads, begin, end);
+        vector<size_t> stack;
+        for (size_t nodeIndex = begin; nodeIndex < end; nodeIndex++) {
+            double x0 = positions.x[nodeIndex];
+            double y0 = positions.y[nodeIndex];
+            double z0 = positions.z[nodeIndex];
+            double changeX = 0, changeY = 0, changeZ = 0;
+
+            stack.push_back(0);
+            while (!stack.empty()) {
+                const OctreeCell& cell = tree.cells[stack.back()];
+                stack.pop_back();
+                if (cell.mass == 0) continue;
+
+                if (cell.isLeaf) {
+                    //Interact exactly with every other node in the leaf
+                    for (size_t i = cell.firstBody; i < cell.lastBody; i++) {
+                        size_t other = tree.bodies[i];
+                        if (other == nodeIndex) continue;
+                        double dx = x0 - positions.x[other];
+                        double dy = y0 - positions.y[other];
+                        double dz = z0 - positions.z[other];
+                        double distance = sqrt(dx * dx + dy * dy + dz * dz);
+                        double fRepel = CalculateFRepel(distance);
+                        changeX += fRepel * dx / distance;
+                        changeY += fRepel * dy / distance;
+                        changeZ += fRepel * dz / distance;
+                    }
+                    continue;
+                }
+
+                //Approximate the cell by its centre of mass if it is far enough away
+                double dx = x0 - cell.massX;
+                double dy = y0 - cell.massY;
+                double dz = z0 - cell.massZ;
+                double distanceSquared = dx * dx + dy * dy + dz * dz;
+                double width = 2 * cell.halfSize;
+                bool outside = fabs(x0 - cell.centerX) > cell.halfSize ||
+                               fabs(y0 - cell.centerY) > cell.halfSize ||
+                               fabs(z0 - cell.centerZ) > cell.halfSize;
+                if (width * width < theta * theta * distanceSquared && outside) {
+                    double distance = sqrt(distanceSquared);
+                    double fRepel = cell.mass * CalculateFRepel(distance);
+                    changeX += fRepel * dx / distance;
+                    changeY += fRepel * dy / distance;
+                    changeZ += fRepel * dz / distance;
+                } else {
+                    for (size_t child = 0; child < 8; child++) {
+                        stack.push_back(cell.firstChild + child);
+                    }
+                }
+            }
+
+            nodeChanges.x[nodeIndex] += changeX;
+            nodeChanges.y[nodeIndex] += changeY;
+            nodeChanges.z[nodeIndex] += changeZ;
+            if ((nodeIndex + 1 - begin) % kDeadlineCheckNodes == 0 &&
+                (stopped || DeadlinePassed(deadline))) {
+                stopped = true;
+                return;
+            }
+        }
+    });
+    return !stopped;
+}
@@ -0,0 +1,102 @@
+/*************************************************************************
+ * File: Octree.h
+ *
+ * A header file defining a point-region octree over the node positions
+ * of a layout in three dimensions, and the Barnes-Hut approximation of
+ * the repulsive forces that uses it.  It is QuadTree.h with a third
+ * coordinate: every cell records the number of nodes it contains and
+ * their centre of mass, and a cell whose width divided by its distance
+ * from a node is below the opening angle theta repels that node as a
+ * single body at its centre of mass.  Each iteration then costs
+ * O(n log n) rather than O(n^2), which is what makes layouts of a
+ * hundred thousand nodes and more practical.
+ *
+ * The walk for each node reads the tree and writes only that node's
+ * force, so the nodes are shared out among threads without any locking.
+ * Setting theta to 0 reproduces the exact forces.  As in the quadtree,
+ * theta must lie in [0, kMaximumBarnesHutTheta), and a cell containing
+ * the node is always opened.
+ */
+
+#ifndef Octree_Included // Include guard
+#define Octree_Included
+
+#include "NodeArrays.h"   // For the SpatialArrays type.
+#include "LayoutBudget.h" // For the LayoutDeadline type.
+
+/* Maximum number of nodes stored in a leaf before it is split. */
+const size_t kOctreeLeafCapacity = 8;
+
+/* Maximum depth of the tree; deeper leaves hold any number of nodes. */
+const size_t kOctreeMaxDepth = 32;
+
+/**
+ * Type: OctreeCell
+ * -----------------------------------------------------------------------
+ * A cube of space.  Internal cells have eight children stored
+ * consecutively starting at firstChild; leaves list their nodes in the
+ * range [firstBody, lastBody) of the tree's bodies vector.
+ */
+struct OctreeCell {
+    double centerX, centerY, centerZ, halfSize;
+    double mass, massX, massY, massZ;
+    bool isLeaf;
+    size_t firstChild;
+    size_t firstBody, lastBody;
+};
+
+/**
+ * Type: Octree
+ * -----------------------------------------------------------------------
+ * An octree whose root is cells[0].  bodies holds the indices of the
+ * graph's nodes, grouped so that each leaf's nodes are contiguous.
+ */
+struct Octree {
+    vector<OctreeCell> cells;
+    vector<size_t> bodies;
+};
+
+/**
+ * Function: BuildOctree(const SpatialArrays& positions, Octree& tree,
+ *                       size_t leafCapacity)
+ * -----------------------------------------------------------------------
+ * Rebuilds tree so that it holds every node in positions, and computes
+ * the mass and centre of mass of every cell.  Cells holding more than
+ * leafCapacity nodes are split.
+ */
+void BuildOctree(const SpatialArrays& positions, Octree& tree,
+                 size_t leafCapacity = kOctreeLeafCapacity);
+
+/**
+ * Function: CalculateOctreeRepulsiveForces(const SpatialArrays& positions,
+ *                                          SpatialArrays& nodeChanges,
+ *                                          double theta,
+ *                                          size_t numberOfThreads)
+ * -----------------------------------------------------------------------
+ * Builds an octree over the node positions and adds the approximate
+ * repulsive force on every node into nodeChanges, using theta as the
+ * opening angle, on numberOfThreads threads (zero meaning one per core).
+ * A theta outside [0, kMaximumBarnesHutTheta) is rejected, and the
+ * forces are then computed exactly.
+ */
+void CalculateOctreeRepulsiveForces(const SpatialArrays& positions, SpatialArrays& nodeChanges,
+                                    double theta, size_t numberOfThreads);
+
+/**
+ * Function: CalculateOctreeRepulsiveForces(const SpatialArrays& positions,
+ *                                          SpatialArrays& nodeChanges,
+ *                                          double theta,
+ *                                          size_t numberOfThreads,
+ *                                          const LayoutDeadline& deadline)
+ * -----------------------------------------------------------------------
+ * The same, except that every thread checks the deadline after the walks
+ * for every kDeadlineCheckNodes of its nodes, and all of them stop once
+ * one has seen it pass.  Returns true if every node was done, and false
+ * if the deadline stopped the pass, in which case nodeChanges holds the
+ * forces on only some of the nodes.
+ */
+bool CalculateOctreeRepulsiveForces(const SpatialArrays& positions, SpatialArrays& nodeChanges,
+                                    double theta, size_t numberOfThreads,
+                                    const LayoutDeadline& deadline);
+
+#endif
@@ -0,0 +1,360 @@
+/******************************************************
+ * File: OverlapRemoval.cpp
+ *
+ * Implementation of the OverlapRemoval.h interface.
+ * The nodes are kept scaled to the unit square, where
+ * every circle has the same radius.  With d_ij the
+ * current length of a proximity edge and s_ij its
+ * growth, the pass minimizes
+ *
+ *   sum of w_ij (|x_i - x_j| - s_ij d_ij)^2
+ *
+ * with w_ij = 1 / (s_ij d_ij)^2, as StressLayout.cpp
+ * does over every pair.  The majorization right-hand
+ * side L_Z(x) x then has the simple entries
+ * w_ij s_ij (x_i - x_j), and L_w has one entry per edge,
+ * so a conjugate gradient step costs O(n).
+ */
+
+#include <cmath>
+#include <set>
+#include <algorithm>
+#include "OverlapRemoval.h"
+#include "Triangulation.h"
+#include "LayoutGeometry.h"
+#include "GraphVisualizer.h"
+using namespace std;
+
+/* Radius GraphVisualizer draws a node at, as a fraction of the drawing
+ * inside its margins, with a tenth more for a visible gap.
+ */
+const double kDefaultOverlapRadius =
+    1.1 * kNodeRadius / (kWindowSize * (1 - 2 * kMarginPaddingPercent));
+
+/* Edges grow this much past touching, so that a pass which lands a
+ * little short of its targets still separates the circles.
+ */
+const double kSeparationSlack = 1.05;
+
+/* Coincident nodes are first spread this far apart, in radii, along a
+ * spiral at the golden angle.
+ */
+const double kCoincidentSpread = 0.1;
+
+/* Relative residual at which a conjugate gradient solve stops early. */
+const double kOverlapConjugateGradientTolerance = 1e-3;
+
+/*
+ * Type: UnitFrame
+ * The bounding box a layout is scaled from, so that it
+ * can be scaled back.  An axis along which every node
+ * lies at the same coordinate takes the extent of the
+ * other axis, or one if both are flat.
+ */
+struct UnitFrame {
+    double minX, minY;
+    double width, height;
+};
+
+/*
+ * DefaultOverlapOptions
+ * Returns the default parameters.
+ */
+OverlapOptions DefaultOverlapOptions() {
+    OverlapOptions options;
+    options.nodeRadius = kDefaultOverlapRadius;
+    options.maximumScale = kDefaultMaximumOverlapScale;
+    options.maximumPasses = kDefaultOverlapPasses;
+    return options;
+}
+
+/*
+ * ScaleToUnitSquare
+ * Scales positions so that their bounding box is the
+ * unit square, and returns the box they had.
+ */
+static UnitFrame ScaleToUnitSquare(NodeArrays& positions) {
+    UnitFrame frame = {0, 0, 1, 1};
+    size_t numberOfNodes = positions.size();
+    if (numberOfNodes == 0) return frame;
+
+    double minX = positions.x[0], maxX = positions.x[0];
+    double minY = positions.y[0], maxY = positions.y[0];
+    for (size_t i = 1; i < numberOfNodes; i++) {
+        minX = min(minX, positions.x[i]);
+        maxX = max(maxX, positions.x[i]);
+        minY = min(minY, positions.y[i]);
+        maxY = max(maxY, positions.y[i]);
+    }
+    frame.minX = minX;
+    frame.minY = minY;
+    frame.width = maxX - minX;
+    frame.height = maxY - minY;
+    if (frame.width == 0) frame.width = (frame.height == 0) ? 1 : frame.height;
+    if (frame.height == 0) frame.height = frame.width;
+
+    for (size_t i = 0; i < numberOfNodes; i++) {
+        positions.x[i] = (positions.x[i] - minX) / frame.width;
+        positions.y[i] = (positions.y[i] - minY) / frame.height;
+    }
+    return frame;
+}
+
+/*
+ * FindOverlaps
+ * Visits the nodes in order of x, dropping from the
+ * active set every node more than a diameter behind the
+ * current one, so that only the active nodes within a
+ * diameter in y need their distance checked.
+ */
+size_t FindOverlaps(const NodeArrays& positions, double radius, vector<Edge>& overlaps) {
+    overlaps.clear();
+    size_t numberOfNodes = positions.size();
+    double diameter = 2 * radius;
+    vector<size_t> order(numberOfNodes);
+    for (size_t i = 0; i < numberOfNodes; i++) order[i] = i;
+    sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return positions.x[a] < positions.x[b];
+    });
+
+    set<pair<double, size_t> > active;
+    size_t oldest = 0;
+    for (size_t k = 0; k < numberOfNodes; k++) {
+        size_t i = order[k];
+        double x = positions.x[i], y = positions.y[i];
+        for (; oldest < k && positions.x[order[oldest]] <= x - diameter; oldest++) {
+            active.erase(make_pair(positions.y[order[oldest]], order[oldest]));
+        }
+
+        set<pair<double, size_t> >::iterator other =
+            active.lower_bound(make_pair(y - diameter, (size_t) 0));
+        for (; other != active.end() && other->first < y + diameter; ++other) {
+            size_t j = other->second;
+            double dx = positions.x[j] - x, dy = positions.y[j] - y;
+            if (dx * dx + dy * dy < diameter * diameter) {
+                Edge edge = {min(i, j), max(i, j)};
+                overlaps.push_back(edge);
+            }
+        }
+        active.insert(make_pair(y, i));
+    }
+    return overlaps.size();
+}
+
+/*
+ * CountOverlaps
+ * Counts the overlaps of a copy scaled as it is drawn.
+ */
+size_t CountOverlaps(const SimpleGraph& graph, const OverlapOptions& options) {
+    NodeArrays positions;
+    LoadNodeArrays(graph.nodes, positions);
+    ScaleToUnitSquare(positions);
+    vector<Edge> overlaps;
+    return FindOverlaps(positions, options.nodeRadius, overlaps);
+}
+
+/*
+ * SpreadCoincidentNodes
+ * Moves every node that shares its position with an
+ * earlier one a small step along a spiral, since two
+ * nodes at one point give no direction to separate in.
+ */
+static void SpreadCoincidentNodes(NodeArrays& positions, double radius) {
+    size_t numberOfNodes = positions.size();
+    vector<size_t> order(numberOfNodes);
+    for (size_t i = 0; i < numberOfNodes; i++) order[i] = i;
+    sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        if (positions.x[a] != positions.x[b]) return positions.x[a] < positions.x[b];
+        return positions.y[a] < positions.y[b];
+    });
+
+    size_t first = 0;
+    for (size_t k = 1; k < numberOfNodes; k++) {
+        size_t i = order[k];
+        size_t anchor = order[first];
+        if (positions.x[i] != positions.x[anchor] || positions.y[i] != positions.y[anchor]) {
+            first = k;
+            continue;
+        }
+        double step = k - first;
+        double distance = kCoincidentSpread * radius * sqrt(step);
+        positions.x[i] += distance * cos(step * kGoldenAngle);
+        positions.y[i] += distance * sin(step * kGoldenAngle);
+    }
+}
+
+/*
+ * HasOverlappingEdge
+ * Returns whether the circles at the two ends of any of
+ * the edges overlap.
+ */
+static bool HasOverlappingEdge(const NodeArrays& positions, const vector<Edge>& edges,
+                               double radius) {
+    double diameter = 2 * radius;
+    for (size_t e = 0; e < edges.size(); e++) {
+        double dx = positions.x[edges[e].start] - positions.x[edges[e].end];
+        double dy = positions.y[edges[e].start] - positions.y[edges[e].end];
+        if (dx * dx + dy * dy < diameter * diameter) return true;
+    }
+    return false;
+}
+
+/*
+ * MultiplyProximityLaplacian
+ * Stores L_w times values in result, one pass over the
+ * proximity edges.
+ */
+static void MultiplyProximityLaplacian(const vector<Edge>& edges, const vector<double>& weights,
+                                       const vector<double>& values, vector<double>& result) {
+    result.assign(values.size(), 0.0);
+    for (size_t e = 0; e < edges.size(); e++) {
+        size_t i = edges[e].start, j = edges[e].end;
+        double term = weights[e] * (values[i] - values[j]);
+        result[i] += term;
+        result[j] -= term;
+    }
+}
+
+/*
+ * Dot
+ * Returns the dot product of two vectors.
+ */
+static double Dot(const vector<double>& a, const vector<double>& b) {
+    double sum = 0;
+    for (size_t i = 0; i < a.size(); i++) sum += a[i] * b[i];
+    return sum;
+}
+
+/*
+ * SolveProximityLaplacian
+ * Improves solution towards L_w solution = rightHandSide
+ * by conjugate gradients, in the same way as the solver
+ * of StressLayout.cpp.  The triangulation is connected,
+ * so the only null space of L_w is a translation, which
+ * the zero-sum residual keeps out of.
+ */
+static void SolveProximityLaplacian(const vector<Edge>& edges, const vector<double>& weights,
+                                    const vector<double>& rightHandSide,
+                                    vector<double>& solution) {
+    size_t numberOfNodes = solution.size();
+    vector<double> residual, direction, product;
+    MultiplyProximityLaplacian(edges, weights, solution, product);
+    residual.resize(numberOfNodes);
+    double mean = 0;
+    for (size_t i = 0; i < numberOfNodes; i++) {
+        residual[i] = rightHandSide[i] - product[i];
+        mean += residual[i];
+    }
+    mean /= numberOfNodes;
+    for (size_t i = 0; i < numberOfNodes; i++) residual[i] -= mean;
+
+    direction = residual;
+    double residualSquared = Dot(residual, residual);
+    double target = kOverlapConjugateGradientTolerance * kOverlapConjugateGradientTolerance *
+                    Dot(rightHandSide, rightHandSide);
+    for (size_t step = 0; step < kDefaultOverlapConjugateGradientIterations; step++) {
+        if (residualSquared <= target) break;
+        MultiplyProximityLaplacian(edges, weights, direction, product);
+        double curvature = Dot(direction, product);
+        if (curvature <= 0) break;
+        double alpha = residualSquared / curvature;
+        for (size_t i = 0; i < numberOfNodes; i++) {
+            solution[i] += alpha * direction[i];
+            residual[i] -= alpha * product[i];
+        }
+        double nextResidualSquared = Dot(residual, residual);
+        double beta = nextResidualSquared / residualSquared;
+        for (size_t i = 0; i < numberOfNodes; i++) {
+            direction[i] = residual[i] + beta * direction[i];
+        }
+        residualSquared = nextResidualSquared;
+    }
+}
+
+/*
+ * ProximityStressStep
+ * Sets each edge's growth from the overlap of its two
+ * circles and takes one majorization step towards the
+ * grown lengths.
+ */
+static void ProximityStressStep(NodeArrays& positions, const vector<Edge>& edges,
+                                const OverlapOptions& options) {
+    size_t numberOfNodes = positions.size();
+    double separation = 2 * options.nodeRadius * kSeparationSlack;
+    vector<double> weights(edges.size());
+    vector<double> rightX(numberOfNodes, 0.0), rightY(numberOfNodes, 0.0);
+    for (size_t e = 0; e < edges.size(); e++) {
+        size_t i = edges[e].start, j = edges[e].end;
+        double dx = positions.x[i] - positions.x[j];
+        double dy = positions.y[i] - positions.y[j];
+        double distance = sqrt(dx * dx + dy * dy);
+        double growth = min(max(1.0, separation / distance), options.maximumScale);
+        double length = growth * distance;
+        weights[e] = 1 / (length * length);
+
+        double scale = weights[e] * growth;
+        rightX[i] += scale * dx;
+        rightY[i] += scale * dy;
+        rightX[j] -= scale * dx;
+        rightY[j] -= scale * dy;
+    }
+
+    vector<double> x(positions.x.data(), positions.x.data() + numberOfNodes);
+    vector<double> y(positions.y.data(), positions.y.data() + numberOfNodes);
+    SolveProximityLaplacian(edges, weights, rightX, x);
+    SolveProximityLaplacian(edges, weights, rightY, y);
+    for (size_t i = 0; i < numberOfNodes; i++) {
+        positions.x[i] = x[i];
+        positions.y[i] = y[i];
+    }
+}
+
+/*
+ * RemoveOverlaps
+ * Scales the layout to the unit square, then runs passes
+ * until no edge of the triangulation overlaps.  Every
+ * node's nearest neighbour is joined to it in the
+ * triangulation, so that is exactly when no pair of
+ * nodes overlaps, and a pass never needs the sweep line,
+ * whose pairs number O(n^2) when many nodes share one
+ * spot.  The mean displacement is measured in the unit
+ * square, before the layout is scaled back to its
+ * original box.
+ */
+OverlapResult RemoveOverlaps(SimpleGraph& graph, const OverlapOptions& options) {
+    OverlapResult result;
+    result.passes = 0;
+    result.displacement = 0;
+    size_t numberOfNodes = graph.nodes.size();
+
+    NodeArrays positions;
+    LoadNodeArrays(graph.nodes, positions);
+    UnitFrame frame = ScaleToUnitSquare(positions);
+    NodeArrays start = positions;
+
+    vector<Edge> overlaps, edges;
+    result.initialOverlaps = FindOverlaps(positions, options.nodeRadius, overlaps);
+    result.remainingOverlaps = result.initialOverlaps;
+    if (result.initialOverlaps > 0) {
+        SpreadCoincidentNodes(positions, options.nodeRadius);
+        ScaleToUnitSquare(positions);
+        while (result.passes < options.maximumPasses) {
+            DelaunayEdges(positions, edges);
+            if (!HasOverlappingEdge(positions, edges, options.nodeRadius)) break;
+            ProximityStressStep(positions, edges, options);
+            ScaleToUnitSquare(positions);
+            result.passes++;
+        }
+        result.remainingOverlaps = FindOverlaps(positions, options.nodeRadius, overlaps);
+    }
+
+    for (size_t i = 0; i < numberOfNodes; i++) {
+        double dx = positions.x[i] - start.x[i];
+        double dy = positions.y[i] - start.y[i];
+        result.displacement += sqrt(dx * dx + dy * dy);
+        graph.nodes[i].x = frame.minX + positions.x[i] * frame.width;
+        graph.nodes[i].y = frame.minY + positions.y[i] * frame.height;
+    }
+    if (numberOfNodes > 0) result.displacement /= numberOfNodes;
+    return result;
+}
@@ -0,0 +1,114 @@
+/*************************************************************************
+ * File: OverlapRemoval.h
+ *
+ * A header file defining a post-processing stage that moves apart nodes
+ * whose drawn circles overlap, for use once a layout has converged.
+ * The force-directed layouts space nodes by their forces alone, with no
+ * notion of how large a node is drawn, so on dense graphs such as
+ * 30clique several circles often land on top of one another.
+ *
+ * The method follows PRISM, from Gansner and Hu, "Efficient Node Overlap
+ * Removal Using a Proximity Stress Model" (2008).  Each pass joins the
+ * nodes by the edges of their Delaunay triangulation (Triangulation.h)
+ * and asks each of those edges to grow by just enough to separate its
+ * two circles, and by no more than maximumScale.  An edge whose nodes
+ * do not overlap asks to keep its current length, so the triangulation
+ * holds the shape of the layout while the overlaps are pushed apart.
+ * One step of stress majorization over these edges gives the next
+ * layout, and the passes repeat until no edge of the triangulation
+ * overlaps, which happens exactly when no two nodes overlap.
+ *
+ * The triangulation and the sparse linear systems of the majorization
+ * each take O(n log n) time or less, so a pass stays fast on layouts of
+ * hundreds of thousands of nodes.  The overlaps themselves are counted
+ * before and after by a sweep line.
+ *
+ * The visualizer scales a layout's bounding box to its window, so the
+ * size a node is drawn at depends on the rest of the layout.  Radii here
+ * are therefore measured as fractions of the width and height of the
+ * bounding box, and the nodes are rescaled to fill it after every pass,
+ * just as they will be drawn.
+ */
+
+#ifndef OverlapRemoval_Included // Include guard
+#define OverlapRemoval_Included
+
+#include "SimpleGraph.h" // For the SimpleGraph type.
+#include "NodeArrays.h"  // For the NodeArrays type.
+
+/* Default parameters of the overlap removal.  The default radius is
+ * derived from GraphVisualizer.h in DefaultOverlapOptions().
+ */
+const double kDefaultMaximumOverlapScale = 1.5;
+const size_t kDefaultOverlapPasses = 300;
+const size_t kDefaultOverlapConjugateGradientIterations = 50;
+
+/**
+ * Type: OverlapOptions
+ * -----------------------------------------------------------------------
+ * Parameters controlling the overlap removal.  Every node is a circle of
+ * radius nodeRadius, as a fraction of the width and height of the
+ * drawing.  No edge is asked to grow by more than maximumScale in one
+ * pass, and the removal gives up after maximumPasses, which it only
+ * reaches when the circles are too large to fit side by side, or when
+ * every node lies on one line and so can only move along it.
+ */
+struct OverlapOptions {
+    double nodeRadius;
+    double maximumScale;
+    size_t maximumPasses;
+};
+
+/**
+ * Type: OverlapResult
+ * -----------------------------------------------------------------------
+ * The number of overlapping pairs of nodes before and after the removal,
+ * the number of passes it ran, and the mean distance each node moved, as
+ * a fraction of the drawing.
+ */
+struct OverlapResult {
+    size_t initialOverlaps;
+    size_t remainingOverlaps;
+    size_t passes;
+    double displacement;
+};
+
+/**
+ * Function: DefaultOverlapOptions()
+ * -----------------------------------------------------------------------
+ * Returns the default overlap removal parameters, whose radius is the
+ * one GraphVisualizer draws nodes at.
+ */
+OverlapOptions DefaultOverlapOptions();
+
+/**
+ * Function: FindOverlaps(const NodeArrays& positions, double radius,
+ *                        vector<Edge>& overlaps)
+ * -----------------------------------------------------------------------
+ * Stores in overlaps every pair of nodes closer together than twice the
+ * radius, with start < end, and returns how many there are.  A sweep
+ * line in x keeps the nodes within reach ordered by y, so this takes
+ * O((n + k) log n) time to find k overlaps.
+ */
+size_t FindOverlaps(const NodeArrays& positions, double radius, vector<Edge>& overlaps);
+
+/**
+ * Function: CountOverlaps(const SimpleGraph& graph,
+ *                         const OverlapOptions& options)
+ * -----------------------------------------------------------------------
+ * Returns the number of pairs of nodes whose circles overlap when the
+ * graph is drawn.
+ */
+size_t CountOverlaps(const SimpleGraph& graph, const OverlapOptions& options);
+
+/**
+ * Function: RemoveOverlaps(SimpleGraph& graph,
+ *                          const OverlapOptions& options)
+ * -----------------------------------------------------------------------
+ * Moves the nodes of the graph until no two of their drawn circles
+ * overlap, keeping the layout as close to its current shape as it can.
+ * The layout keeps its bounding box.
+ */
+OverlapResult RemoveOverlaps(SimpleGraph& graph, const OverlapOptions& options);
+
+#endif
@@ -0,0 +1,89 @@
+/******************************************************
+ * File: Parallel.cpp
+ *
+ * Implementation of the Parallel.h interface.  Threads
+ * are created for each call and joined before it
+ * returns.  That costs a few microseconds per thread,
+ * more than a small graph's whole pass, so the callers
+ * size their thread counts with LimitThreadCount().
+ */
+
+#include <thread>
+#include <algorithm>
+#include <vector>
+#include "Parallel.h"
+using namespace std;
+
+/*
+ * DefaultThreadCount
+ * Asks the standard library for the number of hardware
+ * threads.
+ */
+size_t DefaultThreadCount() {
+    size_t numberOfThreads = thread::hardware_concurrency();
+    return (numberOfThreads == 0) ? 1 : numberOfThreads;
+}
+
+/*
+ * ResolveThreadCount
+ * Replaces a thread count of zero with the default.
+ */
+size_t ResolveThreadCount(size_t numberOfThreads) {
+    return (numberOfThreads == 0) ? DefaultThreadCount() : numberOfThreads;
+}
+
+/*
+ * LimitThreadCount
+ * Allows one thread per kMinimumThreadWork of the work.
+ */
+size_t LimitThreadCount(size_t numberOfThreads, size_t numberOfItems, size_t work) {
+    size_t limit = min(numberOfItems, work / kMinimumThreadWork);
+    return max(min(ResolveThreadCount(numberOfThreads), limit), (size_t) 1);
+}
+
+/*
+ * RunOnThreads
+ * Starts threads 1 and up, does thread 0's share here,
+ * then waits for the rest.
+ */
+void RunOnThreads(size_t numberOfThreads, const function<void (size_t)>& task) {
+    vector<thread> workers;
+    for (size_t threadIndex = 1; threadIndex < numberOfThreads; threadIndex++) {
+        workers.push_back(thread(task, threadIndex));
+    }
+    task(0);
+    for (size_t i = 0; i < workers.size(); i++) {
+        workers[i].join();
+    }
+}
+
+/*
+ * ThreadRange
+ * The first count % numberOfThreads threads get one
+ * extra element.
+ */
+void ThreadRange(size_t count, size_t thread, size_t numberOfThreads,
+                 size_t& begin, size_t& end) {
+    size_t share = count / numberOfThreads;
+    size_t extra = count % numberOfThreads;
+    begin = thread * share + min(thread, extra);
+    end = begin + share + (thread < extra ? 1 : 0);
+}
+
+/*
+ * ThreadBarrier::wait
+ * The last thread to arrive starts a new generation and
+ * wakes the others, which wait for the generation they
+ * arrived in to end.
+ */
+void ThreadBarrier::wait() {
+    unique_lock<mutex> guard(lock);
+    size_t arrivedIn = generation;
+    if (++waiting == numberOfThreads) {
+        waiting = 0;
+        generation++;
+        released.notify_all();
+        return;
+    }
+    released.wait(guard, [&] { return generation != arrivedIn; });
+}
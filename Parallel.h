@@ -0,0 +1,100 @@
+/*************************************************************************
+ * File: Parallel.h
+ *
+ * A header file defining the small amount of threading support shared by
+ * the parallel parts of the layout engine.  Work is split by running the
+ * same task once per thread, each invocation told which thread it is;
+ * the task decides for itself which part of the work that thread owns.
+ * The calling thread always does the share of thread 0, so a thread
+ * count of one runs the task inline without creating any threads.
+ * Threads are started afresh on every call, so callers first ask
+ * LimitThreadCount() for as many as their work is worth.
+ */
+
+#ifndef Parallel_Included // Include guard
+#define Parallel_Included
+
+#include <cstddef>            // For size_t.
+#include <functional>         // For the function type.
+#include <mutex>              // For the mutex type.
+#include <condition_variable> // For the condition_variable type.
+using namespace std;
+
+/* The least work, in force or distance evaluations, worth a thread of its
+ * own.  Starting and joining a thread costs a few thousand evaluations. */
+const size_t kMinimumThreadWork = 16384;
+
+/**
+ * Function: DefaultThreadCount()
+ * -----------------------------------------------------------------------
+ * Returns the number of hardware threads on this machine, or one if the
+ * number cannot be determined.
+ */
+size_t DefaultThreadCount();
+
+/**
+ * Function: ResolveThreadCount(size_t numberOfThreads)
+ * -----------------------------------------------------------------------
+ * Returns numberOfThreads, or DefaultThreadCount() if it is zero.  Zero
+ * is how settings ask for "one thread per core".
+ */
+size_t ResolveThreadCount(size_t numberOfThreads);
+
+/**
+ * Function: LimitThreadCount(size_t numberOfThreads,
+ *                            size_t numberOfItems, size_t work)
+ * -----------------------------------------------------------------------
+ * Returns ResolveThreadCount(numberOfThreads), lowered so that every
+ * thread has at least one of the numberOfItems items the work is split
+ * into and at least kMinimumThreadWork of the work, an estimate of the
+ * evaluations all of the items take together.  Returns at least one.
+ */
+size_t LimitThreadCount(size_t numberOfThreads, size_t numberOfItems, size_t work);
+
+/**
+ * Function: RunOnThreads(size_t numberOfThreads,
+ *                        const function<void (size_t)>& task)
+ * -----------------------------------------------------------------------
+ * Calls task(thread) once for every thread index in [0, numberOfThreads),
+ * each on its own thread, and returns once all of the calls have
+ * finished.  Index 0 runs on the calling thread.
+ */
+void RunOnThreads(size_t numberOfThreads, const function<void (size_t)>& task);
+
+/**
+ * Function: ThreadRange(size_t count, size_t thread,
+ *                       size_t numberOfThreads, size_t& begin,
+ *                       size_t& end)
+ * -----------------------------------------------------------------------
+ * Splits [0, count) into numberOfThreads contiguous ranges as evenly as
+ * possible and stores the one belonging to thread in [begin, end).
+ */
+void ThreadRange(size_t count, size_t thread, size_t numberOfThreads,
+                 size_t& begin, size_t& end);
+
+/**
+ * Type: ThreadBarrier
+ * -----------------------------------------------------------------------
+ * A point at which the numberOfThreads threads of one RunOnThreads()
+ * call wait for each other.  wait() returns in every thread once all of
+ * them have called it, and the barrier can then be used again, so a
+ * task can run many steps on the same threads, each step reading only
+ * what the others finished in the steps before.
+ */
+class ThreadBarrier {
+public:
+    explicit ThreadBarrier(size_t numberOfThreads)
+        : numberOfThreads(numberOfThreads), waiting(0), generation(0) {}
+
+    /* Blocks until every thread has reached the barrier. */
+    void wait();
+
+private:
+    mutex lock;
+    condition_variable released;
+    size_t numberOfThreads;
+    size_t waiting;
+    size_t generation;
+};
+
+#endif
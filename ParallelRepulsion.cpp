@@ -0,0 +1,112 @@
+/******************************************************
+ * File: ParallelRepulsion.cpp
+ *
+ * Implementation of the ParallelRepulsion.h interface.
+ * Thread 0 adds straight into the caller's node
+ * changes; the other threads add into private buffers
+ * that are reduced afterwards, with each thread summing
+ * the buffers over its own range of nodes.
+ */
+
+#include <cmath>
+#include <atomic>
+#include <algorithm>
+#include "ParallelRepulsion.h"
+#include "SimdRepulsion.h"
+#include "Parallel.h"
+using namespace std;
+
+/* One tile of the pair triangle, given by its row and column blocks. */
+struct RepulsionTile {
+    size_t rowBlock, columnBlock;
+};
+
+/*
+ * CalculateParallelRepulsiveForces
+ * Runs against a deadline that never passes.
+ */
+void CalculateParallelRepulsiveForces(const NodeArrays& positions, NodeArrays& nodeChanges,
+                                      size_t numberOfThreads) {
+    CalculateParallelRepulsiveForces(positions, nodeChanges, numberOfThreads,
+                                     StartDeadline(HUGE_VAL));
+}
+
+/*
+ * CalculateParallelRepulsiveForces
+ * Runs the tiles through the kernel DetectSimdLevel()
+ * picks.
+ */
+bool CalculateParallelRepulsiveForces(const NodeArrays& positions, NodeArrays& nodeChanges,
+                                      size_t numberOfThreads, const LayoutDeadline& deadline) {
+    SimdLevel level = DetectSimdLevel();
+    return RunRepulsionTiles(positions, nodeChanges, numberOfThreads, deadline,
+                             [level](const NodeArrays& tilePositions, NodeArrays& changes,
+                                     size_t rowBegin, size_t rowEnd,
+                                     size_t columnBegin, size_t columnEnd) {
+        CalculateVectorizedRepulsiveTile(tilePositions, changes, rowBegin, rowEnd,
+                                         columnBegin, columnEnd, level);
+    });
+}
+
+/*
+ * RunRepulsionTiles
+ * Lists the tiles, lets the threads claim them one at a
+ * time, then reduces the private buffers.  A thread that
+ * finds the deadline passed takes the remaining tiles
+ * away from all of them; if there were any, the buffers
+ * are not reduced.
+ */
+bool RunRepulsionTiles(const NodeArrays& positions, NodeArrays& nodeChanges,
+                       size_t numberOfThreads, const LayoutDeadline& deadline,
+                       const RepulsionTileKernel& kernel) {
+    size_t numberOfNodes = positions.size();
+    size_t numberOfBlocks = (numberOfNodes + kRepulsionTileSize - 1) / kRepulsionTileSize;
+    vector<RepulsionTile> tiles;
+    for (size_t row = 0; row < numberOfBlocks; row++) {
+        for (size_t column = row; column < numberOfBlocks; column++) {
+            RepulsionTile tile = { row, column };
+            tiles.push_back(tile);
+        }
+    }
+
+    //More threads than tiles would only add empty buffers, and each needs its share of pairs
+    numberOfThreads = LimitThreadCount(numberOfThreads, tiles.size(),
+                                       numberOfNodes * numberOfNodes / 2);
+    vector<NodeArrays> buffers(numberOfThreads - 1);
+    atomic<size_t> nextTile(0);
+    atomic<bool> stopped(false);
+
+    RunOnThreads(numberOfThreads, [&](size_t thread) {
+        NodeArrays* changes = &nodeChanges;
+        if (thread > 0) {
+            changes = &buffers[thread - 1];
+            ResizeNodeArrays(*changes, numberOfNodes);
+        }
+        for (size_t t = nextTile++; t < tiles.size(); t = nextTile++) {
+            size_t rowBegin = tiles[t].rowBlock * kRepulsionTileSize;
+            size_t rowEnd = min(rowBegin + kRepulsionTileSize, numberOfNodes);
+            size_t columnBegin = tiles[t].columnBlock * kRepulsionTileSize;
+            size_t columnEnd = min(columnBegin + kRepulsionTileSize, numberOfNodes);
+            kernel(positions, *changes, rowBegin, rowEnd, columnBegin, columnEnd);
+            if (DeadlinePassed(deadline) && nextTile.exchange(tiles.size()) < tiles.size()) {
+                stopped = true;
+            }
+        }
+    });
+    if (stopped) return false;
+    if (buffers.empty()) return true;
+
+    size_t reducingThreads = LimitThreadCount(numberOfThreads, numberOfNodes,
+                                              numberOfNodes * buffers.size());
+    RunOnThreads(reducingThreads, [&](size_t thread) {
+        size_t begin, end;
+        ThreadRange(numberOfNodes, thread, reducingThreads, begin, end);
+        for (size_t b = 0; b < buffers.size(); b++) {
+            for (size_t i = begin; i < end; i++) {
+                nodeChanges.x[i] += buffers[b].x[i];
+                nodeChanges.y[i] += buffers[b].y[i];
+            }
+        }
+    });
+    return true;
+}
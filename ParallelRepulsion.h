@@ -0,0 +1,91 @@
+/*************************************************************************
+ * File: ParallelRepulsion.h
+ *
+ * A header file defining a multithreaded version of the exact all-pairs
+ * repulsion.  The triangle of node pairs is cut into square tiles of
+ * kRepulsionTileSize by kRepulsionTileSize nodes, small enough that the
+ * positions and changes of both blocks of nodes stay in the first-level
+ * cache while the tile is processed.  Threads take tiles from a shared
+ * counter, so the half-sized tiles on the diagonal do not unbalance them.
+ *
+ * Every pair updates both of its nodes, so two threads may update the
+ * same node at once.  Rather than synchronizing each update, every
+ * thread adds into its own private copy of the node changes, and the
+ * copies are summed into the real changes once all tiles are done.
+ *
+ * The tiling does not depend on the force law, so RunRepulsionTiles()
+ * takes the kernel for one tile as a parameter; ForceModels.h uses it
+ * for the models whose repulsion is not kRepel / d.
+ */
+
+#ifndef ParallelRepulsion_Included // Include guard
+#define ParallelRepulsion_Included
+
+#include <functional>     // For the function type.
+#include "NodeArrays.h"   // For the NodeArrays type.
+#include "LayoutBudget.h" // For the LayoutDeadline type.
+
+/* Number of nodes along each side of a tile. */
+const size_t kRepulsionTileSize = 256;
+
+/**
+ * Type: RepulsionTileKernel
+ * -----------------------------------------------------------------------
+ * A function that adds into nodeChanges the repulsion of every pair
+ * (i, j) with i in [rowBegin, rowEnd), j in [columnBegin, columnEnd) and
+ * i < j, to both nodes of the pair.  Its arguments are positions,
+ * nodeChanges, rowBegin, rowEnd, columnBegin and columnEnd, in that
+ * order.
+ */
+typedef function<void (const NodeArrays&, NodeArrays&, size_t, size_t, size_t, size_t)>
+        RepulsionTileKernel;
+
+/**
+ * Function: RunRepulsionTiles(const NodeArrays& positions,
+ *                             NodeArrays& nodeChanges,
+ *                             size_t numberOfThreads,
+ *                             const LayoutDeadline& deadline,
+ *                             const RepulsionTileKernel& kernel)
+ * -----------------------------------------------------------------------
+ * Covers the triangle of node pairs with tiles, runs kernel on each of
+ * them on numberOfThreads threads, or one per core if numberOfThreads is
+ * zero, and adds the result into nodeChanges.  Every thread checks the
+ * deadline after each tile and stops taking tiles once it has passed.
+ * Returns true if every tile was done, and false if the deadline stopped
+ * the pass, in which case nodeChanges holds only part of the forces.
+ * On one thread the tiles are run in a fixed order, straight into
+ * nodeChanges.
+ */
+bool RunRepulsionTiles(const NodeArrays& positions, NodeArrays& nodeChanges,
+                       size_t numberOfThreads, const LayoutDeadline& deadline,
+                       const RepulsionTileKernel& kernel);
+
+/**
+ * Function: CalculateParallelRepulsiveForces(const NodeArrays& positions,
+ *                                            NodeArrays& nodeChanges,
+ *                                            size_t numberOfThreads)
+ * -----------------------------------------------------------------------
+ * Adds the exact repulsive force between every pair of nodes into
+ * nodeChanges using numberOfThreads threads, or one per core if
+ * numberOfThreads is zero.  Each tile uses the kernel returned by
+ * DetectSimdLevel().  The extra memory used is one NodeArrays per thread
+ * beyond the first.
+ */
+void CalculateParallelRepulsiveForces(const NodeArrays& positions, NodeArrays& nodeChanges,
+                                      size_t numberOfThreads);
+
+/**
+ * Function: CalculateParallelRepulsiveForces(const NodeArrays& positions,
+ *                                            NodeArrays& nodeChanges,
+ *                                            size_t numberOfThreads,
+ *                                            const LayoutDeadline& deadline)
+ * -----------------------------------------------------------------------
+ * The same, except that every thread checks the deadline after each tile
+ * and stops taking tiles once it has passed.  Returns true if every tile
+ * was done, and false if the deadline stopped the pass, in which case
+ * nodeChanges holds only part of the forces.
+ */
+bool CalculateParallelRepulsiveForces(const NodeArrays& positions, NodeArrays& nodeChanges,
+                                      size_t numberOfThreads, const LayoutDeadline& deadline);
+
+#endif
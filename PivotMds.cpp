@@ -0,0 +1,165 @@
+/******************************************************
+ * File: PivotMds.cpp
+ *
+ * Implementation of the PivotMds.h interface.  With C
+ * the double-centered n by k matrix of squared pivot
+ * distances, the coordinates are C times the two top
+ * eigenvectors of C^T C.  These are found by power
+ * iteration on a pair of vectors at once, so that two
+ * equal eigenvalues, which symmetric graphs often have,
+ * do not stall the iteration: only the plane the pair
+ * spans needs to converge.
+ */
+
+#include <cmath>
+#include "PivotMds.h"
+#include "GraphDistances.h"
+#include "LayoutGeometry.h"
+using namespace std;
+
+/* Limits on the power iteration. */
+const size_t kMaximumPowerIterations = 1000;
+const double kPowerIterationTolerance = 1e-10;
+
+/* Distance, as a fraction of an edge's length, each node is nudged by. */
+const double kMdsNudge = 0.05;
+
+/*
+ * CenterSquaredDistances
+ * Stores in columns[p] the column of pivot p of
+ * -1/2 J D^2 J, where J subtracts the mean.
+ * Unreachable nodes are taken to be one step beyond the
+ * farthest reachable node.
+ */
+static void CenterSquaredDistances(const vector<vector<unsigned short> >& pivotDepths,
+                                   vector<vector<double> >& columns) {
+    size_t numberOfPivots = pivotDepths.size();
+    size_t numberOfNodes = pivotDepths[0].size();
+    unsigned short maximumDistance = 0;
+    for (size_t p = 0; p < numberOfPivots; p++) {
+        for (size_t node = 0; node < numberOfNodes; node++) {
+            if (pivotDepths[p][node] != kUnreachable) {
+                maximumDistance = max(maximumDistance, pivotDepths[p][node]);
+            }
+        }
+    }
+
+    columns.assign(numberOfPivots, vector<double>(numberOfNodes));
+    vector<double> rowMeans(numberOfNodes, 0.0);
+    double totalMean = 0;
+    for (size_t p = 0; p < numberOfPivots; p++) {
+        double columnMean = 0;
+        for (size_t node = 0; node < numberOfNodes; node++) {
+            double distance = pivotDepths[p][node];
+            if (pivotDepths[p][node] == kUnreachable) distance = maximumDistance + 1;
+            columns[p][node] = distance * distance;
+            columnMean += columns[p][node];
+            rowMeans[node] += columns[p][node] / numberOfPivots;
+        }
+        columnMean /= numberOfNodes;
+        totalMean += columnMean / numberOfPivots;
+        for (size_t node = 0; node < numberOfNodes; node++) columns[p][node] -= columnMean;
+    }
+    for (size_t p = 0; p < numberOfPivots; p++) {
+        for (size_t node = 0; node < numberOfNodes; node++) {
+            columns[p][node] = -0.5 * (columns[p][node] - rowMeans[node] + totalMean);
+        }
+    }
+}
+
+/*
+ * Normalize
+ * Scales a vector to unit length, returning false if it
+ * has none.
+ */
+static bool Normalize(vector<double>& values) {
+    double length = 0;
+    for (size_t i = 0; i < values.size(); i++) length += values[i] * values[i];
+    length = sqrt(length);
+    if (length == 0) return false;
+    for (size_t i = 0; i < values.size(); i++) values[i] /= length;
+    return true;
+}
+
+/*
+ * TopEigenvectors
+ * Stores in first and second orthonormal vectors
+ * spanning the top two eigenvectors of the symmetric
+ * matrix, by power iteration with Gram-Schmidt.
+ */
+static void TopEigenvectors(const vector<vector<double> >& matrix,
+                            vector<double>& first, vector<double>& second) {
+    size_t size = matrix.size();
+    first.resize(size);
+    second.resize(size);
+    for (size_t i = 0; i < size; i++) {
+        first[i] = 1 + sin(i + 1.0);
+        second[i] = cos(i + 1.0);
+    }
+
+    vector<double> nextFirst(size), nextSecond(size);
+    for (size_t iteration = 0; iteration < kMaximumPowerIterations; iteration++) {
+        for (size_t i = 0; i < size; i++) {
+            nextFirst[i] = nextSecond[i] = 0;
+            for (size_t j = 0; j < size; j++) {
+                nextFirst[i] += matrix[i][j] * first[j];
+                nextSecond[i] += matrix[i][j] * second[j];
+            }
+        }
+        if (!Normalize(nextFirst)) return;
+        double overlap = 0;
+        for (size_t i = 0; i < size; i++) overlap += nextFirst[i] * nextSecond[i];
+        for (size_t i = 0; i < size; i++) nextSecond[i] -= overlap * nextFirst[i];
+        if (!Normalize(nextSecond)) return;
+
+        double change = 0;
+        for (size_t i = 0; i < size; i++) {
+            change += fabs(nextFirst[i] - first[i]) + fabs(nextSecond[i] - second[i]);
+        }
+        first.swap(nextFirst);
+        second.swap(nextSecond);
+        if (change < kPowerIterationTolerance) return;
+    }
+}
+
+/*
+ * PivotMdsLayout
+ * Chooses the pivots, builds C and C^T C, projects the
+ * nodes onto the top eigenvectors, and scales and nudges
+ * the result.
+ */
+void PivotMdsLayout(SimpleGraph& graph, size_t numberOfPivots) {
+    size_t numberOfNodes = graph.nodes.size();
+    if (numberOfNodes < 2 || numberOfPivots == 0) return;
+
+    Adjacency adjacency;
+    BuildAdjacency(numberOfNodes, graph.edges, adjacency);
+    vector<size_t> pivots;
+    vector<vector<unsigned short> > pivotDepths;
+    ChoosePivots(adjacency, numberOfPivots, pivots, pivotDepths);
+    numberOfPivots = pivots.size();
+
+    vector<vector<double> > columns;
+    CenterSquaredDistances(pivotDepths, columns);
+    vector<vector<double> > product(numberOfPivots, vector<double>(numberOfPivots));
+    for (size_t p = 0; p < numberOfPivots; p++) {
+        for (size_t q = p; q < numberOfPivots; q++) {
+            double sum = 0;
+            for (size_t node = 0; node < numberOfNodes; node++) {
+                sum += columns[p][node] * columns[q][node];
+            }
+            product[p][q] = product[q][p] = sum;
+        }
+    }
+    vector<double> first, second;
+    TopEigenvectors(product, first, second);
+
+    vector<double> x(numberOfNodes, 0.0), y(numberOfNodes, 0.0);
+    for (size_t p = 0; p < numberOfPivots; p++) {
+        for (size_t node = 0; node < numberOfNodes; node++) {
+            x[node] += columns[p][node] * first[p];
+            y[node] += columns[p][node] * second[p];
+        }
+    }
+    PlaceAtUnitEdgeLength(x, y, kMdsNudge, graph);
+}
@@ -0,0 +1,40 @@
+/*************************************************************************
+ * File: PivotMds.h
+ *
+ * A header file defining an initial layout by Pivot MDS, after Brandes
+ * and Pich, "Eigensolver Methods for Progressive Multidimensional
+ * Scaling of Large Data" (2006).  Classical multidimensional scaling
+ * places the nodes so that their distances best match the graph
+ * distances, using the top eigenvectors of the double-centered matrix
+ * of squared distances between all pairs.  Pivot MDS keeps only the
+ * columns of k pivot nodes: k breadth-first searches fill an n by k
+ * matrix, and the eigenvectors of a k by k product of it give the
+ * layout.  The cost is O(k * m) for the searches and O(k^2 * n) for the
+ * product, so a few dozen pivots lay out graphs of many thousands of
+ * nodes in a fraction of a second.
+ *
+ * The result shows the global shape of the graph, which the unit circle
+ * hides, so the force-directed layout started from it only has to fix
+ * local detail.  Nodes the pivots cannot tell apart, such as the leaves
+ * of a star, land on the same spot, so every node is nudged slightly
+ * to keep the forces between them finite.
+ */
+
+#ifndef PivotMds_Included // Include guard
+#define PivotMds_Included
+
+#include "SimpleGraph.h" // For the SimpleGraph type.
+
+/* Default number of pivots. */
+const size_t kDefaultMdsPivots = 50;
+
+/**
+ * Function: PivotMdsLayout(SimpleGraph& graph, size_t numberOfPivots)
+ * -----------------------------------------------------------------------
+ * Places the graph's nodes by Pivot MDS with up to numberOfPivots
+ * pivots, scaled so that edges are one unit long on average.  Graphs of
+ * fewer than two nodes are left unchanged.
+ */
+void PivotMdsLayout(SimpleGraph& graph, size_t numberOfPivots);
+
+#endif
@@ -0,0 +1,368 @@
+/******************************************************
+ * File: PrecisionRepulsion.cpp
+ *
+ * Implementation of the PrecisionRepulsion.h interface.
+ * The template chooses its kernel by overloading on the
+ * array types, so each pairing gets the widest kernel
+ * that suits it: double positions go to the kernels of
+ * SimdRepulsion.h, and float positions to the AVX2
+ * kernels below, or to the scalar template on other
+ * processors.
+ *
+ * Each scalar pair computes kRepel * (dx, dy) / d^2,
+ * which is the force kRepel / d along the unit vector,
+ * without a square root.  It works in the type of the
+ * positions and only adds the result in the type of the
+ * forces.
+ */
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include "PrecisionRepulsion.h"
+#include "SimdRepulsion.h"
+#include "ParallelRepulsion.h"
+#include "ForceLayout.h"
+using namespace std;
+
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 5))
+#define SIMD_PRECISION_AVAILABLE
+#include <immintrin.h>
+#endif
+
+/* Most float forces the mixed kernel sums before adding them to a double. */
+const size_t kMixedFlushInterval = 256;
+
+/*
+ * PrecisionModeName
+ * Returns a printable name for a mode.
+ */
+const char* PrecisionModeName(PrecisionMode mode) {
+    if (mode == kSinglePrecision) return "single";
+    if (mode == kMixedPrecision) return "mixed";
+    return "double";
+}
+
+/*
+ * RepelPrecisionPair
+ * Applies the repulsion between nodes i and j to both of
+ * their changes, computing it in Position and adding it
+ * in Accumulator.
+ */
+template <typename Position, typename Accumulator>
+static inline void RepelPrecisionPair(const Position* x, const Position* y,
+                                      Accumulator* changeX, Accumulator* changeY,
+                                      size_t i, size_t j) {
+    Position dx = x[j] - x[i];
+    Position dy = y[j] - y[i];
+    Position scale = Position(kRepel) / (dx * dx + dy * dy);
+    changeX[i] -= scale * dx;
+    changeY[i] -= scale * dy;
+    changeX[j] += scale * dx;
+    changeY[j] += scale * dy;
+}
+
+/*
+ * RowFinished
+ * Counts the pairs of a finished row and, once those
+ * since the last check reach kDeadlineCheckPairs, checks
+ * the deadline.  Returns true if it has passed.
+ */
+static inline bool RowFinished(size_t rowPairs, size_t& pairsSinceCheck,
+                               const LayoutDeadline& deadline) {
+    pairsSinceCheck += rowPairs;
+    if (pairsSinceCheck < kDeadlineCheckPairs) return false;
+    pairsSinceCheck = 0;
+    return DeadlinePassed(deadline);
+}
+
+/*
+ * RepelPrecisionScalar
+ * The portable kernel, visiting every pair once.
+ */
+template <typename Position, typename Accumulator>
+static bool RepelPrecisionScalar(const Position* x, const Position* y,
+                                 Accumulator* changeX, Accumulator* changeY,
+                                 size_t numberOfNodes, const LayoutDeadline& deadline) {
+    size_t pairsSinceCheck = 0;
+    for (size_t i = 0; i + 1 < numberOfNodes; i++) {
+        for (size_t j = i + 1; j < numberOfNodes; j++) {
+            RepelPrecisionPair(x, y, changeX, changeY, i, j);
+        }
+        if (RowFinished(numberOfNodes - i - 1, pairsSinceCheck, deadline)) return false;
+    }
+    return true;
+}
+
+#ifdef SIMD_PRECISION_AVAILABLE
+
+/*
+ * RepelAvx2Single
+ * The AVX2 kernel in single precision, handling eight
+ * partners at a time.  The reciprocal square root
+ * estimate is good to about 1e-4, and one Newton-Raphson
+ * step brings it to the precision of a float.
+ */
+__attribute__((target("avx2,fma")))
+static bool RepelAvx2Single(const float* x, const float* y, float* changeX, float* changeY,
+                            size_t numberOfNodes, const LayoutDeadline& deadline) {
+    const __m256 repel = _mm256_set1_ps((float) kRepel);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 threeHalves = _mm256_set1_ps(1.5f);
+    size_t pairsSinceCheck = 0;
+
+    for (size_t i = 0; i + 1 < numberOfNodes; i++) {
+        __m256 x0 = _mm256_set1_ps(x[i]);
+        __m256 y0 = _mm256_set1_ps(y[i]);
+        __m256 sumX = _mm256_setzero_ps();
+        __m256 sumY = _mm256_setzero_ps();
+
+        size_t j = i + 1;
+        for (; j + 8 <= numberOfNodes; j += 8) {
+            __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(x + j), x0);
+            __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(y + j), y0);
+            __m256 distanceSquared = _mm256_fmadd_ps(dx, dx, _mm256_mul_ps(dy, dy));
+
+            //Estimate 1 / d, then refine: r = r * (1.5 - 0.5 * d^2 * r^2)
+            __m256 inverse = _mm256_rsqrt_ps(distanceSquared);
+            __m256 product = _mm256_mul_ps(_mm256_mul_ps(half, distanceSquared),
+                                           _mm256_mul_ps(inverse, inverse));
+            inverse = _mm256_mul_ps(inverse, _mm256_sub_ps(threeHalves, product));
+
+            __m256 scale = _mm256_mul_ps(_mm256_mul_ps(repel, inverse), inverse);
+            __m256 forceX = _mm256_mul_ps(scale, dx);
+            __m256 forceY = _mm256_mul_ps(scale, dy);
+
+            sumX = _mm256_add_ps(sumX, forceX);
+            sumY = _mm256_add_ps(sumY, forceY);
+            _mm256_storeu_ps(changeX + j, _mm256_add_ps(_mm256_loadu_ps(changeX + j), forceX));
+            _mm256_storeu_ps(changeY + j, _mm256_add_ps(_mm256_loadu_ps(changeY + j), forceY));
+        }
+
+        float partsX[8], partsY[8];
+        _mm256_storeu_ps(partsX, sumX);
+        _mm256_storeu_ps(partsY, sumY);
+        changeX[i] -= ((partsX[0] + partsX[1]) + (partsX[2] + partsX[3])) +
+                      ((partsX[4] + partsX[5]) + (partsX[6] + partsX[7]));
+        changeY[i] -= ((partsY[0] + partsY[1]) + (partsY[2] + partsY[3])) +
+                      ((partsY[4] + partsY[5]) + (partsY[6] + partsY[7]));
+
+        for (; j < numberOfNodes; j++) {
+            RepelPrecisionPair(x, y, changeX, changeY, i, j);
+        }
+        if (RowFinished(numberOfNodes - i - 1, pairsSinceCheck, deadline)) return false;
+    }
+    return true;
+}
+
+/*
+ * AddWidened
+ * Adds the eight floats of part, widened, to the four
+ * doubles of sum.
+ */
+__attribute__((target("avx2,fma")))
+static inline __m256d AddWidened(__m256d sum, __m256 part) {
+    __m256d low = _mm256_cvtps_pd(_mm256_castps256_ps128(part));
+    __m256d high = _mm256_cvtps_pd(_mm256_extractf128_ps(part, 1));
+    return _mm256_add_pd(sum, _mm256_add_pd(low, high));
+}
+
+/*
+ * RepelAvx2Mixed
+ * The AVX2 kernel for float positions and double forces.
+ * Each pair is computed in float, eight partners at a
+ * time, as in RepelAvx2Single().  Widening every force
+ * to double would cost more than the float arithmetic
+ * saves, so forces are summed in float for at most
+ * kMixedFlushInterval pairs and only those partial sums
+ * are added in double: a node's own sum every that many
+ * partners, and its partners' sums, kept in float
+ * buffers, every that many rows.  The deadline is
+ * checked once per block of rows, after its flush.
+ */
+__attribute__((target("avx2,fma")))
+static bool RepelAvx2Mixed(const float* x, const float* y, double* changeX, double* changeY,
+                           size_t numberOfNodes, const LayoutDeadline& deadline) {
+    const __m256 repel = _mm256_set1_ps((float) kRepel);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 threeHalves = _mm256_set1_ps(1.5f);
+    vector<float> partialX(numberOfNodes, 0.0f), partialY(numberOfNodes, 0.0f);
+
+    for (size_t firstRow = 0; firstRow + 1 < numberOfNodes; firstRow += kMixedFlushInterval) {
+        size_t lastRow = min(firstRow + kMixedFlushInterval, numberOfNodes - 1);
+        for (size_t i = firstRow; i < lastRow; i++) {
+            __m256 x0 = _mm256_set1_ps(x[i]);
+            __m256 y0 = _mm256_set1_ps(y[i]);
+            __m256d rowX = _mm256_setzero_pd();
+            __m256d rowY = _mm256_setzero_pd();
+            double restX = 0, restY = 0;
+
+            for (size_t first = i + 1; first < numberOfNodes; first += kMixedFlushInterval) {
+                size_t last = min(first + kMixedFlushInterval, numberOfNodes);
+                __m256 sumX = _mm256_setzero_ps();
+                __m256 sumY = _mm256_setzero_ps();
+                size_t j = first;
+                for (; j + 8 <= last; j += 8) {
+                    __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(x + j), x0);
+                    __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(y + j), y0);
+                    __m256 distanceSquared = _mm256_fmadd_ps(dx, dx, _mm256_mul_ps(dy, dy));
+
+                    //Estimate 1 / d, then refine: r = r * (1.5 - 0.5 * d^2 * r^2)
+                    __m256 inverse = _mm256_rsqrt_ps(distanceSquared);
+                    __m256 product = _mm256_mul_ps(_mm256_mul_ps(half, distanceSquared),
+                                                   _mm256_mul_ps(inverse, inverse));
+                    inverse = _mm256_mul_ps(inverse, _mm256_sub_ps(threeHalves, product));
+
+                    __m256 scale = _mm256_mul_ps(_mm256_mul_ps(repel, inverse), inverse);
+                    __m256 forceX = _mm256_mul_ps(scale, dx);
+                    __m256 forceY = _mm256_mul_ps(scale, dy);
+
+                    sumX = _mm256_add_ps(sumX, forceX);
+                    sumY = _mm256_add_ps(sumY, forceY);
+                    _mm256_storeu_ps(partialX.data() + j,
+                                     _mm256_add_ps(_mm256_loadu_ps(partialX.data() + j), forceX));
+                    _mm256_storeu_ps(partialY.data() + j,
+                                     _mm256_add_ps(_mm256_loadu_ps(partialY.data() + j), forceY));
+                }
+                rowX = AddWidened(rowX, sumX);
+                rowY = AddWidened(rowY, sumY);
+
+                for (; j < last; j++) {
+                    float dx = x[j] - x[i];
+                    float dy = y[j] - y[i];
+                    float scale = (float) kRepel / (dx * dx + dy * dy);
+                    restX += scale * dx;
+                    restY += scale * dy;
+                    partialX[j] += scale * dx;
+                    partialY[j] += scale * dy;
+                }
+            }
+
+            double partsX[4], partsY[4];
+            _mm256_storeu_pd(partsX, rowX);
+            _mm256_storeu_pd(partsY, rowY);
+            changeX[i] -= ((partsX[0] + partsX[1]) + (partsX[2] + partsX[3])) + restX;
+            changeY[i] -= ((partsY[0] + partsY[1]) + (partsY[2] + partsY[3])) + restY;
+        }
+
+        //Every partner's float sum now holds at most kMixedFlushInterval forces
+        for (size_t j = firstRow + 1; j < numberOfNodes; j++) {
+            changeX[j] += partialX[j];
+            changeY[j] += partialY[j];
+            partialX[j] = partialY[j] = 0.0f;
+        }
+        if (DeadlinePassed(deadline)) return false;
+    }
+    return true;
+}
+
+#endif
+
+/*
+ * RepelAllPairs
+ * Double positions and forces: the kernels of
+ * SimdRepulsion.h, in tiles on one thread if there is a
+ * deadline to check between them.
+ */
+static bool RepelAllPairs(const BasicNodeArrays<double>& positions,
+                          BasicNodeArrays<double>& nodeChanges, const LayoutDeadline& deadline) {
+    if (deadline.limited) {
+        return CalculateParallelRepulsiveForces(positions, nodeChanges, 1, deadline);
+    }
+    CalculateVectorizedRepulsiveForces(positions, nodeChanges);
+    return true;
+}
+
+/*
+ * RepelAllPairs
+ * Float positions and forces.
+ */
+static bool RepelAllPairs(const BasicNodeArrays<float>& positions,
+                          BasicNodeArrays<float>& nodeChanges, const LayoutDeadline& deadline) {
+#ifdef SIMD_PRECISION_AVAILABLE
+    if (DetectSimdLevel() >= kAvx2Kernel) {
+        return RepelAvx2Single(positions.x.data(), positions.y.data(), nodeChanges.x.data(),
+                               nodeChanges.y.data(), positions.size(), deadline);
+    }
+#endif
+    return RepelPrecisionScalar(positions.x.data(), positions.y.data(), nodeChanges.x.data(),
+                                nodeChanges.y.data(), positions.size(), deadline);
+}
+
+/*
+ * RepelAllPairs
+ * Float positions and double forces.
+ */
+static bool RepelAllPairs(const BasicNodeArrays<float>& positions,
+                          BasicNodeArrays<double>& nodeChanges, const LayoutDeadline& deadline) {
+#ifdef SIMD_PRECISION_AVAILABLE
+    if (DetectSimdLevel() >= kAvx2Kernel) {
+        return RepelAvx2Mixed(positions.x.data(), positions.y.data(), nodeChanges.x.data(),
+                              nodeChanges.y.data(), positions.size(), deadline);
+    }
+#endif
+    return RepelPrecisionScalar(positions.x.data(), positions.y.data(), nodeChanges.x.data(),
+                                nodeChanges.y.data(), positions.size(), deadline);
+}
+
+/*
+ * CalculatePrecisionRepulsiveForces
+ * Picks the kernel for the pairing by overload.
+ */
+template <typename Position, typename Accumulator>
+void CalculatePrecisionRepulsiveForces(const BasicNodeArrays<Position>& positions,
+                                       BasicNodeArrays<Accumulator>& nodeChanges) {
+    RepelAllPairs(positions, nodeChanges, StartDeadline(HUGE_VAL));
+}
+
+//The three pairings described in the header
+template void CalculatePrecisionRepulsiveForces(const BasicNodeArrays<double>& positions,
+                                                BasicNodeArrays<double>& nodeChanges);
+template void CalculatePrecisionRepulsiveForces(const BasicNodeArrays<float>& positions,
+                                                BasicNodeArrays<float>& nodeChanges);
+template void CalculatePrecisionRepulsiveForces(const BasicNodeArrays<float>& positions,
+                                                BasicNodeArrays<double>& nodeChanges);
+
+/*
+ * CalculatePrecisionRepulsiveForces
+ * Runs against a deadline that never passes.
+ */
+void CalculatePrecisionRepulsiveForces(const NodeArrays& positions, NodeArrays& nodeChanges,
+                                       PrecisionMode mode) {
+    CalculatePrecisionRepulsiveForces(positions, nodeChanges, mode, StartDeadline(HUGE_VAL));
+}
+
+/*
+ * CalculatePrecisionRepulsiveForces
+ * Rounds the positions to float for the reduced modes.
+ * The mixed kernel adds straight into the double changes;
+ * the single kernel sums into float changes that are then
+ * added in, unless the deadline stopped it.
+ */
+bool CalculatePrecisionRepulsiveForces(const NodeArrays& positions, NodeArrays& nodeChanges,
+                                       PrecisionMode mode, const LayoutDeadline& deadline) {
+    if (mode == kDoublePrecision) {
+        return RepelAllPairs(positions, nodeChanges, deadline);
+    }
+
+    size_t numberOfNodes = positions.size();
+    BasicNodeArrays<float> rounded;
+    ResizeNodeArrays(rounded, numberOfNodes);
+    for (size_t i = 0; i < numberOfNodes; i++) {
+        rounded.x[i] = (float) positions.x[i];
+        rounded.y[i] = (float) positions.y[i];
+    }
+
+    if (mode == kMixedPrecision) {
+        return RepelAllPairs(rounded, nodeChanges, deadline);
+    }
+    BasicNodeArrays<float> changes;
+    ResizeNodeArrays(changes, numberOfNodes);
+    if (!RepelAllPairs(rounded, changes, deadline)) return false;
+    for (size_t i = 0; i < numberOfNodes; i++) {
+        nodeChanges.x[i] += changes.x[i];
+        nodeChanges.y[i] += changes.y[i];
+    }
+    return true;
+}
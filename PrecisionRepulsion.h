@@ -0,0 +1,96 @@
+/*************************************************************************
+ * File: PrecisionRepulsion.h
+ *
+ * A header file defining the exact all-pairs repulsion in reduced
+ * precision.  The exact engine reads every node's coordinates once per
+ * node, so on large graphs it is limited by memory traffic and by the
+ * number of pairs a vector instruction can hold.  Storing coordinates as
+ * float halves both the traffic and the width of each pair, so an AVX2
+ * register holds eight partners instead of four.
+ *
+ * The kernel is a template over two types: Position, the type the node
+ * coordinates are read and each pair's force computed in, and
+ * Accumulator, the type the forces are summed in.  Three pairings are
+ * provided:
+ *
+ *   - double positions and double forces, the reference;
+ *   - float positions and float forces, the fastest and least exact;
+ *   - float positions and double forces.  Each pair costs what it does
+ *     in single precision, but no sum runs over more than a few hundred
+ *     float forces before it is added in double, so the sums of
+ *     thousands of small forces keep their accuracy.
+ *
+ * The layout keeps its positions in double between iterations, so the
+ * loss of precision does not build up from step to step; only each
+ * force evaluation sees rounded coordinates.
+ */
+
+#ifndef PrecisionRepulsion_Included // Include guard
+#define PrecisionRepulsion_Included
+
+#include "NodeArrays.h"   // For the NodeArrays type.
+#include "LayoutBudget.h" // For the LayoutDeadline type.
+
+/**
+ * Type: PrecisionMode
+ * -----------------------------------------------------------------------
+ * The precision of the exact repulsion.  kDoublePrecision uses the
+ * double kernels of SimdRepulsion.h.  kSinglePrecision reads positions
+ * and sums forces in float.  kMixedPrecision reads positions and
+ * computes each pair in float, and sums forces in double.
+ */
+enum PrecisionMode {
+    kDoublePrecision,
+    kSinglePrecision,
+    kMixedPrecision
+};
+
+/**
+ * Function: PrecisionModeName(PrecisionMode mode)
+ * -----------------------------------------------------------------------
+ * Returns a printable name for the mode, such as "mixed".
+ */
+const char* PrecisionModeName(PrecisionMode mode);
+
+/**
+ * Function: CalculatePrecisionRepulsiveForces(
+ *               const BasicNodeArrays<Position>& positions,
+ *               BasicNodeArrays<Accumulator>& nodeChanges)
+ * -----------------------------------------------------------------------
+ * Adds the exact repulsive force between every pair of nodes into
+ * nodeChanges, computing in the given types.  Provided for the three
+ * pairings described above; the float pairings use AVX2 when the
+ * processor has it.
+ */
+template <typename Position, typename Accumulator>
+void CalculatePrecisionRepulsiveForces(const BasicNodeArrays<Position>& positions,
+                                       BasicNodeArrays<Accumulator>& nodeChanges);
+
+/**
+ * Function: CalculatePrecisionRepulsiveForces(const NodeArrays& positions,
+ *                                             NodeArrays& nodeChanges,
+ *                                             PrecisionMode mode)
+ * -----------------------------------------------------------------------
+ * Rounds the positions to the precision the mode reads them in, runs
+ * the matching kernel on one thread, and adds its forces into the
+ * double nodeChanges.
+ */
+void CalculatePrecisionRepulsiveForces(const NodeArrays& positions, NodeArrays& nodeChanges,
+                                       PrecisionMode mode);
+
+/**
+ * Function: CalculatePrecisionRepulsiveForces(const NodeArrays& positions,
+ *                                             NodeArrays& nodeChanges,
+ *                                             PrecisionMode mode,
+ *                                             const LayoutDeadline& deadline)
+ * -----------------------------------------------------------------------
+ * The same, except that the deadline is checked after every row of
+ * pairs that brings those since the last check to kDeadlineCheckPairs,
+ * or after every block of rows the mixed kernel flushes.  Returns true
+ * if every pair was done, and false if the deadline stopped the pass,
+ * in which case nodeChanges holds only part of the forces.
+ */
+bool CalculatePrecisionRepulsiveForces(const NodeArrays& positions, NodeArrays& nodeChanges,
+                                       PrecisionMode mode, const LayoutDeadline& deadline);
+
+#endif
@@ -0,0 +1,269 @@
+/******************************************************
+ * File: QuadTree.cpp
+ *
+ * Implementation of the QuadTree.h interface.  The tree
+ * is rebuilt from scratch on every iteration; building
+ * it is cheap next to the force calculation, and the
+ * nodes move too much between iterations for an update
+ * in place to pay off.
+ */
+
+#include <cmath>
+#include <algorithm>
+#include "QuadTree.h"
+#include "ForceLayout.h"
+using namespace std;
+
+/* Predicates used to split a cell's nodes into quadrants. */
+struct BelowY {
+    const double* y;
+    double middle;
+    bool operator() (size_t index) const { return y[index] < middle; }
+};
+
+struct LeftOfX {
+    const double* x;
+    double middle;
+    bool operator() (size_t index) const { return x[index] < middle; }
+};
+
+/*
+ * MassOf
+ * Returns the mass of a node: its entry in masses, or
+ * one if the nodes are unweighted.
+ */
+static inline double MassOf(const double* masses, size_t node) {
+    return masses ? masses[node] : 1.0;
+}
+
+/*
+ * BuildCell
+ * Fills in the cell at cellIndex, which covers the nodes
+ * in bodies[first, last), splitting it into four children
+ * until each leaf is small enough.  masses is NULL for
+ * unweighted nodes.
+ */
+static void BuildCell(const NodeArrays& positions, const double* masses, QuadTree& tree,
+                      size_t cellIndex, size_t first, size_t last, size_t depth,
+                      size_t leafCapacity) {
+    QuadTreeCell cell = tree.cells[cellIndex];
+    cell.firstBody = first;
+    cell.lastBody = last;
+    cell.mass = 0;
+    cell.massX = cell.massY = 0;
+
+    //Small or very deep cells become leaves
+    if (last - first <= leafCapacity || depth == kQuadTreeMaxDepth) {
+        cell.isLeaf = true;
+        cell.firstChild = 0;
+        for (size_t i = first; i < last; i++) {
+            double mass = MassOf(masses, tree.bodies[i]);
+            cell.mass += mass;
+            cell.massX += mass * positions.x[tree.bodies[i]];
+            cell.massY += mass * positions.y[tree.bodies[i]];
+        }
+        if (cell.mass > 0) {
+            cell.massX /= cell.mass;
+            cell.massY /= cell.mass;
+        }
+        tree.cells[cellIndex] = cell;
+        return;
+    }
+
+    //Split the nodes into bottom and top halves, then each half into left and right
+    BelowY below = { positions.y.data(), cell.centerY };
+    LeftOfX left = { positions.x.data(), cell.centerX };
+    vector<size_t>::iterator begin = tree.bodies.begin();
+    size_t middle = partition(begin + first, begin + last, below) - begin;
+    size_t bounds[5];
+    bounds[0] = first;
+    bounds[1] = partition(begin + first, begin + middle, left) - begin;
+    bounds[2] = middle;
+    bounds[3] = partition(begin + middle, begin + last, left) - begin;
+    bounds[4] = last;
+
+    //Children are numbered bottom-left, bottom-right, top-left, top-right
+    cell.isLeaf = false;
+    cell.firstChild = tree.cells.size();
+    double quarter = cell.halfSize / 2;
+    for (size_t child = 0; child < 4; child++) {
+        QuadTreeCell childCell;
+        childCell.centerX = cell.centerX + ((child & 1) ? quarter : -quarter);
+        childCell.centerY = cell.centerY + ((child & 2) ? quarter : -quarter);
+        childCell.halfSize = quarter;
+        tree.cells.push_back(childCell);
+    }
+    for (size_t child = 0; child < 4; child++) {
+        BuildCell(positions, masses, tree, cell.firstChild + child, bounds[child],
+                  bounds[child + 1], depth + 1, leafCapacity);
+        const QuadTreeCell& childCell = tree.cells[cell.firstChild + child];
+        cell.mass += childCell.mass;
+        cell.massX += childCell.mass * childCell.massX;
+        cell.massY += childCell.mass * childCell.massY;
+    }
+    cell.massX /= cell.mass;
+    cell.massY /= cell.mass;
+    tree.cells[cellIndex] = cell;
+}
+
+/*
+ * BuildTree
+ * Rebuilds the tree over the given nodes, with a square
+ * root cell just large enough to hold all of them.
+ */
+static void BuildTree(const NodeArrays& positions, const double* masses, QuadTree& tree,
+                      size_t leafCapacity) {
+    size_t numberOfNodes = positions.size();
+    tree.cells.clear();
+    tree.bodies.resize(numberOfNodes);
+    for (size_t i = 0; i < numberOfNodes; i++) {
+        tree.bodies[i] = i;
+    }
+
+    //Find the bounding box of the nodes
+    double minX = 0, minY = 0, maxX = 0, maxY = 0;
+    if (numberOfNodes > 0) {
+        minX = maxX = positions.x[0];
+        minY = maxY = positions.y[0];
+    }
+    for (size_t i = 1; i < numberOfNodes; i++) {
+        minX = min(minX, positions.x[i]);
+        maxX = max(maxX, positions.x[i]);
+        minY = min(minY, positions.y[i]);
+        maxY = max(maxY, positions.y[i]);
+    }
+
+    QuadTreeCell root;
+    root.centerX = (minX + maxX) / 2;
+    root.centerY = (minY + maxY) / 2;
+    root.halfSize = max(maxX - minX, maxY - minY) / 2;
+    tree.cells.push_back(root);
+    BuildCell(positions, masses, tree, 0, 0, numberOfNodes, 0, leafCapacity);
+}
+
+/*
+ * BuildQuadTree
+ * Builds the tree with every node of mass one.
+ */
+void BuildQuadTree(const NodeArrays& positions, QuadTree& tree, size_t leafCapacity) {
+    BuildTree(positions, NULL, tree, leafCapacity);
+}
+
+/*
+ * ValidTheta
+ * Returns theta if it is a usable opening angle, and
+ * zero, which opens every cell, if it is not.
+ */
+static double ValidTheta(double theta) {
+    return (theta >= 0 && theta < kMaximumBarnesHutTheta) ? theta : 0;
+}
+
+/*
+ * RepelThroughTree
+ * Walks the quadtree once for every node, opening cells
+ * that are too close to approximate, or that contain the
+ * node, and interacting exactly with the nodes of any
+ * leaf it reaches.  Each force is scaled by the masses
+ * of both ends; masses is NULL for unweighted nodes,
+ * which leaves every force as it was.  The deadline is
+ * checked after every kDeadlineCheckNodes walks.
+ */
+static bool RepelThroughTree(const NodeArrays& positions, const double* masses,
+                             NodeArrays& nodeChanges, double theta,
+                             const LayoutDeadline& deadline) {
+    theta = ValidTheta(theta);
+    QuadTree tree;
+    BuildTree(positions, masses, tree, kQuadTreeLeafCapacity);
+
+    vector<size_t> stack;
+    for (size_t nodeIndex = 0; nodeIndex < positions.size(); nodeIndex++) {
+        double x0 = positions.x[nodeIndex];
+        double y0 = positions.y[nodeIndex];
+        double changeX = 0, changeY = 0;
+
+        stack.push_back(0);
+        while (!stack.empty()) {
+            const QuadTreeCell& cell = tree.cells[stack.back()];
+            stack.pop_back();
+            if (cell.mass == 0) continue;
+
+            if (cell.isLeaf) {
+                //Interact exactly with every other node in the leaf
+                for (size_t i = cell.firstBody; i < cell.lastBody; i++) {
+                    size_t other = tree.bodies[i];
+                    if (other == nodeIndex) continue;
+                    double x1 = positions.x[other];
+                    double y1 = positions.y[other];
+                    double distance = sqrt((x0 - x1) * (x0 - x1) + (y0 - y1) * (y0 - y1));
+                    double fRepel = MassOf(masses, other) * CalculateFRepel(distance);
+                    changeX += fRepel * (x0 - x1) / distance;
+                    changeY += fRepel * (y0 - y1) / distance;
+                }
+                continue;
+            }
+
+            //Approximate the cell by its centre of mass if it is far enough away
+            double dx = x0 - cell.massX;
+            double dy = y0 - cell.massY;
+            double distanceSquared = dx * dx + dy * dy;
+            double width = 2 * cell.halfSize;
+            bool outside = fabs(x0 - cell.centerX) > cell.halfSize ||
+                           fabs(y0 - cell.centerY) > cell.halfSize;
+            if (width * width < theta * theta * distanceSquared && outside) {
+                double distance = sqrt(distanceSquared);
+                double fRepel = cell.mass * CalculateFRepel(distance);
+                changeX += fRepel * dx / distance;
+                changeY += fRepel * dy / distance;
+            } else {
+                for (size_t child = 0; child < 4; child++) {
+                    stack.push_back(cell.firstChild + child);
+                }
+            }
+        }
+
+        double mass = MassOf(masses, nodeIndex);
+        nodeChanges.x[nodeIndex] += mass * changeX;
+        nodeChanges.y[nodeIndex] += mass * changeY;
+        if ((nodeIndex + 1) % kDeadlineCheckNodes == 0 && DeadlinePassed(deadline)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * CalculateBarnesHutRepulsiveForces
+ * Repels unweighted nodes.
+ */
+void CalculateBarnesHutRepulsiveForces(const NodeArrays& positions, NodeArrays& nodeChanges,
+                                       double theta) {
+    RepelThroughTree(positions, NULL, nodeChanges, theta, StartDeadline(HUGE_VAL));
+}
+
+/*
+ * CalculateBarnesHutRepulsiveForces
+ * Repels unweighted nodes until the deadline passes.
+ */
+bool CalculateBarnesHutRepulsiveForces(const NodeArrays& positions, NodeArrays& nodeChanges,
+                                       double theta, const LayoutDeadline& deadline) {
+    return RepelThroughTree(positions, NULL, nodeChanges, theta, deadline);
+}
+
+/*
+ * CalculateBarnesHutRepulsiveForces
+ * Repels nodes weighted by the given masses.
+ */
+void CalculateBarnesHutRepulsiveForces(const NodeArrays& positions, const vector<double>& masses,
+                                       NodeArrays& nodeChanges, double theta) {
+    RepelThroughTree(positions, masses.data(), nodeChanges, theta, StartDeadline(HUGE_VAL));
+}
+
+/*
+ * CalculateBarnesHutRepulsiveForces
+ * Repels weighted nodes until the deadline passes.
+ */
+bool CalculateBarnesHutRepulsiveForces(const NodeArrays& positions, const vector<double>& masses,
+                                       NodeArrays& nodeChanges, double theta,
+                                       const LayoutDeadline& deadline) {
+    return RepelThroughTree(positions, masses.data(), nodeChanges, theta, deadline);
+}
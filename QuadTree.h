@@ -0,0 +1,132 @@
+/*************************************************************************
+ * File: QuadTree.h
+ *
+ * A header file defining a point-region quadtree over a set of node
+ * positions, along with the Barnes-Hut approximation of the repulsive
+ * forces that uses it.
+ *
+ * Every cell of the tree records the number of nodes it contains and
+ * their centre of mass.  When a cell is far enough away from a node
+ * (its width divided by its distance is below the opening angle theta),
+ * the repulsion from all of its nodes is approximated by a single
+ * interaction with its centre of mass.  This reduces each iteration from
+ * O(n^2) to O(n log n).
+ *
+ * With the default theta of 0.5, the net repulsive force on each node of
+ * the bundled 30clique, 127binary-tree and 10grid graphs stays within 2%
+ * of the largest exact force in the graph, both at the unit-circle start
+ * and after the layout has run (on 30clique every cell is opened, so the
+ * forces come out exact).  LayoutBenchmark checks this bound on every
+ * graph file it is given.  Setting theta to 0 always reproduces the exact
+ * forces.
+ *
+ * theta must lie in [0, kMaximumBarnesHutTheta) of ForceLayout.h.  Past
+ * 1 / sqrt(2) the opening test alone could accept the very cell a node
+ * lies in, so the walk also opens every cell that contains the node.
+ */
+
+#ifndef QuadTree_Included // Include guard
+#define QuadTree_Included
+
+#include "NodeArrays.h"   // For the NodeArrays type.
+#include "LayoutBudget.h" // For the LayoutDeadline type.
+
+/* Maximum number of nodes stored in a leaf before it is split. */
+const size_t kQuadTreeLeafCapacity = 4;
+
+/* Maximum depth of the tree; deeper leaves hold any number of nodes. */
+const size_t kQuadTreeMaxDepth = 32;
+
+/**
+ * Type: QuadTreeCell
+ * -----------------------------------------------------------------------
+ * A square region of the plane.  Internal cells have four children
+ * stored consecutively starting at firstChild; leaves list their nodes
+ * in the range [firstBody, lastBody) of the tree's bodies vector.
+ */
+struct QuadTreeCell {
+    double centerX, centerY, halfSize;
+    double mass, massX, massY;
+    bool isLeaf;
+    size_t firstChild;
+    size_t firstBody, lastBody;
+};
+
+/**
+ * Type: QuadTree
+ * -----------------------------------------------------------------------
+ * A quadtree whose root is cells[0].  bodies holds the indices of the
+ * graph's nodes, grouped so that each leaf's nodes are contiguous.
+ */
+struct QuadTree {
+    vector<QuadTreeCell> cells;
+    vector<size_t> bodies;
+};
+
+/**
+ * Function: BuildQuadTree(const NodeArrays& positions, QuadTree& tree,
+ *                         size_t leafCapacity)
+ * -----------------------------------------------------------------------
+ * Rebuilds tree so that it holds every node in positions, and computes the
+ * mass and centre of mass of every cell.  Cells holding more than
+ * leafCapacity nodes are split.
+ */
+void BuildQuadTree(const NodeArrays& positions, QuadTree& tree,
+                   size_t leafCapacity = kQuadTreeLeafCapacity);
+
+/**
+ * Function: CalculateBarnesHutRepulsiveForces(const NodeArrays& positions,
+ *                                             NodeArrays& nodeChanges,
+ *                                             double theta)
+ * -----------------------------------------------------------------------
+ * Builds a quadtree over the node positions and adds the approximate
+ * repulsive force on every node into nodeChanges, using theta as the
+ * opening angle.  A theta outside [0, kMaximumBarnesHutTheta) is
+ * rejected, and the forces are then computed exactly, as with theta = 0.
+ */
+void CalculateBarnesHutRepulsiveForces(const NodeArrays& positions, NodeArrays& nodeChanges,
+                                       double theta);
+
+/**
+ * Function: CalculateBarnesHutRepulsiveForces(const NodeArrays& positions,
+ *                                             NodeArrays& nodeChanges,
+ *                                             double theta,
+ *                                             const LayoutDeadline& deadline)
+ * -----------------------------------------------------------------------
+ * The same, except that the deadline is checked after the walks for
+ * every kDeadlineCheckNodes nodes.  Returns true if every node was done,
+ * and false if the deadline stopped the pass, in which case nodeChanges
+ * holds the forces on only some of the nodes.
+ */
+bool CalculateBarnesHutRepulsiveForces(const NodeArrays& positions, NodeArrays& nodeChanges,
+                                       double theta, const LayoutDeadline& deadline);
+
+/**
+ * Function: CalculateBarnesHutRepulsiveForces(const NodeArrays& positions,
+ *                                             const vector<double>& masses,
+ *                                             NodeArrays& nodeChanges,
+ *                                             double theta)
+ * -----------------------------------------------------------------------
+ * The same, with the force between two nodes scaled by the product of
+ * their masses, as ForceAtlas2.h's degree-weighted repulsion needs.  A
+ * cell's mass is then the total mass of its nodes, and its centre of
+ * mass their weighted mean.
+ */
+void CalculateBarnesHutRepulsiveForces(const NodeArrays& positions, const vector<double>& masses,
+                                       NodeArrays& nodeChanges, double theta);
+
+/**
+ * Function: CalculateBarnesHutRepulsiveForces(const NodeArrays& positions,
+ *                                             const vector<double>& masses,
+ *                                             NodeArrays& nodeChanges,
+ *                                             double theta,
+ *                                             const LayoutDeadline& deadline)
+ * -----------------------------------------------------------------------
+ * The same, weighted by the masses, stopping as the unweighted version
+ * does once the deadline has passed.
+ */
+bool CalculateBarnesHutRepulsiveForces(const NodeArrays& positions, const vector<double>& masses,
+                                       NodeArrays& nodeChanges, double theta,
+                                       const LayoutDeadline& deadline);
+
+#endif
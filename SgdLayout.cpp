@@ -0,0 +1,253 @@
+/******************************************************
+ * File: SgdLayout.cpp
+ *
+ * Implementation of the SgdLayout.h interface.  Each
+ * term carries a separate weight for each of its nodes:
+ * the exact terms and the edge terms move both nodes
+ * alike, while a pivot term only moves the ordinary
+ * node, since the pivot stands in for many nodes that
+ * are not actually pulled.
+ */
+
+#include <cmath>
+#include <random>
+#include <algorithm>
+#include "SgdLayout.h"
+#include "GraphDistances.h"
+#include "Parallel.h"
+using namespace std;
+
+/* Number of terms shuffled together, small enough to stay in the cache. */
+const size_t kSgdBlockSize = 1024;
+
+/* One term of the stress. */
+struct SgdTerm {
+    unsigned int node0, node1;
+    float distance;
+    float weight0, weight1;  // weights used when moving node0 and node1
+};
+
+/*
+ * DefaultSgdOptions
+ * Returns the default parameters, using the exact
+ * engine.
+ */
+SgdOptions DefaultSgdOptions() {
+    SgdOptions options;
+    options.epochs = kDefaultSgdEpochs;
+    options.epsilon = kDefaultSgdEpsilon;
+    options.numberOfPivots = 0;
+    options.numberOfThreads = 0;
+    options.seed = kDefaultSgdSeed;
+    return options;
+}
+
+/*
+ * MakeTerm
+ * Returns a term between two nodes.
+ */
+static SgdTerm MakeTerm(size_t node0, size_t node1, double distance,
+                        double weight0, double weight1) {
+    SgdTerm term;
+    term.node0 = node0;
+    term.node1 = node1;
+    term.distance = distance;
+    term.weight0 = weight0;
+    term.weight1 = weight1;
+    return term;
+}
+
+/*
+ * BuildExactTerms
+ * Adds one term for every pair of nodes, weighted by
+ * 1 / d^2, reading the distances from the table that
+ * CalculateGraphDistances() fills on several threads.
+ * Returns false if the graph is too large for the
+ * table.
+ */
+static bool BuildExactTerms(const SimpleGraph& graph, size_t numberOfThreads,
+                            vector<SgdTerm>& terms) {
+    GraphDistances distances;
+    if (!CalculateGraphDistances(graph, distances, numberOfThreads)) return false;
+    size_t numberOfNodes = distances.numberOfNodes;
+    terms.reserve(numberOfNodes * (numberOfNodes - 1) / 2);
+    const unsigned short* value = distances.values.data();
+    for (size_t node0 = 0; node0 + 1 < numberOfNodes; node0++) {
+        for (size_t node1 = node0 + 1; node1 < numberOfNodes; node1++) {
+            double distance = *value++;
+            double weight = 1.0 / (distance * distance);
+            terms.push_back(MakeTerm(node0, node1, distance, weight, weight));
+        }
+    }
+    return true;
+}
+
+/*
+ * BuildPivotTerms
+ * Chooses pivots by max-min distance and assigns every
+ * node to its closest pivot's region.  Adds a term for
+ * each edge, and from every node to every pivot it is
+ * not adjacent to.  That term is weighted by the number
+ * of nodes in the pivot's region that are no farther
+ * from the pivot than half the node's distance to it,
+ * the nodes whose terms it replaces.
+ */
+static void BuildPivotTerms(const SimpleGraph& graph, const Adjacency& adjacency,
+                            size_t numberOfPivots, vector<SgdTerm>& terms) {
+    size_t numberOfNodes = adjacency.size();
+    vector<size_t> pivots;
+    vector<vector<unsigned short> > pivotDepths;
+    ChoosePivots(adjacency, numberOfPivots, pivots, pivotDepths);
+    numberOfPivots = pivots.size();
+
+    vector<unsigned short> closestDistance(numberOfNodes, kUnreachable);
+    vector<size_t> closestPivot(numberOfNodes, numberOfPivots);
+    for (size_t p = 0; p < numberOfPivots; p++) {
+        for (size_t node = 0; node < numberOfNodes; node++) {
+            if (pivotDepths[p][node] < closestDistance[node]) {
+                closestDistance[node] = pivotDepths[p][node];
+                closestPivot[node] = p;
+            }
+        }
+    }
+
+    //regionCounts[p][t] is the number of nodes in p's region within t of p
+    vector<vector<size_t> > regionCounts(numberOfPivots);
+    for (size_t node = 0; node < numberOfNodes; node++) {
+        size_t p = closestPivot[node];
+        if (p == numberOfPivots) continue;
+        if (regionCounts[p].size() <= closestDistance[node]) {
+            regionCounts[p].resize(closestDistance[node] + 1, 0);
+        }
+        regionCounts[p][closestDistance[node]]++;
+    }
+    for (size_t p = 0; p < numberOfPivots; p++) {
+        for (size_t t = 1; t < regionCounts[p].size(); t++) {
+            regionCounts[p][t] += regionCounts[p][t - 1];
+        }
+    }
+
+    for (size_t i = 0; i < graph.edges.size(); i++) {
+        const Edge& edge = graph.edges[i];
+        if (edge.start == edge.end) continue;
+        terms.push_back(MakeTerm(edge.start, edge.end, 1, 1, 1));
+    }
+    for (size_t p = 0; p < numberOfPivots; p++) {
+        for (size_t node = 0; node < numberOfNodes; node++) {
+            unsigned short distance = pivotDepths[p][node];
+            if (distance < 2 || distance == kUnreachable) continue;
+            size_t half = min((size_t) distance / 2, regionCounts[p].size() - 1);
+            double weight = regionCounts[p][half] / ((double) distance * distance);
+            terms.push_back(MakeTerm(node, pivots[p], distance, weight, 0));
+        }
+    }
+}
+
+/*
+ * ApplyTerms
+ * Applies the terms in [begin, end) in order with the
+ * given learning rate.  Runs concurrently with other
+ * threads applying other terms to the same arrays.
+ */
+static void ApplyTerms(const vector<SgdTerm>& terms, size_t begin, size_t end,
+                       double learningRate, double* x, double* y) {
+    for (size_t t = begin; t < end; t++) {
+        const SgdTerm& term = terms[t];
+        double dx = x[term.node0] - x[term.node1];
+        double dy = y[term.node0] - y[term.node1];
+        double length = sqrt(dx * dx + dy * dy);
+        if (length == 0) continue;
+
+        //Half of the error, along the unit vector between the nodes
+        double scale = (length - term.distance) / (2 * length);
+        double step0 = min(term.weight0 * learningRate, 1.0) * scale;
+        double step1 = min(term.weight1 * learningRate, 1.0) * scale;
+        x[term.node0] -= step0 * dx;
+        y[term.node0] -= step0 * dy;
+        x[term.node1] += step1 * dx;
+        y[term.node1] += step1 * dy;
+    }
+}
+
+/*
+ * SgdLayout
+ * Builds the terms, falling back to pivots on graphs
+ * too large for the exact ones, then runs the epochs,
+ * lowering the learning rate geometrically between
+ * them.  Shuffling millions of terms every epoch costs
+ * more than applying them, since every swap misses the
+ * cache.  The terms are instead shuffled once, cut into
+ * blocks, and each epoch visits the blocks in a new
+ * random order and shuffles each block as it reaches
+ * it.  Threads shuffle their own blocks, so that work
+ * is parallel too.
+ */
+size_t SgdLayout(SimpleGraph& graph, const SgdOptions& options) {
+    size_t numberOfNodes = graph.nodes.size();
+    if (numberOfNodes < 2) return 0;
+
+    Adjacency adjacency;
+    BuildAdjacency(numberOfNodes, graph.edges, adjacency);
+    vector<SgdTerm> terms;
+    size_t numberOfPivots = options.numberOfPivots;
+    if (numberOfPivots == 0 && (numberOfNodes > kMaximumExactSgdNodes ||
+                                !BuildExactTerms(graph, options.numberOfThreads, terms))) {
+        numberOfPivots = kDefaultSgdPivots;
+    }
+    if (numberOfPivots != 0) {
+        BuildPivotTerms(graph, adjacency, numberOfPivots, terms);
+    }
+    if (terms.empty()) return 0;
+
+    double minimumWeight = HUGE_VAL, maximumWeight = 0;
+    for (size_t t = 0; t < terms.size(); t++) {
+        double weights[] = { terms[t].weight0, terms[t].weight1 };
+        for (size_t w = 0; w < 2; w++) {
+            if (weights[w] == 0) continue;
+            minimumWeight = min(minimumWeight, weights[w]);
+            maximumWeight = max(maximumWeight, weights[w]);
+        }
+    }
+    double maximumRate = 1 / minimumWeight;
+    double minimumRate = options.epsilon / maximumWeight;
+    double decay = (options.epochs > 1)
+                   ? log(maximumRate / minimumRate) / (options.epochs - 1) : 0;
+
+    vector<double> x(numberOfNodes), y(numberOfNodes);
+    for (size_t i = 0; i < numberOfNodes; i++) {
+        x[i] = graph.nodes[i].x;
+        y[i] = graph.nodes[i].y;
+    }
+
+    //One full shuffle up front; each epoch then only reorders blocks
+    mt19937 generator(options.seed);
+    shuffle(terms.begin(), terms.end(), generator);
+    size_t numberOfBlocks = (terms.size() + kSgdBlockSize - 1) / kSgdBlockSize;
+    vector<size_t> blockOrder(numberOfBlocks);
+    for (size_t b = 0; b < numberOfBlocks; b++) blockOrder[b] = b;
+
+    size_t numberOfThreads = LimitThreadCount(options.numberOfThreads, numberOfBlocks,
+                                              terms.size());
+    for (size_t epoch = 0; epoch < options.epochs; epoch++) {
+        double learningRate = maximumRate * exp(-decay * epoch);
+        shuffle(blockOrder.begin(), blockOrder.end(), generator);
+        unsigned int epochSeed = generator();
+        RunOnThreads(numberOfThreads, [&](size_t thread) {
+            minstd_rand blockGenerator(epochSeed + thread);
+            size_t begin, end;
+            ThreadRange(numberOfBlocks, thread, numberOfThreads, begin, end);
+            for (size_t b = begin; b < end; b++) {
+                size_t first = blockOrder[b] * kSgdBlockSize;
+                size_t last = min(first + kSgdBlockSize, terms.size());
+                shuffle(terms.begin() + first, terms.begin() + last, blockGenerator);
+                ApplyTerms(terms, first, last, learningRate, x.data(), y.data());
+            }
+        });
+    }
+
+    for (size_t i = 0; i < numberOfNodes; i++) {
+        graph.nodes[i].x = x[i];
+        graph.nodes[i].y = y[i];
+    }
+    return terms.size();
+}
@@ -0,0 +1,83 @@
+/*************************************************************************
+ * File: SgdLayout.h
+ *
+ * A header file defining a stress layout engine driven by stochastic
+ * gradient descent, following Zheng, Pawar and Goodman, "Graph Drawing
+ * by Stochastic Gradient Descent" (2018).  It minimizes the same stress
+ * as StressLayout.h, but one pair of nodes at a time: each term moves
+ * its two nodes along the line between them so that their distance
+ * approaches the graph distance, by a fraction of the error that shrinks
+ * from epoch to epoch under an exponentially annealed learning rate.
+ * About thirty passes over the terms give a good layout from any
+ * starting positions.
+ *
+ * Every term touches only two nodes, so the terms of an epoch are
+ * shuffled and then split between threads that apply their updates
+ * without any locking, in the style of Hogwild.  Two threads now and
+ * then update the same node at once and one update is lost; the descent
+ * does not depend on any single update, so this costs nothing in
+ * quality but makes runs on several threads nondeterministic.
+ *
+ * The exact engine has one term per pair of nodes.  The sparse engine
+ * keeps memory proportional to n * k by using one term per edge plus
+ * one term from every node to each of k pivot nodes, weighted by the
+ * number of nodes the pivot stands in for, as described in section 4.2
+ * of the paper.
+ */
+
+#ifndef SgdLayout_Included // Include guard
+#define SgdLayout_Included
+
+#include "SimpleGraph.h" // For the SimpleGraph type.
+
+/* Default parameters of the descent. */
+const size_t kDefaultSgdEpochs = 30;
+const double kDefaultSgdEpsilon = 0.1;
+const size_t kDefaultSgdPivots = 200;
+const unsigned int kDefaultSgdSeed = 106;
+
+/*
+ * Largest graph the exact engine takes.  Its terms take 20 bytes per
+ * pair of nodes, about 1 GB at this size; larger graphs use pivots.
+ */
+const size_t kMaximumExactSgdNodes = 10000;
+
+/**
+ * Type: SgdOptions
+ * -----------------------------------------------------------------------
+ * Parameters controlling the descent.  The learning rate falls from the
+ * reciprocal of the smallest term weight to epsilon times the reciprocal
+ * of the largest over the given number of epochs.  numberOfPivots
+ * selects the sparse engine with that many pivots, or the exact engine
+ * if it is zero; graphs of more than kMaximumExactSgdNodes nodes then
+ * use kDefaultSgdPivots pivots instead.  numberOfThreads is the number
+ * of threads to update positions on, with zero meaning one per core.
+ * seed seeds the shuffling.
+ */
+struct SgdOptions {
+    size_t epochs;
+    double epsilon;
+    size_t numberOfPivots;
+    size_t numberOfThreads;
+    unsigned int seed;
+};
+
+/**
+ * Function: DefaultSgdOptions()
+ * -----------------------------------------------------------------------
+ * Returns options for the exact engine on one thread per core.
+ */
+SgdOptions DefaultSgdOptions();
+
+/**
+ * Function: SgdLayout(SimpleGraph& graph, const SgdOptions& options)
+ * -----------------------------------------------------------------------
+ * Lays out the graph by stochastic gradient descent on its stress,
+ * starting from the nodes' current positions, and returns the number of
+ * terms used.  The exact engine stores 20 bytes for every pair of
+ * nodes, so graphs beyond a few thousand nodes should use pivots, and
+ * those beyond kMaximumExactSgdNodes always do.
+ */
+size_t SgdLayout(SimpleGraph& graph, const SgdOptions& options);
+
+#endif
@@ -0,0 +1,273 @@
+/******************************************************
+ * File: SimdRepulsion.cpp
+ *
+ * Implementation of the SimdRepulsion.h interface.  The
+ * node positions are stored in separate x and y arrays,
+ * so four or eight consecutive partners can be loaded
+ * with a single instruction.  As in the scalar
+ * kernel, each pair is visited once and its force is
+ * added to both nodes: the partners' changes are loaded,
+ * updated and stored back a vector at a time, while the
+ * force on the current node is accumulated in a register.
+ *
+ * The kernels are compiled with per-function target
+ * attributes, so no special compiler flags are needed
+ * and the program still runs on older processors.
+ */
+
+#include <cmath>
+#include <cfloat>
+#include <algorithm>
+#include "SimdRepulsion.h"
+#include "ForceLayout.h"
+using namespace std;
+
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 5))
+#define SIMD_REPULSION_AVAILABLE
+#include <immintrin.h>
+#endif
+
+/*
+ * RepelPair
+ * Applies the repulsion between nodes i and j to both of
+ * their changes.  Used for the pairs left over after the
+ * vector loop.
+ */
+static inline void RepelPair(const double* x, const double* y, double* changeX,
+                             double* changeY, size_t i, size_t j) {
+    double dx = x[j] - x[i];
+    double dy = y[j] - y[i];
+    double distance = sqrt(dx * dx + dy * dy);
+    double fRepel = CalculateFRepel(distance);
+    changeX[i] -= fRepel * dx / distance;
+    changeY[i] -= fRepel * dy / distance;
+    changeX[j] += fRepel * dx / distance;
+    changeY[j] += fRepel * dy / distance;
+}
+
+/*
+ * RepelScalar
+ * The scalar kernel for one tile, used when the processor
+ * has no suitable vector instructions.
+ */
+static void RepelScalar(const double* x, const double* y, double* changeX, double* changeY,
+                        size_t rowBegin, size_t rowEnd, size_t columnBegin, size_t columnEnd) {
+    for (size_t i = rowBegin; i < rowEnd; i++) {
+        for (size_t j = max(columnBegin, i + 1); j < columnEnd; j++) {
+            RepelPair(x, y, changeX, changeY, i, j);
+        }
+    }
+}
+
+#ifdef SIMD_REPULSION_AVAILABLE
+
+/*
+ * RepelAvx2
+ * The AVX2 kernel, handling four partners at a time.
+ * AVX2 has no double-precision reciprocal square root,
+ * so the estimate is made in single precision.  Squared
+ * distances outside the range of a float would flush to
+ * zero or overflow there, so those lanes take 1 / d from
+ * a full division instead.
+ */
+__attribute__((target("avx2,fma")))
+static void RepelAvx2(const double* x, const double* y, double* changeX, double* changeY,
+                      size_t rowBegin, size_t rowEnd, size_t columnBegin, size_t columnEnd) {
+    const __m256d repel = _mm256_set1_pd(kRepel);
+    const __m256d half = _mm256_set1_pd(0.5);
+    const __m256d threeHalves = _mm256_set1_pd(1.5);
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d floatMinimum = _mm256_set1_pd(FLT_MIN);
+    const __m256d floatMaximum = _mm256_set1_pd(FLT_MAX);
+
+    for (size_t i = rowBegin; i < rowEnd; i++) {
+        __m256d x0 = _mm256_set1_pd(x[i]);
+        __m256d y0 = _mm256_set1_pd(y[i]);
+        __m256d sumX = _mm256_setzero_pd();
+        __m256d sumY = _mm256_setzero_pd();
+
+        size_t j = max(columnBegin, i + 1);
+        for (; j + 4 <= columnEnd; j += 4) {
+            __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(x + j), x0);
+            __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(y + j), y0);
+            __m256d distanceSquared = _mm256_fmadd_pd(dx, dx, _mm256_mul_pd(dy, dy));
+
+            //Estimate 1 / d, then refine: r = r * (1.5 - 0.5 * d^2 * r^2)
+            __m256d inverse = _mm256_cvtps_pd(_mm_rsqrt_ps(_mm256_cvtpd_ps(distanceSquared)));
+            for (int step = 0; step < 2; step++) {
+                __m256d product = _mm256_mul_pd(_mm256_mul_pd(half, distanceSquared),
+                                                _mm256_mul_pd(inverse, inverse));
+                inverse = _mm256_mul_pd(inverse, _mm256_sub_pd(threeHalves, product));
+            }
+            __m256d tooNear = _mm256_cmp_pd(distanceSquared, floatMinimum, _CMP_LT_OQ);
+            __m256d tooFar = _mm256_cmp_pd(distanceSquared, floatMaximum, _CMP_GT_OQ);
+            __m256d outside = _mm256_or_pd(tooNear, tooFar);
+            if (_mm256_movemask_pd(outside)) {
+                __m256d exact = _mm256_div_pd(one, _mm256_sqrt_pd(distanceSquared));
+                inverse = _mm256_blendv_pd(inverse, exact, outside);
+            }
+
+            //The force kRepel / d along the unit vector (dx, dy) / d
+            __m256d scale = _mm256_mul_pd(_mm256_mul_pd(repel, inverse), inverse);
+            __m256d forceX = _mm256_mul_pd(scale, dx);
+            __m256d forceY = _mm256_mul_pd(scale, dy);
+
+            sumX = _mm256_add_pd(sumX, forceX);
+            sumY = _mm256_add_pd(sumY, forceY);
+            _mm256_storeu_pd(changeX + j, _mm256_add_pd(_mm256_loadu_pd(changeX + j), forceX));
+            _mm256_storeu_pd(changeY + j, _mm256_add_pd(_mm256_loadu_pd(changeY + j), forceY));
+        }
+
+        double partsX[4], partsY[4];
+        _mm256_storeu_pd(partsX, sumX);
+        _mm256_storeu_pd(partsY, sumY);
+        changeX[i] -= (partsX[0] + partsX[1]) + (partsX[2] + partsX[3]);
+        changeY[i] -= (partsY[0] + partsY[1]) + (partsY[2] + partsY[3]);
+
+        for (; j < columnEnd; j++) {
+            RepelPair(x, y, changeX, changeY, i, j);
+        }
+    }
+}
+
+/*
+ * RepelAvx512
+ * The AVX-512 kernel, handling eight partners at a time
+ * with the double-precision reciprocal square root
+ * estimate.
+ */
+__attribute__((target("avx512f")))
+static void RepelAvx512(const double* x, const double* y, double* changeX, double* changeY,
+                        size_t rowBegin, size_t rowEnd, size_t columnBegin, size_t columnEnd) {
+    const __m512d repel = _mm512_set1_pd(kRepel);
+    const __m512d half = _mm512_set1_pd(0.5);
+    const __m512d threeHalves = _mm512_set1_pd(1.5);
+
+    for (size_t i = rowBegin; i < rowEnd; i++) {
+        __m512d x0 = _mm512_set1_pd(x[i]);
+        __m512d y0 = _mm512_set1_pd(y[i]);
+        __m512d sumX = _mm512_setzero_pd();
+        __m512d sumY = _mm512_setzero_pd();
+
+        size_t j = max(columnBegin, i + 1);
+        for (; j + 8 <= columnEnd; j += 8) {
+            __m512d dx = _mm512_sub_pd(_mm512_loadu_pd(x + j), x0);
+            __m512d dy = _mm512_sub_pd(_mm512_loadu_pd(y + j), y0);
+            __m512d distanceSquared = _mm512_fmadd_pd(dx, dx, _mm512_mul_pd(dy, dy));
+
+            //Estimate 1 / d, then refine: r = r * (1.5 - 0.5 * d^2 * r^2)
+            __m512d inverse = _mm512_maskz_rsqrt14_pd(0xFF, distanceSquared);
+            for (int step = 0; step < 2; step++) {
+                __m512d product = _mm512_mul_pd(_mm512_mul_pd(half, distanceSquared),
+                                                _mm512_mul_pd(inverse, inverse));
+                inverse = _mm512_mul_pd(inverse, _mm512_sub_pd(threeHalves, product));
+            }
+
+            //The force kRepel / d along the unit vector (dx, dy) / d
+            __m512d scale = _mm512_mul_pd(_mm512_mul_pd(repel, inverse), inverse);
+            __m512d forceX = _mm512_mul_pd(scale, dx);
+            __m512d forceY = _mm512_mul_pd(scale, dy);
+
+            sumX = _mm512_add_pd(sumX, forceX);
+            sumY = _mm512_add_pd(sumY, forceY);
+            _mm512_storeu_pd(changeX + j, _mm512_add_pd(_mm512_loadu_pd(changeX + j), forceX));
+            _mm512_storeu_pd(changeY + j, _mm512_add_pd(_mm512_loadu_pd(changeY + j), forceY));
+        }
+
+        double partsX[8], partsY[8];
+        _mm512_storeu_pd(partsX, sumX);
+        _mm512_storeu_pd(partsY, sumY);
+        changeX[i] -= ((partsX[0] + partsX[1]) + (partsX[2] + partsX[3])) +
+                      ((partsX[4] + partsX[5]) + (partsX[6] + partsX[7]));
+        changeY[i] -= ((partsY[0] + partsY[1]) + (partsY[2] + partsY[3])) +
+                      ((partsY[4] + partsY[5]) + (partsY[6] + partsY[7]));
+
+        for (; j < columnEnd; j++) {
+            RepelPair(x, y, changeX, changeY, i, j);
+        }
+    }
+}
+
+#endif
+
+/*
+ * ProbeSimdLevel
+ * Asks the processor which instruction sets it supports.
+ */
+static SimdLevel ProbeSimdLevel() {
+#ifdef SIMD_REPULSION_AVAILABLE
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return kAvx512Kernel;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return kAvx2Kernel;
+#endif
+    return kScalarKernel;
+}
+
+/*
+ * DetectSimdLevel
+ * Probes the processor once, remembering the answer for
+ * later calls.  The static is initialized exactly once
+ * even if several layout threads get here together.
+ */
+SimdLevel DetectSimdLevel() {
+    static const SimdLevel detected = ProbeSimdLevel();
+    return detected;
+}
+
+/*
+ * SimdLevelName
+ * Returns a printable name for a kernel.
+ */
+const char* SimdLevelName(SimdLevel level) {
+    if (level == kAvx512Kernel) return "AVX-512";
+    if (level == kAvx2Kernel) return "AVX2";
+    return "scalar";
+}
+
+/*
+ * CalculateVectorizedRepulsiveForces
+ * Uses the widest kernel this processor supports.
+ */
+void CalculateVectorizedRepulsiveForces(const NodeArrays& positions, NodeArrays& nodeChanges) {
+    CalculateVectorizedRepulsiveForces(positions, nodeChanges, DetectSimdLevel());
+}
+
+/*
+ * CalculateVectorizedRepulsiveForces
+ * Runs the requested kernel over the whole triangle of
+ * pairs, or the scalar reference kernel if asked to.
+ */
+void CalculateVectorizedRepulsiveForces(const NodeArrays& positions, NodeArrays& nodeChanges,
+                                        SimdLevel level) {
+    if (level == kScalarKernel) {
+        CalculateRepulsiveForces(positions, nodeChanges);
+    } else {
+        CalculateVectorizedRepulsiveTile(positions, nodeChanges, 0, positions.size(),
+                                         0, positions.size(), level);
+    }
+}
+
+/*
+ * CalculateVectorizedRepulsiveTile
+ * Runs the requested kernel over the pairs in one tile.
+ */
+void CalculateVectorizedRepulsiveTile(const NodeArrays& positions, NodeArrays& nodeChanges,
+                                      size_t rowBegin, size_t rowEnd,
+                                      size_t columnBegin, size_t columnEnd, SimdLevel level) {
+    const double* x = positions.x.data();
+    const double* y = positions.y.data();
+    double* changeX = nodeChanges.x.data();
+    double* changeY = nodeChanges.y.data();
+
+#ifdef SIMD_REPULSION_AVAILABLE
+    if (level == kAvx512Kernel) {
+        RepelAvx512(x, y, changeX, changeY, rowBegin, rowEnd, columnBegin, columnEnd);
+        return;
+    } else if (level == kAvx2Kernel) {
+        RepelAvx2(x, y, changeX, changeY, rowBegin, rowEnd, columnBegin, columnEnd);
+        return;
+    }
+#endif
+    RepelScalar(x, y, changeX, changeY, rowBegin, rowEnd, columnBegin, columnEnd);
+}
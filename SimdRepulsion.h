@@ -0,0 +1,80 @@
+/*************************************************************************
+ * File: SimdRepulsion.h
+ *
+ * A header file defining vectorized versions of the exact all-pairs
+ * repulsion.  The exact kernel is deterministic and the best choice for
+ * small dense graphs such as cliques, but the scalar loop handles one
+ * pair at a time.  The kernels here compare a node against four (AVX2)
+ * or eight (AVX-512) partner nodes per instruction, computing 1 / d with
+ * the processor's approximate reciprocal square root refined by two
+ * Newton-Raphson steps, which is accurate to about 1e-14.
+ *
+ * The widest kernel the processor supports is chosen the first time one
+ * is needed.  On other processors and compilers the scalar kernel in
+ * ForceLayout.h is used instead.
+ */
+
+#ifndef SimdRepulsion_Included // Include guard
+#define SimdRepulsion_Included
+
+#include "NodeArrays.h" // For the NodeArrays type.
+
+/**
+ * Type: SimdLevel
+ * -----------------------------------------------------------------------
+ * The instruction sets a repulsion kernel can be built on, from the
+ * narrowest to the widest.
+ */
+enum SimdLevel {
+    kScalarKernel,
+    kAvx2Kernel,
+    kAvx512Kernel
+};
+
+/**
+ * Function: DetectSimdLevel()
+ * -----------------------------------------------------------------------
+ * Returns the widest kernel supported by this processor.  The processor
+ * is only queried on the first call, and any thread may call this.
+ */
+SimdLevel DetectSimdLevel();
+
+/**
+ * Function: SimdLevelName(SimdLevel level)
+ * -----------------------------------------------------------------------
+ * Returns a printable name for the kernel, such as "AVX2".
+ */
+const char* SimdLevelName(SimdLevel level);
+
+/**
+ * Function: CalculateVectorizedRepulsiveForces(const NodeArrays& positions,
+ *                                              NodeArrays& nodeChanges)
+ * -----------------------------------------------------------------------
+ * Adds the exact repulsive force between every pair of nodes into
+ * nodeChanges, using the kernel returned by DetectSimdLevel().  The
+ * second version uses the given kernel, which must be no wider than the
+ * one DetectSimdLevel() returns.
+ */
+void CalculateVectorizedRepulsiveForces(const NodeArrays& positions, NodeArrays& nodeChanges);
+void CalculateVectorizedRepulsiveForces(const NodeArrays& positions, NodeArrays& nodeChanges,
+                                        SimdLevel level);
+
+/**
+ * Function: CalculateVectorizedRepulsiveTile(const NodeArrays& positions,
+ *                                            NodeArrays& nodeChanges,
+ *                                            size_t rowBegin, size_t rowEnd,
+ *                                            size_t columnBegin,
+ *                                            size_t columnEnd,
+ *                                            SimdLevel level)
+ * -----------------------------------------------------------------------
+ * Adds the repulsion for one tile of the pair triangle into nodeChanges:
+ * every pair (i, j) with i in [rowBegin, rowEnd), j in [columnBegin,
+ * columnEnd) and i < j.  Both nodes of each pair receive their force.
+ * Covering the triangle with tiles therefore gives the same forces as
+ * CalculateVectorizedRepulsiveForces().
+ */
+void CalculateVectorizedRepulsiveTile(const NodeArrays& positions, NodeArrays& nodeChanges,
+                                      size_t rowBegin, size_t rowEnd,
+                                      size_t columnBegin, size_t columnEnd, SimdLevel level);
+
+#endif
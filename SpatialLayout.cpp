@@ -0,0 +1,251 @@
+/******************************************************
+ * File: SpatialLayout.cpp
+ *
+ * Implementation of the SpatialLayout.h interface.  The
+ * step is that of AdaptiveStep.cpp, with a third
+ * coordinate, and adapts through the same
+ * UpdateConvergence().
+ */
+
+#include <cmath>
+#include <algorithm>
+#include "SpatialLayout.h"
+#include "Octree.h"
+#include "Parallel.h"
+#include "LayoutGeometry.h"
+using namespace std;
+
+/*
+ * InitialSpatialLayout
+ * Spaces the nodes evenly in height from pole to pole,
+ * turning each by the golden angle from the last.
+ */
+void InitialSpatialLayout(size_t numberOfNodes, SpatialArrays& positions) {
+    ResizeSpatialArrays(positions, numberOfNodes);
+    for (size_t node = 0; node < numberOfNodes; node++) {
+        double z = 1 - (2 * node + 1) / (double) numberOfNodes;
+        double radius = sqrt(1 - z * z);
+        double angle = kGoldenAngle * node;
+        positions.x[node] = radius * cos(angle);
+        positions.y[node] = radius * sin(angle);
+        positions.z[node] = z;
+    }
+}
+
+/*
+ * CalculateSpatialRepulsiveForces
+ * Runs against a deadline that never passes.
+ */
+void CalculateSpatialRepulsiveForces(const SpatialArrays& positions, SpatialArrays& nodeChanges) {
+    CalculateSpatialRepulsiveForces(positions, nodeChanges, StartDeadline(HUGE_VAL));
+}
+
+/*
+ * CalculateSpatialRepulsiveForces
+ * Visits every pair once, checking the deadline after
+ * each row that brings the pairs since the last check
+ * to kDeadlineCheckPairs.
+ */
+bool CalculateSpatialRepulsiveForces(const SpatialArrays& positions, SpatialArrays& nodeChanges,
+                                     const LayoutDeadline& deadline) {
+    size_t numberOfNodes = positions.size();
+    size_t pairsSinceCheck = 0;
+    for (size_t nodeIndex0 = 0; nodeIndex0 + 1 < numberOfNodes; nodeIndex0++) {
+        double x0 = positions.x[nodeIndex0];
+        double y0 = positions.y[nodeIndex0];
+        double z0 = positions.z[nodeIndex0];
+        for (size_t nodeIndex1 = nodeIndex0 + 1; nodeIndex1 < numberOfNodes; nodeIndex1++) {
+            double dx = positions.x[nodeIndex1] - x0;
+            double dy = positions.y[nodeIndex1] - y0;
+            double dz = positions.z[nodeIndex1] - z0;
+            double distance = sqrt(dx * dx + dy * dy + dz * dz);
+
+            double fRepel = CalculateFRepel(distance);
+            double forceX = fRepel * dx / distance;
+            double forceY = fRepel * dy / distance;
+            double forceZ = fRepel * dz / distance;
+
+            nodeChanges.x[nodeIndex0] -= forceX;
+            nodeChanges.y[nodeIndex0] -= forceY;
+            nodeChanges.z[nodeIndex0] -= forceZ;
+            nodeChanges.x[nodeIndex1] += forceX;
+            nodeChanges.y[nodeIndex1] += forceY;
+            nodeChanges.z[nodeIndex1] += forceZ;
+        }
+        pairsSinceCheck += numberOfNodes - nodeIndex0 - 1;
+        if (pairsSinceCheck >= kDeadlineCheckPairs) {
+            if (DeadlinePassed(deadline)) return false;
+            pairsSinceCheck = 0;
+        }
+    }
+    return true;
+}
+
+/*
+ * CalculateSpatialAttractiveForces
+ * Each thread owns a contiguous range of nodes and sums,
+ * for each of them, the pull of its neighbours, with
+ * the work counted as in ForceModels.h.
+ */
+void CalculateSpatialAttractiveForces(const SpatialArrays& positions, const Adjacency& adjacency,
+                                      SpatialArrays& nodeChanges, size_t numberOfThreads) {
+    size_t numberOfNodes = adjacency.size();
+    numberOfThreads = LimitThreadCount(numberOfThreads, numberOfNodes,
+                                       numberOfNodes + adjacency.targets.size());
+    RunOnThreads(numberOfThreads, [&](size_t thread) {
+        size_t begin, end;
+        ThreadRange(numberOfNodes, thread, numberOfThreads, begin, end);
+        for (size_t node = begin; node < end; node++) {
+            double sumX = 0, sumY = 0, sumZ = 0;
+            for (size_t k = adjacency.offsets[node]; k < adjacency.offsets[node + 1]; k++) {
+                size_t neighbour = adjacency.targets[k];
+                double dx = positions.x[neighbour] - positions.x[node];
+                double dy = positions.y[neighbour] - positions.y[node];
+                double dz = positions.z[neighbour] - positions.z[node];
+                double distance = sqrt(dx * dx + dy * dy + dz * dz);
+                if (distance == 0) continue;
+                double fAttract = CalculateFAttract(distance);
+                sumX += fAttract * dx / distance;
+                sumY += fAttract * dy / distance;
+                sumZ += fAttract * dz / distance;
+            }
+            nodeChanges.x[node] += sumX;
+            nodeChanges.y[node] += sumY;
+            nodeChanges.z[node] += sumZ;
+        }
+    });
+}
+
+/*
+ * MeanSpatialEdgeLength
+ * Returns the mean length of the edges in the adjacency,
+ * or one if there are none or all have zero length.
+ */
+static double MeanSpatialEdgeLength(const SpatialArrays& positions, const Adjacency& adjacency) {
+    double total = 0;
+    for (size_t node = 0; node < adjacency.size(); node++) {
+        for (size_t k = adjacency.offsets[node]; k < adjacency.offsets[node + 1]; k++) {
+            size_t neighbour = adjacency.targets[k];
+            double dx = positions.x[neighbour] - positions.x[node];
+            double dy = positions.y[neighbour] - positions.y[node];
+            double dz = positions.z[neighbour] - positions.z[node];
+            total += sqrt(dx * dx + dy * dy + dz * dz);
+        }
+    }
+    return adjacency.targets.empty() || total == 0 ? 1 : total / adjacency.targets.size();
+}
+
+/*
+ * ApplySpatialAdaptiveStep
+ * Moves every node along its force by at most the step,
+ * then updates the step from the change in energy.  The
+ * step only cools while it holds some node back.  From
+ * the unit sphere every force starts out far weaker than
+ * the step, and the energy rises and falls for a while
+ * as the nodes find their sides; cooling on each rise
+ * would leave the step too short to finish the layout
+ * by the time the forces reach it.  The largest move is
+ * measured in edgeLength, as in AdaptiveStep.cpp.
+ */
+static void ApplySpatialAdaptiveStep(SpatialArrays& positions, SpatialArrays& nodeChanges,
+                                     double edgeLength, const LayoutOptions& layoutOptions,
+                                     const ConvergenceOptions& options,
+                                     ConvergenceState& state) {
+    double energy = 0, maximumDisplacement = 0;
+    bool limited = false;
+    for (size_t nodeIndex = 0; nodeIndex < positions.size(); nodeIndex++) {
+        double forceX = nodeChanges.x[nodeIndex];
+        double forceY = nodeChanges.y[nodeIndex];
+        double forceZ = nodeChanges.z[nodeIndex];
+        double forceSquared = forceX * forceX + forceY * forceY + forceZ * forceZ;
+        double force = sqrt(forceSquared);
+        double scale = 1.0;
+        if (force > state.step) {
+            scale = state.step / force;
+            limited = true;
+        }
+        positions.x[nodeIndex] += scale * forceX;
+        positions.y[nodeIndex] += scale * forceY;
+        positions.z[nodeIndex] += scale * forceZ;
+        energy += forceSquared;
+        maximumDisplacement = max(maximumDisplacement, scale * force);
+    }
+    ClearSpatialArrays(nodeChanges);
+    UpdateConvergence(options, energy, maximumDisplacement / edgeLength, limited, false,
+                      ApproximateForces(layoutOptions), state);
+}
+
+/*
+ * AdaptiveTransformSpatialArrays
+ * Runs against a deadline that never passes.
+ */
+void AdaptiveTransformSpatialArrays(SpatialArrays& positions, const Adjacency& adjacency,
+                                    SpatialArrays& nodeChanges, const LayoutOptions& layoutOptions,
+                                    const ConvergenceOptions& options, ConvergenceState& state) {
+    AdaptiveTransformSpatialArrays(positions, adjacency, nodeChanges, layoutOptions, options,
+                                   state, StartDeadline(HUGE_VAL));
+}
+
+/*
+ * AdaptiveTransformSpatialArrays
+ * Calculates the forces, then takes an adaptive step,
+ * unless the deadline stopped the repulsion.
+ */
+bool AdaptiveTransformSpatialArrays(SpatialArrays& positions, const Adjacency& adjacency,
+                                    SpatialArrays& nodeChanges, const LayoutOptions& layoutOptions,
+                                    const ConvergenceOptions& options, ConvergenceState& state,
+                                    const LayoutDeadline& deadline) {
+    bool finished;
+    if (layoutOptions.repulsionMode == kExactRepulsion) {
+        finished = CalculateSpatialRepulsiveForces(positions, nodeChanges, deadline);
+    } else {
+        finished = CalculateOctreeRepulsiveForces(positions, nodeChanges, layoutOptions.theta,
+                                                  layoutOptions.numberOfThreads, deadline);
+    }
+    if (!finished) {
+        ClearSpatialArrays(nodeChanges);
+        return false;
+    }
+    CalculateSpatialAttractiveForces(positions, adjacency, nodeChanges,
+                                     layoutOptions.numberOfThreads);
+    ApplySpatialAdaptiveStep(positions, nodeChanges, MeanSpatialEdgeLength(positions, adjacency),
+                             layoutOptions, options, state);
+    return true;
+}
+
+/*
+ * RunSpatialToConvergence
+ * Builds the adjacency once for all of the iterations.
+ */
+ConvergenceState RunSpatialToConvergence(const SimpleGraph& graph, SpatialArrays& positions,
+                                         const LayoutOptions& layoutOptions,
+                                         const ConvergenceOptions& options) {
+    ConvergenceState state = InitializeConvergence(options);
+    Adjacency adjacency;
+    BuildAdjacency(graph.nodes.size(), graph.edges, adjacency);
+    SpatialArrays nodeChanges;
+    ResizeSpatialArrays(nodeChanges, positions.size());
+    while (!state.converged && state.iterations < options.maximumIterations) {
+        AdaptiveTransformSpatialArrays(positions, adjacency, nodeChanges, layoutOptions, options,
+                                       state);
+    }
+    return state;
+}
+
+/*
+ * ProjectSpatialArrays
+ * Turns each node about the y axis, then about the x
+ * axis, and drops its depth.
+ */
+void ProjectSpatialArrays(const SpatialArrays& positions, double yaw, double pitch,
+                          vector<Node>& nodes) {
+    double cosYaw = cos(yaw), sinYaw = sin(yaw);
+    double cosPitch = cos(pitch), sinPitch = sin(pitch);
+    nodes.resize(positions.size());
+    for (size_t node = 0; node < positions.size(); node++) {
+        double x = cosYaw * positions.x[node] + sinYaw * positions.z[node];
+        double z = cosYaw * positions.z[node] - sinYaw * positions.x[node];
+        nodes[node].x = x;
+        nodes[node].y = cosPitch * positions.y[node] - sinPitch * z;
+    }
+}
@@ -0,0 +1,136 @@
+/*************************************************************************
+ * File: SpatialLayout.h
+ *
+ * A header file defining force-directed layout in three dimensions.
+ * Graphs such as the cube, the icosahedron, the dodecahedron and the
+ * tesseract have a natural shape in space that any drawing in the plane
+ * has to fold over itself, and large networks have more room to spread
+ * out in a third dimension.
+ *
+ * The layout uses the Fruchterman-Reingold forces of ForceLayout.h and
+ * the adaptive step schedule of AdaptiveStep.h, on positions held in
+ * SpatialArrays rather than in the graph, whose nodes only have x and y.
+ * The repulsion is computed exactly or through an octree (Octree.h).
+ * ProjectSpatialArrays() then turns the layout into a SimpleGraph for
+ * DrawGraph() by an orthographic projection from any direction; turning
+ * the direction a little between frames lets the shape be seen.
+ */
+
+#ifndef SpatialLayout_Included // Include guard
+#define SpatialLayout_Included
+
+#include "SimpleGraph.h"  // For the SimpleGraph type.
+#include "NodeArrays.h"   // For the SpatialArrays type.
+#include "Adjacency.h"    // For the Adjacency type.
+#include "ForceLayout.h"  // For the LayoutOptions type.
+#include "AdaptiveStep.h" // For the ConvergenceOptions and ConvergenceState types.
+
+/**
+ * Function: InitialSpatialLayout(size_t numberOfNodes,
+ *                                SpatialArrays& positions)
+ * -----------------------------------------------------------------------
+ * Places numberOfNodes nodes evenly over the unit sphere, along a
+ * Fibonacci spiral, as the three-dimensional counterpart of the unit
+ * circle the program starts from.
+ */
+void InitialSpatialLayout(size_t numberOfNodes, SpatialArrays& positions);
+
+/**
+ * Function: CalculateSpatialRepulsiveForces(const SpatialArrays& positions,
+ *                                           SpatialArrays& nodeChanges)
+ * -----------------------------------------------------------------------
+ * Adds the repulsive force between every pair of nodes into nodeChanges.
+ */
+void CalculateSpatialRepulsiveForces(const SpatialArrays& positions, SpatialArrays& nodeChanges);
+
+/**
+ * Function: CalculateSpatialRepulsiveForces(const SpatialArrays& positions,
+ *                                           SpatialArrays& nodeChanges,
+ *                                           const LayoutDeadline& deadline)
+ * -----------------------------------------------------------------------
+ * The same, except that the deadline is checked after every row of
+ * pairs that brings those since the last check to kDeadlineCheckPairs.
+ * Returns true if every pair was done, and false if the deadline
+ * stopped the pass, in which case nodeChanges holds only part of the
+ * forces.
+ */
+bool CalculateSpatialRepulsiveForces(const SpatialArrays& positions, SpatialArrays& nodeChanges,
+                                     const LayoutDeadline& deadline);
+
+/**
+ * Function: CalculateSpatialAttractiveForces(const SpatialArrays& positions,
+ *                                            const Adjacency& adjacency,
+ *                                            SpatialArrays& nodeChanges,
+ *                                            size_t numberOfThreads)
+ * -----------------------------------------------------------------------
+ * Adds the attractive force along every edge into nodeChanges, gathered
+ * per node over the adjacency on numberOfThreads threads.
+ */
+void CalculateSpatialAttractiveForces(const SpatialArrays& positions, const Adjacency& adjacency,
+                                      SpatialArrays& nodeChanges, size_t numberOfThreads);
+
+/**
+ * Function: AdaptiveTransformSpatialArrays(SpatialArrays& positions,
+ *                                          const Adjacency& adjacency,
+ *                                          SpatialArrays& nodeChanges,
+ *                                          const LayoutOptions& layoutOptions,
+ *                                          const ConvergenceOptions& options,
+ *                                          ConvergenceState& state)
+ * -----------------------------------------------------------------------
+ * Runs one iteration in three dimensions, as AdaptiveTransformNodeArrays()
+ * does in two.  layoutOptions.repulsionMode selects the exact forces or
+ * the octree; the multipole and grid engines have no three-dimensional
+ * form and use the octree too.  The octree and the attraction run on
+ * layoutOptions.numberOfThreads threads.  nodeChanges must have one
+ * node per position and is cleared again afterwards.
+ */
+void AdaptiveTransformSpatialArrays(SpatialArrays& positions, const Adjacency& adjacency,
+                                    SpatialArrays& nodeChanges, const LayoutOptions& layoutOptions,
+                                    const ConvergenceOptions& options, ConvergenceState& state);
+
+/**
+ * Function: AdaptiveTransformSpatialArrays(SpatialArrays& positions,
+ *                                          const Adjacency& adjacency,
+ *                                          SpatialArrays& nodeChanges,
+ *                                          const LayoutOptions& layoutOptions,
+ *                                          const ConvergenceOptions& options,
+ *                                          ConvergenceState& state,
+ *                                          const LayoutDeadline& deadline)
+ * -----------------------------------------------------------------------
+ * The same, except that the repulsion stops part of the way through if
+ * the deadline passes first.  Returns false if it did, in which case the
+ * iteration is dropped: nodeChanges is cleared, and positions and state
+ * are left as they were.
+ */
+bool AdaptiveTransformSpatialArrays(SpatialArrays& positions, const Adjacency& adjacency,
+                                    SpatialArrays& nodeChanges, const LayoutOptions& layoutOptions,
+                                    const ConvergenceOptions& options, ConvergenceState& state,
+                                    const LayoutDeadline& deadline);
+
+/**
+ * Function: RunSpatialToConvergence(const SimpleGraph& graph,
+ *                                   SpatialArrays& positions,
+ *                                   const LayoutOptions& layoutOptions,
+ *                                   const ConvergenceOptions& options)
+ * -----------------------------------------------------------------------
+ * Lays out the graph in three dimensions from the given positions until
+ * it converges or options.maximumIterations have run, and returns the
+ * final state.
+ */
+ConvergenceState RunSpatialToConvergence(const SimpleGraph& graph, SpatialArrays& positions,
+                                         const LayoutOptions& layoutOptions,
+                                         const ConvergenceOptions& options);
+
+/**
+ * Function: ProjectSpatialArrays(const SpatialArrays& positions,
+ *                                double yaw, double pitch,
+ *                                vector<Node>& nodes)
+ * -----------------------------------------------------------------------
+ * Stores in nodes the orthographic projection of the layout as seen
+ * after turning it by yaw radians about the y axis and then pitch
+ * radians about the x axis.  Angles of zero look along the z axis.
+ */
+void ProjectSpatialArrays(const SpatialArrays& positions, double yaw, double pitch,
+                          vector<Node>& nodes);
+
+#endif
@@ -0,0 +1,245 @@
+/******************************************************
+ * File: SpectralLayout.cpp
+ *
+ * Implementation of the SpectralLayout.h interface.
+ * Each Lanczos run builds an orthonormal basis of up to
+ * kLanczosSteps vectors in which sI - L is tridiagonal,
+ * and takes the top eigenvector of that small matrix
+ * back to the full space.  If it is not yet accurate,
+ * the run restarts from it.  Every new basis vector is
+ * orthogonalized against the whole basis and the
+ * projected-out vectors, since in floating point the
+ * three-term recurrence alone soon loses orthogonality.
+ */
+
+#include <cmath>
+#include <random>
+#include "SpectralLayout.h"
+#include "GraphDistances.h"
+#include "LayoutGeometry.h"
+using namespace std;
+
+/* Limits on each Lanczos run. */
+const size_t kLanczosSteps = 50;
+const size_t kMaximumLanczosRestarts = 50;
+const double kLanczosTolerance = 1e-7;
+
+/* Seed of the starting vectors. */
+const unsigned int kSpectralSeed = 106;
+
+/* Distance, as a fraction of an edge's length, each node is nudged by. */
+const double kSpectralNudge = 0.05;
+
+/*
+ * Dot
+ * Returns the dot product of two vectors.
+ */
+static double Dot(const vector<double>& a, const vector<double>& b) {
+    double sum = 0;
+    for (size_t i = 0; i < a.size(); i++) sum += a[i] * b[i];
+    return sum;
+}
+
+/*
+ * Normalize
+ * Scales a vector to unit length, returning its former
+ * length.
+ */
+static double Normalize(vector<double>& values) {
+    double length = sqrt(Dot(values, values));
+    if (length > 0) {
+        for (size_t i = 0; i < values.size(); i++) values[i] /= length;
+    }
+    return length;
+}
+
+/*
+ * ProjectOut
+ * Removes from values its components along each of the
+ * given orthonormal vectors.
+ */
+static void ProjectOut(const vector<vector<double> >& vectors, vector<double>& values) {
+    for (size_t v = 0; v < vectors.size(); v++) {
+        double component = Dot(values, vectors[v]);
+        for (size_t i = 0; i < values.size(); i++) values[i] -= component * vectors[v][i];
+    }
+}
+
+/*
+ * MultiplyShiftedLaplacian
+ * Stores (sI - L) times values in result, where
+ * (L x)_i is the degree of i times x_i less the sum of
+ * x over i's neighbours.
+ */
+static void MultiplyShiftedLaplacian(const Adjacency& adjacency, double shift,
+                                     const vector<double>& values, vector<double>& result) {
+    result.resize(values.size());
+    for (size_t node = 0; node < values.size(); node++) {
+        double sum = (shift - adjacency.degree(node)) * values[node];
+        for (size_t k = adjacency.offsets[node]; k < adjacency.offsets[node + 1]; k++) {
+            sum += values[adjacency.targets[k]];
+        }
+        result[node] = sum;
+    }
+}
+
+/*
+ * TridiagonalEigenvectors
+ * Finds the eigenvalues and eigenvectors of the
+ * symmetric tridiagonal matrix with diagonal and
+ * offDiagonal, by the QL algorithm with implicit shifts.
+ * offDiagonal[i] joins rows i and i + 1.  On return
+ * diagonal holds the eigenvalues and column i of vectors
+ * the eigenvector of diagonal[i].
+ */
+static void TridiagonalEigenvectors(vector<double>& diagonal, vector<double> offDiagonal,
+                                    vector<vector<double> >& vectors) {
+    int size = diagonal.size();
+    vectors.assign(size, vector<double>(size, 0.0));
+    for (int i = 0; i < size; i++) vectors[i][i] = 1;
+    offDiagonal.resize(size, 0.0);
+
+    for (int first = 0; first < size; first++) {
+        for (int iteration = 0; iteration < 60; iteration++) {
+            //Find the first negligible off-diagonal element at or after first
+            int last = first;
+            for (; last < size - 1; last++) {
+                double scale = fabs(diagonal[last]) + fabs(diagonal[last + 1]);
+                if (fabs(offDiagonal[last]) <= 1e-15 * scale) break;
+            }
+            if (last == first) break;
+
+            double g = (diagonal[first + 1] - diagonal[first]) / (2 * offDiagonal[first]);
+            double r = hypot(g, 1.0);
+            g = diagonal[last] - diagonal[first] + offDiagonal[first] / (g + copysign(r, g));
+            double s = 1, c = 1, p = 0;
+            int i = last - 1;
+            for (; i >= first; i--) {
+                double f = s * offDiagonal[i];
+                double b = c * offDiagonal[i];
+                r = hypot(f, g);
+                offDiagonal[i + 1] = r;
+                if (r == 0) {
+                    diagonal[i + 1] -= p;
+                    offDiagonal[last] = 0;
+                    break;
+                }
+                s = f / r;
+                c = g / r;
+                g = diagonal[i + 1] - p;
+                r = (diagonal[i] - g) * s + 2 * c * b;
+                p = s * r;
+                diagonal[i + 1] = g + p;
+                g = c * r - b;
+                for (int k = 0; k < size; k++) {
+                    f = vectors[k][i + 1];
+                    vectors[k][i + 1] = s * vectors[k][i] + c * f;
+                    vectors[k][i] = c * vectors[k][i] - s * f;
+                }
+            }
+            if (r == 0 && i >= first) continue;
+            diagonal[first] -= p;
+            offDiagonal[first] = g;
+            offDiagonal[last] = 0;
+        }
+    }
+}
+
+/*
+ * LargestEigenvector
+ * Stores in eigenvector the eigenvector of the largest
+ * eigenvalue of sI - L orthogonal to the deflated
+ * vectors, starting from its current contents.
+ */
+static void LargestEigenvector(const Adjacency& adjacency, double shift,
+                               const vector<vector<double> >& deflated,
+                               vector<double>& eigenvector) {
+    size_t numberOfNodes = adjacency.size();
+    size_t maximumSteps = min(kLanczosSteps, numberOfNodes - deflated.size());
+    ProjectOut(deflated, eigenvector);
+    Normalize(eigenvector);
+
+    vector<vector<double> > basis;
+    vector<double> diagonal, offDiagonal, product;
+    for (size_t restart = 0; restart < kMaximumLanczosRestarts; restart++) {
+        basis.assign(1, eigenvector);
+        diagonal.clear();
+        offDiagonal.clear();
+        double residual = 0;
+        while (true) {
+            size_t step = basis.size() - 1;
+            MultiplyShiftedLaplacian(adjacency, shift, basis[step], product);
+            diagonal.push_back(Dot(product, basis[step]));
+            //One pass leaves rounding errors that Normalize magnifies, so make two
+            for (size_t pass = 0; pass < 2; pass++) {
+                ProjectOut(deflated, product);
+                ProjectOut(basis, product);
+            }
+            residual = Normalize(product);
+            if (residual < kLanczosTolerance * shift || basis.size() == maximumSteps) break;
+            offDiagonal.push_back(residual);
+            basis.push_back(product);
+        }
+
+        vector<double> eigenvalues = diagonal;
+        vector<vector<double> > vectors;
+        TridiagonalEigenvectors(eigenvalues, offDiagonal, vectors);
+        size_t top = 0;
+        for (size_t i = 1; i < eigenvalues.size(); i++) {
+            if (eigenvalues[i] > eigenvalues[top]) top = i;
+        }
+
+        eigenvector.assign(numberOfNodes, 0.0);
+        for (size_t b = 0; b < basis.size(); b++) {
+            for (size_t node = 0; node < numberOfNodes; node++) {
+                eigenvector[node] += vectors[b][top] * basis[b][node];
+            }
+        }
+        Normalize(eigenvector);
+
+        //The Ritz vector's residual is the last basis weight times the next recurrence term
+        if (residual * fabs(vectors[basis.size() - 1][top]) < kLanczosTolerance * shift) return;
+    }
+}
+
+/*
+ * SpectralLayout
+ * Checks that the graph is connected, finds the two
+ * eigenvectors with the constant vector projected out,
+ * and scales and nudges the result.
+ */
+bool SpectralLayout(SimpleGraph& graph) {
+    size_t numberOfNodes = graph.nodes.size();
+    if (numberOfNodes < 3) return false;
+    Adjacency adjacency;
+    BuildAdjacency(numberOfNodes, graph.edges, adjacency);
+
+    vector<unsigned short> depth(numberOfNodes);
+    vector<size_t> queue(numberOfNodes);
+    BreadthFirstSearch(adjacency, 0, depth, queue);
+    for (size_t node = 0; node < numberOfNodes; node++) {
+        if (depth[node] == kUnreachable) return false;
+    }
+
+    //Gershgorin: no eigenvalue of L exceeds twice the largest degree
+    double shift = 0;
+    for (size_t node = 0; node < numberOfNodes; node++) {
+        shift = max(shift, 2.0 * adjacency.degree(node));
+    }
+
+    vector<vector<double> > deflated(1, vector<double>(numberOfNodes,
+                                                       1 / sqrt((double) numberOfNodes)));
+    //Random starts, as a regular one can miss part of a repeated eigenvalue's space
+    vector<vector<double> > coordinates(2, vector<double>(numberOfNodes));
+    mt19937 generator(kSpectralSeed);
+    uniform_real_distribution<double> distribution(-1, 1);
+    for (size_t axis = 0; axis < 2; axis++) {
+        for (size_t node = 0; node < numberOfNodes; node++) {
+            coordinates[axis][node] = distribution(generator);
+        }
+        LargestEigenvector(adjacency, shift, deflated, coordinates[axis]);
+        deflated.push_back(coordinates[axis]);
+    }
+    PlaceAtUnitEdgeLength(coordinates[0], coordinates[1], kSpectralNudge, graph);
+    return true;
+}
@@ -0,0 +1,41 @@
+/*************************************************************************
+ * File: SpectralLayout.h
+ *
+ * A header file defining an initial layout from the eigenvectors of the
+ * graph Laplacian L = D - A, after Hall, "An r-dimensional Quadratic
+ * Placement Algorithm" (1970) and Koren, "Drawing Graphs by
+ * Eigenvectors" (2005).  The eigenvector of the smallest eigenvalue is
+ * constant; those of the second and third smallest are the coordinates
+ * that minimize the total squared edge length among layouts of fixed
+ * spread, and serve as x and y.  On meshes and grids this is close to
+ * the final layout, so the force-directed algorithm only needs to
+ * polish it.
+ *
+ * The eigenvectors are found by the Lanczos method, which never forms
+ * L: each step multiplies a vector by it, at a cost proportional to the
+ * number of edges.  Lanczos finds the largest eigenvalues fastest, so it
+ * is run on sI - L, with s bounding the largest eigenvalue of L.  A
+ * single Lanczos run finds only one vector of an eigenvalue that has
+ * several, as the symmetric graphs in this project often do, so each
+ * eigenvector is found by its own run with the vectors already found
+ * projected out.
+ */
+
+#ifndef SpectralLayout_Included // Include guard
+#define SpectralLayout_Included
+
+#include "SimpleGraph.h" // For the SimpleGraph type.
+
+/**
+ * Function: SpectralLayout(SimpleGraph& graph)
+ * -----------------------------------------------------------------------
+ * Places the graph's nodes at the second and third eigenvectors of its
+ * Laplacian, scaled so that edges are one unit long on average, and
+ * returns true.  Every node is then nudged slightly, so that nodes with
+ * equal eigenvector entries do not coincide.  Returns false, leaving the
+ * graph unchanged, if it has fewer than three nodes or is not connected,
+ * since then the eigenvectors only tell the components apart.
+ */
+bool SpectralLayout(SimpleGraph& graph);
+
+#endif
@@ -0,0 +1,242 @@
+/******************************************************
+ * File: StressLayout.cpp
+ *
+ * Implementation of the StressLayout.h interface.  The
+ * weight of a pair is 1 / d_ij^2, read from a table
+ * indexed by distance.  Each iteration solves
+ *
+ *   L_w x' = L_Z(x) x
+ *
+ * for both coordinates, where L_w is the Laplacian with
+ * the pair weights and L_Z(x) the Laplacian with entries
+ * -w_ij d_ij / |x_i - x_j| off the diagonal.  Both are
+ * singular, but the right-hand side always sums to zero,
+ * so conjugate gradients converge to a solution; the
+ * layout's centroid simply stays where it was.
+ */
+
+#include <cmath>
+#include "StressLayout.h"
+#include "GraphDistances.h"
+using namespace std;
+
+/* The graph distances and the weight of each distance. */
+struct StressState {
+    GraphDistances distances;
+    vector<double> weights;  // weights[d] is 1 / d^2
+};
+
+/*
+ * DefaultStressOptions
+ * Returns the default parameters.
+ */
+StressOptions DefaultStressOptions() {
+    StressOptions options;
+    options.maximumIterations = kDefaultStressIterations;
+    options.tolerance = kDefaultStressTolerance;
+    options.conjugateGradientIterations = kDefaultConjugateGradientIterations;
+    options.conjugateGradientTolerance = kDefaultConjugateGradientTolerance;
+    return options;
+}
+
+/*
+ * MultiplyWeightedLaplacian
+ * Stores L_w times values in result, one pass over the
+ * pairs.
+ */
+static void MultiplyWeightedLaplacian(const StressState& state, const vector<double>& values,
+                                      vector<double>& result) {
+    size_t numberOfNodes = state.distances.numberOfNodes;
+    const unsigned short* distance = state.distances.values.data();
+    result.assign(numberOfNodes, 0.0);
+    for (size_t i = 0; i < numberOfNodes; i++) {
+        double sum = 0;
+        for (size_t j = i + 1; j < numberOfNodes; j++) {
+            double term = state.weights[*distance++] * (values[i] - values[j]);
+            sum += term;
+            result[j] -= term;
+        }
+        result[i] += sum;
+    }
+}
+
+/*
+ * Dot
+ * Returns the dot product of two vectors.
+ */
+static double Dot(const vector<double>& a, const vector<double>& b) {
+    double sum = 0;
+    for (size_t i = 0; i < a.size(); i++) sum += a[i] * b[i];
+    return sum;
+}
+
+/*
+ * SolveWeightedLaplacian
+ * Improves solution towards L_w solution = rightHandSide
+ * by conjugate gradients.  The residual is kept summing
+ * to zero so that rounding cannot push the iteration
+ * into the Laplacian's null space.
+ */
+static void SolveWeightedLaplacian(const StressState& state, const vector<double>& rightHandSide,
+                                   vector<double>& solution, const StressOptions& options) {
+    size_t numberOfNodes = solution.size();
+    vector<double> residual, direction, product;
+    MultiplyWeightedLaplacian(state, solution, product);
+    residual.resize(numberOfNodes);
+    double mean = 0;
+    for (size_t i = 0; i < numberOfNodes; i++) {
+        residual[i] = rightHandSide[i] - product[i];
+        mean += residual[i];
+    }
+    mean /= numberOfNodes;
+    for (size_t i = 0; i < numberOfNodes; i++) residual[i] -= mean;
+
+    direction = residual;
+    double residualSquared = Dot(residual, residual);
+    double target = options.conjugateGradientTolerance * options.conjugateGradientTolerance *
+                    Dot(rightHandSide, rightHandSide);
+    for (size_t step = 0; step < options.conjugateGradientIterations; step++) {
+        if (residualSquared <= target) break;
+        MultiplyWeightedLaplacian(state, direction, product);
+        double curvature = Dot(direction, product);
+        if (curvature <= 0) break;
+        double alpha = residualSquared / curvature;
+        for (size_t i = 0; i < numberOfNodes; i++) {
+            solution[i] += alpha * direction[i];
+            residual[i] -= alpha * product[i];
+        }
+        double nextResidualSquared = Dot(residual, residual);
+        double beta = nextResidualSquared / residualSquared;
+        for (size_t i = 0; i < numberOfNodes; i++) {
+            direction[i] = residual[i] + beta * direction[i];
+        }
+        residualSquared = nextResidualSquared;
+    }
+}
+
+/*
+ * MajorizationRightHandSide
+ * Stores L_Z(x) x for both coordinates and returns the
+ * stress of the layout, both of which need the same
+ * distances between the nodes.
+ */
+static double MajorizationRightHandSide(const StressState& state, const vector<double>& x,
+                                        const vector<double>& y,
+                                        vector<double>& rightX, vector<double>& rightY) {
+    size_t numberOfNodes = x.size();
+    const unsigned short* distance = state.distances.values.data();
+    rightX.assign(numberOfNodes, 0.0);
+    rightY.assign(numberOfNodes, 0.0);
+    double stress = 0;
+    for (size_t i = 0; i < numberOfNodes; i++) {
+        double sumX = 0, sumY = 0;
+        for (size_t j = i + 1; j < numberOfNodes; j++) {
+            unsigned short graphDistance = *distance++;
+            double dx = x[i] - x[j];
+            double dy = y[i] - y[j];
+            double layoutDistance = sqrt(dx * dx + dy * dy);
+            double weight = state.weights[graphDistance];
+            double error = layoutDistance - graphDistance;
+            stress += weight * error * error;
+            if (layoutDistance == 0) continue;
+
+            double scale = weight * graphDistance / layoutDistance;
+            sumX += scale * dx;
+            sumY += scale * dy;
+            rightX[j] -= scale * dx;
+            rightY[j] -= scale * dy;
+        }
+        rightX[i] += sumX;
+        rightY[i] += sumY;
+    }
+    return stress;
+}
+
+/*
+ * InitializeStressState
+ * Computes the graph distances and the weight table.
+ * Returns false if the graph is too large.
+ */
+static bool InitializeStressState(const SimpleGraph& graph, StressState& state) {
+    if (!CalculateGraphDistances(graph, state.distances)) return false;
+    state.weights.assign(state.distances.disconnectedDistance + 1, 0.0);
+    for (size_t d = 1; d < state.weights.size(); d++) {
+        state.weights[d] = 1.0 / ((double) d * d);
+    }
+    return true;
+}
+
+/*
+ * StressMajorizationLayout
+ * Computes the graph distances, then alternates between
+ * measuring the stress and solving for the next layout
+ * until the stress stops falling.
+ */
+StressResult StressMajorizationLayout(SimpleGraph& graph, const StressOptions& options) {
+    StressResult result;
+    result.iterations = 0;
+    result.stress = HUGE_VAL;
+
+    StressState state;
+    if (!InitializeStressState(graph, state)) return result;
+    size_t numberOfNodes = graph.nodes.size();
+    if (numberOfNodes < 2) {
+        result.stress = 0;
+        return result;
+    }
+
+    vector<double> x(numberOfNodes), y(numberOfNodes);
+    for (size_t i = 0; i < numberOfNodes; i++) {
+        x[i] = graph.nodes[i].x;
+        y[i] = graph.nodes[i].y;
+    }
+    vector<double> rightX, rightY;
+
+    double stress = MajorizationRightHandSide(state, x, y, rightX, rightY);
+    while (result.iterations < options.maximumIterations) {
+        SolveWeightedLaplacian(state, rightX, x, options);
+        SolveWeightedLaplacian(state, rightY, y, options);
+        result.iterations++;
+
+        double previousStress = stress;
+        stress = MajorizationRightHandSide(state, x, y, rightX, rightY);
+        if (previousStress - stress < options.tolerance * previousStress) break;
+    }
+
+    for (size_t i = 0; i < numberOfNodes; i++) {
+        graph.nodes[i].x = x[i];
+        graph.nodes[i].y = y[i];
+    }
+    result.stress = stress;
+    return result;
+}
+
+/*
+ * CalculateStress
+ * With a_ij the layout distance and d_ij the graph
+ * distance, the stress at scale s is
+ *   sum of w_ij (s a_ij - d_ij)^2
+ * which is least at s = sum w_ij a_ij d_ij / sum w_ij a_ij^2.
+ * One pass collects the three sums the result needs.
+ */
+double CalculateStress(const SimpleGraph& graph) {
+    StressState state;
+    if (!InitializeStressState(graph, state)) return HUGE_VAL;
+    size_t numberOfNodes = graph.nodes.size();
+    const unsigned short* distance = state.distances.values.data();
+    double weightedSquares = 0, weightedProducts = 0, weightedTargets = 0;
+    for (size_t i = 0; i < numberOfNodes; i++) {
+        for (size_t j = i + 1; j < numberOfNodes; j++) {
+            unsigned short graphDistance = *distance++;
+            double weight = state.weights[graphDistance];
+            double dx = graph.nodes[i].x - graph.nodes[j].x;
+            double dy = graph.nodes[i].y - graph.nodes[j].y;
+            double layoutDistance = sqrt(dx * dx + dy * dy);
+            weightedSquares += weight * layoutDistance * layoutDistance;
+            weightedProducts += weight * layoutDistance * graphDistance;
+            weightedTargets += weight * graphDistance * graphDistance;
+        }
+    }
+    if (weightedSquares == 0) return weightedTargets;
+    return weightedTargets - weightedProducts * weightedProducts / weightedSquares;
+}
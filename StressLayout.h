@@ -0,0 +1,98 @@
+/*************************************************************************
+ * File: StressLayout.h
+ *
+ * A header file defining a stress majorization layout engine, an
+ * alternative to the force-directed pipeline in ForceLayout.h.  Stress
+ * measures how well the distances in a layout match the graph
+ * distances between the nodes:
+ *
+ *   stress = sum over pairs i < j of (|x_i - x_j| - d_ij)^2 / d_ij^2
+ *
+ * where d_ij is the number of edges on a shortest path from i to j.  As
+ * described by Gansner, Koren and North in "Graph Drawing by Stress
+ * Majorization" (2004), each iteration minimizes a quadratic function
+ * that bounds the stress from above and touches it at the current
+ * layout, so the stress never increases.  Minimizing the quadratic
+ * means solving one linear system per coordinate with the weighted
+ * Laplacian of the graph distances, which is done by conjugate
+ * gradients starting from the current layout.
+ *
+ * Unlike the force-directed layout the result depends only on the
+ * starting positions, and it converges in far fewer iterations.  Like
+ * any local method it can settle with parts of the graph folded over,
+ * most often when started from a symmetric layout such as the unit
+ * circle.  Every iteration does work proportional to the square of the
+ * number of nodes, and the distances take the memory described in
+ * GraphDistances.h, so the engine suits graphs of up to a few tens of
+ * thousands of nodes.  An edge's ideal length is one unit, as in the
+ * force-directed layout.
+ */
+
+#ifndef StressLayout_Included // Include guard
+#define StressLayout_Included
+
+#include "SimpleGraph.h" // For the SimpleGraph type.
+
+/* Default parameters of the stress majorization. */
+const size_t kDefaultStressIterations = 500;
+const double kDefaultStressTolerance = 1e-5;
+const size_t kDefaultConjugateGradientIterations = 10;
+const double kDefaultConjugateGradientTolerance = 1e-3;
+
+/**
+ * Type: StressOptions
+ * -----------------------------------------------------------------------
+ * Parameters controlling the majorization.  It stops after
+ * maximumIterations, or once an iteration lowers the stress by less
+ * than tolerance times its previous value.  Each linear system is
+ * solved with at most conjugateGradientIterations steps, stopping once
+ * the residual has shrunk by conjugateGradientTolerance.
+ */
+struct StressOptions {
+    size_t maximumIterations;
+    double tolerance;
+    size_t conjugateGradientIterations;
+    double conjugateGradientTolerance;
+};
+
+/**
+ * Type: StressResult
+ * -----------------------------------------------------------------------
+ * The number of majorization iterations run, and the stress of the
+ * final layout.
+ */
+struct StressResult {
+    size_t iterations;
+    double stress;
+};
+
+/**
+ * Function: DefaultStressOptions()
+ * -----------------------------------------------------------------------
+ * Returns the default majorization parameters.
+ */
+StressOptions DefaultStressOptions();
+
+/**
+ * Function: StressMajorizationLayout(SimpleGraph& graph,
+ *                                    const StressOptions& options)
+ * -----------------------------------------------------------------------
+ * Lays out the graph by stress majorization, starting from the nodes'
+ * current positions.  No two nodes may start at the same position.
+ * Graphs too large for GraphDistances are left unchanged, with a result
+ * of zero iterations and infinite stress.
+ */
+StressResult StressMajorizationLayout(SimpleGraph& graph, const StressOptions& options);
+
+/**
+ * Function: CalculateStress(const SimpleGraph& graph)
+ * -----------------------------------------------------------------------
+ * Returns the stress of the graph's current layout after scaling it
+ * uniformly by whichever factor gives the least stress.  Engines differ
+ * in the overall size of their layouts, so this is the fairer number
+ * for comparing them.  Returns infinity for graphs too large for
+ * GraphDistances.
+ */
+double CalculateStress(const SimpleGraph& graph);
+
+#endif
@@ -0,0 +1,412 @@
+/******************************************************
+ * File: Triangulation.cpp
+ *
+ * Implementation of the Triangulation.h interface.
+ * Triangles are stored as halfedges: halfedge e runs
+ * from corner e to corner NextHalfedge(e) of triangle
+ * e / 3, every triangle is counterclockwise, and
+ * opposite[e] is the matching halfedge of the
+ * neighbouring triangle, or -1 on the convex hull.  The
+ * hull is a circular list of nodes, also counterclockwise,
+ * with each hull node remembering the halfedge that
+ * leaves it along the hull.
+ */
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include "Triangulation.h"
+using namespace std;
+
+/* Coordinates closer than this are taken to be the same point. */
+const double kDuplicateTolerance = numeric_limits<double>::epsilon();
+
+/*
+ * Type: SweepHull
+ * The triangles built so far and the convex hull around
+ * them.  hullNext[i] == i marks a node that has left the
+ * hull, and hullHash maps a range of angles around the
+ * seed circle to a node on the hull at about that angle.
+ */
+struct SweepHull {
+    const double* x;
+    const double* y;
+    vector<size_t> corners;
+    vector<int> opposite;
+    vector<size_t> hullNext, hullPrev;
+    vector<int> hullTri;
+    vector<int> hullHash;
+    size_t hullStart;
+    double centerX, centerY;
+    vector<int> edgeStack;
+};
+
+/*
+ * Cross
+ * Returns twice the signed area of triangle abc, which
+ * is positive when a, b, c turn counterclockwise.
+ */
+static double Cross(const SweepHull& hull, size_t a, size_t b, size_t c) {
+    return (hull.x[b] - hull.x[a]) * (hull.y[c] - hull.y[a]) -
+           (hull.y[b] - hull.y[a]) * (hull.x[c] - hull.x[a]);
+}
+
+/*
+ * InCircle
+ * Returns whether d lies strictly inside the circle
+ * through the counterclockwise triangle abc.
+ */
+static bool InCircle(const SweepHull& hull, size_t a, size_t b, size_t c, size_t d) {
+    double ax = hull.x[a] - hull.x[d], ay = hull.y[a] - hull.y[d];
+    double bx = hull.x[b] - hull.x[d], by = hull.y[b] - hull.y[d];
+    double cx = hull.x[c] - hull.x[d], cy = hull.y[c] - hull.y[d];
+    double aa = ax * ax + ay * ay;
+    double bb = bx * bx + by * by;
+    double cc = cx * cx + cy * cy;
+    return ax * (by * cc - bb * cy) - ay * (bx * cc - bb * cx) + aa * (bx * cy - by * cx) > 0;
+}
+
+/*
+ * CircumradiusSquared
+ * Returns the squared radius of the circle through a, b
+ * and c, or infinity if they are collinear.
+ */
+static double CircumradiusSquared(const SweepHull& hull, size_t a, size_t b, size_t c) {
+    double bx = hull.x[b] - hull.x[a], by = hull.y[b] - hull.y[a];
+    double cx = hull.x[c] - hull.x[a], cy = hull.y[c] - hull.y[a];
+    double bb = bx * bx + by * by;
+    double cc = cx * cx + cy * cy;
+    double determinant = bx * cy - by * cx;
+    if (determinant == 0) return numeric_limits<double>::infinity();
+    double ux = (cy * bb - by * cc) * 0.5 / determinant;
+    double uy = (bx * cc - cx * bb) * 0.5 / determinant;
+    return ux * ux + uy * uy;
+}
+
+/*
+ * HashKey
+ * Buckets the angle of (px, py) around the seed circle
+ * using a pseudo-angle, which orders directions as the
+ * true angle does without any trigonometry.
+ */
+static size_t HashKey(const SweepHull& hull, double px, double py) {
+    double dx = px - hull.centerX, dy = py - hull.centerY;
+    if (dx == 0 && dy == 0) return 0;
+    double p = dx / (fabs(dx) + fabs(dy));
+    double angle = (dy > 0 ? 3 - p : 1 + p) / 4;
+    size_t size = hull.hullHash.size();
+    return (size_t) floor(angle * size) % size;
+}
+
+/*
+ * NextHalfedge
+ * Returns the halfedge after e in its triangle.
+ */
+static int NextHalfedge(int e) {
+    return (e % 3 == 2) ? e - 2 : e + 1;
+}
+
+/*
+ * Link
+ * Makes halfedges a and b opposite each other; b may be
+ * -1 for an edge on the hull.
+ */
+static void Link(SweepHull& hull, int a, int b) {
+    hull.opposite[a] = b;
+    if (b != -1) hull.opposite[b] = a;
+}
+
+/*
+ * AddTriangle
+ * Adds the triangle i0, i1, i2 whose halfedges are
+ * opposite a, b and c, and returns its first halfedge.
+ */
+static int AddTriangle(SweepHull& hull, size_t i0, size_t i1, size_t i2, int a, int b, int c) {
+    int t = hull.corners.size();
+    hull.corners.push_back(i0);
+    hull.corners.push_back(i1);
+    hull.corners.push_back(i2);
+    hull.opposite.resize(t + 3);
+    Link(hull, t, a);
+    Link(hull, t + 1, b);
+    Link(hull, t + 2, c);
+    return t;
+}
+
+/*
+ * Legalize
+ * Flips halfedge a and the edges behind it until every
+ * triangle they touch has an empty circumcircle, and
+ * returns the halfedge that now follows a in its
+ * triangle.  A flip swaps the diagonal of the two
+ * triangles on either side of an edge, which may in
+ * turn make the far edges illegal, so those are kept on
+ * an explicit stack.
+ */
+static int Legalize(SweepHull& hull, int a) {
+    int ar = 0;
+    hull.edgeStack.clear();
+    while (true) {
+        int b = hull.opposite[a];
+        int a0 = a - a % 3;
+        ar = a0 + (a + 2) % 3;
+
+        //An edge on the hull has nothing to flip against
+        if (b == -1) {
+            if (hull.edgeStack.empty()) break;
+            a = hull.edgeStack.back();
+            hull.edgeStack.pop_back();
+            continue;
+        }
+
+        int b0 = b - b % 3;
+        int al = a0 + (a + 1) % 3;
+        int bl = b0 + (b + 2) % 3;
+        size_t p0 = hull.corners[ar];
+        size_t pr = hull.corners[a];
+        size_t pl = hull.corners[al];
+        size_t p1 = hull.corners[bl];
+
+        if (InCircle(hull, p0, pr, pl, p1)) {
+            hull.corners[a] = p1;
+            hull.corners[b] = p0;
+            int hbl = hull.opposite[bl];
+
+            //The flipped edge may have been the one a hull node points to
+            if (hbl == -1) {
+                size_t e = hull.hullStart;
+                do {
+                    if (hull.hullTri[e] == bl) {
+                        hull.hullTri[e] = a;
+                        break;
+                    }
+                    e = hull.hullPrev[e];
+                } while (e != hull.hullStart);
+            }
+            Link(hull, a, hbl);
+            Link(hull, b, hull.opposite[ar]);
+            Link(hull, ar, bl);
+            hull.edgeStack.push_back(b0 + (b + 1) % 3);
+        } else {
+            if (hull.edgeStack.empty()) break;
+            a = hull.edgeStack.back();
+            hull.edgeStack.pop_back();
+        }
+    }
+    return ar;
+}
+
+/*
+ * ChainEdges
+ * Joins consecutive distinct nodes in order of x, then
+ * y, for inputs that have no triangle.
+ */
+static void ChainEdges(const NodeArrays& positions, vector<Edge>& edges) {
+    vector<size_t> order(positions.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = i;
+    sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        if (positions.x[a] != positions.x[b]) return positions.x[a] < positions.x[b];
+        return positions.y[a] < positions.y[b];
+    });
+    for (size_t k = 1; k < order.size(); k++) {
+        size_t a = order[k - 1], b = order[k];
+        if (fabs(positions.x[a] - positions.x[b]) <= kDuplicateTolerance &&
+            fabs(positions.y[a] - positions.y[b]) <= kDuplicateTolerance) {
+            order[k] = a;
+            continue;
+        }
+        Edge edge = {min(a, b), max(a, b)};
+        edges.push_back(edge);
+    }
+}
+
+/*
+ * DelaunayEdges
+ * Seeds the hull with the smallest triangle near the
+ * middle of the nodes, then adds the rest in order of
+ * distance from its circumcentre, so that every new
+ * node lies outside the hull built so far.
+ */
+void DelaunayEdges(const NodeArrays& positions, vector<Edge>& edges) {
+    edges.clear();
+    size_t numberOfNodes = positions.size();
+    if (numberOfNodes < 3) {
+        ChainEdges(positions, edges);
+        return;
+    }
+
+    SweepHull hull;
+    hull.x = positions.x.data();
+    hull.y = positions.y.data();
+
+    //Seed with the node nearest the middle, its nearest node, and the smallest circle
+    double minX = hull.x[0], maxX = hull.x[0], minY = hull.y[0], maxY = hull.y[0];
+    for (size_t i = 1; i < numberOfNodes; i++) {
+        minX = min(minX, hull.x[i]);
+        maxX = max(maxX, hull.x[i]);
+        minY = min(minY, hull.y[i]);
+        maxY = max(maxY, hull.y[i]);
+    }
+    double middleX = (minX + maxX) / 2, middleY = (minY + maxY) / 2;
+
+    size_t i0 = 0, i1 = 0, i2 = 0;
+    double bestDistance = numeric_limits<double>::infinity();
+    for (size_t i = 0; i < numberOfNodes; i++) {
+        double dx = hull.x[i] - middleX, dy = hull.y[i] - middleY;
+        if (dx * dx + dy * dy < bestDistance) {
+            bestDistance = dx * dx + dy * dy;
+            i0 = i;
+        }
+    }
+    bestDistance = numeric_limits<double>::infinity();
+    for (size_t i = 0; i < numberOfNodes; i++) {
+        double dx = hull.x[i] - hull.x[i0], dy = hull.y[i] - hull.y[i0];
+        double distance = dx * dx + dy * dy;
+        if (i != i0 && distance > 0 && distance < bestDistance) {
+            bestDistance = distance;
+            i1 = i;
+        }
+    }
+    double bestRadius = numeric_limits<double>::infinity();
+    for (size_t i = 0; i < numberOfNodes; i++) {
+        if (i == i0 || i == i1) continue;
+        double radius = CircumradiusSquared(hull, i0, i1, i);
+        if (radius < bestRadius) {
+            bestRadius = radius;
+            i2 = i;
+        }
+    }
+    if (std::isinf(bestRadius)) {
+        ChainEdges(positions, edges);
+        return;
+    }
+    if (Cross(hull, i0, i1, i2) < 0) swap(i1, i2);
+
+    //Circumcentre of the seed, which every later node is sorted around
+    {
+        double bx = hull.x[i1] - hull.x[i0], by = hull.y[i1] - hull.y[i0];
+        double cx = hull.x[i2] - hull.x[i0], cy = hull.y[i2] - hull.y[i0];
+        double bb = bx * bx + by * by;
+        double cc = cx * cx + cy * cy;
+        double determinant = bx * cy - by * cx;
+        hull.centerX = hull.x[i0] + (cy * bb - by * cc) * 0.5 / determinant;
+        hull.centerY = hull.y[i0] + (bx * cc - cx * bb) * 0.5 / determinant;
+    }
+
+    vector<double> distances(numberOfNodes);
+    vector<size_t> order(numberOfNodes);
+    for (size_t i = 0; i < numberOfNodes; i++) {
+        double dx = hull.x[i] - hull.centerX, dy = hull.y[i] - hull.centerY;
+        distances[i] = dx * dx + dy * dy;
+        order[i] = i;
+    }
+    sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return distances[a] < distances[b];
+    });
+
+    size_t hashSize = (size_t) ceil(sqrt((double) numberOfNodes));
+    hull.hullHash.assign(hashSize, -1);
+    hull.hullNext.assign(numberOfNodes, 0);
+    hull.hullPrev.assign(numberOfNodes, 0);
+    hull.hullTri.assign(numberOfNodes, -1);
+    hull.corners.reserve(6 * numberOfNodes);
+    hull.opposite.reserve(6 * numberOfNodes);
+
+    hull.hullStart = i0;
+    hull.hullNext[i0] = hull.hullPrev[i2] = i1;
+    hull.hullNext[i1] = hull.hullPrev[i0] = i2;
+    hull.hullNext[i2] = hull.hullPrev[i1] = i0;
+    hull.hullTri[i0] = 0;
+    hull.hullTri[i1] = 1;
+    hull.hullTri[i2] = 2;
+    hull.hullHash[HashKey(hull, hull.x[i0], hull.y[i0])] = i0;
+    hull.hullHash[HashKey(hull, hull.x[i1], hull.y[i1])] = i1;
+    hull.hullHash[HashKey(hull, hull.x[i2], hull.y[i2])] = i2;
+    AddTriangle(hull, i0, i1, i2, -1, -1, -1);
+
+    double previousX = 0, previousY = 0;
+    for (size_t k = 0; k < numberOfNodes; k++) {
+        size_t i = order[k];
+        double x = hull.x[i], y = hull.y[i];
+
+        //Skip nodes on top of the one before, and the seed itself
+        if (k > 0 && fabs(x - previousX) <= kDuplicateTolerance &&
+            fabs(y - previousY) <= kDuplicateTolerance) continue;
+        previousX = x;
+        previousY = y;
+        if (i == i0 || i == i1 || i == i2) continue;
+
+        //Find a hull edge the node can see, starting near its angle
+        size_t start = 0;
+        size_t key = HashKey(hull, x, y);
+        for (size_t j = 0; j < hashSize; j++) {
+            int candidate = hull.hullHash[(key + j) % hashSize];
+            if (candidate != -1 && hull.hullNext[candidate] != (size_t) candidate) {
+                start = candidate;
+                break;
+            }
+        }
+        start = hull.hullPrev[start];
+        size_t e = start;
+        bool visible = true;
+        while (Cross(hull, e, hull.hullNext[e], i) >= 0) {
+            e = hull.hullNext[e];
+            if (e == start) {
+                visible = false;
+                break;
+            }
+        }
+        if (!visible) continue;
+
+        //Join the node to the first visible edge
+        int t = AddTriangle(hull, e, i, hull.hullNext[e], -1, -1, hull.hullTri[e]);
+        hull.hullTri[i] = Legalize(hull, t + 2);
+        hull.hullTri[e] = t;
+
+        //Then to every visible edge after it
+        size_t n = hull.hullNext[e];
+        while (Cross(hull, n, hull.hullNext[n], i) < 0) {
+            size_t q = hull.hullNext[n];
+            t = AddTriangle(hull, n, i, q, hull.hullTri[i], -1, hull.hullTri[n]);
+            hull.hullTri[i] = Legalize(hull, t + 2);
+            hull.hullNext[n] = n;
+            n = q;
+        }
+
+        //And to every visible edge before it
+        if (e == start) {
+            while (Cross(hull, hull.hullPrev[e], e, i) < 0) {
+                size_t q = hull.hullPrev[e];
+                t = AddTriangle(hull, q, i, e, -1, hull.hullTri[e], hull.hullTri[q]);
+                Legalize(hull, t + 2);
+                hull.hullTri[q] = t;
+                hull.hullNext[e] = e;
+                e = q;
+            }
+        }
+
+        hull.hullStart = hull.hullPrev[i] = e;
+        hull.hullNext[e] = hull.hullPrev[n] = i;
+        hull.hullNext[i] = n;
+        hull.hullHash[HashKey(hull, x, y)] = i;
+        hull.hullHash[HashKey(hull, hull.x[e], hull.y[e])] = e;
+    }
+
+    //Each interior edge has two halfedges; keep the one with the larger index
+    for (size_t e = 0; e < hull.corners.size(); e++) {
+        int other = hull.opposite[e];
+        if (other != -1 && (size_t) other > e) continue;
+        size_t a = hull.corners[e];
+        size_t b = hull.corners[NextHalfedge(e)];
+        Edge edge = {min(a, b), max(a, b)};
+        edges.push_back(edge);
+    }
+
+    //Nodes a hair apart can leave an edge in two triangles that both survive
+    sort(edges.begin(), edges.end(), [](const Edge& a, const Edge& b) {
+        return a.start != b.start ? a.start < b.start : a.end < b.end;
+    });
+    edges.erase(unique(edges.begin(), edges.end(), [](const Edge& a, const Edge& b) {
+        return a.start == b.start && a.end == b.end;
+    }), edges.end());
+}
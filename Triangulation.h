@@ -0,0 +1,36 @@
+/*************************************************************************
+ * File: Triangulation.h
+ *
+ * A header file defining the Delaunay triangulation of the node
+ * positions of a layout.  The triangulation joins every node to its
+ * natural neighbours, so its edges form a sparse, connected and rigid
+ * proximity graph with fewer than 3n edges, which the overlap removal of
+ * OverlapRemoval.h uses in place of the O(n^2) pairs of nodes.
+ *
+ * The triangulation is built by the sweep-hull method: the nodes are
+ * sorted by their distance from a small seed triangle and added in that
+ * order, each joined to the edges of the convex hull it can see, and
+ * every new triangle is flipped until it satisfies the Delaunay
+ * condition.  A hash on the angle around the seed finds the visible part
+ * of the hull, so the whole triangulation takes O(n log n) time, most of
+ * it in the sort.
+ */
+
+#ifndef Triangulation_Included // Include guard
+#define Triangulation_Included
+
+#include "SimpleGraph.h" // For the Edge type.
+#include "NodeArrays.h"  // For the NodeArrays type.
+
+/**
+ * Function: DelaunayEdges(const NodeArrays& positions,
+ *                         vector<Edge>& edges)
+ * -----------------------------------------------------------------------
+ * Stores in edges every edge of the Delaunay triangulation of the node
+ * positions, each once, with start < end.  Nodes at the same position as
+ * another are left out, and if every node lies on one line the edges
+ * instead join consecutive nodes along it.
+ */
+void DelaunayEdges(const NodeArrays& positions, vector<Edge>& edges);
+
+#endif
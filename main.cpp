@@ -6,10 +6,13 @@
  * The program prompts the user for a file that contains 
  * the information for a simple graph of connected nodes.
  * It uses this information to create a graph of the nodes.
- * It then prompts the user for the number of seconds to run 
+ * It then prompts the user for the maximum number of seconds to run
  * a force algorithm on the graph.  This algorithm calculates
  * repulsive and attractive forces based on the Fruchterman-
- * Reingold algorithm to make an aesthetically pleasing graph.
+ * Reingold algorithm to make an aesthetically pleasing graph,
+ * stopping early once the layout stops moving, and can then
+ * move apart any nodes drawn on top of one another and bundle
+ * the edges together.
  * It then asks the user if they want to try another graph.
  *
  * References: CS106L coursereader was referenced for Getline,
@@ -22,35 +25,79 @@
 #include <string>
 #include <sstream>
 #include <cmath>
-#include <ctime>
+#include <algorithm>
 #include "SimpleGraph.h"
 #include "GraphVisualizer.h"
+#include "ForceLayout.h"
+#include "FastMultipole.h"
+#include "GridRepulsion.h"
+#include "SimdRepulsion.h"
+#include "Parallel.h"
+#include "Multilevel.h"
+#include "AdaptiveStep.h"
+#include "StressLayout.h"
+#include "GraphDistances.h"
+#include "SgdLayout.h"
+#include "KamadaKawai.h"
+#include "PivotMds.h"
+#include "SpectralLayout.h"
+#include "ForceAtlas2.h"
+#include "ComponentLayout.h"
+#include "SpatialLayout.h"
+#include "LayoutBudget.h"
+#include "OverlapRemoval.h"
+#include "EdgeBundling.h"
+#include "LayoutGeometry.h"
 using namespace std;
 
 /* Constants */
-const double kPi = 3.14159265358979323;
-const double kRepel = 10e-3;
-const double kAttract = 10e-3;
+
+/* The angles, in radians, a layout in 3D is viewed from and turns by each frame. */
+const double kSpatialViewPitch = 0.4;
+const double kSpatialTurnPerFrame = 0.02;
+
+/* The layout algorithms the user can choose between. */
+enum LayoutAlgorithm {
+    kForceDirectedAlgorithm,
+    kStressMajorizationAlgorithm,
+    kSgdAlgorithm,
+    kKamadaKawaiAlgorithm,
+    kForceAtlas2Algorithm,
+    kComponentAlgorithm,
+    kSpatialAlgorithm
+};
+
+/* The starting layouts the user can choose between. */
+enum InitialLayout {
+    kUnitCircleLayout,
+    kMultilevelLayout,
+    kPivotMdsLayout,
+    kSpectralLayout
+};
 
 /* Function prototypes */
 void Welcome();
 string GetLine();
 int GetInteger();
 int GetPositiveInteger();
+double GetReal();
 string PromptForFileName();
-int PromptForTime();
+double PromptForTime();
+size_t PromptForIterationLimit();
+LayoutOptions PromptForLayoutOptions();
+InitialLayout PromptForInitialLayout();
+LayoutAlgorithm PromptForLayoutAlgorithm();
+void RunForceDirectedLayout(SimpleGraph& graph, const Adjacency& adjacency);
+void RunStressLayout(SimpleGraph& graph);
+void RunSgdLayout(SimpleGraph& graph);
+void RunKamadaKawaiLayout(SimpleGraph& graph);
+void RunForceAtlas2Layout(SimpleGraph& graph, const Adjacency& adjacency);
+void RunComponentLayout(SimpleGraph& graph);
+void RunSpatialLayout(SimpleGraph& graph, const Adjacency& adjacency);
+void RunOverlapRemoval(SimpleGraph& graph);
+void RunEdgeBundling(SimpleGraph& graph);
 Node CreateInitialNode(size_t nodeNumber, size_t totalNumberOfNodes);
 SimpleGraph LoadGraph();
-double GetElapsedTime(time_t startTime);
-double CalculateFRepel(double x0, double x1, double y0, double y1);
-double CalculateFAttract(double x0, double x1, double y0, double y1);
-double CalculateRadiansAngle(double x0, double x1, double y0, double y1);
-double CalculateXForce(double fRepel, double radiansAngle);
-double CalculateYForce(double fRepel, double radiansAngle);
-void CalculateRepulsiveForces(SimpleGraph& graph, vector<Node>& nodeChanges);
-vector<Node> InitializeNodeChanges(SimpleGraph& graph);
-void CalculateAttractiveForces(SimpleGraph& graph, vector<Node>& nodeChanges);
-void UpdateNodeMovements(SimpleGraph& graph, vector<Node>& nodeChanges);
 
 /* Functions */
 
@@ -60,8 +107,10 @@ void UpdateNodeMovements(SimpleGraph& graph, vector<Node>& nodeChanges);
  */
 void Welcome() {
 	cout << "Welcome to CS106L GraphViz!" << endl;
-	cout << "This program uses a force-directed graph layout algorithm" << endl;
+	cout << "This program uses force-directed and stress-based layout algorithms" << endl;
 	cout << "to render sleek, snazzy pictures of various graphs." << endl;
+	cout << "Exact repulsion uses the " << SimdLevelName(DetectSimdLevel())
+	     << " kernel on this processor." << endl;
 	cout << endl;
 }
 
@@ -120,6 +169,32 @@ int GetPositiveInteger() {
     }
 }
 
+/*
+ * GetReal
+ * Takes in a real number and prompts until a valid
+ * number is inputed by the user.
+ */
+double GetReal() {
+    while(true) {
+        stringstream converter;
+        converter << GetLine();
+        double result;
+        /* Check if a number is entered correctly */
+        if(converter >> result) {
+            /*Check for extraneous input */
+            char remaining;
+            if(converter >> remaining) {
+                cout << "Unexpected character: " << remaining << endl;
+            } else {
+                return result;
+            }
+        } else {
+            cout << "Please enter a number." << endl;
+        }
+        cout << "Retry: ";
+    }
+}
+
 /*
  * PromptForFile
  * Prompts the user for a file name until they enter an 
@@ -219,170 +294,439 @@ Node CreateInitialNode(size_t nodeNumber, size_t totalNumberOfNodes) {
 
 /* 
  * PromptForTime 
- * Prompts the user for time and integer
- * (GetInteger wrapper with a prompt)
+ * Prompts the user for the time budget in seconds,
+ * which may be a fraction such as 0.15
+ * (GetReal wrapper with a prompt)
  */
-int PromptForTime () {
-    cout << "Enter an integer number of seconds to run the algorithm: ";
-    return GetPositiveInteger();
+double PromptForTime () {
+    cout << "Enter the maximum number of seconds to run the algorithm (e.g. 0.15 or 10): ";
+    while(true) {
+        double seconds = GetReal();
+        if(seconds > 0) return seconds;
+        cout << "Please enter a positive number: ";
+    }
 }
 
 /*
- * GetElapsedTime
- * Takes in a startTime and returns the time
- * elapsed since that point.
+ * PromptForIterationLimit
+ * Prompts the user for the most iterations to run,
+ * where 0 means no limit besides the algorithm's own.
  */
-double GetElapsedTime(time_t startTime) {
-    return difftime(time(NULL), startTime);
+size_t PromptForIterationLimit() {
+    cout << "Maximum number of iterations (0 = no limit): ";
+    while(true) {
+        int iterations = GetInteger();
+        if(iterations > 0) return iterations;
+        if(iterations == 0) return kDefaultMaximumIterations;
+        cout << "Please enter a non-negative number: ";
+    }
 }
 
 /*
- * TransformGraph
- * Takes in a graph by reference, calculates the repulsive and
- * attractive forces acting on the nodes in the graph, and
- * then updates node positions accordingly.
+ * PromptForLayoutOptions
+ * Asks the user which engine to use for the repulsive
+ * forces, along with the opening angle for Barnes-Hut,
+ * the expansion order for the multipole engine or the
+ * cutoff distance for the grid engine, and for the exact
+ * engine its precision, threads and whether its result
+ * must not depend on the number of threads.
  */
-void TransformGraph(SimpleGraph& graph) {
-    vector<Node> nodeChanges = InitializeNodeChanges(graph);
-    CalculateRepulsiveForces(graph, nodeChanges);
-    CalculateAttractiveForces(graph, nodeChanges);
-    UpdateNodeMovements(graph, nodeChanges);
+LayoutOptions PromptForLayoutOptions() {
+    LayoutOptions options = DefaultLayoutOptions();
+    cout << "Repulsion engine (0 = exact, 1 = Barnes-Hut, 2 = multipole, 3 = grid): ";
+    while(true) {
+        int mode = GetInteger();
+        if(mode == 0) {
+            options.repulsionMode = kExactRepulsion;
+            break;
+        } else if(mode == 1) {
+            options.repulsionMode = kBarnesHutRepulsion;
+            break;
+        } else if(mode == 2) {
+            options.repulsionMode = kFastMultipoleRepulsion;
+            break;
+        } else if(mode == 3) {
+            options.repulsionMode = kGridRepulsion;
+            break;
+        }
+        cout << "Please enter 0, 1, 2 or 3: ";
+    }
+    if(options.repulsionMode == kBarnesHutRepulsion) {
+        cout << "Opening angle theta (e.g. " << kDefaultBarnesHutTheta << "): ";
+        while(true) {
+            options.theta = GetReal();
+            if(options.theta >= 0 && options.theta < kMaximumBarnesHutTheta) break;
+            cout << "Please enter a number from 0 up to, but not including, "
+                 << kMaximumBarnesHutTheta << ": ";
+        }
+    }
+    if(options.repulsionMode == kFastMultipoleRepulsion) {
+        cout << "Expansion order (e.g. " << kDefaultFastMultipoleOrder << "): ";
+        options.multipoleOrder = GetPositiveInteger();
+        cout << "Error bound per interaction: "
+             << FastMultipoleErrorBound(options.multipoleOrder, options.theta) << endl;
+    }
+    if(options.repulsionMode == kGridRepulsion) {
+        cout << "Repulsion cutoff distance (e.g. " << kDefaultRepulsionCutoff << "): ";
+        while(true) {
+            options.cutoff = GetReal();
+            if(options.cutoff > 0) break;
+            cout << "Please enter a positive number: ";
+        }
+    }
+    cout << "Force model (0 = Fruchterman-Reingold, 1 = LinLog, 2 = ForceAtlas2): ";
+    while(true) {
+        int model = GetInteger();
+        if(model >= 0 && model <= 2) {
+            options.forceModel = (ForceModel) model;
+            break;
+        }
+        cout << "Please enter 0, 1 or 2: ";
+    }
+    if(options.repulsionMode == kExactRepulsion) {
+        cout << "Precision (0 = double, 1 = single, 2 = float positions with double forces): ";
+        while(true) {
+            int precision = GetInteger();
+            if(precision >= 0 && precision <= 2) {
+                options.precision = (PrecisionMode) precision;
+                break;
+            }
+            cout << "Please enter 0, 1 or 2: ";
+        }
+    }
+    if(options.repulsionMode == kExactRepulsion && options.precision == kDoublePrecision) {
+        cout << "Number of threads (0 = one per core, this machine has "
+             << DefaultThreadCount() << "): ";
+        while(true) {
+            int numberOfThreads = GetInteger();
+            if(numberOfThreads >= 0) {
+                options.numberOfThreads = numberOfThreads;
+                break;
+            }
+            cout << "Please enter a non-negative number: ";
+        }
+        cout << "Same result on any number of threads (0 = no, 1 = yes): ";
+        while(true) {
+            int deterministic = GetInteger();
+            if(deterministic == 0 || deterministic == 1) {
+                options.deterministic = (deterministic == 1);
+                break;
+            }
+            cout << "Please enter 0 or 1: ";
+        }
+    }
+    return options;
 }
 
 /*
- * InitializeNodeChanges
- * Takes in a graph by referenceand initializes and returns an 
- * nodeChange vector according to the number of nodes in the graph.
- * The node change vector is a vector holding a number of Node
- * structs equal to the number of nodes in the graph.  Each node
- * struct has an x and y which are 0.
+ * PromptForInitialLayout
+ * Asks the user which layout to start the force-directed
+ * algorithm from.
  */
-vector<Node> InitializeNodeChanges(SimpleGraph& graph) {
-    vector<Node> nodeChanges;
-    for (size_t index = 0; index < graph.nodes.size(); index++) {
-        Node node;
-        node.x = 0;
-        node.y = 0;
-        nodeChanges.push_back(node);
+InitialLayout PromptForInitialLayout() {
+    cout << "Initial layout (0 = unit circle, 1 = multilevel, 2 = pivot MDS, 3 = spectral): ";
+    while(true) {
+        int layout = GetInteger();
+        if(layout == 0) return kUnitCircleLayout;
+        if(layout == 1) return kMultilevelLayout;
+        if(layout == 2) return kPivotMdsLayout;
+        if(layout == 3) return kSpectralLayout;
+        cout << "Please enter 0, 1, 2 or 3: ";
+    }
+}
+
+/*
+ * PromptForLayoutAlgorithm
+ * Asks the user which layout algorithm to run on the
+ * graph.
+ */
+LayoutAlgorithm PromptForLayoutAlgorithm() {
+    cout << "Layout algorithm (0 = force-directed, 1 = stress majorization, 2 = stress by SGD, "
+         << "3 = Kamada-Kawai, 4 = ForceAtlas2, 5 = force-directed by component, "
+         << "6 = force-directed in 3D): ";
+    while(true) {
+        int algorithm = GetInteger();
+        if(algorithm == 0) return kForceDirectedAlgorithm;
+        if(algorithm == 1) return kStressMajorizationAlgorithm;
+        if(algorithm == 2) return kSgdAlgorithm;
+        if(algorithm == 3) return kKamadaKawaiAlgorithm;
+        if(algorithm == 4) return kForceAtlas2Algorithm;
+        if(algorithm == 5) return kComponentAlgorithm;
+        if(algorithm == 6) return kSpatialAlgorithm;
+        cout << "Please enter a number from 0 to 6: ";
     }
-    return nodeChanges;
 }
 
 /*
- * CalculateRepulsiveForces
- * Takes in a simple graph and a vector of Node structs both by
- * by reference. Calculates the repulsive forces on the nodes 
- * and stores them in the vector of nodes.
+ * RunForceDirectedLayout
+ * Asks for the time and iteration limits and the layout
+ * options, then runs the force-directed algorithm on
+ * the graph until it converges or a limit is reached,
+ * drawing every iteration.  The positions stay in
+ * NodeArrays between iterations and are copied out only
+ * to be drawn.  The time limit covers the initial
+ * layout too: the multilevel start stops refining when
+ * it runs out, and the Pivot MDS and spectral starts,
+ * which cannot stop part of the way through, leave the
+ * iterations only what remains.
  */
-void CalculateRepulsiveForces(SimpleGraph& graph, vector<Node>& nodeChanges) {
-    for (size_t nodeIndex0 = 0; nodeIndex0 < graph.nodes.size() - 1; nodeIndex0++) {
-        for (size_t nodeIndex1 = nodeIndex0 + 1; nodeIndex1 < graph.nodes.size(); nodeIndex1++) {
-            
-            //Get node positions
-            double x0 = graph.nodes[nodeIndex0].x;
-            double x1 = graph.nodes[nodeIndex1].x;
-            double y0 = graph.nodes[nodeIndex0].y;
-            double y1 = graph.nodes[nodeIndex1].y;
-            
-            //Calculate repulsive force and angle between the two nodes
-            double fRepel = CalculateFRepel(x0, x1, y0, y1);
-            double radiansAngle = CalculateRadiansAngle(x0, x1, y0, y1);
-            
-            //Update the x and y changes based on the forces.
-            nodeChanges[nodeIndex0].x -= CalculateXForce(fRepel, radiansAngle);
-            nodeChanges[nodeIndex0].y -= CalculateYForce(fRepel, radiansAngle);
-            nodeChanges[nodeIndex1].x += CalculateXForce(fRepel, radiansAngle);
-            nodeChanges[nodeIndex1].y += CalculateYForce(fRepel, radiansAngle);
+void RunForceDirectedLayout(SimpleGraph& graph, const Adjacency& adjacency) {
+    //Get algorithm time
+    double algorithmTime = PromptForTime();
+    ConvergenceOptions convergenceOptions = DefaultConvergenceOptions();
+    convergenceOptions.maximumIterations = PromptForIterationLimit();
+    LayoutOptions options = PromptForLayoutOptions();
+    InitialLayout initialLayout = PromptForInitialLayout();
+    LayoutDeadline deadline = StartDeadline(algorithmTime);
+    if(initialLayout == kMultilevelLayout) {
+        size_t levels = MultilevelLayout(graph, options, DefaultMultilevelOptions(), deadline);
+        cout << "Multilevel layout used " << levels << " levels." << endl;
+        DrawGraph(graph);
+    } else if(initialLayout == kPivotMdsLayout) {
+        PivotMdsLayout(graph, kDefaultMdsPivots);
+        DrawGraph(graph);
+    } else if(initialLayout == kSpectralLayout) {
+        if(SpectralLayout(graph)) {
+            DrawGraph(graph);
+        } else {
+            cout << "The graph is not connected, so it starts from the unit circle." << endl;
+        }
+    }
+
+    //Start transformation, stopping early once the layout settles
+    ConvergenceState state = InitializeConvergence(convergenceOptions);
+    NodeArrays positions;
+    LoadNodeArrays(graph.nodes, positions);
+    NodeArrays nodeChanges = InitializeNodeChanges(positions);
+    bool interruptible = InterruptibleForces(options);
+    double lastIterationSeconds = 0;
+    while(state.iterations < convergenceOptions.maximumIterations) {
+        //An iteration that cannot stop early is not started unless the last one says it fits
+        if(!IterationFitsBudget(deadline, interruptible ? 0 : lastIterationSeconds)) break;
+        double iterationStart = SecondsSinceStart(deadline);
+
+        //A long iteration is dropped part of the way through if the time runs out
+        if(!AdaptiveTransformNodeArrays(positions, adjacency, nodeChanges, options,
+                                        convergenceOptions, state, deadline)) break;
+        lastIterationSeconds = SecondsSinceStart(deadline) - iterationStart;
+        StoreNodeArrays(positions, graph.nodes);
+        DrawGraph(graph);
+        if(state.converged) {
+            cout << "The layout has converged." << endl;
+            break;
         }
     }
+    cout << "Iterations used: " << state.iterations << endl;
+    cout << "Final energy: " << state.energy << endl;
 }
 
+/*
+ * RunStressLayout
+ * Lays out the graph by stress majorization and draws
+ * the result.
+ */
+void RunStressLayout(SimpleGraph& graph) {
+    StressResult result = StressMajorizationLayout(graph, DefaultStressOptions());
+    if(result.iterations == 0 && graph.nodes.size() > kMaximumDistanceNodes) {
+        cout << "The graph is too large for stress majorization." << endl;
+        return;
+    }
+    DrawGraph(graph);
+    cout << "Iterations used: " << result.iterations << endl;
+    cout << "Final stress: " << result.stress << endl;
+}
 
 /*
- * CalculateAttractiveForces
- * Takes in a graph and vector of changes by reference
- * Calculates the attractive forces and updates the
- * vector of node changes appropriately.
+ * RunSgdLayout
+ * Asks for the number of pivots, lays out the graph by
+ * stochastic gradient descent on its stress and draws
+ * the result.
  */
-void CalculateAttractiveForces(SimpleGraph& graph, vector<Node>& nodeChanges) {
-    for (size_t edgeIndex = 0; edgeIndex < graph.edges.size(); edgeIndex++) {
-        
-        //Get nodes
-        Node node0 = graph.nodes[graph.edges[edgeIndex].start];
-        Node node1 = graph.nodes[graph.edges[edgeIndex].end];
-        
-        //Get node positions
-        double x0 = node0.x;
-        double x1 = node1.x;
-        double y0 = node0.y;
-        double y1 = node1.y;
-        
-        //Calculate attractive force and radian angle
-        double fAttract = CalculateFAttract(x0, x1, y0, y1);
-        double radiansAngle = CalculateRadiansAngle(x0, x1, y0, y1);
-        
-        //Update x and y changes based on graph
-        nodeChanges[graph.edges[edgeIndex].start].x += CalculateXForce(fAttract, radiansAngle);
-        nodeChanges[graph.edges[edgeIndex].start].y += CalculateYForce(fAttract, radiansAngle);
-        nodeChanges[graph.edges[edgeIndex].end].x   -= CalculateXForce(fAttract, radiansAngle);
-        nodeChanges[graph.edges[edgeIndex].end].y   -= CalculateYForce(fAttract, radiansAngle);
+void RunSgdLayout(SimpleGraph& graph) {
+    SgdOptions options = DefaultSgdOptions();
+    cout << "Number of pivots (0 = every pair of nodes, e.g. " << kDefaultSgdPivots
+         << " for large graphs): ";
+    while(true) {
+        int numberOfPivots = GetInteger();
+        if(numberOfPivots >= 0) {
+            options.numberOfPivots = numberOfPivots;
+            break;
+        }
+        cout << "Please enter a non-negative number: ";
     }
+    size_t numberOfTerms = SgdLayout(graph, options);
+    DrawGraph(graph);
+    cout << "Stochastic gradient descent used " << numberOfTerms << " terms over "
+         << options.epochs << " epochs." << endl;
 }
 
 /*
- * CalculateFRepel
- * Calculates and returns the repeling force from the
- * input of four double coordinates of two node locations
+ * RunForceAtlas2Layout
+ * Asks for time and iteration limits and a repulsion
+ * engine, then runs ForceAtlas2 until it converges or a
+ * limit is reached, drawing every iteration.
  */
-double CalculateFRepel(double x0, double x1, double y0, double y1) {
-    return kRepel / sqrt( (x1 - x0) * (x1 - x0) + (y1 - y0) * (y1 - y0));
+void RunForceAtlas2Layout(SimpleGraph& graph, const Adjacency& adjacency) {
+    double algorithmTime = PromptForTime();
+    size_t iterationLimit = PromptForIterationLimit();
+    LayoutOptions layoutOptions = DefaultLayoutOptions();
+    cout << "Repulsion engine (0 = exact, 1 = Barnes-Hut, 2 = grid): ";
+    while(true) {
+        int mode = GetInteger();
+        if(mode == 0) {
+            layoutOptions.repulsionMode = kExactRepulsion;
+            break;
+        } else if(mode == 1) {
+            layoutOptions.repulsionMode = kBarnesHutRepulsion;
+            break;
+        } else if(mode == 2) {
+            layoutOptions.repulsionMode = kGridRepulsion;
+            break;
+        }
+        cout << "Please enter 0, 1 or 2: ";
+    }
+
+    ForceAtlas2Options options = DefaultForceAtlas2Options();
+    options.maximumIterations = min(options.maximumIterations, iterationLimit);
+    ForceAtlas2State state = InitializeForceAtlas2(adjacency, options);
+    NodeArrays positions;
+    LoadNodeArrays(graph.nodes, positions);
+    LayoutDeadline deadline = StartDeadline(algorithmTime);
+    while(state.iterations < options.maximumIterations) {
+        //Every engine stops part of the way through an iteration, so none can overrun
+        if(!IterationFitsBudget(deadline, 0)) break;
+        if(!ForceAtlas2TransformNodeArrays(positions, adjacency, layoutOptions, options, state,
+                                           deadline)) break;
+        StoreNodeArrays(positions, graph.nodes);
+        DrawGraph(graph);
+        if(state.converged) {
+            cout << "The layout has converged." << endl;
+            break;
+        }
+    }
+    cout << "Iterations used: " << state.iterations << endl;
+    cout << "Final speed: " << state.speed << endl;
 }
 
 /*
- * CalculateFAttract
- * Calculates and returns the attracting force from the
- * input of four double coordinates of two node locations
+ * RunComponentLayout
+ * Asks for the layout options, lays out each connected
+ * component of the graph on its own, one per core at a
+ * time, packs them and draws the result.
  */
-double CalculateFAttract(double x0, double x1, double y0, double y1) {
-    return kAttract * ((x1 - x0) * (x1 - x0) + (y1 - y0) * (y1 - y0));
+void RunComponentLayout(SimpleGraph& graph) {
+    LayoutOptions options = PromptForLayoutOptions();
+    size_t numberOfComponents = ComponentLayout(graph, options, DefaultConvergenceOptions(),
+                                                DefaultComponentOptions());
+    DrawGraph(graph);
+    cout << "Connected components laid out: " << numberOfComponents << endl;
 }
 
 /*
- * CalculateRadiansAngle
- * Calculates and returns the radians angle between nodes with
- * two different positions
+ * RunSpatialLayout
+ * Asks for time and iteration limits and a repulsion
+ * engine, then lays the graph out in three dimensions
+ * from the unit sphere until it converges or a limit is
+ * reached.  Every iteration is drawn as seen from a
+ * direction that turns a little each frame, so that the
+ * shape can be seen.
  */
-double CalculateRadiansAngle(double x0, double x1, double y0, double y1) {
-    return atan2 (y1-y0, x1-x0);
+void RunSpatialLayout(SimpleGraph& graph, const Adjacency& adjacency) {
+    double algorithmTime = PromptForTime();
+    ConvergenceOptions convergenceOptions = DefaultConvergenceOptions();
+    convergenceOptions.maximumIterations = PromptForIterationLimit();
+    LayoutOptions options = DefaultLayoutOptions();
+    cout << "Repulsion engine (0 = exact, 1 = octree): ";
+    while(true) {
+        int mode = GetInteger();
+        if(mode == 0) {
+            options.repulsionMode = kExactRepulsion;
+            break;
+        } else if(mode == 1) {
+            options.repulsionMode = kBarnesHutRepulsion;
+            options.numberOfThreads = 0;
+            break;
+        }
+        cout << "Please enter 0 or 1: ";
+    }
+
+    ConvergenceState state = InitializeConvergence(convergenceOptions);
+    SpatialArrays positions, nodeChanges;
+    InitialSpatialLayout(graph.nodes.size(), positions);
+    ResizeSpatialArrays(nodeChanges, positions.size());
+    double yaw = 0;
+    LayoutDeadline deadline = StartDeadline(algorithmTime);
+    while(state.iterations < convergenceOptions.maximumIterations) {
+        //Both engines drop an iteration part of the way through if the time runs out
+        if(DeadlinePassed(deadline)) break;
+        if(!AdaptiveTransformSpatialArrays(positions, adjacency, nodeChanges, options,
+                                           convergenceOptions, state, deadline)) break;
+        ProjectSpatialArrays(positions, yaw, kSpatialViewPitch, graph.nodes);
+        DrawGraph(graph);
+        yaw += kSpatialTurnPerFrame;
+        if(state.converged) {
+            cout << "The layout has converged." << endl;
+            break;
+        }
+    }
+    cout << "Iterations used: " << state.iterations << endl;
+    cout << "Final energy: " << state.energy << endl;
 }
-                                         
+
 /*
- * CalculateXForce
- * Takes in a force and an angle in radians and computes the appropriate
- * x component of that force.
+ * RunKamadaKawaiLayout
+ * Lays out the graph by the Kamada-Kawai method and
+ * draws the result.
  */
-double CalculateXForce(double fRepel, double radiansAngle){
-    return fRepel * cos(radiansAngle);
+void RunKamadaKawaiLayout(SimpleGraph& graph) {
+    KamadaKawaiResult result = KamadaKawaiLayout(graph, DefaultKamadaKawaiOptions());
+    if(result.iterations == 0 && graph.nodes.size() > kMaximumDistanceNodes) {
+        cout << "The graph is too large for the Kamada-Kawai layout." << endl;
+        return;
+    }
+    DrawGraph(graph);
+    cout << "Newton-Raphson steps used: " << result.iterations << endl;
+    cout << "Final energy: " << result.energy << endl;
 }
 
 /*
- * CalculateYForce
- * Takes in a force and an angle in radians and computes the appropriate
- * Y component of that force.
+ * RunOverlapRemoval
+ * Asks whether to move apart the nodes that are drawn
+ * on top of one another, and if so removes the overlaps
+ * and draws the result.
  */
-double CalculateYForce(double fRepel, double radiansAngle){
-    return fRepel * sin(radiansAngle);
+void RunOverlapRemoval(SimpleGraph& graph) {
+    cout << "Remove overlapping nodes (0 = no, 1 = yes): ";
+    while(true) {
+        int remove = GetInteger();
+        if(remove == 0) return;
+        if(remove == 1) break;
+        cout << "Please enter 0 or 1: ";
+    }
+    OverlapResult result = RemoveOverlaps(graph, DefaultOverlapOptions());
+    DrawGraph(graph);
+    cout << "Overlapping pairs: " << result.initialOverlaps << " before, "
+         << result.remainingOverlaps << " after " << result.passes << " passes" << endl;
 }
 
-void UpdateNodeMovements(SimpleGraph& graph, vector<Node>& nodeChanges) {
-    for(size_t nodeIndex = 0; nodeIndex < graph.nodes.size(); nodeIndex++) {
-       //Update the node positions
-        graph.nodes[nodeIndex].x +=nodeChanges[nodeIndex].x;
-        graph.nodes[nodeIndex].y +=nodeChanges[nodeIndex].y;
-        //Reset the node changes
-        nodeChanges[nodeIndex].x = 0;
-        nodeChanges[nodeIndex].y = 0;
+/*
+ * RunEdgeBundling
+ * Asks whether to bundle the edges, and if so draws
+ * them along the bundled paths instead of as straight
+ * lines.
+ */
+void RunEdgeBundling(SimpleGraph& graph) {
+    cout << "Bundle edges (0 = no, 1 = yes): ";
+    while(true) {
+        int bundle = GetInteger();
+        if(bundle == 0) return;
+        if(bundle == 1) break;
+        cout << "Please enter 0 or 1: ";
     }
+    vector<vector<Node> > edgePaths;
+    size_t numberOfPairs = BundleEdges(graph, DefaultBundlingOptions(), edgePaths);
+    DrawGraph(graph, edgePaths);
+    cout << "Compatible edge pairs: " << numberOfPairs << endl;
 }
 
 /* Main function */
@@ -394,16 +738,30 @@ int main() {
     do {
         //Load graph
         SimpleGraph graph = LoadGraph();
+        Adjacency adjacency;
+        BuildAdjacency(graph.nodes.size(), graph.edges, adjacency);
         DrawGraph(graph);
-        //Get algorithm time
-        int algorithmTime = PromptForTime();
-    
-        //Start transformation
-        time_t startTime = time(NULL);
-        while (true) {
-            TransformGraph(graph);
-            DrawGraph(graph);
-            if(GetElapsedTime(startTime) > algorithmTime) break;
+        LayoutAlgorithm algorithm = PromptForLayoutAlgorithm();
+        if(algorithm == kStressMajorizationAlgorithm) {
+            RunStressLayout(graph);
+        } else if(algorithm == kSgdAlgorithm) {
+            RunSgdLayout(graph);
+        } else if(algorithm == kKamadaKawaiAlgorithm) {
+            RunKamadaKawaiLayout(graph);
+        } else if(algorithm == kForceAtlas2Algorithm) {
+            RunForceAtlas2Layout(graph, adjacency);
+        } else if(algorithm == kComponentAlgorithm) {
+            RunComponentLayout(graph);
+        } else if(algorithm == kSpatialAlgorithm) {
+            RunSpatialLayout(graph, adjacency);
+        } else {
+            RunForceDirectedLayout(graph, adjacency);
+        }
+
+        //A 3D layout is seen from a new direction every frame, so has no fixed picture
+        if(algorithm != kSpatialAlgorithm) {
+            RunOverlapRemoval(graph);
+            RunEdgeBundling(graph);
         }
         
         //Allow for multiple graphs